@@ -31,8 +31,10 @@
 
 #include "core/globals.h"
 #include "geometry.h"
+#include "io/file_access_compressed.h"
 #include "io/file_access_encrypted.h"
 #include "io/marshalls.h"
+#include "io/resource_load_queue.h"
 #include "os/keyboard.h"
 #include "os/os.h"
 
@@ -120,6 +122,51 @@ Ref<ResourceImportMetadata> _ResourceLoader::load_import_metadata(const String &
 	return ResourceLoader::load_import_metadata(p_path);
 }
 
+Error _ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint) {
+
+	return ResourceLoadQueue::get_singleton()->request(p_path, p_type_hint);
+}
+
+_ResourceLoader::ThreadLoadStatus _ResourceLoader::load_threaded_get_status(const String &p_path) {
+
+	return ThreadLoadStatus(ResourceLoadQueue::get_singleton()->get_status(p_path));
+}
+
+float _ResourceLoader::load_threaded_get_progress(const String &p_path) {
+
+	float progress = 0;
+	ResourceLoadQueue::get_singleton()->get_status(p_path, &progress);
+	return progress;
+}
+
+RES _ResourceLoader::load_threaded_get(const String &p_path) {
+
+	Error err = OK;
+	RES ret = ResourceLoadQueue::get_singleton()->get(p_path, &err);
+
+	if (err != OK) {
+		ERR_EXPLAIN("Error loading resource: '" + p_path + "'");
+		ERR_FAIL_COND_V(err != OK, ret);
+	}
+	return ret;
+}
+
+Dictionary _ResourceLoader::load_threaded_get_stats() {
+
+	ResourceLoadQueue::Stats stats = ResourceLoadQueue::get_singleton()->get_stats();
+
+	Dictionary ret;
+	ret["requested"] = stats.requested;
+	ret["dependencies"] = stats.dependencies;
+	ret["loaded"] = stats.loaded;
+	ret["failed"] = stats.failed;
+	ret["pending"] = stats.pending;
+	ret["total_load_msec"] = stats.total_load_usec / 1000.0;
+	ret["max_load_msec"] = stats.max_load_usec / 1000.0;
+	ret["total_wait_msec"] = stats.total_wait_usec / 1000.0;
+	return ret;
+}
+
 void _ResourceLoader::_bind_methods() {
 
 	ObjectTypeDB::bind_method(_MD("load_interactive:ResourceInteractiveLoader", "path", "type_hint"), &_ResourceLoader::load_interactive, DEFVAL(""));
@@ -129,6 +176,18 @@ void _ResourceLoader::_bind_methods() {
 	ObjectTypeDB::bind_method(_MD("set_abort_on_missing_resources", "abort"), &_ResourceLoader::set_abort_on_missing_resources);
 	ObjectTypeDB::bind_method(_MD("get_dependencies", "path"), &_ResourceLoader::get_dependencies);
 	ObjectTypeDB::bind_method(_MD("has", "path"), &_ResourceLoader::has);
+
+	ObjectTypeDB::bind_method(_MD("load_threaded_request", "path", "type_hint"), &_ResourceLoader::load_threaded_request, DEFVAL(""));
+	ObjectTypeDB::bind_method(_MD("load_threaded_get_status", "path"), &_ResourceLoader::load_threaded_get_status);
+	ObjectTypeDB::bind_method(_MD("load_threaded_get_progress", "path"), &_ResourceLoader::load_threaded_get_progress);
+	ObjectTypeDB::bind_method(_MD("load_threaded_get:Resource", "path"), &_ResourceLoader::load_threaded_get);
+	ObjectTypeDB::bind_method(_MD("load_threaded_get_stats"), &_ResourceLoader::load_threaded_get_stats);
+
+	BIND_CONSTANT(THREAD_LOAD_INVALID_RESOURCE);
+	BIND_CONSTANT(THREAD_LOAD_QUEUED);
+	BIND_CONSTANT(THREAD_LOAD_IN_PROGRESS);
+	BIND_CONSTANT(THREAD_LOAD_LOADED);
+	BIND_CONSTANT(THREAD_LOAD_FAILED);
 }
 
 _ResourceLoader::_ResourceLoader() {
@@ -1473,6 +1532,25 @@ Error _File::open_encrypted_pass(const String &p_path, int p_mode_flags, const S
 	return OK;
 }
 
+Error _File::open_compressed(const String &p_path, int p_mode_flags, int p_compress_mode) {
+
+	ERR_FAIL_INDEX_V(p_compress_mode, COMPRESSION_ZSTD + 1, ERR_INVALID_PARAMETER);
+
+	FileAccessCompressed *fac = memnew(FileAccessCompressed);
+	fac->configure("GCPF", Compression::Mode(p_compress_mode));
+
+	Error err = fac->_open(p_path, p_mode_flags);
+	if (err) {
+		memdelete(fac);
+		return err;
+	}
+
+	close();
+	f = fac;
+	f->set_endian_swap(eswap);
+	return OK;
+}
+
 Error _File::open(const String &p_path, int p_mode_flags) {
 
 	close();
@@ -1778,6 +1856,7 @@ void _File::_bind_methods() {
 
 	ObjectTypeDB::bind_method(_MD("open_encrypted", "path", "mode_flags", "key"), &_File::open_encrypted);
 	ObjectTypeDB::bind_method(_MD("open_encrypted_with_pass", "path", "mode_flags", "pass"), &_File::open_encrypted_pass);
+	ObjectTypeDB::bind_method(_MD("open_compressed", "path", "mode_flags", "compression_mode"), &_File::open_compressed, DEFVAL(0));
 
 	ObjectTypeDB::bind_method(_MD("open", "path", "flags"), &_File::open);
 	ObjectTypeDB::bind_method(_MD("close"), &_File::close);
@@ -1827,6 +1906,10 @@ void _File::_bind_methods() {
 	BIND_CONSTANT(WRITE);
 	BIND_CONSTANT(READ_WRITE);
 	BIND_CONSTANT(WRITE_READ);
+
+	BIND_CONSTANT(COMPRESSION_FASTLZ);
+	BIND_CONSTANT(COMPRESSION_DEFLATE);
+	BIND_CONSTANT(COMPRESSION_ZSTD);
 }
 
 _File::_File() {
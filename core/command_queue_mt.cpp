@@ -48,6 +48,22 @@ void CommandQueueMT::wait_for_flush() {
 	OS::get_singleton()->delay_usec(1000);
 }
 
+void CommandQueueMT::wait_for_publish() {
+
+	// the producer is in the middle of writing a command, let it run
+	OS::get_singleton()->delay_usec(1);
+}
+
+void CommandQueueMT::_wait_for_room(uint32_t p_end) {
+
+	// the reserved space may still hold commands the flushing thread didn't run yet.
+	// a plain read is enough, a stale value only makes us wait longer. The difference
+	// is signed, p_end may come from a stale reserve_pos that was already flushed.
+	while ((int32_t)(p_end - *(volatile uint32_t *)&release_pos) > COMMAND_MEM_SIZE) {
+		wait_for_flush();
+	}
+}
+
 CommandQueueMT::SyncSemaphore *CommandQueueMT::_alloc_sync_sem() {
 
 	int idx = -1;
@@ -75,11 +91,15 @@ CommandQueueMT::SyncSemaphore *CommandQueueMT::_alloc_sync_sem() {
 	return &sync_sems[idx];
 }
 
-CommandQueueMT::CommandQueueMT(bool p_sync) {
+CommandQueueMT::CommandQueueMT(bool p_sync, bool p_lockless) {
 
 	read_ptr = 0;
 	write_ptr = 0;
+	reserve_pos = 0;
+	release_pos = 0;
+	lockless = p_lockless;
 	mutex = Mutex::create();
+	memset(command_mem, 0, COMMAND_MEM_SIZE);
 
 	for (int i = 0; i < SYNC_SEMAPHORES; i++) {
 
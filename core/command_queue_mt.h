@@ -33,8 +33,11 @@
 #include "os/memory.h"
 #include "os/mutex.h"
 #include "os/semaphore.h"
+#include "safe_refcount.h"
 #include "simple_type.h"
 #include "typedefs.h"
+
+#include <string.h>
 /**
 	@author Juan Linietsky <reduzio@gmail.com>
 */
@@ -44,7 +47,7 @@ class CommandQueueMT {
 	struct SyncSemaphore {
 
 		Semaphore *sem;
-		bool in_use;
+		bool in_use; // released by the waiting thread, once it consumed the post
 	};
 
 	struct CommandBase {
@@ -183,7 +186,6 @@ class CommandQueueMT {
 		virtual void call() {
 			*ret = (instance->*method)();
 			sync->sem->post();
-			sync->in_use = false;
 			;
 		}
 	};
@@ -200,7 +202,6 @@ class CommandQueueMT {
 		virtual void call() {
 			*ret = (instance->*method)(p1);
 			sync->sem->post();
-			sync->in_use = false;
 		}
 	};
 
@@ -217,7 +218,6 @@ class CommandQueueMT {
 		virtual void call() {
 			*ret = (instance->*method)(p1, p2);
 			sync->sem->post();
-			sync->in_use = false;
 			;
 		}
 	};
@@ -236,7 +236,6 @@ class CommandQueueMT {
 		virtual void call() {
 			*ret = (instance->*method)(p1, p2, p3);
 			sync->sem->post();
-			sync->in_use = false;
 			;
 		}
 	};
@@ -256,7 +255,6 @@ class CommandQueueMT {
 		virtual void call() {
 			*ret = (instance->*method)(p1, p2, p3, p4);
 			sync->sem->post();
-			sync->in_use = false;
 			;
 		}
 	};
@@ -277,7 +275,6 @@ class CommandQueueMT {
 		virtual void call() {
 			*ret = (instance->*method)(p1, p2, p3, p4, p5);
 			sync->sem->post();
-			sync->in_use = false;
 			;
 		}
 	};
@@ -299,7 +296,6 @@ class CommandQueueMT {
 		virtual void call() {
 			*ret = (instance->*method)(p1, p2, p3, p4, p5, p6);
 			sync->sem->post();
-			sync->in_use = false;
 			;
 		}
 	};
@@ -322,7 +318,6 @@ class CommandQueueMT {
 		virtual void call() {
 			*ret = (instance->*method)(p1, p2, p3, p4, p5, p6, p7);
 			sync->sem->post();
-			sync->in_use = false;
 			;
 		}
 	};
@@ -346,7 +341,6 @@ class CommandQueueMT {
 		virtual void call() {
 			*ret = (instance->*method)(p1, p2, p3, p4, p5, p6, p7, p8);
 			sync->sem->post();
-			sync->in_use = false;
 			;
 		}
 	};
@@ -366,7 +360,6 @@ class CommandQueueMT {
 		virtual void call() {
 			(instance->*method)();
 			sync->sem->post();
-			sync->in_use = false;
 			;
 		}
 	};
@@ -383,7 +376,6 @@ class CommandQueueMT {
 		virtual void call() {
 			(instance->*method)(p1);
 			sync->sem->post();
-			sync->in_use = false;
 			;
 		}
 	};
@@ -401,7 +393,6 @@ class CommandQueueMT {
 		virtual void call() {
 			(instance->*method)(p1, p2);
 			sync->sem->post();
-			sync->in_use = false;
 			;
 		}
 	};
@@ -420,7 +411,6 @@ class CommandQueueMT {
 		virtual void call() {
 			(instance->*method)(p1, p2, p3);
 			sync->sem->post();
-			sync->in_use = false;
 			;
 		}
 	};
@@ -440,7 +430,6 @@ class CommandQueueMT {
 		virtual void call() {
 			(instance->*method)(p1, p2, p3, p4);
 			sync->sem->post();
-			sync->in_use = false;
 			;
 		}
 	};
@@ -461,7 +450,6 @@ class CommandQueueMT {
 		virtual void call() {
 			(instance->*method)(p1, p2, p3, p4, p5);
 			sync->sem->post();
-			sync->in_use = false;
 			;
 		}
 	};
@@ -483,7 +471,6 @@ class CommandQueueMT {
 		virtual void call() {
 			(instance->*method)(p1, p2, p3, p4, p5, p6);
 			sync->sem->post();
-			sync->in_use = false;
 			;
 		}
 	};
@@ -506,7 +493,6 @@ class CommandQueueMT {
 		virtual void call() {
 			(instance->*method)(p1, p2, p3, p4, p5, p6, p7);
 			sync->sem->post();
-			sync->in_use = false;
 			;
 		}
 	};
@@ -530,7 +516,6 @@ class CommandQueueMT {
 		virtual void call() {
 			(instance->*method)(p1, p2, p3, p4, p5, p6, p7, p8);
 			sync->sem->post();
-			sync->in_use = false;
 			;
 		}
 	};
@@ -540,12 +525,36 @@ class CommandQueueMT {
 	enum {
 		COMMAND_MEM_SIZE_KB = 256,
 		COMMAND_MEM_SIZE = COMMAND_MEM_SIZE_KB * 1024,
-		SYNC_SEMAPHORES = 8
+		SYNC_SEMAPHORES = 8,
+		PUBLISH_SPIN_COUNT = 64
+	};
+
+	/* Lock-free mode: producers reserve records with a single atomic add on a
+	   monotonic position (wrapping at 2^32, a multiple of COMMAND_MEM_SIZE) and
+	   publish them by setting the record state, so pushing never takes the mutex.
+	   Only one thread may flush. */
+
+	enum RecordState {
+		RECORD_PENDING, // reserved (or free), contents not ready yet
+		RECORD_COMMAND,
+		RECORD_SKIP // padding, a record can't wrap around the end of the buffer
+	};
+
+	struct RecordHeader {
+
+		uint32_t size; // including the header, always a multiple of 8
+		uint32_t state;
 	};
 
-	uint8_t command_mem[COMMAND_MEM_SIZE];
+	union {
+		uint8_t command_mem[COMMAND_MEM_SIZE];
+		uint64_t command_mem_align;
+	};
 	uint32_t read_ptr;
 	uint32_t write_ptr;
+	uint32_t reserve_pos; // lock-free, next position handed out to a producer
+	uint32_t release_pos; // lock-free, everything before was flushed
+	bool lockless;
 	SyncSemaphore sync_sems[SYNC_SEMAPHORES];
 	Mutex *mutex;
 	Semaphore *sync;
@@ -591,9 +600,41 @@ class CommandQueueMT {
 		return cmd;
 	}
 
+	template <class T>
+	T *allocate_lockless() {
+
+		uint32_t alloc_size = (sizeof(RecordHeader) + sizeof(T) + 7) & ~7;
+
+		while (true) {
+
+			// don't queue up behind a full buffer, a reservation can't be given back
+			_wait_for_room(*(volatile uint32_t *)&reserve_pos + alloc_size);
+
+			uint32_t pos = atomic_add(&reserve_pos, alloc_size) - alloc_size;
+			uint32_t ofs = pos % COMMAND_MEM_SIZE;
+
+			_wait_for_room(pos + alloc_size);
+
+			if (ofs + alloc_size <= COMMAND_MEM_SIZE) {
+
+				RecordHeader *header = (RecordHeader *)&command_mem[ofs];
+				header->size = alloc_size;
+				return memnew_placement(&command_mem[ofs + sizeof(RecordHeader)], T);
+			}
+
+			// no room at the end, skip what was reserved (on both sides of the wrap) and try again
+			uint32_t tail = COMMAND_MEM_SIZE - ofs;
+			_publish_record(0, alloc_size - tail, RECORD_SKIP);
+			_publish_record(ofs, tail, RECORD_SKIP);
+		}
+	}
+
 	template <class T>
 	T *allocate_and_lock() {
 
+		if (lockless)
+			return allocate_lockless<T>();
+
 		lock();
 		T *ret;
 
@@ -608,8 +649,30 @@ class CommandQueueMT {
 		return ret;
 	}
 
+	template <class T>
+	void commit_and_unlock(T *p_cmd) {
+
+		if (!lockless) {
+			unlock();
+			return;
+		}
+
+		RecordHeader *header = reinterpret_cast<RecordHeader *>(reinterpret_cast<uint8_t *>(p_cmd) - sizeof(RecordHeader));
+		atomic_add(&header->state, (uint32_t)RECORD_COMMAND); // full barrier, contents are visible before the state
+	}
+
+	_FORCE_INLINE_ void _publish_record(uint32_t p_ofs, uint32_t p_size, RecordState p_state) {
+
+		RecordHeader *header = (RecordHeader *)&command_mem[p_ofs];
+		header->size = p_size;
+		atomic_add(&header->state, (uint32_t)p_state);
+	}
+
 	bool flush_one() {
 
+		if (lockless)
+			return flush_one_lockless();
+
 	tryagain:
 
 		// tried to read an empty queue
@@ -636,9 +699,40 @@ class CommandQueueMT {
 		return true;
 	}
 
+	bool flush_one_lockless() {
+
+		while (true) {
+
+			uint32_t ofs = release_pos % COMMAND_MEM_SIZE;
+			RecordHeader *header = (RecordHeader *)&command_mem[ofs];
+
+			uint32_t state = atomic_add(&header->state, 0);
+			if (state == RECORD_PENDING)
+				return false; // empty, or the next record is still being written
+
+			uint32_t size = header->size;
+
+			if (state == RECORD_COMMAND) {
+
+				CommandBase *cmd = reinterpret_cast<CommandBase *>(&command_mem[ofs + sizeof(RecordHeader)]);
+				cmd->call();
+				cmd->~CommandBase();
+			}
+
+			// leave the space zeroed, so stale data is never mistaken for a header
+			memset(header, 0, size);
+			atomic_add(&release_pos, size);
+
+			if (state == RECORD_COMMAND)
+				return true;
+		}
+	}
+
 	void lock();
 	void unlock();
 	void wait_for_flush();
+	void wait_for_publish();
+	void _wait_for_room(uint32_t p_end);
 	SyncSemaphore *_alloc_sync_sem();
 
 public:
@@ -652,7 +746,7 @@ public:
 		cmd->instance = p_instance;
 		cmd->method = p_method;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 	}
@@ -666,7 +760,7 @@ public:
 		cmd->method = p_method;
 		cmd->p1 = p1;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 	}
@@ -681,7 +775,7 @@ public:
 		cmd->p1 = p1;
 		cmd->p2 = p2;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 	}
@@ -697,7 +791,7 @@ public:
 		cmd->p2 = p2;
 		cmd->p3 = p3;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 	}
@@ -714,7 +808,7 @@ public:
 		cmd->p3 = p3;
 		cmd->p4 = p4;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 	}
@@ -732,7 +826,7 @@ public:
 		cmd->p4 = p4;
 		cmd->p5 = p5;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 	}
@@ -751,7 +845,7 @@ public:
 		cmd->p5 = p5;
 		cmd->p6 = p6;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 	}
@@ -771,7 +865,7 @@ public:
 		cmd->p6 = p6;
 		cmd->p7 = p7;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 	}
@@ -792,7 +886,7 @@ public:
 		cmd->p7 = p7;
 		cmd->p8 = p8;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 	}
@@ -811,10 +905,11 @@ public:
 
 		cmd->sync = ss;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 		ss->sem->wait();
+		ss->in_use = false;
 	}
 
 	template <class T, class M, class P1, class R>
@@ -831,10 +926,11 @@ public:
 
 		cmd->sync = ss;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 		ss->sem->wait();
+		ss->in_use = false;
 	}
 
 	template <class T, class M, class P1, class P2, class R>
@@ -852,10 +948,11 @@ public:
 
 		cmd->sync = ss;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 		ss->sem->wait();
+		ss->in_use = false;
 	}
 
 	template <class T, class M, class P1, class P2, class P3, class R>
@@ -874,10 +971,11 @@ public:
 
 		cmd->sync = ss;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 		ss->sem->wait();
+		ss->in_use = false;
 	}
 
 	template <class T, class M, class P1, class P2, class P3, class P4, class R>
@@ -897,10 +995,11 @@ public:
 
 		cmd->sync = ss;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 		ss->sem->wait();
+		ss->in_use = false;
 	}
 
 	template <class T, class M, class P1, class P2, class P3, class P4, class P5, class R>
@@ -921,10 +1020,11 @@ public:
 
 		cmd->sync = ss;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 		ss->sem->wait();
+		ss->in_use = false;
 	}
 
 	template <class T, class M, class P1, class P2, class P3, class P4, class P5, class P6, class R>
@@ -946,10 +1046,11 @@ public:
 
 		cmd->sync = ss;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 		ss->sem->wait();
+		ss->in_use = false;
 	}
 
 	template <class T, class M, class P1, class P2, class P3, class P4, class P5, class P6, class P7, class R>
@@ -972,10 +1073,11 @@ public:
 
 		cmd->sync = ss;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 		ss->sem->wait();
+		ss->in_use = false;
 	}
 
 	template <class T, class M, class P1, class P2, class P3, class P4, class P5, class P6, class P7, class P8, class R>
@@ -999,10 +1101,11 @@ public:
 
 		cmd->sync = ss;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 		ss->sem->wait();
+		ss->in_use = false;
 	}
 
 	template <class T, class M>
@@ -1017,10 +1120,11 @@ public:
 
 		cmd->sync = ss;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 		ss->sem->wait();
+		ss->in_use = false;
 	}
 
 	template <class T, class M, class P1>
@@ -1036,10 +1140,11 @@ public:
 
 		cmd->sync = ss;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 		ss->sem->wait();
+		ss->in_use = false;
 	}
 
 	template <class T, class M, class P1, class P2>
@@ -1056,10 +1161,11 @@ public:
 
 		cmd->sync = ss;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 		ss->sem->wait();
+		ss->in_use = false;
 	}
 
 	template <class T, class M, class P1, class P2, class P3>
@@ -1077,10 +1183,11 @@ public:
 
 		cmd->sync = ss;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 		ss->sem->wait();
+		ss->in_use = false;
 	}
 
 	template <class T, class M, class P1, class P2, class P3, class P4>
@@ -1099,10 +1206,11 @@ public:
 
 		cmd->sync = ss;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 		ss->sem->wait();
+		ss->in_use = false;
 	}
 
 	template <class T, class M, class P1, class P2, class P3, class P4, class P5>
@@ -1122,10 +1230,11 @@ public:
 
 		cmd->sync = ss;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 		ss->sem->wait();
+		ss->in_use = false;
 	}
 
 	template <class T, class M, class P1, class P2, class P3, class P4, class P5, class P6>
@@ -1146,10 +1255,11 @@ public:
 
 		cmd->sync = ss;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 		ss->sem->wait();
+		ss->in_use = false;
 	}
 
 	template <class T, class M, class P1, class P2, class P3, class P4, class P5, class P6, class P7>
@@ -1171,10 +1281,11 @@ public:
 
 		cmd->sync = ss;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 		ss->sem->wait();
+		ss->in_use = false;
 	}
 
 	template <class T, class M, class P1, class P2, class P3, class P4, class P5, class P6, class P7, class P8>
@@ -1197,15 +1308,26 @@ public:
 
 		cmd->sync = ss;
 
-		unlock();
+		commit_and_unlock(cmd);
 
 		if (sync) sync->post();
 		ss->sem->wait();
+		ss->in_use = false;
 	}
 
 	void wait_and_flush_one() {
 		ERR_FAIL_COND(!sync);
 		sync->wait();
+		if (lockless) {
+			// the posted command may be behind one that was reserved but not published yet
+			for (int i = 0; !flush_one_lockless(); i++) {
+				if (atomic_add(&reserve_pos, 0) == release_pos)
+					break; // nothing pending, already flushed by flush_all()
+				if (i >= PUBLISH_SPIN_COUNT)
+					wait_for_publish();
+			}
+			return;
+		}
 		lock();
 		flush_one();
 		unlock();
@@ -1214,16 +1336,18 @@ public:
 	void flush_all() {
 
 		//ERR_FAIL_COND(sync);
-		lock();
+		if (!lockless)
+			lock();
 		while (true) {
 			bool exit = !flush_one();
 			if (exit)
 				break;
 		}
-		unlock();
+		if (!lockless)
+			unlock();
 	}
 
-	CommandQueueMT(bool p_sync);
+	CommandQueueMT(bool p_sync, bool p_lockless = true);
 	~CommandQueueMT();
 };
 
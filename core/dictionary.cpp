@@ -32,32 +32,252 @@
 #include "safe_refcount.h"
 #include "variant.h"
 
-struct _DictionaryVariantHash {
-
-	static _FORCE_INLINE_ uint32_t hash(const Variant &p_variant) { return p_variant.hash(); }
-};
+/* Entries are kept in insertion order in a dense array, so iterating is linear and
+ * preserves the order keys were added in. Erased entries are left as holes (hash 0)
+ * until the array needs to grow, then the live ones are compacted. A separate open
+ * addressing index, twice the size of the entry array, maps hashes to entry positions. */
 
 struct DictionaryPrivate {
 
+	enum {
+		ERASED_HASH = 0,
+		EMPTY_INDEX = -1,
+		MIN_CAPACITY = 8
+	};
+
+	struct Entry {
+
+		Variant key;
+		Variant value;
+		uint32_t hash;
+	};
+
 	SafeRefCount refcount;
-	HashMap<Variant, Variant, _DictionaryVariantHash> variant_map;
 	bool shared;
+
+	Entry *entries;
+	uint32_t entry_count; // used positions, including erased ones
+	uint32_t capacity;
+	uint32_t size; // live entries
+	int32_t *index; // 2 * capacity slots
+
+	static _FORCE_INLINE_ uint32_t _hash(const Variant &p_key) {
+
+		uint32_t hash = p_key.hash();
+		return hash == ERASED_HASH ? 1 : hash;
+	}
+
+	int find(const Variant &p_key, uint32_t p_hash) const {
+
+		if (!capacity)
+			return -1;
+
+		uint32_t mask = capacity * 2 - 1;
+		uint32_t pos = p_hash & mask;
+
+		while (index[pos] != EMPTY_INDEX) {
+
+			const Entry &e = entries[index[pos]];
+			if (e.hash == p_hash && e.key == p_key)
+				return index[pos];
+
+			pos = (pos + 1) & mask;
+		}
+
+		return -1;
+	}
+
+	void _index_insert(uint32_t p_entry) {
+
+		uint32_t mask = capacity * 2 - 1;
+		uint32_t pos = entries[p_entry].hash & mask;
+
+		while (index[pos] != EMPTY_INDEX)
+			pos = (pos + 1) & mask;
+
+		index[pos] = p_entry;
+	}
+
+	void _index_erase(uint32_t p_entry) {
+
+		uint32_t mask = capacity * 2 - 1;
+		uint32_t pos = entries[p_entry].hash & mask;
+
+		while (index[pos] != (int32_t)p_entry)
+			pos = (pos + 1) & mask;
+
+		/* shift back the rest of the cluster, so no lookup stops early at the hole */
+		uint32_t hole = pos;
+		index[hole] = EMPTY_INDEX;
+		pos = (pos + 1) & mask;
+
+		while (index[pos] != EMPTY_INDEX) {
+
+			uint32_t ideal = entries[index[pos]].hash & mask;
+			if (((pos - ideal) & mask) >= ((pos - hole) & mask)) {
+				index[hole] = index[pos];
+				index[pos] = EMPTY_INDEX;
+				hole = pos;
+			}
+			pos = (pos + 1) & mask;
+		}
+	}
+
+	/* moves the live entries to a new array of p_capacity, in order, and rebuilds the index */
+	void _reallocate(uint32_t p_capacity) {
+
+		Entry *new_entries = (Entry *)memalloc(sizeof(Entry) * p_capacity);
+		uint32_t new_count = 0;
+
+		for (uint32_t i = 0; i < entry_count; i++) {
+
+			if (entries[i].hash != ERASED_HASH) {
+				memnew_placement(&new_entries[new_count], Entry(entries[i]));
+				new_count++;
+			}
+			entries[i].~Entry();
+		}
+
+		if (capacity) {
+			memfree(entries);
+			memfree(index);
+		}
+
+		entries = new_entries;
+		entry_count = new_count;
+		capacity = p_capacity;
+
+		index = (int32_t *)memalloc(sizeof(int32_t) * capacity * 2);
+		for (uint32_t i = 0; i < capacity * 2; i++)
+			index[i] = EMPTY_INDEX;
+		for (uint32_t i = 0; i < entry_count; i++)
+			_index_insert(i);
+	}
+
+	Variant &insert(const Variant &p_key, uint32_t p_hash) {
+
+		if (entry_count == capacity) {
+
+			/* compact if at least half the entries are erased, grow otherwise */
+			uint32_t new_capacity = capacity ? capacity : MIN_CAPACITY;
+			if (size >= capacity / 2 && capacity)
+				new_capacity = capacity * 2;
+			_reallocate(new_capacity);
+		}
+
+		Entry *e = memnew_placement(&entries[entry_count], Entry);
+		e->key = p_key;
+		e->hash = p_hash;
+		_index_insert(entry_count);
+		entry_count++;
+		size++;
+
+		return e->value;
+	}
+
+	void erase(uint32_t p_entry) {
+
+		_index_erase(p_entry);
+
+		/* the key stays valid (nil) and positions don't move, so iterating this same data can
+		 * go on past an erased entry. Only when erase() does not copy on write, though. */
+		Entry &e = entries[p_entry];
+		e.key = Variant();
+		e.value = Variant();
+		e.hash = ERASED_HASH;
+		size--;
+	}
+
+	int next_entry(int p_from) const {
+
+		for (uint32_t i = p_from; i < entry_count; i++) {
+			if (entries[i].hash != ERASED_HASH)
+				return i;
+		}
+		return -1;
+	}
+
+	void clear() {
+
+		if (capacity) {
+
+			for (uint32_t i = 0; i < entry_count; i++)
+				entries[i].~Entry();
+
+			memfree(entries);
+			memfree(index);
+		}
+
+		entries = NULL;
+		index = NULL;
+		entry_count = 0;
+		capacity = 0;
+		size = 0;
+	}
+
+	void copy_from(const DictionaryPrivate &p_from) {
+
+		clear();
+
+		if (!p_from.size)
+			return;
+
+		uint32_t new_capacity = MIN_CAPACITY;
+		while (new_capacity < p_from.size)
+			new_capacity <<= 1;
+
+		entries = (Entry *)memalloc(sizeof(Entry) * new_capacity);
+		for (uint32_t i = 0; i < p_from.entry_count; i++) {
+
+			if (p_from.entries[i].hash != ERASED_HASH) {
+				memnew_placement(&entries[entry_count], Entry(p_from.entries[i]));
+				entry_count++;
+			}
+		}
+
+		size = entry_count;
+		capacity = new_capacity;
+		index = (int32_t *)memalloc(sizeof(int32_t) * capacity * 2);
+		for (uint32_t i = 0; i < capacity * 2; i++)
+			index[i] = EMPTY_INDEX;
+		for (uint32_t i = 0; i < entry_count; i++)
+			_index_insert(i);
+	}
+
+	DictionaryPrivate() {
+
+		entries = NULL;
+		index = NULL;
+		entry_count = 0;
+		capacity = 0;
+		size = 0;
+		shared = false;
+	}
+
+	~DictionaryPrivate() {
+
+		clear();
+	}
 };
 
 void Dictionary::get_key_list(List<Variant> *p_keys) const {
 
-	_p->variant_map.get_key_list(p_keys);
+	for (uint32_t i = 0; i < _p->entry_count; i++) {
+
+		if (_p->entries[i].hash != DictionaryPrivate::ERASED_HASH)
+			p_keys->push_back(_p->entries[i].key);
+	}
 }
 
 void Dictionary::_copy_on_write() const {
 
-	//make a copy of what we have
-	if (_p->shared)
+	//make a copy of what we have, unless no one else has it
+	if (_p->shared || _p->refcount.get() == 1)
 		return;
 
 	DictionaryPrivate *p = memnew(DictionaryPrivate);
 	p->shared = _p->shared;
-	p->variant_map = _p->variant_map;
+	p->copy_from(*_p);
 	p->refcount.init();
 	_unref();
 	_p = p;
@@ -67,21 +287,33 @@ Variant &Dictionary::operator[](const Variant &p_key) {
 
 	_copy_on_write();
 
-	return _p->variant_map[p_key];
+	uint32_t hash = DictionaryPrivate::_hash(p_key);
+	int pos = _p->find(p_key, hash);
+	if (pos >= 0)
+		return _p->entries[pos].value;
+
+	return _p->insert(p_key, hash);
 }
 
 const Variant &Dictionary::operator[](const Variant &p_key) const {
 
-	return _p->variant_map[p_key];
+	const Variant *v = getptr(p_key);
+	if (!v) {
+		static const Variant nil;
+		ERR_FAIL_V(nil);
+	}
+	return *v;
 }
 const Variant *Dictionary::getptr(const Variant &p_key) const {
 
-	return _p->variant_map.getptr(p_key);
+	int pos = _p->find(p_key, DictionaryPrivate::_hash(p_key));
+	return pos < 0 ? NULL : &_p->entries[pos].value;
 }
 Variant *Dictionary::getptr(const Variant &p_key) {
 
 	_copy_on_write();
-	return _p->variant_map.getptr(p_key);
+	int pos = _p->find(p_key, DictionaryPrivate::_hash(p_key));
+	return pos < 0 ? NULL : &_p->entries[pos].value;
 }
 
 Variant Dictionary::get_valid(const Variant &p_key) const {
@@ -94,16 +326,16 @@ Variant Dictionary::get_valid(const Variant &p_key) const {
 
 int Dictionary::size() const {
 
-	return _p->variant_map.size();
+	return _p->size;
 }
 bool Dictionary::empty() const {
 
-	return !_p->variant_map.size();
+	return !_p->size;
 }
 
 bool Dictionary::has(const Variant &p_key) const {
 
-	return _p->variant_map.has(p_key);
+	return _p->find(p_key, DictionaryPrivate::_hash(p_key)) >= 0;
 }
 
 bool Dictionary::has_all(const Array &p_keys) const {
@@ -117,7 +349,9 @@ bool Dictionary::has_all(const Array &p_keys) const {
 
 void Dictionary::erase(const Variant &p_key) {
 	_copy_on_write();
-	_p->variant_map.erase(p_key);
+	int pos = _p->find(p_key, DictionaryPrivate::_hash(p_key));
+	if (pos >= 0)
+		_p->erase(pos);
 }
 
 bool Dictionary::operator==(const Dictionary &p_dictionary) const {
@@ -144,7 +378,7 @@ void Dictionary::_ref(const Dictionary &p_from) const {
 void Dictionary::clear() {
 
 	_copy_on_write();
-	_p->variant_map.clear();
+	_p->clear();
 }
 
 bool Dictionary::is_shared() const {
@@ -164,13 +398,14 @@ uint32_t Dictionary::hash() const {
 
 	uint32_t h = hash_djb2_one_32(Variant::DICTIONARY);
 
-	List<Variant> keys;
-	get_key_list(&keys);
+	for (uint32_t i = 0; i < _p->entry_count; i++) {
 
-	for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
+		const DictionaryPrivate::Entry &e = _p->entries[i];
+		if (e.hash == DictionaryPrivate::ERASED_HASH)
+			continue;
 
-		h = hash_djb2_one_32(E->get().hash(), h);
-		h = hash_djb2_one_32(operator[](E->get()).hash(), h);
+		h = hash_djb2_one_32(e.key.hash(), h);
+		h = hash_djb2_one_32(e.value.hash(), h);
 	}
 
 	return h;
@@ -180,10 +415,11 @@ Array Dictionary::keys() const {
 
 	Array karr;
 	karr.resize(size());
-	const Variant *K = NULL;
 	int idx = 0;
-	while ((K = next(K))) {
-		karr[idx++] = (*K);
+	for (uint32_t i = 0; i < _p->entry_count; i++) {
+
+		if (_p->entries[i].hash != DictionaryPrivate::ERASED_HASH)
+			karr[idx++] = _p->entries[i].key;
 	}
 	return karr;
 }
@@ -192,17 +428,51 @@ Array Dictionary::values() const {
 
 	Array varr;
 	varr.resize(size());
-	const Variant *key = NULL;
-	int i = 0;
-	while ((key = next(key))) {
-		varr[i++] = _p->variant_map[*key];
+	int idx = 0;
+	for (uint32_t i = 0; i < _p->entry_count; i++) {
+
+		if (_p->entries[i].hash != DictionaryPrivate::ERASED_HASH)
+			varr[idx++] = _p->entries[i].value;
 	}
 	return varr;
 }
 
 const Variant *Dictionary::next(const Variant *p_key) const {
 
-	return _p->variant_map.next(p_key);
+	int from = 0;
+
+	if (p_key) {
+
+		/* keys returned by next() point into the entry array, so the position is known.
+		 * Any other pointer falls back to a lookup. */
+		const uint8_t *begin = (const uint8_t *)_p->entries;
+		const uint8_t *ptr = (const uint8_t *)p_key;
+		uint32_t pos = _p->capacity && ptr >= begin ? uint32_t(ptr - begin) / sizeof(DictionaryPrivate::Entry) : _p->capacity;
+
+		if (pos < _p->entry_count && &_p->entries[pos].key == p_key) {
+			from = pos + 1;
+		} else {
+			int found = _p->find(*p_key, DictionaryPrivate::_hash(*p_key));
+			ERR_FAIL_COND_V(found < 0, NULL); /* invalid key supplied */
+			from = found + 1;
+		}
+	}
+
+	int pos = _p->next_entry(from);
+	return pos < 0 ? NULL : &_p->entries[pos].key;
+}
+
+int Dictionary::next_position(int p_pos) const {
+
+	return _p->next_entry(p_pos + 1);
+}
+
+const Variant *Dictionary::get_key_at_position(int p_pos) const {
+
+	if (p_pos < 0 || p_pos >= (int)_p->entry_count || _p->entries[p_pos].hash == DictionaryPrivate::ERASED_HASH)
+		return NULL;
+
+	return &_p->entries[p_pos].key;
 }
 
 Error Dictionary::parse_json(const String &p_json) {
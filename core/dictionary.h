@@ -37,6 +37,8 @@ class Variant;
 
 struct DictionaryPrivate;
 
+/* Keys are kept in insertion order. Inserting may move stored keys and values, so
+ * pointers and references obtained from it are only valid until the next insertion. */
 class Dictionary {
 
 	mutable DictionaryPrivate *_p;
@@ -77,6 +79,11 @@ public:
 
 	const Variant *next(const Variant *p_key = NULL) const;
 
+	/* positional iteration, as done by Variant::iter_*(). Positions survive erasing,
+	 * but an insertion may compact the entries and invalidate them. */
+	int next_position(int p_pos = -1) const;
+	const Variant *get_key_at_position(int p_pos) const;
+
 	Array keys() const;
 	Array values() const;
 
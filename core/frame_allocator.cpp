@@ -0,0 +1,209 @@
+/*************************************************************************/
+/*  frame_allocator.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "frame_allocator.h"
+#include "error_macros.h"
+
+FrameAllocator *FrameAllocator::singleton = NULL;
+
+FrameAllocator *FrameAllocator::get_singleton() {
+
+	return singleton;
+}
+
+FrameAllocator::Block *FrameAllocator::_create_block(size_t p_size) {
+
+	Block *block = (Block *)memalloc(_align(sizeof(Block)) + p_size);
+	ERR_FAIL_COND_V(!block, NULL);
+	block->next = NULL;
+	block->size = p_size;
+	block->used = 0;
+	return block;
+}
+
+void FrameAllocator::_free_blocks() {
+
+	while (first) {
+
+		Block *next = first->next;
+		memfree(first);
+		first = next;
+	}
+
+	current = NULL;
+}
+
+void *FrameAllocator::alloc(size_t p_bytes) {
+
+#ifdef DEBUG_ENABLED
+	ERR_EXPLAIN("FrameAllocator used from a thread that does not own it");
+	ERR_FAIL_COND_V(!is_owner_thread(), NULL);
+#endif
+
+	size_t size = _align(p_bytes);
+
+	while (true) {
+
+		if (current && current->used + size <= current->size) {
+
+			void *ptr = _get_block_data(current) + current->used;
+			current->used += size;
+			used_total += size;
+			if (used_total > peak_usage)
+				peak_usage = used_total;
+			return ptr;
+		}
+
+		if (current && current->next) {
+			//move on to a block kept from a previous frame
+			used_total += current->size - current->used;
+			current = current->next;
+			current->used = 0;
+			continue;
+		}
+
+		Block *block = _create_block(MAX((size_t)block_size, size));
+		ERR_FAIL_COND_V(!block, NULL);
+
+		if (current) {
+			used_total += current->size - current->used;
+			current->next = block;
+		} else {
+			first = block;
+		}
+		current = block;
+	}
+}
+
+FrameAllocator::Mark FrameAllocator::get_mark() const {
+
+	Mark mark;
+	mark.block = current;
+	mark.used = current ? current->used : 0;
+	mark.used_total = used_total;
+	return mark;
+}
+
+void FrameAllocator::rewind(const Mark &p_mark) {
+
+	if (p_mark.block) {
+
+		current = p_mark.block;
+		current->used = p_mark.used;
+	} else {
+
+		current = first;
+		if (current)
+			current->used = 0;
+	}
+
+	used_total = p_mark.used_total;
+}
+
+void FrameAllocator::reset() {
+
+	if (scope_depth > 0)
+		return; //something in the call stack still uses its memory
+
+	if (first && first->next) {
+
+		//more than one block was needed, replace them with a single one big enough for the peak
+		_free_blocks();
+		first = _create_block(MAX((size_t)block_size, _align(peak_usage)));
+	}
+
+	current = first;
+	if (current)
+		current->used = 0;
+	used_total = 0;
+}
+
+FrameAllocator::FrameAllocator(size_t p_block_size, bool p_singleton) {
+
+	first = NULL;
+	current = NULL;
+	block_size = _align(p_block_size);
+	used_total = 0;
+	peak_usage = 0;
+	scope_depth = 0;
+	owner = Thread::get_caller_ID();
+
+	if (p_singleton)
+		singleton = this;
+}
+
+FrameAllocator::~FrameAllocator() {
+
+	_free_blocks();
+
+	if (singleton == this)
+		singleton = NULL;
+}
+
+/* SCOPE */
+
+void *FrameAllocator::Scope::alloc(size_t p_bytes) {
+
+	if (!heap)
+		return allocator->alloc(p_bytes);
+
+	//not the owner thread, keep the allocations in a list to free them on exit
+	uint8_t *mem = (uint8_t *)memalloc(_align(sizeof(void *)) + p_bytes);
+	ERR_FAIL_COND_V(!mem, NULL);
+	*(void **)mem = heap_allocs;
+	heap_allocs = mem;
+	return mem + _align(sizeof(void *));
+}
+
+FrameAllocator::Scope::Scope(FrameAllocator *p_allocator) {
+
+	allocator = p_allocator;
+	heap = !allocator || !allocator->is_owner_thread();
+	heap_allocs = NULL;
+	if (!heap) {
+		mark = allocator->get_mark();
+		allocator->scope_depth++;
+	}
+}
+
+FrameAllocator::Scope::~Scope() {
+
+	if (!heap) {
+		allocator->rewind(mark);
+		allocator->scope_depth--;
+		return;
+	}
+
+	while (heap_allocs) {
+
+		void *next = *(void **)heap_allocs;
+		memfree(heap_allocs);
+		heap_allocs = next;
+	}
+}
@@ -0,0 +1,127 @@
+/*************************************************************************/
+/*  frame_allocator.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef FRAME_ALLOCATOR_H
+#define FRAME_ALLOCATOR_H
+
+#include "os/memory.h"
+#include "os/thread.h"
+
+/**
+ * Linear allocator for memory that only lives during a frame. Allocating bumps a
+ * pointer inside a block, nothing is freed individually and destructors are not
+ * called, so use it only for plain data (pointers, vectors, etc.).
+ *
+ * An allocator belongs to one thread. The one returned by get_singleton() is owned
+ * by the main thread and reset at the end of every Main::iteration(); servers that
+ * run on their own thread keep their own instance and reset it themselves.
+ *
+ * Use Scope to give back what a function allocated when it returns, so code called
+ * many times per frame does not grow the arena. A Scope used from a thread that does
+ * not own the allocator falls back to the heap. reset() does nothing while a Scope is
+ * open, as happens when the editor runs a nested Main::iteration() to show progress.
+ */
+
+class FrameAllocator {
+public:
+	enum {
+		ALIGNMENT = 16,
+		DEFAULT_BLOCK_SIZE = 65536
+	};
+
+private:
+	struct Block {
+
+		Block *next;
+		size_t size;
+		size_t used;
+	};
+
+	Block *first;
+	Block *current;
+	size_t block_size;
+	size_t used_total; // blocks filled before the current one, plus its used size
+	size_t peak_usage;
+	int scope_depth;
+	Thread::ID owner;
+
+	static FrameAllocator *singleton;
+
+	static _FORCE_INLINE_ size_t _align(size_t p_size) { return (p_size + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1); }
+	static _FORCE_INLINE_ uint8_t *_get_block_data(Block *p_block) { return (uint8_t *)p_block + _align(sizeof(Block)); }
+
+	Block *_create_block(size_t p_size);
+	void _free_blocks();
+
+public:
+	struct Mark {
+
+		Block *block;
+		size_t used;
+		size_t used_total;
+	};
+
+	class Scope {
+
+		FrameAllocator *allocator;
+		Mark mark;
+		bool heap;
+		void *heap_allocs;
+
+	public:
+		void *alloc(size_t p_bytes);
+
+		template <class T>
+		_FORCE_INLINE_ T *alloc_array(int p_count) { return (T *)alloc(sizeof(T) * p_count); }
+
+		Scope(FrameAllocator *p_allocator = FrameAllocator::get_singleton());
+		~Scope();
+	};
+
+	static FrameAllocator *get_singleton();
+
+	void *alloc(size_t p_bytes);
+
+	template <class T>
+	_FORCE_INLINE_ T *alloc_array(int p_count) { return (T *)alloc(sizeof(T) * p_count); }
+
+	Mark get_mark() const;
+	void rewind(const Mark &p_mark);
+	void reset();
+
+	bool is_owner_thread() const { return Thread::get_caller_ID() == owner; }
+	void set_owner_thread(Thread::ID p_owner) { owner = p_owner; }
+
+	size_t get_peak_usage() const { return peak_usage; }
+
+	FrameAllocator(size_t p_block_size = DEFAULT_BLOCK_SIZE, bool p_singleton = false);
+	~FrameAllocator();
+};
+
+#endif
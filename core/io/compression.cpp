@@ -33,9 +33,12 @@
 #include "zip_io.h"
 
 #include "thirdparty/misc/fastlz.h"
+#include "thirdparty/zstd/zstd.h"
 
 #include <zlib.h>
 
+int Compression::zstd_level = 3;
+
 int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode) {
 
 	switch (p_mode) {
@@ -72,6 +75,13 @@ int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size,
 			return aout;
 
 		} break;
+		case MODE_ZSTD: {
+
+			size_t ret = ZSTD_compress(p_dst, ZSTD_compressBound(p_src_size), p_src, p_src_size, zstd_level);
+			ERR_FAIL_COND_V(ZSTD_isError(ret), -1);
+			return ret;
+
+		} break;
 	}
 
 	ERR_FAIL_V(-1);
@@ -101,6 +111,10 @@ int Compression::get_max_compressed_buffer_size(int p_src_size, Mode p_mode) {
 			deflateEnd(&strm);
 			return aout;
 		} break;
+		case MODE_ZSTD: {
+
+			return ZSTD_compressBound(p_src_size);
+		} break;
 	}
 
 	ERR_FAIL_V(-1);
@@ -144,6 +158,12 @@ int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p
 			ERR_FAIL_COND_V(err != Z_STREAM_END, -1);
 			return total;
 		} break;
+		case MODE_ZSTD: {
+
+			size_t ret = ZSTD_decompress(p_dst, p_dst_max_size, p_src, p_src_size);
+			ERR_FAIL_COND_V(ZSTD_isError(ret), -1);
+			return ret;
+		} break;
 	}
 
 	ERR_FAIL_V(-1);
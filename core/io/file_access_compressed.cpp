@@ -28,6 +28,7 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
 /*************************************************************************/
 #include "file_access_compressed.h"
+#include "os/copymem.h"
 #include "print_string.h"
 void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_mode, int p_block_size) {
 
@@ -206,6 +207,9 @@ void FileAccessCompressed::seek(size_t p_position) {
 			at_end = true;
 		} else {
 
+			at_end = false;
+			read_eof = false;
+
 			int block_idx = p_position / block_size;
 			if (block_idx != read_block) {
 
@@ -306,10 +310,15 @@ int FileAccessCompressed::get_buffer(uint8_t *p_dst, int p_length) const {
 		return 0;
 	}
 
-	for (int i = 0; i < p_length; i++) {
+	int i = 0;
+	while (i < p_length) {
+
+		//copy as much as possible from the current block
+		int to_copy = MIN(p_length - i, read_block_size - read_pos);
+		copymem(&p_dst[i], &read_ptr[read_pos], to_copy);
+		i += to_copy;
+		read_pos += to_copy;
 
-		p_dst[i] = read_ptr[read_pos];
-		read_pos++;
 		if (read_pos >= read_block_size) {
 			read_block++;
 
@@ -323,7 +332,7 @@ int FileAccessCompressed::get_buffer(uint8_t *p_dst, int p_length) const {
 			} else {
 				read_block--;
 				at_end = true;
-				if (i < p_length - 1)
+				if (i < p_length)
 					read_eof = true;
 				return i;
 			}
@@ -59,6 +59,7 @@ public:
 	virtual uint8_t get_8() const; ///< get a byte
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const; ///< get an array of bytes
+	virtual const uint8_t *get_direct_buffer(int p_length) const;
 
 	virtual Error get_error() const; ///< get last error
 
@@ -28,11 +28,14 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
 /*************************************************************************/
 #include "file_access_pack.h"
+#include "io/file_access_compressed.h"
+#include "io/marshalls.h"
+#include "os/copymem.h"
 #include "version.h"
 
 #include <stdio.h>
 
-#define PACK_VERSION 0
+#define PACK_VERSION 1
 
 Error PackedData::add_pack(const String &p_path) {
 
@@ -61,34 +64,139 @@ void PackedData::add_path(const String &pkg_path, const String &path, uint64_t o
 	for (int i = 0; i < 16; i++)
 		pf.md5[i] = p_md5[i];
 	pf.src = p_src;
+	pf.compression = PACK_COMPRESSION_NONE;
+	pf.layer = indices.size();
 
 	files[pmd5] = pf;
 
 	if (!exists) {
-		//search for dir
-		String p = path.replace_first("res://", "");
-		PackedDir *cd = root;
+		_add_dir_path(path);
+	}
+}
+
+void PackedData::_add_dir_path(const String &p_path) {
 
-		if (p.find("/") != -1) { //in a subdir
+	//search for dir
+	String p = p_path.replace_first("res://", "");
+	PackedDir *cd = root;
 
-			Vector<String> ds = p.get_base_dir().split("/");
+	if (p.find("/") != -1) { //in a subdir
 
-			for (int j = 0; j < ds.size(); j++) {
+		Vector<String> ds = p.get_base_dir().split("/");
 
-				if (!cd->subdirs.has(ds[j])) {
+		for (int j = 0; j < ds.size(); j++) {
 
-					PackedDir *pd = memnew(PackedDir);
-					pd->name = ds[j];
-					pd->parent = cd;
-					cd->subdirs[pd->name] = pd;
-					cd = pd;
-				} else {
-					cd = cd->subdirs[ds[j]];
-				}
+			if (!cd->subdirs.has(ds[j])) {
+
+				PackedDir *pd = memnew(PackedDir);
+				pd->name = ds[j];
+				pd->parent = cd;
+				cd->subdirs[pd->name] = pd;
+				cd = pd;
+			} else {
+				cd = cd->subdirs[ds[j]];
 			}
 		}
-		cd->files.insert(path.get_file());
 	}
+	cd->files.insert(p_path.get_file());
+}
+
+void PackedData::add_pack_index(const String &p_pack, uint64_t p_base, uint32_t p_count, const Vector<uint8_t> &p_entries, uint64_t p_names_offset, uint32_t p_names_size, PackSource *p_src) {
+
+	ERR_FAIL_COND(uint64_t(p_entries.size()) != uint64_t(p_count) * PACK_INDEX_ENTRY_SIZE);
+
+	PackIndex index;
+	index.pack = p_pack;
+	index.src = p_src;
+	index.base = p_base;
+	index.count = p_count;
+	index.entries = p_entries;
+	index.names_offset = p_names_offset;
+	index.names_size = p_names_size;
+
+	indices.push_back(index);
+}
+
+bool PackedData::_find_indexed(const uint8_t *p_md5, int p_from, PackedFile *r_file) const {
+
+	//newest pack first, so patches override what they replace
+	for (int i = indices.size() - 1; i >= p_from; i--) {
+
+		const PackIndex &index = indices[i];
+		const uint8_t *entries = index.entries.ptr();
+
+		int lo = 0;
+		int hi = index.count;
+		while (lo < hi) {
+
+			int mid = (lo + hi) >> 1;
+			const uint8_t *entry = &entries[mid * PACK_INDEX_ENTRY_SIZE];
+			int cmp = memcmp(entry, p_md5, 16);
+
+			if (cmp < 0) {
+				lo = mid + 1;
+			} else if (cmp > 0) {
+				hi = mid;
+			} else {
+
+				r_file->pack = index.pack;
+				r_file->offset = index.base + decode_uint64(&entry[16]);
+				r_file->size = decode_uint64(&entry[24]);
+				r_file->compression = decode_uint32(&entry[32]);
+				copymem(r_file->md5, &entry[44], 16);
+				r_file->src = index.src;
+				r_file->layer = i + 1;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+PackedData::PackedDir *PackedData::_get_root() {
+
+	if (indices_in_dirs == indices.size())
+		return root;
+
+	//directory listings are rare, so the names are only read the first time one is needed
+	GLOBAL_LOCK_FUNCTION
+
+	//another thread may have added them while this one waited for the lock
+	if (indices_in_dirs == indices.size())
+		return root;
+
+	for (int idx = indices_in_dirs; idx < indices.size(); idx++) {
+
+		const PackIndex &index = indices[idx];
+
+		FileAccess *f = FileAccess::open(index.pack, FileAccess::READ);
+		ERR_CONTINUE(!f);
+
+		Vector<uint8_t> names;
+		names.resize(index.names_size);
+		f->seek(index.base + index.names_offset);
+		f->get_buffer(names.ptr(), index.names_size);
+		memdelete(f);
+
+		const uint8_t *entries = index.entries.ptr();
+		for (uint32_t i = 0; i < index.count; i++) {
+
+			const uint8_t *entry = &entries[i * PACK_INDEX_ENTRY_SIZE];
+			uint32_t name_ofs = decode_uint32(&entry[36]);
+			uint32_t name_len = decode_uint32(&entry[40]);
+			ERR_CONTINUE(uint64_t(name_ofs) + name_len > index.names_size);
+
+			String path;
+			path.parse_utf8((const char *)&names[name_ofs], name_len);
+			_add_dir_path(path);
+		}
+	}
+
+	//only published once the tree is complete, the check before the lock reads it unlocked
+	indices_in_dirs = indices.size();
+
+	return root;
 }
 
 void PackedData::add_pack_source(PackSource *p_source) {
@@ -106,8 +214,9 @@ PackedData::PackedData() {
 	root = memnew(PackedDir);
 	root->parent = NULL;
 	disabled = false;
+	indices_in_dirs = 0;
 
-	add_pack_source(memnew(PackedSourcePCK));
+	add_pack_source(PackedSourcePCK::create());
 }
 
 void PackedData::_free_packed_dirs(PackedDir *p_dir) {
@@ -127,6 +236,16 @@ PackedData::~PackedData() {
 
 //////////////////////////////////////////////////////////////////
 
+PackedSourcePCK *(*PackedSourcePCK::create_func)() = NULL;
+
+PackedSourcePCK *PackedSourcePCK::create() {
+
+	if (create_func)
+		return create_func();
+
+	return memnew(PackedSourcePCK);
+}
+
 bool PackedSourcePCK::try_open_pack(const String &p_path) {
 
 	FileAccess *f = FileAccess::open(p_path, FileAccess::READ);
@@ -160,6 +279,7 @@ bool PackedSourcePCK::try_open_pack(const String &p_path) {
 		}
 	}
 
+	uint64_t pack_base = f->get_pos() - 4;
 	uint32_t version = f->get_32();
 	uint32_t ver_major = f->get_32();
 	uint32_t ver_minor = f->get_32();
@@ -175,6 +295,35 @@ bool PackedSourcePCK::try_open_pack(const String &p_path) {
 		f->get_32();
 	}
 
+	if (version >= 1) {
+
+		uint32_t count = f->get_32();
+		uint64_t index_offset = f->get_64();
+		uint64_t names_offset = f->get_64();
+		uint32_t names_size = f->get_32();
+
+		//the index has to fit in the pack, so a corrupt count can't ask for a huge (or wrapped) allocation
+		uint64_t index_size = uint64_t(count) * PackedData::PACK_INDEX_ENTRY_SIZE;
+		uint64_t len = f->get_len();
+		if (pack_base + index_offset > len || index_size > len - (pack_base + index_offset) || index_size > 0x7FFFFFFF) {
+			memdelete(f);
+			ERR_EXPLAIN("Corrupt pack index: " + p_path);
+			ERR_FAIL_V(false);
+		}
+
+		//one read for the whole index, nothing is expanded until looked up
+		Vector<uint8_t> entries;
+		entries.resize(index_size);
+		f->seek(pack_base + index_offset);
+		int read = f->get_buffer(entries.ptr(), entries.size());
+		memdelete(f);
+
+		ERR_FAIL_COND_V(read != entries.size(), false);
+
+		PackedData::get_singleton()->add_pack_index(p_path, pack_base, count, entries, names_offset, names_size, this);
+		return true;
+	}
+
 	int file_count = f->get_32();
 
 	for (int i = 0; i < file_count; i++) {
@@ -195,12 +344,34 @@ bool PackedSourcePCK::try_open_pack(const String &p_path) {
 		PackedData::get_singleton()->add_path(p_path, path, ofs, size, md5, this);
 	};
 
+	memdelete(f);
+
 	return true;
 };
 
+FileAccess *PackedSourcePCK::_open_compressed(FileAccess *p_raw, const PackedData::PackedFile *p_file) {
+
+	if (p_file->compression == PackedData::PACK_COMPRESSION_NONE)
+		return p_raw;
+
+	uint8_t magic[4];
+	p_raw->get_buffer(magic, 4);
+	if (magic[0] != 'G' || magic[1] != 'C' || magic[2] != 'P' || magic[3] != 'F') {
+		memdelete(p_raw);
+		ERR_EXPLAIN("Corrupt compressed file in pack: " + p_file->pack);
+		ERR_FAIL_V(NULL);
+	}
+
+	FileAccessCompressed *fac = memnew(FileAccessCompressed);
+	fac->configure("GCPF", Compression::Mode(p_file->compression - 1));
+	fac->open_after_magic(p_raw);
+
+	return fac;
+}
+
 FileAccess *PackedSourcePCK::get_file(const String &p_path, PackedData::PackedFile *p_file) {
 
-	return memnew(FileAccessPack(p_path, *p_file));
+	return _open_compressed(memnew(FileAccessPack(p_path, *p_file)), p_file);
 };
 
 //////////////////////////////////////////////////////////////////
@@ -213,11 +384,15 @@ Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
 
 void FileAccessPack::close() {
 
-	f->close();
+	if (f)
+		f->close();
 }
 
 bool FileAccessPack::is_open() const {
 
+	if (mapped)
+		return true;
+
 	return f->is_open();
 }
 
@@ -229,7 +404,8 @@ void FileAccessPack::seek(size_t p_position) {
 		eof = false;
 	}
 
-	f->seek(pf.offset + p_position);
+	if (f)
+		f->seek(pf.offset + p_position);
 	pos = p_position;
 }
 void FileAccessPack::seek_end(int64_t p_position) {
@@ -257,6 +433,9 @@ uint8_t FileAccessPack::get_8() const {
 		return 0;
 	}
 
+	if (mapped)
+		return mapped[pos++];
+
 	pos++;
 	return f->get_8();
 }
@@ -272,18 +451,35 @@ int FileAccessPack::get_buffer(uint8_t *p_dst, int p_length) const {
 		to_read = int64_t(pf.size) - int64_t(pos);
 	}
 
+	size_t from = pos;
 	pos += p_length;
 
 	if (to_read <= 0)
 		return 0;
-	f->get_buffer(p_dst, to_read);
+
+	if (mapped)
+		copymem(p_dst, &mapped[from], to_read);
+	else
+		f->get_buffer(p_dst, to_read);
 
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::get_direct_buffer(int p_length) const {
+
+	if (!mapped || eof || p_length < 0 || pos + p_length > pf.size)
+		return NULL;
+
+	const uint8_t *ptr = &mapped[pos];
+	pos += p_length;
+
+	return ptr;
+}
+
 void FileAccessPack::set_endian_swap(bool p_swap) {
 	FileAccess::set_endian_swap(p_swap);
-	f->set_endian_swap(p_swap);
+	if (f)
+		f->set_endian_swap(p_swap);
 }
 
 Error FileAccessPack::get_error() const {
@@ -308,17 +504,25 @@ bool FileAccessPack::file_exists(const String &p_name) {
 	return false;
 }
 
-FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file) {
+FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_mapped) {
 
 	pf = p_file;
+	pos = 0;
+	eof = false;
+	mapped = p_mapped;
+
+	if (mapped) {
+		//reads are served straight from memory, no handle needed
+		f = NULL;
+		return;
+	}
+
 	f = FileAccess::open(pf.pack, FileAccess::READ);
 	if (!f) {
 		ERR_EXPLAIN("Can't open pack-referenced file: " + String(pf.pack));
 		ERR_FAIL_COND(!f);
 	}
 	f->seek(pf.offset);
-	pos = 0;
-	eof = false;
 }
 
 FileAccessPack::~FileAccessPack() {
@@ -410,7 +614,7 @@ Error DirAccessPack::change_dir(String p_dir) {
 	PackedData::PackedDir *pd;
 
 	if (absolute)
-		pd = PackedData::get_singleton()->root;
+		pd = PackedData::get_singleton()->_get_root();
 	else
 		pd = current;
 
@@ -482,7 +686,7 @@ size_t DirAccessPack::get_space_left() {
 
 DirAccessPack::DirAccessPack() {
 
-	current = PackedData::get_singleton()->root;
+	current = PackedData::get_singleton()->_get_root();
 	cdir = false;
 }
 
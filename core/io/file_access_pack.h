@@ -51,6 +51,14 @@ public:
 		uint64_t size;
 		uint8_t md5[16];
 		PackSource *src;
+		uint32_t compression; //PACK_COMPRESSION_*
+		int layer; //indexed packs added before this file, the ones added after it override it
+	};
+
+	enum {
+		//pack version 1: files may be compressed, the directory is a sorted index
+		PACK_INDEX_ENTRY_SIZE = 64,
+		PACK_COMPRESSION_NONE = 0, //else Compression::Mode + 1, stored as a FileAccessCompressed stream
 	};
 
 private:
@@ -89,6 +97,22 @@ private:
 
 	Map<PathMD5, PackedFile> files;
 
+	//version 1 packs are not expanded into the map and the dir tree, lookups
+	//binary search their index (sorted by path md5) instead
+	struct PackIndex {
+
+		String pack;
+		PackSource *src;
+		uint64_t base;
+		uint32_t count;
+		Vector<uint8_t> entries;
+		uint64_t names_offset;
+		uint32_t names_size;
+	};
+
+	Vector<PackIndex> indices;
+	int indices_in_dirs; //indices whose paths were already added to the dir tree
+
 	Vector<PackSource *> sources;
 
 	PackedDir *root;
@@ -98,10 +122,14 @@ private:
 	bool disabled;
 
 	void _free_packed_dirs(PackedDir *p_dir);
+	void _add_dir_path(const String &p_path);
+	bool _find_indexed(const uint8_t *p_md5, int p_from, PackedFile *r_file) const;
+	PackedDir *_get_root(); //adds the paths of the indexed packs to the tree first, if needed
 
 public:
 	void add_pack_source(PackSource *p_source);
 	void add_path(const String &pkg_path, const String &path, uint64_t ofs, uint64_t size, const uint8_t *p_md5, PackSource *p_src); // for PackSource
+	void add_pack_index(const String &p_pack, uint64_t p_base, uint32_t p_count, const Vector<uint8_t> &p_entries, uint64_t p_names_offset, uint32_t p_names_size, PackSource *p_src); // for PackSource
 
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled() const { return disabled; }
@@ -126,7 +154,14 @@ public:
 
 class PackedSourcePCK : public PackSource {
 
+protected:
+	static PackedSourcePCK *(*create_func)();
+
+	static FileAccess *_open_compressed(FileAccess *p_raw, const PackedData::PackedFile *p_file); //takes over p_raw
+
 public:
+	static PackedSourcePCK *create(); ///< platform default, may read the pack through a memory mapping
+
 	virtual bool try_open_pack(const String &p_path);
 	virtual FileAccess *get_file(const String &p_path, PackedData::PackedFile *p_file);
 };
@@ -139,6 +174,7 @@ class FileAccessPack : public FileAccess {
 	mutable bool eof;
 
 	FileAccess *f;
+	const uint8_t *mapped; //start of the file when the pack is mapped in memory, f is NULL then
 	virtual Error _open(const String &p_path, int p_mode_flags);
 	virtual uint64_t _get_modified_time(const String &p_file) { return 0; }
 
@@ -156,6 +192,7 @@ public:
 	virtual uint8_t get_8() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const;
+	virtual const uint8_t *get_direct_buffer(int p_length) const;
 
 	virtual void set_endian_swap(bool p_swap);
 
@@ -167,15 +204,23 @@ public:
 
 	virtual bool file_exists(const String &p_name);
 
-	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file);
+	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const uint8_t *p_mapped = NULL);
 	~FileAccessPack();
 };
 
 FileAccess *PackedData::try_open_path(const String &p_path) {
 
 	//print_line("try open path " + p_path);
-	PathMD5 pmd5(p_path.md5_buffer());
-	Map<PathMD5, PackedFile>::Element *E = files.find(pmd5);
+	Vector<uint8_t> md5 = p_path.md5_buffer();
+	Map<PathMD5, PackedFile>::Element *E = files.find(PathMD5(md5));
+
+	int layer = E ? E->get().layer : 0;
+	if (indices.size() > layer) {
+		PackedFile pf;
+		if (_find_indexed(md5.ptr(), layer, &pf))
+			return pf.src->get_file(p_path, &pf);
+	}
+
 	if (!E)
 		return NULL; //not found
 	if (E->get().offset == 0)
@@ -186,7 +231,12 @@ FileAccess *PackedData::try_open_path(const String &p_path) {
 
 bool PackedData::has_path(const String &p_path) {
 
-	return files.has(PathMD5(p_path.md5_buffer()));
+	Vector<uint8_t> md5 = p_path.md5_buffer();
+	if (files.has(PathMD5(md5)))
+		return true;
+
+	PackedFile pf;
+	return indices.size() && _find_indexed(md5.ptr(), 0, &pf);
 }
 
 class DirAccessPack : public DirAccess {
@@ -26,10 +26,14 @@
 /* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
 /* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
-/*************************************************************************/
 #include "pck_packer.h"
 
+#include "core/io/compression.h"
+#include "core/io/file_access_memory.h"
+#include "core/io/file_access_pack.h"
 #include "core/os/file_access.h"
+#include "core/version.h"
+#include "thirdparty/misc/md5.h"
 
 static uint64_t _align(uint64_t p_n, int p_alignment) {
 
@@ -51,60 +55,215 @@ static void _pad(FileAccess *p_file, int p_bytes) {
 	};
 };
 
+bool PCKPacker::File::operator<(const File &p_file) const {
+
+	return memcmp(path_md5, p_file.path_md5, 16) < 0;
+}
+
 void PCKPacker::_bind_methods() {
 
 	ObjectTypeDB::bind_method(_MD("pck_start", "pck_name", "alignment"), &PCKPacker::pck_start);
+	ObjectTypeDB::bind_method(_MD("set_compression", "mode"), &PCKPacker::set_compression);
+	ObjectTypeDB::bind_method(_MD("get_compression"), &PCKPacker::get_compression);
 	ObjectTypeDB::bind_method(_MD("add_file", "pck_path", "source_path"), &PCKPacker::add_file);
+	ObjectTypeDB::bind_method(_MD("add_buffer", "pck_path", "data"), &PCKPacker::add_buffer);
 	ObjectTypeDB::bind_method(_MD("flush", "verbose"), &PCKPacker::flush);
+
+	BIND_CONSTANT(COMPRESSION_NONE);
+	BIND_CONSTANT(COMPRESSION_FASTLZ);
+	BIND_CONSTANT(COMPRESSION_DEFLATE);
+	BIND_CONSTANT(COMPRESSION_ZSTD);
 };
 
+Error PCKPacker::_start() {
+
+	pack_base = file->get_pos();
+
+	file->store_32(0x43504447); // MAGIC
+	file->store_32(1); // # version
+	file->store_32(VERSION_MAJOR); // # major
+	file->store_32(VERSION_MINOR); // # minor
+	file->store_32(0); // # revision
+
+	for (int i = 0; i < 16; i++) {
+
+		file->store_32(0); // reserved
+	};
+
+	// index location, filled in by flush()
+	file->store_32(0); // file count
+	file->store_64(0); // index offset
+	file->store_64(0); // names offset
+	file->store_32(0); // names size
+
+	files.clear();
+
+	return OK;
+}
+
 Error PCKPacker::pck_start(const String &p_file, int p_alignment) {
 
+	ERR_FAIL_COND_V(file != NULL, ERR_ALREADY_IN_USE);
+
 	file = FileAccess::open(p_file, FileAccess::WRITE);
 	if (file == NULL) {
 
 		return ERR_CANT_CREATE;
 	};
 
+	owns_file = true;
 	alignment = p_alignment;
 
-	file->store_32(0x43504447); // MAGIC
-	file->store_32(0); // # version
-	file->store_32(0); // # major
-	file->store_32(0); // # minor
-	file->store_32(0); // # revision
+	return _start();
+};
 
-	for (int i = 0; i < 16; i++) {
+Error PCKPacker::pck_start_at(FileAccess *p_file, int p_alignment) {
 
-		file->store_32(0); // reserved
-	};
+	ERR_FAIL_COND_V(file != NULL, ERR_ALREADY_IN_USE);
+	ERR_FAIL_COND_V(!p_file, ERR_INVALID_PARAMETER);
 
-	files.clear();
+	file = p_file;
+	owns_file = false;
+	alignment = p_alignment;
+
+	return _start();
+}
+
+void PCKPacker::set_compression(CompressionMode p_mode) {
+
+	compression = p_mode;
+}
+
+PCKPacker::CompressionMode PCKPacker::get_compression() const {
+
+	return compression;
+}
+
+Error PCKPacker::_store(const String &p_path, FileAccess *p_src) {
+
+	File pf;
+	pf.path = p_path;
+	Vector<uint8_t> path_md5 = p_path.md5_buffer();
+	copymem(pf.path_md5, path_md5.ptr(), 16);
+
+	uint64_t ofs = _align(file->get_pos() - pack_base, alignment);
+	_pad(file, ofs - (file->get_pos() - pack_base));
+	pf.offset = ofs;
+
+	uint64_t size = p_src->get_len();
+	pf.compression = PackedData::PACK_COMPRESSION_NONE;
+
+	MD5_CTX md5;
+	MD5Init(&md5);
+
+	Vector<uint8_t> buf;
+	buf.resize(COMPRESSION_BLOCK_SIZE);
+
+	// FileAccessCompressed offsets are 32 bits
+	if (compression != COMPRESSION_NONE && size < 0x7FFFFFFF) {
+
+		// same layout FileAccessCompressed writes, so it can read the file back in blocks
+		Compression::Mode mode = Compression::Mode(compression - 1);
+		int block_count = (size / COMPRESSION_BLOCK_SIZE) + 1;
+
+		Vector<uint8_t> cbuf;
+		cbuf.resize(Compression::get_max_compressed_buffer_size(COMPRESSION_BLOCK_SIZE, mode));
+
+		Vector<uint32_t> block_sizes;
+		Vector<uint8_t> blocks;
+		uint64_t csize = 16 + block_count * 4 + 4;
+
+		for (int i = 0; i < block_count && csize < size; i++) {
+
+			int bl = i == (block_count - 1) ? size % COMPRESSION_BLOCK_SIZE : COMPRESSION_BLOCK_SIZE;
+			p_src->get_buffer(buf.ptr(), bl);
+			MD5Update(&md5, buf.ptr(), bl);
+
+			int s = Compression::compress(cbuf.ptr(), buf.ptr(), bl, mode);
+			ERR_FAIL_COND_V(s < 0, ERR_BUG);
+
+			int at = blocks.size();
+			blocks.resize(at + s);
+			copymem(&blocks[at], cbuf.ptr(), s);
+			block_sizes.push_back(s);
+			csize += s;
+		}
+
+		if (csize < size) {
+
+			file->store_buffer((const uint8_t *)"GCPF", 4);
+			file->store_32(mode);
+			file->store_32(COMPRESSION_BLOCK_SIZE);
+			file->store_32(size);
+			for (int i = 0; i < block_sizes.size(); i++) {
+				file->store_32(block_sizes[i]);
+			}
+			file->store_buffer(blocks.ptr(), blocks.size());
+			file->store_buffer((const uint8_t *)"GCPF", 4);
+
+			pf.compression = compression;
+			pf.size = csize;
+		} else {
+
+			// doesn't compress, store it as is
+			p_src->seek(0);
+			MD5Init(&md5);
+		}
+	}
+
+	if (pf.compression == PackedData::PACK_COMPRESSION_NONE) {
+
+		uint64_t to_write = size;
+		while (to_write > 0) {
+
+			int read = p_src->get_buffer(buf.ptr(), MIN(to_write, uint64_t(COMPRESSION_BLOCK_SIZE)));
+			ERR_FAIL_COND_V(read <= 0, ERR_FILE_CANT_READ);
+			MD5Update(&md5, buf.ptr(), read);
+			file->store_buffer(buf.ptr(), read);
+			to_write -= read;
+		};
+
+		pf.size = size;
+	}
+
+	MD5Final(&md5);
+	copymem(pf.md5, md5.digest, 16);
+
+	files.push_back(pf);
 
 	return OK;
-};
+}
 
 Error PCKPacker::add_file(const String &p_file, const String &p_src) {
 
+	ERR_FAIL_COND_V(!file, ERR_UNCONFIGURED);
+
 	FileAccess *f = FileAccess::open(p_src, FileAccess::READ);
 	if (!f) {
 		return ERR_FILE_CANT_OPEN;
 	};
 
-	File pf;
-	pf.path = p_file;
-	pf.src_path = p_src;
-	pf.size = f->get_len();
-	pf.offset_offset = 0;
-
-	files.push_back(pf);
+	Error err = _store(p_file, f);
 
 	f->close();
 	memdelete(f);
 
-	return OK;
+	return err;
 };
 
+Error PCKPacker::add_buffer(const String &p_file, const Vector<uint8_t> &p_data) {
+
+	ERR_FAIL_COND_V(!file, ERR_UNCONFIGURED);
+
+	// FileAccessMemory refuses a NULL buffer, which is what an empty vector has
+	static const uint8_t empty = 0;
+
+	FileAccessMemory f;
+	f.open_custom(p_data.size() ? p_data.ptr() : &empty, p_data.size());
+
+	return _store(p_file, &f);
+}
+
 Error PCKPacker::flush(bool p_verbose) {
 
 	if (!file) {
@@ -112,68 +271,61 @@ Error PCKPacker::flush(bool p_verbose) {
 		return ERR_INVALID_PARAMETER;
 	};
 
-	// write the index
+	// the index is sorted by path md5, so it can be binary searched as it is
+	files.sort();
 
-	file->store_32(files.size());
+	uint64_t names_ofs = file->get_pos() - pack_base;
+	Vector<uint32_t> name_offsets;
+	Vector<uint32_t> name_lengths;
+	uint32_t names_size = 0;
 
 	for (int i = 0; i < files.size(); i++) {
 
-		file->store_pascal_string(files[i].path);
-		files[i].offset_offset = file->get_pos();
-		file->store_64(0); // offset
-		file->store_64(files[i].size); // size
-
-		// # empty md5
-		file->store_32(0);
-		file->store_32(0);
-		file->store_32(0);
-		file->store_32(0);
-	};
-
-	uint64_t ofs = file->get_pos();
-	ofs = _align(ofs, alignment);
+		CharString cs = files[i].path.utf8();
+		file->store_buffer((const uint8_t *)cs.get_data(), cs.length());
+		name_offsets.push_back(names_size);
+		name_lengths.push_back(cs.length());
+		names_size += cs.length();
+	}
 
-	_pad(file, ofs - file->get_pos());
+	uint64_t index_ofs = _align(file->get_pos() - pack_base, 8);
+	_pad(file, index_ofs - (file->get_pos() - pack_base));
 
-	const uint32_t buf_max = 65536;
-	uint8_t *buf = memnew_arr(uint8_t, buf_max);
-
-	int count = 0;
 	for (int i = 0; i < files.size(); i++) {
 
-		FileAccess *src = FileAccess::open(files[i].src_path, FileAccess::READ);
-		uint64_t to_write = files[i].size;
-		while (to_write > 0) {
-
-			int read = src->get_buffer(buf, MIN(to_write, buf_max));
-			file->store_buffer(buf, read);
-			to_write -= read;
-		};
+		const File &pf = files[i];
+		file->store_buffer(pf.path_md5, 16);
+		file->store_64(pf.offset);
+		file->store_64(pf.size);
+		file->store_32(pf.compression);
+		file->store_32(name_offsets[i]);
+		file->store_32(name_lengths[i]);
+		file->store_buffer(pf.md5, 16);
+		file->store_32(0); // reserved
 
-		uint64_t pos = file->get_pos();
-		file->seek(files[i].offset_offset); // go back to store the file's offset
-		file->store_64(ofs);
-		file->seek(pos);
-
-		ofs = _align(ofs + files[i].size, alignment);
-		_pad(file, ofs - pos);
-
-		src->close();
-		memdelete(src);
-		count += 1;
-		if (p_verbose) {
-			if (count % 100 == 0) {
-				printf("%i/%i (%.2f)\r", count, files.size(), float(count) / files.size() * 100);
-				fflush(stdout);
-			};
+		if (p_verbose && (i + 1) % 100 == 0) {
+			printf("%i/%i (%.2f)\r", i + 1, files.size(), float(i + 1) / files.size() * 100);
+			fflush(stdout);
 		};
 	};
 
 	if (p_verbose)
 		printf("\n");
 
-	file->close();
-	memdelete(buf);
+	uint64_t end = file->get_pos();
+	file->seek(pack_base + 21 * 4);
+	file->store_32(files.size());
+	file->store_64(index_ofs);
+	file->store_64(names_ofs);
+	file->store_32(names_size);
+	file->seek(end);
+
+	if (owns_file) {
+		file->close();
+		memdelete(file);
+	}
+	file = NULL;
+	files.clear();
 
 	return OK;
 };
@@ -181,10 +333,14 @@ Error PCKPacker::flush(bool p_verbose) {
 PCKPacker::PCKPacker() {
 
 	file = NULL;
+	owns_file = false;
+	pack_base = 0;
+	alignment = 0;
+	compression = COMPRESSION_NONE;
 };
 
 PCKPacker::~PCKPacker() {
-	if (file != NULL) {
+	if (file != NULL && owns_file) {
 		memdelete(file);
 	};
 	file = NULL;
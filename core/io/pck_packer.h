@@ -27,6 +27,9 @@
 /* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
 /*************************************************************************/
+#ifndef PCK_PACKER_H
+#define PCK_PACKER_H
+
 #include "core/reference.h"
 
 class FileAccess;
@@ -35,25 +38,56 @@ class PCKPacker : public Reference {
 
 	OBJ_TYPE(PCKPacker, Reference);
 
+public:
+	enum CompressionMode {
+		COMPRESSION_NONE,
+		COMPRESSION_FASTLZ,
+		COMPRESSION_DEFLATE,
+		COMPRESSION_ZSTD,
+	};
+
+private:
+	enum {
+		COMPRESSION_BLOCK_SIZE = 16384
+	};
+
 	FileAccess *file;
+	bool owns_file;
+	uint64_t pack_base;
 	int alignment;
+	CompressionMode compression;
 
 	static void _bind_methods();
 
 	struct File {
 
 		String path;
-		String src_path;
-		int size;
-		uint64_t offset_offset;
+		uint8_t path_md5[16];
+		uint64_t offset;
+		uint64_t size;
+		uint32_t compression;
+		uint8_t md5[16];
+
+		bool operator<(const File &p_file) const;
 	};
 	Vector<File> files;
 
+	Error _start();
+	Error _store(const String &p_path, FileAccess *p_src);
+
 public:
 	Error pck_start(const String &p_file, int p_alignment);
+	Error pck_start_at(FileAccess *p_file, int p_alignment); ///< writes from the current position on, p_file is not closed
+	void set_compression(CompressionMode p_mode);
+	CompressionMode get_compression() const;
 	Error add_file(const String &p_file, const String &p_src);
+	Error add_buffer(const String &p_file, const Vector<uint8_t> &p_data);
 	Error flush(bool p_verbose = false);
 
 	PCKPacker();
 	~PCKPacker();
 };
+
+VARIANT_ENUM_CAST(PCKPacker::CompressionMode);
+
+#endif // PCK_PACKER_H
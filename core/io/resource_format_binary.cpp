@@ -105,6 +105,14 @@ enum {
 
 };
 
+static Compression::Mode _get_compression_mode() {
+
+	//files compressed in any mode can be read back, the mode is stored with them
+	int mode = GLOBAL_DEF("compression/binary_resource_mode", Compression::MODE_FASTLZ);
+	ERR_FAIL_INDEX_V(mode, Compression::MODE_ZSTD + 1, Compression::MODE_FASTLZ);
+	return Compression::Mode(mode);
+}
+
 void ResourceInteractiveLoaderBinary::_advance_padding(uint32_t p_len) {
 
 	uint32_t extra = 4 - (p_len % 4);
@@ -877,11 +885,20 @@ static String get_ustring(FileAccess *f) {
 String ResourceInteractiveLoaderBinary::get_unicode_string() {
 
 	int len = f->get_32();
+	if (len == 0)
+		return String();
+
+	//mapped packs can be parsed in place
+	const char *direct = (const char *)f->get_direct_buffer(len);
+	if (direct) {
+		String s;
+		s.parse_utf8(direct, len);
+		return s;
+	}
+
 	if (len > str_buf.size()) {
 		str_buf.resize(len);
 	}
-	if (len == 0)
-		return String();
 	f->get_buffer((uint8_t *)&str_buf[0], len);
 	String s;
 	s.parse_utf8(&str_buf[0]);
@@ -1302,7 +1319,7 @@ Error ResourceFormatLoaderBinary::rename_dependencies(const String &p_path, cons
 		f = fac;
 
 		FileAccessCompressed *facw = memnew(FileAccessCompressed);
-		facw->configure("RSCC");
+		facw->configure("RSCC", _get_compression_mode());
 		Error err = facw->_open(p_path + ".depren", FileAccess::WRITE);
 		if (err) {
 			memdelete(fac);
@@ -2095,7 +2112,7 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const RES &p
 	Error err;
 	if (p_flags & ResourceSaver::FLAG_COMPRESS) {
 		FileAccessCompressed *fac = memnew(FileAccessCompressed);
-		fac->configure("RSCC");
+		fac->configure("RSCC", _get_compression_mode());
 		f = fac;
 		err = fac->_open(p_path, FileAccess::WRITE);
 		if (err)
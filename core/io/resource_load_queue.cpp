@@ -0,0 +1,487 @@
+/*************************************************************************/
+/*  resource_load_queue.cpp                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "resource_load_queue.h"
+#include "globals.h"
+#include "io/resource_loader.h"
+#include "os/os.h"
+#include "print_string.h"
+
+ResourceLoadQueue *ResourceLoadQueue::singleton = NULL;
+
+String ResourceLoadQueue::_localize(const String &p_path) const {
+
+	if (p_path.is_rel_path())
+		return "res://" + p_path;
+
+	return Globals::get_singleton()->localize_path(p_path);
+}
+
+void ResourceLoadQueue::_start() {
+
+	if (started)
+		return;
+
+	started = true;
+
+	// 0 runs the loads on whichever thread polls or waits for them
+	int count = thread_count;
+	if (count < 0) {
+		count = GLOBAL_DEF("core/resource_load_thread_count", 2);
+		Globals::get_singleton()->set_custom_property_info("core/resource_load_thread_count", PropertyInfo(Variant::INT, "core/resource_load_thread_count", PROPERTY_HINT_RANGE, "0,16,1"));
+	}
+
+	if (!OS::get_singleton()->can_use_threads())
+		count = 0;
+
+	for (int i = 0; i < count; i++) {
+		threads.push_back(Thread::create(_thread_func, this));
+	}
+}
+
+ResourceLoadQueue::Task *ResourceLoadQueue::_create_task(const String &p_path, const String &p_type_hint) {
+
+	Task *task = memnew(Task);
+	task->path = p_path;
+	task->type_hint = p_type_hint;
+	task->status = STATUS_QUEUED;
+	task->error = OK;
+	task->discovered = false;
+	task->pending_dependencies = 0;
+	task->requests = 0;
+	task->refs = 0;
+	task->waiters = 0;
+	task->done = NULL;
+	task->queued_usec = OS::get_singleton()->get_ticks_usec();
+	task->start_usec = 0;
+	task->load_usec = 0;
+
+	tasks[p_path] = task;
+	stats.pending++;
+
+	return task;
+}
+
+void ResourceLoadQueue::_push_ready(Task *p_task) {
+
+	ready.push_back(p_task);
+	if (threads.size())
+		work_semaphore->post();
+}
+
+bool ResourceLoadQueue::_depends_on(Task *p_task, Task *p_dependency) const {
+
+	if (p_task == p_dependency)
+		return true;
+
+	for (int i = 0; i < p_task->dependencies.size(); i++) {
+		if (_depends_on(p_task->dependencies[i], p_dependency))
+			return true;
+	}
+
+	return false;
+}
+
+void ResourceLoadQueue::_free_if_unused(Task *p_task) {
+
+	if (p_task->refs > 0 || (p_task->status != STATUS_LOADED && p_task->status != STATUS_FAILED))
+		return;
+
+	tasks.erase(p_task->path);
+	if (p_task->done)
+		memdelete(p_task->done);
+	memdelete(p_task);
+}
+
+void ResourceLoadQueue::_unref(Task *p_task) {
+
+	p_task->refs--;
+	_free_if_unused(p_task);
+}
+
+Error ResourceLoadQueue::_wait(Task *p_task) {
+
+	while (p_task->status != STATUS_LOADED && p_task->status != STATUS_FAILED) {
+
+		if (threads.size() == 0) {
+			if (_process_one())
+				continue;
+
+			//only happens when waiting from inside the load of the task itself
+			ERR_EXPLAIN("Can't wait for a resource that is being loaded on the same thread: " + p_task->path);
+			ERR_FAIL_V(ERR_BUSY);
+		}
+
+		if (!p_task->done)
+			p_task->done = Semaphore::create();
+		p_task->waiters++;
+
+		mutex->unlock();
+		p_task->done->wait();
+		mutex->lock();
+	}
+
+	return p_task->error;
+}
+
+void ResourceLoadQueue::_discover(Task *p_task) {
+
+	p_task->start_usec = OS::get_singleton()->get_ticks_usec();
+	stats.total_wait_usec += p_task->start_usec - p_task->queued_usec;
+
+	// reading the dependency list means opening the file, so do it unlocked
+	mutex->unlock();
+	List<String> dependencies;
+	if (!ResourceCache::has(p_task->path))
+		ResourceLoader::get_dependencies(p_task->path, &dependencies, true);
+	mutex->lock();
+
+	p_task->discovered = true;
+
+	for (List<String>::Element *E = dependencies.front(); E; E = E->next()) {
+
+		String path = E->get();
+		String type_hint;
+		int sep = path.find("::");
+		if (sep != -1) {
+			type_hint = path.substr(sep + 2, path.length());
+			path = path.substr(0, sep);
+		}
+
+		path = _localize(path);
+		if (path == p_task->path || ResourceCache::has(path))
+			continue;
+
+		Task *dependency;
+		Task **existing = tasks.getptr(path);
+		if (existing) {
+
+			dependency = *existing;
+			if (dependency->status == STATUS_LOADED || dependency->status == STATUS_FAILED)
+				continue;
+			// a cycle would never finish, let the loader resolve it synchronously instead
+			if (_depends_on(dependency, p_task) || p_task->dependencies.find(dependency) != -1)
+				continue;
+		} else {
+
+			dependency = _create_task(path, type_hint);
+			stats.dependencies++;
+			_push_ready(dependency);
+		}
+
+		dependency->dependents.push_back(p_task);
+		dependency->refs++;
+		p_task->dependencies.push_back(dependency);
+		p_task->pending_dependencies++;
+	}
+
+	if (p_task->pending_dependencies == 0)
+		_load(p_task);
+}
+
+void ResourceLoadQueue::_load(Task *p_task) {
+
+	p_task->status = STATUS_LOADING;
+
+	mutex->unlock();
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	Error err = OK;
+	RES resource = ResourceLoader::load(p_task->path, p_task->type_hint, false, &err);
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+	mutex->lock();
+
+	p_task->resource = resource;
+	p_task->load_usec = elapsed;
+	p_task->status = resource.is_valid() ? STATUS_LOADED : STATUS_FAILED;
+	p_task->error = resource.is_valid() ? OK : (err != OK ? err : ERR_CANT_OPEN);
+
+	stats.pending--;
+	if (resource.is_valid())
+		stats.loaded++;
+	else
+		stats.failed++;
+	stats.total_load_usec += elapsed;
+	if (elapsed > stats.max_load_usec)
+		stats.max_load_usec = elapsed;
+
+	if (OS::get_singleton()->is_stdout_verbose())
+		print_line("threaded load: " + p_task->path + " (" + rtos(elapsed / 1000.0) + " msec)");
+
+	for (int i = 0; i < p_task->dependents.size(); i++) {
+
+		Task *dependent = p_task->dependents[i];
+		dependent->pending_dependencies--;
+		if (dependent->pending_dependencies == 0)
+			_push_ready(dependent);
+	}
+	p_task->dependents.clear();
+
+	// dependencies were only kept alive so the loader above found them cached
+	for (int i = 0; i < p_task->dependencies.size(); i++) {
+		_unref(p_task->dependencies[i]);
+	}
+	p_task->dependencies.clear();
+
+	for (int i = 0; i < p_task->waiters; i++) {
+		p_task->done->post();
+	}
+	p_task->waiters = 0;
+
+	_free_if_unused(p_task);
+}
+
+bool ResourceLoadQueue::_process_one() {
+
+	if (ready.empty())
+		return false;
+
+	Task *task = ready.front()->get();
+	ready.pop_front();
+
+	if (!task->discovered)
+		_discover(task);
+	else
+		_load(task);
+
+	return true;
+}
+
+void ResourceLoadQueue::_thread_func(void *p_self) {
+
+	ResourceLoadQueue *self = (ResourceLoadQueue *)p_self;
+
+	while (true) {
+
+		self->work_semaphore->wait();
+
+		self->mutex->lock();
+		if (self->exit) {
+			self->mutex->unlock();
+			break;
+		}
+		self->_process_one();
+		self->mutex->unlock();
+	}
+}
+
+Error ResourceLoadQueue::request(const String &p_path, const String &p_type_hint) {
+
+	String local_path = _localize(p_path);
+
+	MutexLock lock(mutex);
+
+	ERR_FAIL_COND_V(exit, ERR_UNAVAILABLE);
+	_start();
+
+	Task **existing = tasks.getptr(local_path);
+	if (existing) {
+		Task *task = *existing;
+		if (task->requests == 0)
+			stats.requested++;
+		task->requests++;
+		task->refs++;
+		return OK;
+	}
+
+	Task *task = _create_task(local_path, p_type_hint);
+	task->requests = 1;
+	task->refs = 1;
+	stats.requested++;
+	_push_ready(task);
+
+	return OK;
+}
+
+ResourceLoadQueue::Status ResourceLoadQueue::get_status(const String &p_path, float *r_progress) {
+
+	String local_path = _localize(p_path);
+
+	MutexLock lock(mutex);
+
+	// without workers, polling is what moves the queue forward
+	if (threads.size() == 0)
+		_process_one();
+
+	Task **existing = tasks.getptr(local_path);
+	if (!existing) {
+		if (r_progress)
+			*r_progress = 0;
+		return STATUS_INVALID;
+	}
+
+	Task *task = *existing;
+	if (r_progress) {
+		if (task->status == STATUS_LOADED || task->status == STATUS_FAILED)
+			*r_progress = 1.0;
+		else if (!task->discovered)
+			*r_progress = 0;
+		else
+			*r_progress = float(task->dependencies.size() - task->pending_dependencies) / (task->dependencies.size() + 1);
+	}
+
+	return task->status;
+}
+
+Error ResourceLoadQueue::wait(const String &p_path) {
+
+	String local_path = _localize(p_path);
+
+	MutexLock lock(mutex);
+
+	Task **existing = tasks.getptr(local_path);
+	ERR_FAIL_COND_V(!existing, ERR_DOES_NOT_EXIST);
+
+	Task *task = *existing;
+	task->refs++;
+	Error err = _wait(task);
+	_unref(task);
+
+	return err;
+}
+
+RES ResourceLoadQueue::get(const String &p_path, Error *r_error) {
+
+	String local_path = _localize(p_path);
+
+	if (r_error)
+		*r_error = ERR_DOES_NOT_EXIST;
+
+	MutexLock lock(mutex);
+
+	Task **existing = tasks.getptr(local_path);
+	ERR_FAIL_COND_V(!existing, RES());
+
+	Task *task = *existing;
+	task->refs++;
+	Error err = _wait(task);
+	if (r_error)
+		*r_error = err;
+
+	RES resource = task->resource;
+	if (err != ERR_BUSY && task->requests > 0) {
+		task->requests--;
+		task->refs--;
+	}
+	_unref(task);
+
+	return resource;
+}
+
+uint64_t ResourceLoadQueue::get_load_time_usec(const String &p_path) {
+
+	String local_path = _localize(p_path);
+
+	MutexLock lock(mutex);
+
+	Task **existing = tasks.getptr(local_path);
+	return existing ? (*existing)->load_usec : 0;
+}
+
+ResourceLoadQueue::Stats ResourceLoadQueue::get_stats() {
+
+	MutexLock lock(mutex);
+	return stats;
+}
+
+void ResourceLoadQueue::set_thread_count(int p_count) {
+
+	MutexLock lock(mutex);
+
+	ERR_EXPLAIN("The thread count can't change once loading started");
+	ERR_FAIL_COND(started);
+	thread_count = p_count;
+}
+
+void ResourceLoadQueue::finish() {
+
+	mutex->lock();
+	exit = true;
+	mutex->unlock();
+
+	for (int i = 0; i < threads.size(); i++) {
+		work_semaphore->post();
+	}
+
+	for (int i = 0; i < threads.size(); i++) {
+		Thread::wait_to_finish(threads[i]);
+		memdelete(threads[i]);
+	}
+	threads.clear();
+
+	List<Task *> leftover;
+	const String *K = NULL;
+	while ((K = tasks.next(K))) {
+		leftover.push_back(tasks[*K]);
+	}
+
+	for (List<Task *>::Element *E = leftover.front(); E; E = E->next()) {
+		if (E->get()->done)
+			memdelete(E->get()->done);
+		memdelete(E->get());
+	}
+
+	tasks.clear();
+	ready.clear();
+}
+
+ResourceLoadQueue::ResourceLoadQueue(bool p_singleton) {
+
+	if (p_singleton)
+		singleton = this;
+
+	mutex = Mutex::create();
+	work_semaphore = Semaphore::create();
+	thread_count = -1;
+	started = false;
+	exit = false;
+
+	stats.requested = 0;
+	stats.dependencies = 0;
+	stats.loaded = 0;
+	stats.failed = 0;
+	stats.pending = 0;
+	stats.total_load_usec = 0;
+	stats.max_load_usec = 0;
+	stats.total_wait_usec = 0;
+}
+
+ResourceLoadQueue::~ResourceLoadQueue() {
+
+	finish();
+
+	if (work_semaphore)
+		memdelete(work_semaphore);
+	if (mutex)
+		memdelete(mutex);
+
+	if (singleton == this)
+		singleton = NULL;
+}
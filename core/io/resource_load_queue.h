@@ -0,0 +1,142 @@
+/*************************************************************************/
+/*  resource_load_queue.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef RESOURCE_LOAD_QUEUE_H
+#define RESOURCE_LOAD_QUEUE_H
+
+#include "hash_map.h"
+#include "os/mutex.h"
+#include "os/semaphore.h"
+#include "os/thread.h"
+#include "resource.h"
+
+/**
+ * Loads resources on worker threads. A request first reads the dependency
+ * list of the file and queues every external dependency that is not cached
+ * yet as a task of its own, so independent textures, meshes and samples load
+ * in parallel. The requested resource loads last, when all of its
+ * dependencies are in the cache.
+ *
+ * Loading from a thread has the usual restrictions: resources that create
+ * server objects need the threaded render model (or a server that is safe
+ * to call from other threads).
+ */
+
+class ResourceLoadQueue {
+public:
+	enum Status {
+		STATUS_INVALID, ///< never requested, or already retrieved
+		STATUS_QUEUED, ///< waiting for a worker or for dependencies
+		STATUS_LOADING,
+		STATUS_LOADED,
+		STATUS_FAILED,
+	};
+
+	struct Stats {
+
+		uint32_t requested; ///< explicit requests
+		uint32_t dependencies; ///< dependency tasks queued on behalf of requests
+		uint32_t loaded;
+		uint32_t failed;
+		uint32_t pending;
+		uint64_t total_load_usec;
+		uint64_t max_load_usec;
+		uint64_t total_wait_usec; ///< time spent queued before a worker picked the task
+	};
+
+private:
+	struct Task {
+
+		String path;
+		String type_hint;
+		Status status;
+		Error error;
+		RES resource;
+
+		bool discovered;
+		int pending_dependencies;
+		Vector<Task *> dependencies; //tasks this one waits for
+		Vector<Task *> dependents; //tasks waiting for this one
+
+		int requests;
+		int refs; //requests + dependents not yet loaded + waiters
+		int waiters;
+		Semaphore *done;
+
+		uint64_t queued_usec;
+		uint64_t start_usec;
+		uint64_t load_usec;
+	};
+
+	static ResourceLoadQueue *singleton;
+
+	HashMap<String, Task *> tasks;
+	List<Task *> ready;
+	Stats stats;
+
+	Mutex *mutex;
+	Semaphore *work_semaphore;
+	Vector<Thread *> threads;
+	int thread_count;
+	bool started;
+	bool exit;
+
+	void _start();
+	String _localize(const String &p_path) const;
+	Task *_create_task(const String &p_path, const String &p_type_hint);
+	void _push_ready(Task *p_task);
+	bool _depends_on(Task *p_task, Task *p_dependency) const;
+	void _free_if_unused(Task *p_task);
+	void _unref(Task *p_task);
+	Error _wait(Task *p_task);
+	void _discover(Task *p_task);
+	void _load(Task *p_task);
+	bool _process_one();
+
+	static void _thread_func(void *p_self);
+
+public:
+	static ResourceLoadQueue *get_singleton() { return singleton; }
+
+	Error request(const String &p_path, const String &p_type_hint = "");
+	Status get_status(const String &p_path, float *r_progress = NULL);
+	RES get(const String &p_path, Error *r_error = NULL); ///< waits if needed and releases the request
+	Error wait(const String &p_path);
+
+	uint64_t get_load_time_usec(const String &p_path);
+	Stats get_stats();
+
+	void set_thread_count(int p_count); ///< before the first request, -1 uses core/resource_load_thread_count
+	void finish();
+
+	ResourceLoadQueue(bool p_singleton = false);
+	~ResourceLoadQueue();
+};
+
+#endif // RESOURCE_LOAD_QUEUE_H
@@ -161,12 +161,18 @@ RES ResourceLoader::load(const String &p_path, const String &p_type_hint, bool p
 	local_path = find_complete_path(local_path, p_type_hint);
 	ERR_FAIL_COND_V(local_path == "", RES());
 
-	if (!p_no_cache && ResourceCache::has(local_path)) {
+	if (!p_no_cache) {
 
-		if (OS::get_singleton()->is_stdout_verbose())
-			print_line("load resource: " + local_path + " (cached)");
+		RES cached = ResourceCache::get_ref(local_path);
+		if (cached.is_valid()) {
+
+			if (OS::get_singleton()->is_stdout_verbose())
+				print_line("load resource: " + local_path + " (cached)");
 
-		return RES(ResourceCache::get(local_path));
+			if (r_error)
+				*r_error = OK;
+			return cached;
+		}
 	}
 
 	String remapped_path = PathRemap::get_singleton()->get_remap(local_path);
@@ -294,12 +300,12 @@ Ref<ResourceInteractiveLoader> ResourceLoader::load_interactive(const String &p_
 	local_path = find_complete_path(local_path, p_type_hint);
 	ERR_FAIL_COND_V(local_path == "", Ref<ResourceInteractiveLoader>());
 
-	if (!p_no_cache && ResourceCache::has(local_path)) {
+	Ref<Resource> res_cached = p_no_cache ? Ref<Resource>() : ResourceCache::get_ref(local_path);
+	if (res_cached.is_valid()) {
 
 		if (OS::get_singleton()->is_stdout_verbose())
 			print_line("load resource: " + local_path + " (cached)");
 
-		Ref<Resource> res_cached = ResourceCache::get(local_path);
 		Ref<ResourceInteractiveLoaderDefault> ril = Ref<ResourceInteractiveLoaderDefault>(memnew(ResourceInteractiveLoaderDefault));
 
 		ril->resource = res_cached;
@@ -34,6 +34,7 @@
 #include "list.h"
 #include "map.h"
 #include "print_string.h"
+#include "sort.h"
 #include "variant.h"
 #include "vector3.h"
 
@@ -346,7 +347,14 @@ private:
 		uint32_t mask;
 	};
 
+	struct _ElementIDSort {
+
+		_FORCE_INLINE_ bool operator()(const Element *p_a, const Element *p_b) const { return p_a->_id < p_b->_id; }
+	};
+
 	void _cull_convex(Octant *p_octant, _CullConvexData *p_cull);
+	void _cull_convex_threadsafe(const Octant *p_octant, const _CullConvexData *p_cull, bool p_children, Vector<const Element *> &r_result, int &r_count) const;
+	int _cull_convex_threadsafe_unique(const Element **p_elements, int p_count, Vector<T *> &r_result) const;
 	void _cull_AABB(Octant *p_octant, const AABB &p_aabb, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask);
 	void _cull_segment(Octant *p_octant, const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask);
 	void _cull_point(Octant *p_octant, const Vector3 &p_point, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask);
@@ -375,7 +383,20 @@ public:
 	T *get(OctreeElementID p_id) const;
 	int get_subindex(OctreeElementID p_id) const;
 
+	// scratch space of the threadsafe culls, each cull running at the same time needs its own
+	typedef Vector<const Element *> CullBuffer;
+
+	enum {
+		CULL_PARTS = 9 // the root's own elements and the subtree of each of its children
+	};
+
 	int cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF);
+	// does not touch the pass counters, so it can run from several threads at once while the octree is not modified
+	int cull_convex_threadsafe(const Vector<Plane> &p_convex, Vector<T *> &r_result, CullBuffer &r_buffer, uint32_t p_mask = 0xFFFFFFFF) const;
+	// a single threadsafe cull split in CULL_PARTS, which can run on different threads. each part fills its own buffer
+	// and returns the amount collected, cull_convex_threadsafe_merge() then takes the buffers and amounts of all parts
+	int cull_convex_threadsafe_part(int p_part, const Vector<Plane> &p_convex, CullBuffer &r_buffer, uint32_t p_mask = 0xFFFFFFFF) const;
+	int cull_convex_threadsafe_merge(CullBuffer *p_buffers, const int *p_counts, Vector<T *> &r_result) const;
 	int cull_AABB(const AABB &p_aabb, T **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF);
 	int cull_segment(const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int p_result_max, int *p_subindex_array = NULL, uint32_t p_mask = 0xFFFFFFFF);
 
@@ -1088,6 +1109,65 @@ void Octree<T, use_pairs, AL>::_cull_convex(Octant *p_octant, _CullConvexData *p
 	}
 }
 
+template <class T, bool use_pairs, class AL>
+void Octree<T, use_pairs, AL>::_cull_convex_threadsafe(const Octant *p_octant, const _CullConvexData *p_cull, bool p_children, Vector<const Element *> &r_result, int &r_count) const {
+
+	for (int l = 0; l < (use_pairs ? 2 : 1); l++) {
+
+		const List<Element *, AL> &elements = l == 0 ? p_octant->elements : p_octant->pairable_elements;
+
+		for (const typename List<Element *, AL>::Element *I = elements.front(); I; I = I->next()) {
+
+			const Element *e = I->get();
+
+			if (use_pairs && !(e->pairable_type & p_cull->mask))
+				continue;
+
+			if (!e->aabb.intersects_convex_shape(p_cull->planes, p_cull->plane_count))
+				continue;
+
+			if (r_count == r_result.size())
+				r_result.resize(MAX(r_count * 2, 64));
+
+			r_result[r_count++] = e;
+		}
+	}
+
+	if (!p_children)
+		return;
+
+	for (int i = 0; i < 8; i++) {
+
+		if (p_octant->children[i] && p_octant->children[i]->aabb.intersects_convex_shape(p_cull->planes, p_cull->plane_count)) {
+			_cull_convex_threadsafe(p_octant->children[i], p_cull, true, r_result, r_count);
+		}
+	}
+}
+
+template <class T, bool use_pairs, class AL>
+int Octree<T, use_pairs, AL>::_cull_convex_threadsafe_unique(const Element **p_elements, int p_count, Vector<T *> &r_result) const {
+
+	if (p_count == 0)
+		return 0;
+
+	// without a pass, elements spanning several octants are found more than once.
+	// sorting by id removes them and keeps the order the same from run to run
+	SortArray<const Element *, _ElementIDSort> sorter;
+	sorter.sort(p_elements, p_count);
+
+	if (r_result.size() < p_count)
+		r_result.resize(p_count);
+
+	int unique_count = 0;
+	for (int i = 0; i < p_count; i++) {
+
+		if (i == 0 || p_elements[i] != p_elements[i - 1])
+			r_result[unique_count++] = p_elements[i]->userdata;
+	}
+
+	return unique_count;
+}
+
 template <class T, bool use_pairs, class AL>
 void Octree<T, use_pairs, AL>::_cull_AABB(Octant *p_octant, const AABB &p_aabb, T **p_result_array, int *p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask) {
 
@@ -1329,6 +1409,79 @@ int Octree<T, use_pairs, AL>::cull_convex(const Vector<Plane> &p_convex, T **p_r
 	return result_count;
 }
 
+template <class T, bool use_pairs, class AL>
+int Octree<T, use_pairs, AL>::cull_convex_threadsafe(const Vector<Plane> &p_convex, Vector<T *> &r_result, CullBuffer &r_buffer, uint32_t p_mask) const {
+
+	if (!root)
+		return 0;
+
+	int result_count = 0;
+	_CullConvexData cdata;
+	cdata.planes = &p_convex[0];
+	cdata.plane_count = p_convex.size();
+	cdata.result_array = NULL;
+	cdata.result_max = 0;
+	cdata.result_idx = NULL;
+	cdata.mask = p_mask;
+
+	_cull_convex_threadsafe(root, &cdata, true, r_buffer, result_count);
+
+	return _cull_convex_threadsafe_unique(r_buffer.ptr(), result_count, r_result);
+}
+
+template <class T, bool use_pairs, class AL>
+int Octree<T, use_pairs, AL>::cull_convex_threadsafe_part(int p_part, const Vector<Plane> &p_convex, CullBuffer &r_buffer, uint32_t p_mask) const {
+
+	ERR_FAIL_INDEX_V(p_part, CULL_PARTS, 0);
+
+	if (!root)
+		return 0;
+
+	int result_count = 0;
+	_CullConvexData cdata;
+	cdata.planes = &p_convex[0];
+	cdata.plane_count = p_convex.size();
+	cdata.result_array = NULL;
+	cdata.result_max = 0;
+	cdata.result_idx = NULL;
+	cdata.mask = p_mask;
+
+	if (p_part == 0) {
+		_cull_convex_threadsafe(root, &cdata, false, r_buffer, result_count);
+	} else {
+
+		const Octant *child = root->children[p_part - 1];
+		if (child && child->aabb.intersects_convex_shape(cdata.planes, cdata.plane_count))
+			_cull_convex_threadsafe(child, &cdata, true, r_buffer, result_count);
+	}
+
+	return result_count;
+}
+
+template <class T, bool use_pairs, class AL>
+int Octree<T, use_pairs, AL>::cull_convex_threadsafe_merge(CullBuffer *p_buffers, const int *p_counts, Vector<T *> &r_result) const {
+
+	int total = 0;
+	for (int i = 0; i < CULL_PARTS; i++)
+		total += p_counts[i];
+
+	// the first buffer gathers all of them
+	CullBuffer &merged = p_buffers[0];
+	if (merged.size() < total)
+		merged.resize(total);
+
+	int count = p_counts[0];
+	const Element **w = merged.ptr();
+	for (int i = 1; i < CULL_PARTS; i++) {
+
+		const Element *const *r = p_buffers[i].ptr();
+		for (int j = 0; j < p_counts[i]; j++)
+			w[count++] = r[j];
+	}
+
+	return _cull_convex_threadsafe_unique(w, total, r_result);
+}
+
 template <class T, bool use_pairs, class AL>
 int Octree<T, use_pairs, AL>::cull_AABB(const AABB &p_aabb, T **p_result_array, int p_result_max, int *p_subindex_array, uint32_t p_mask) {
 
@@ -0,0 +1,415 @@
+/*************************************************************************/
+/*  oa_hash_map.h                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef OA_HASH_MAP_H
+#define OA_HASH_MAP_H
+
+#include "hash_map.h"
+
+/**
+ * @class OAHashMap
+ *
+ * Open addressing version of HashMap. Pairs are stored in one contiguous array
+ * and collisions are resolved with linear probing, so a lookup touches a few
+ * neighbouring slots instead of following a chain of separately allocated entries.
+ * The interface is the same as HashMap, with one important difference:
+ * inserting may move existing pairs, so pointers returned by getptr(), operator[]
+ * or next() are only valid until the next insertion. Erasing moves pairs too.
+ * @param TKey  Key, search is based on it, needs to be hasheable. It is unique in this container.
+ * @param TData Data, data associated with the key
+ * @param Hasher Hasher object, needs to provide a valid static hash function for TKey
+ * @param Comparator comparator object, needs to be able to safely compare two TKey values.
+ * @param MIN_HASH_TABLE_POWER Miminum size of the table, as a power of two.
+ *
+*/
+
+template <class TKey, class TData, class Hasher = HashMapHasherDefault, class Comparator = HashMapComparatorDefault<TKey>, uint8_t MIN_HASH_TABLE_POWER = 3>
+class OAHashMap {
+public:
+	struct Pair {
+
+		TKey key;
+		TData data;
+
+		Pair() {}
+		Pair(const TKey &p_key, const TData &p_data) {
+			key = p_key;
+			data = p_data;
+		}
+	};
+
+private:
+	enum {
+		EMPTY_HASH = 0 // hashes are never stored as zero, see _hash()
+	};
+
+	uint32_t *hashes;
+	Pair *pairs;
+	uint32_t capacity;
+	uint32_t elements;
+
+	static _FORCE_INLINE_ uint32_t _hash(const TKey &p_key) {
+
+		uint32_t hash = Hasher::hash(p_key);
+		return hash == EMPTY_HASH ? 1 : hash;
+	}
+
+	template <class C>
+	_FORCE_INLINE_ int _find_pos(const C &p_key, uint32_t p_hash) const {
+
+		if (!capacity)
+			return -1;
+
+		uint32_t mask = capacity - 1;
+		uint32_t pos = p_hash & mask;
+
+		/* the table is never full, so there is always an empty slot to stop at */
+		while (hashes[pos] != EMPTY_HASH) {
+
+			/* checking hash first avoids comparing key, which may take longer */
+			if (hashes[pos] == p_hash && Comparator::compare(pairs[pos].key, p_key))
+				return pos;
+
+			pos = (pos + 1) & mask;
+		}
+
+		return -1;
+	}
+
+	void _allocate(uint32_t p_capacity) {
+
+		capacity = p_capacity;
+		hashes = (uint32_t *)memalloc(sizeof(uint32_t) * capacity);
+		pairs = (Pair *)memalloc(sizeof(Pair) * capacity);
+
+		for (uint32_t i = 0; i < capacity; i++)
+			hashes[i] = EMPTY_HASH;
+	}
+
+	uint32_t _insert_new(const TKey &p_key, uint32_t p_hash) {
+
+		/* keep the load factor under 3/4 */
+		if (!capacity || (elements + 1) * 4 > capacity * 3)
+			_resize(capacity ? capacity * 2 : (1 << MIN_HASH_TABLE_POWER));
+
+		uint32_t mask = capacity - 1;
+		uint32_t pos = p_hash & mask;
+
+		while (hashes[pos] != EMPTY_HASH)
+			pos = (pos + 1) & mask;
+
+		memnew_placement(&pairs[pos], Pair);
+		pairs[pos].key = p_key;
+		hashes[pos] = p_hash;
+		elements++;
+
+		return pos;
+	}
+
+	void _resize(uint32_t p_capacity) {
+
+		uint32_t old_capacity = capacity;
+		uint32_t *old_hashes = hashes;
+		Pair *old_pairs = pairs;
+
+		_allocate(p_capacity);
+
+		uint32_t mask = capacity - 1;
+
+		for (uint32_t i = 0; i < old_capacity; i++) {
+
+			if (old_hashes[i] == EMPTY_HASH)
+				continue;
+
+			uint32_t pos = old_hashes[i] & mask;
+			while (hashes[pos] != EMPTY_HASH)
+				pos = (pos + 1) & mask;
+
+			memnew_placement(&pairs[pos], Pair(old_pairs[i]));
+			hashes[pos] = old_hashes[i];
+			old_pairs[i].~Pair();
+		}
+
+		if (old_capacity) {
+			memfree(old_hashes);
+			memfree(old_pairs);
+		}
+	}
+
+	void _erase_pos(uint32_t p_pos) {
+
+		uint32_t mask = capacity - 1;
+
+		pairs[p_pos].~Pair();
+		hashes[p_pos] = EMPTY_HASH;
+		elements--;
+
+		/* shift back the following pairs of the cluster, so no lookup stops early at the hole */
+		uint32_t hole = p_pos;
+		uint32_t pos = (p_pos + 1) & mask;
+
+		while (hashes[pos] != EMPTY_HASH) {
+
+			uint32_t ideal = hashes[pos] & mask;
+
+			/* move only if the hole is between the ideal position and the current one */
+			if (((pos - ideal) & mask) >= ((pos - hole) & mask)) {
+
+				memnew_placement(&pairs[hole], Pair(pairs[pos]));
+				hashes[hole] = hashes[pos];
+				pairs[pos].~Pair();
+				hashes[pos] = EMPTY_HASH;
+				hole = pos;
+			}
+
+			pos = (pos + 1) & mask;
+		}
+	}
+
+	void copy_from(const OAHashMap &p_t) {
+
+		if (&p_t == this)
+			return;
+
+		clear();
+
+		if (!p_t.elements)
+			return;
+
+		_allocate(p_t.capacity);
+		elements = p_t.elements;
+
+		for (uint32_t i = 0; i < capacity; i++) {
+
+			if (p_t.hashes[i] == EMPTY_HASH)
+				continue;
+
+			memnew_placement(&pairs[i], Pair(p_t.pairs[i]));
+			hashes[i] = p_t.hashes[i];
+		}
+	}
+
+public:
+	void set(const TKey &p_key, const TData &p_data) {
+
+		set(Pair(p_key, p_data));
+	}
+
+	void set(const Pair &p_pair) {
+
+		uint32_t hash = _hash(p_pair.key);
+		int pos = _find_pos(p_pair.key, hash);
+
+		if (pos < 0)
+			pos = _insert_new(p_pair.key, hash);
+
+		pairs[pos].data = p_pair.data;
+	}
+
+	bool has(const TKey &p_key) const {
+
+		return getptr(p_key) != NULL;
+	}
+
+	/**
+	 * Get a key from data, return a const reference.
+	 * WARNING: this doesn't check errors, use either getptr and check NULL, or check
+	 * first with has(key)
+	 */
+
+	const TData &get(const TKey &p_key) const {
+
+		const TData *res = getptr(p_key);
+		ERR_FAIL_COND_V(!res, *res);
+		return *res;
+	}
+
+	TData &get(const TKey &p_key) {
+
+		TData *res = getptr(p_key);
+		ERR_FAIL_COND_V(!res, *res);
+		return *res;
+	}
+
+	_FORCE_INLINE_ TData *getptr(const TKey &p_key) {
+
+		int pos = _find_pos(p_key, _hash(p_key));
+		return pos < 0 ? NULL : &pairs[pos].data;
+	}
+
+	_FORCE_INLINE_ const TData *getptr(const TKey &p_key) const {
+
+		int pos = _find_pos(p_key, _hash(p_key));
+		return pos < 0 ? NULL : &pairs[pos].data;
+	}
+
+	/**
+	 * Same as getptr, with a custom key (that should support operator==()) and its hash,
+	 * which must be the same one Hasher would return for the equivalent key.
+	 */
+
+	template <class C>
+	_FORCE_INLINE_ TData *custom_getptr(C p_custom_key, uint32_t p_custom_hash) {
+
+		int pos = _find_pos(p_custom_key, p_custom_hash == EMPTY_HASH ? 1 : p_custom_hash);
+		return pos < 0 ? NULL : &pairs[pos].data;
+	}
+
+	template <class C>
+	_FORCE_INLINE_ const TData *custom_getptr(C p_custom_key, uint32_t p_custom_hash) const {
+
+		int pos = _find_pos(p_custom_key, p_custom_hash == EMPTY_HASH ? 1 : p_custom_hash);
+		return pos < 0 ? NULL : &pairs[pos].data;
+	}
+
+	/**
+	 * Erase an item, return true if erasing was succesful
+	 */
+
+	bool erase(const TKey &p_key) {
+
+		int pos = _find_pos(p_key, _hash(p_key));
+		if (pos < 0)
+			return false;
+
+		_erase_pos(pos);
+		return true;
+	}
+
+	inline const TData &operator[](const TKey &p_key) const { //constref
+
+		return get(p_key);
+	}
+
+	inline TData &operator[](const TKey &p_key) { //assignment
+
+		uint32_t hash = _hash(p_key);
+		int pos = _find_pos(p_key, hash);
+
+		if (pos < 0)
+			pos = _insert_new(p_key, hash);
+
+		return pairs[pos].data;
+	}
+
+	/**
+	 * Get the next key to p_key, and the first key if p_key is null.
+	 * Works like HashMap::next(), but p_key must be a pointer returned by a previous
+	 * call, as the position is taken from the pointer instead of looking the key up again.
+	 */
+	const TKey *next(const TKey *p_key) const {
+
+		if (!elements)
+			return NULL;
+
+		uint32_t from = 0;
+
+		if (p_key) {
+			from = uint32_t(((const uint8_t *)p_key - (const uint8_t *)&pairs[0].key) / sizeof(Pair)) + 1;
+			ERR_FAIL_COND_V(from > capacity, NULL); /* invalid key supplied */
+		}
+
+		for (uint32_t i = from; i < capacity; i++) {
+
+			if (hashes[i] != EMPTY_HASH)
+				return &pairs[i].key;
+		}
+
+		return NULL; /* nothing found */
+	}
+
+	inline unsigned int size() const {
+
+		return elements;
+	}
+
+	inline bool empty() const {
+
+		return elements == 0;
+	}
+
+	void clear() {
+
+		if (capacity) {
+
+			for (uint32_t i = 0; i < capacity; i++) {
+
+				if (hashes[i] != EMPTY_HASH)
+					pairs[i].~Pair();
+			}
+
+			memfree(hashes);
+			memfree(pairs);
+		}
+
+		hashes = NULL;
+		pairs = NULL;
+		capacity = 0;
+		elements = 0;
+	}
+
+	void get_key_list(List<TKey> *p_keys) const {
+
+		for (uint32_t i = 0; i < capacity; i++) {
+
+			if (hashes[i] != EMPTY_HASH)
+				p_keys->push_back(pairs[i].key);
+		}
+	}
+
+	void operator=(const OAHashMap &p_table) {
+
+		copy_from(p_table);
+	}
+
+	OAHashMap() {
+
+		hashes = NULL;
+		pairs = NULL;
+		capacity = 0;
+		elements = 0;
+	}
+
+	OAHashMap(const OAHashMap &p_table) {
+
+		hashes = NULL;
+		pairs = NULL;
+		capacity = 0;
+		elements = 0;
+
+		copy_from(p_table);
+	}
+
+	~OAHashMap() {
+
+		clear();
+	}
+};
+
+#endif
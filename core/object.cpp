@@ -858,6 +858,14 @@ Variant Object::call(const StringName &p_method, const Variant **p_args, int p_a
 	return ret;
 }
 
+Variant Object::call_method_bind(MethodBind *p_method, const Variant **p_args, int p_argcount, Variant::CallError &r_error) {
+
+	r_error.error = Variant::CallError::CALL_OK;
+
+	OBJ_DEBUG_LOCK
+	return p_method->call(this, p_args, p_argcount, r_error);
+}
+
 void Object::notification(int p_notification, bool p_reversed) {
 
 	_notificationv(p_notification, p_reversed);
@@ -1109,9 +1117,9 @@ void Object::emit_signal(const StringName &p_name, const Variant **p_args, int p
 	List<_ObjectSignalDisconnectData> disconnect_data;
 
 	//copy on write will ensure that disconnecting the signal or even deleting the object will not affect the signal calling.
-	//this happens automatically and will not change the performance of calling.
-	//awesome, isn't it?
-	VMap<Signal::Target, Signal::Slot> slot_map = s->slot_map;
+	//the copy only shares the data, and it must be kept const so nothing is actually copied
+	//unless a connection changes during emission.
+	const VMap<Signal::Target, Signal::Slot> slot_map = s->slot_map;
 
 	int ssize = slot_map.size();
 
@@ -1121,7 +1129,8 @@ void Object::emit_signal(const StringName &p_name, const Variant **p_args, int p
 
 	for (int i = 0; i < ssize; i++) {
 
-		const Connection &c = slot_map.getv(i).conn;
+		const Signal::Slot &slot = slot_map.getv(i);
+		const Connection &c = slot.conn;
 
 		Object *target;
 #ifdef DEBUG_ENABLED
@@ -1153,7 +1162,12 @@ void Object::emit_signal(const StringName &p_name, const Variant **p_args, int p
 			MessageQueue::get_singleton()->push_call(target->get_instance_ID(), c.method, args, argc, true);
 		} else {
 			Variant::CallError ce;
-			target->call(c.method, args, argc, ce);
+			if (slot.method && !target->script_instance) {
+				//no script can override it, skip the method lookup
+				target->call_method_bind(slot.method, args, argc, ce);
+			} else {
+				target->call(c.method, args, argc, ce);
+			}
 			if (ce.error != Variant::CallError::CALL_OK) {
 
 				if (ce.error == Variant::CallError::CALL_ERROR_INVALID_METHOD && !ObjectTypeDB::type_exists(target->get_type_name())) {
@@ -1378,6 +1392,8 @@ Error Object::connect(const StringName &p_signal, Object *p_to_object, const Str
 	conn.binds = p_binds;
 	slot.conn = conn;
 	slot.cE = p_to_object->connections.push_back(conn);
+	if (p_to_method != CoreStringNames::get_singleton()->_free && !ObjectTypeDB::overrides_call(p_to_object->get_type_name()))
+		slot.method = ObjectTypeDB::get_method(p_to_object->get_type_name(), p_to_method);
 	s->slot_map[target] = slot;
 
 	return OK;
@@ -1786,45 +1802,98 @@ void postinitialize_handler(Object *p_object) {
 	p_object->_postinitialize();
 }
 
-HashMap<uint32_t, Object *> ObjectDB::instances;
-uint32_t ObjectDB::instance_counter = 1;
+ObjectDB::Slot *ObjectDB::slot_pages[ObjectDB::SLOT_MAX_PAGES] = { NULL };
+uint32_t ObjectDB::slot_count = 1; //slot 0 is never used, so no valid ID is 0
+uint32_t ObjectDB::free_head = 0;
+uint32_t ObjectDB::free_tail = 0;
+uint32_t ObjectDB::free_count = 0;
+uint32_t ObjectDB::instance_count = 0;
+#ifdef DEBUG_ENABLED
 HashMap<Object *, ObjectID, ObjectDB::ObjectPtrHash> ObjectDB::instance_checks;
+#endif
+
 uint32_t ObjectDB::add_instance(Object *p_object) {
 
 	GLOBAL_LOCK_FUNCTION;
 	ERR_FAIL_COND_V(p_object->get_instance_ID() != 0, 0);
-	instances[++instance_counter] = p_object;
+
+	uint32_t index;
+
+	if (free_count > SLOT_MIN_FREE || (free_count && slot_count == (1 << SLOT_INDEX_BITS))) {
+
+		index = free_head;
+		free_head = _get_slot(index)->next_free;
+		free_count--;
+	} else {
+
+		ERR_EXPLAIN("Too many objects alive at the same time");
+		ERR_FAIL_COND_V(slot_count == (1 << SLOT_INDEX_BITS), 0);
+
+		index = slot_count;
+		if (!slot_pages[index >> SLOT_PAGE_BITS]) {
+
+			Slot *page = (Slot *)memalloc(sizeof(Slot) * SLOT_PAGE_SIZE);
+			for (int i = 0; i < SLOT_PAGE_SIZE; i++) {
+				page[i].id = 0;
+				page[i].object = NULL;
+				page[i].generation = 0;
+				page[i].next_free = 0;
+			}
+			slot_pages[index >> SLOT_PAGE_BITS] = page;
+		}
+		slot_count++;
+	}
+
+	Slot *slot = _get_slot(index);
+	ObjectID id = (index << SLOT_GENERATION_BITS) | slot->generation;
+	slot->object = p_object;
+	slot->id = id; //published last, see get_instance()
+	instance_count++;
 #ifdef DEBUG_ENABLED
-	instance_checks[p_object] = instance_counter;
+	instance_checks[p_object] = id;
 #endif
-	return instance_counter;
+
+	return id;
 }
 
 void ObjectDB::remove_instance(Object *p_object) {
 
 	GLOBAL_LOCK_FUNCTION;
-	instances.erase(p_object->get_instance_ID());
+
+	ObjectID id = p_object->get_instance_ID();
+	uint32_t index = id >> SLOT_GENERATION_BITS;
+	Slot *slot = _get_slot(index);
+	if (!slot)
+		return; //leaked past cleanup()
+	ERR_FAIL_COND(slot->id != id);
+
+	slot->id = 0; //unpublished first, see get_instance()
+	slot->object = NULL;
+	slot->generation = (slot->generation + 1) & SLOT_GENERATION_MASK;
+	instance_count--;
 #ifdef DEBUG_ENABLED
 	instance_checks.erase(p_object);
 #endif
-}
-Object *ObjectDB::get_instance(uint32_t p_instance_ID) {
 
-	GLOBAL_LOCK_FUNCTION;
-	Object **obj = instances.getptr(p_instance_ID);
-	if (!obj)
-		return NULL;
-	return *obj;
+	//oldest freed slots are reused first
+	slot->next_free = 0;
+	if (free_count)
+		_get_slot(free_tail)->next_free = index;
+	else
+		free_head = index;
+	free_tail = index;
+	free_count++;
 }
 
 void ObjectDB::debug_objects(DebugFunc p_func) {
 
 	GLOBAL_LOCK_FUNCTION;
 
-	const uint32_t *K = NULL;
-	while ((K = instances.next(K))) {
+	for (uint32_t i = 1; i < slot_count; i++) {
 
-		p_func(instances[*K]);
+		Slot *slot = _get_slot(i);
+		if (slot->id)
+			p_func(slot->object);
 	}
 }
 
@@ -1834,28 +1903,45 @@ void Object::get_argument_options(const StringName &p_function, int p_idx, List<
 int ObjectDB::get_object_count() {
 
 	GLOBAL_LOCK_FUNCTION;
-	return instances.size();
+	return instance_count;
 }
 
 void ObjectDB::cleanup() {
 
 	GLOBAL_LOCK_FUNCTION;
-	if (instances.size()) {
+	if (instance_count) {
 
 		WARN_PRINT("ObjectDB Instances still exist!");
 		if (OS::get_singleton()->is_stdout_verbose()) {
-			const uint32_t *K = NULL;
-			while ((K = instances.next(K))) {
+			for (uint32_t i = 1; i < slot_count; i++) {
 
+				Slot *slot = _get_slot(i);
+				if (!slot->id)
+					continue;
+
+				Object *obj = slot->object;
 				String node_name;
-				if (instances[*K]->is_type("Node"))
-					node_name = " - Node Name: " + String(instances[*K]->call("get_name"));
-				if (instances[*K]->is_type("Resource"))
-					node_name = " - Resource Name: " + String(instances[*K]->call("get_name")) + " Path: " + String(instances[*K]->call("get_path"));
-				print_line("Leaked Instance: " + String(instances[*K]->get_type()) + ":" + itos(*K) + node_name);
+				if (obj->is_type("Node"))
+					node_name = " - Node Name: " + String(obj->call("get_name"));
+				if (obj->is_type("Resource"))
+					node_name = " - Resource Name: " + String(obj->call("get_name")) + " Path: " + String(obj->call("get_path"));
+				print_line("Leaked Instance: " + String(obj->get_type()) + ":" + itos(slot->id) + node_name);
 			}
 		}
 	}
-	instances.clear();
+
+	for (int i = 0; i < SLOT_MAX_PAGES; i++) {
+		if (slot_pages[i]) {
+			memfree(slot_pages[i]);
+			slot_pages[i] = NULL;
+		}
+	}
+	slot_count = 1;
+	free_head = 0;
+	free_tail = 0;
+	free_count = 0;
+	instance_count = 0;
+#ifdef DEBUG_ENABLED
 	instance_checks.clear();
+#endif
 }
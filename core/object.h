@@ -329,6 +329,7 @@ public:                                                      \
 private:
 
 class ScriptInstance;
+class MethodBind;
 typedef uint32_t ObjectID;
 
 class Object {
@@ -386,6 +387,8 @@ private:
 
 			Connection conn;
 			List<Connection>::Element *cE;
+			MethodBind *method; // resolved at connect time, NULL if only a script can handle it
+			Slot() { method = NULL; }
 		};
 
 		MethodInfo user;
@@ -595,6 +598,7 @@ public:
 	virtual void call_multilevel_reversed(const StringName &p_method, const Variant **p_args, int p_argcount);
 	Variant call(const StringName &p_name, VARIANT_ARG_LIST); // C++ helper
 	void call_multilevel(const StringName &p_name, VARIANT_ARG_LIST); // C++ helper
+	Variant call_method_bind(MethodBind *p_method, const Variant **p_args, int p_argcount, Variant::CallError &r_error); // for callers that already resolved what call() would dispatch to
 
 	void notification(int p_notification, bool p_reversed = false);
 
@@ -667,6 +671,30 @@ void postinitialize_handler(Object *p_object);
 
 class ObjectDB {
 
+	/* Instance IDs are a slot index plus the generation of that slot, so lookups are
+	   a plain array access. Slots live in pages that never move, which lets readers go
+	   without the lock, and freed slots wait in a FIFO so their IDs are not reused soon. */
+
+	enum {
+		SLOT_GENERATION_BITS = 10,
+		SLOT_GENERATION_MASK = (1 << SLOT_GENERATION_BITS) - 1,
+		SLOT_INDEX_BITS = 32 - SLOT_GENERATION_BITS,
+		SLOT_PAGE_BITS = 12,
+		SLOT_PAGE_SIZE = 1 << SLOT_PAGE_BITS,
+		SLOT_PAGE_MASK = SLOT_PAGE_SIZE - 1,
+		SLOT_MAX_PAGES = 1 << (SLOT_INDEX_BITS - SLOT_PAGE_BITS),
+		SLOT_MIN_FREE = 1024 //free slots kept waiting before one is reused
+	};
+
+	struct Slot {
+
+		volatile ObjectID id; //0 while free
+		Object *volatile object;
+		uint32_t generation;
+		uint32_t next_free;
+	};
+
+#ifdef DEBUG_ENABLED
 	struct ObjectPtrHash {
 
 		static _FORCE_INLINE_ uint32_t hash(const Object *p_obj) {
@@ -680,10 +708,17 @@ class ObjectDB {
 		}
 	};
 
-	static HashMap<uint32_t, Object *> instances;
+	//live pointers, so a possibly freed object can be validated without reading it
 	static HashMap<Object *, ObjectID, ObjectPtrHash> instance_checks;
+#endif
+
+	static Slot *slot_pages[SLOT_MAX_PAGES];
+	static uint32_t slot_count;
+	static uint32_t free_head;
+	static uint32_t free_tail;
+	static uint32_t free_count;
+	static uint32_t instance_count;
 
-	static uint32_t instance_counter;
 	friend class Object;
 	friend void unregister_core_types();
 
@@ -691,10 +726,28 @@ class ObjectDB {
 	static uint32_t add_instance(Object *p_object);
 	static void remove_instance(Object *p_object);
 
+	_FORCE_INLINE_ static Slot *_get_slot(uint32_t p_index) {
+
+		Slot *page = slot_pages[p_index >> SLOT_PAGE_BITS];
+		return page ? &page[p_index & SLOT_PAGE_MASK] : NULL;
+	}
+
 public:
 	typedef void (*DebugFunc)(Object *p_obj);
 
-	static Object *get_instance(uint32_t p_instance_ID);
+	_FORCE_INLINE_ static Object *get_instance(uint32_t p_instance_ID) {
+
+		Slot *slot = _get_slot(p_instance_ID >> SLOT_GENERATION_BITS);
+		if (!slot)
+			return NULL;
+
+		//read the object before the id, a slot is only trusted if the id still matches afterwards
+		Object *obj = slot->object;
+		if (slot->id != p_instance_ID)
+			return NULL;
+		return obj;
+	}
+
 	static void debug_objects(DebugFunc p_func);
 	static int get_object_count();
 
@@ -218,6 +218,25 @@ bool ObjectTypeDB::is_type(const StringName &p_type, const StringName &p_inherit
 
 	return false;
 }
+
+bool ObjectTypeDB::overrides_call(const StringName &p_type) {
+
+	//scripts call their static functions, the Java wrappers forward to the JNI
+	static const char *types[] = {
+		"Script",
+		"JavaClass",
+		"JavaObject",
+		NULL
+	};
+
+	for (int i = 0; types[i]; i++) {
+		if (is_type(p_type, types[i]))
+			return true;
+	}
+
+	return false;
+}
+
 void ObjectTypeDB::get_type_list(List<StringName> *p_types) {
 
 	OBJTYPE_LOCK;
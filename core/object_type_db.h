@@ -31,6 +31,7 @@
 #define OBJECT_TYPE_DB_H
 
 #include "method_bind.h"
+#include "oa_hash_map.h"
 #include "object.h"
 #include "print_string.h"
 /**
@@ -121,9 +122,9 @@ class ObjectTypeDB {
 	struct TypeInfo {
 
 		TypeInfo *inherits_ptr;
-		HashMap<StringName, MethodBind *, StringNameHasher> method_map;
-		HashMap<StringName, int, StringNameHasher> constant_map;
-		HashMap<StringName, MethodInfo, StringNameHasher> signal_map;
+		OAHashMap<StringName, MethodBind *, StringNameHasher> method_map;
+		OAHashMap<StringName, int, StringNameHasher> constant_map;
+		OAHashMap<StringName, MethodInfo, StringNameHasher> signal_map;
 		List<PropertyInfo> property_list;
 #ifdef DEBUG_METHODS_ENABLED
 		List<StringName> constant_order;
@@ -131,7 +132,7 @@ class ObjectTypeDB {
 		List<MethodInfo> virtual_methods;
 		StringName category;
 #endif
-		HashMap<StringName, PropertySetGet, StringNameHasher> property_setget;
+		OAHashMap<StringName, PropertySetGet, StringNameHasher> property_setget;
 
 		StringName inherits;
 		StringName name;
@@ -229,6 +230,7 @@ public:
 	static StringName type_inherits_from(const StringName &p_type);
 	static bool type_exists(const StringName &p_type);
 	static bool is_type(const StringName &p_type, const StringName &p_inherits);
+	static bool overrides_call(const StringName &p_type); //reimplements Object::call(), so its MethodBinds must not be called directly
 	static bool can_instance(const StringName &p_type);
 	static Object *instance(const StringName &p_type);
 
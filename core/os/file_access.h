@@ -105,6 +105,7 @@ public:
 	virtual real_t get_real() const;
 
 	virtual int get_buffer(uint8_t *p_dst, int p_length) const; ///< get an array of bytes
+	virtual const uint8_t *get_direct_buffer(int p_length) const { return NULL; } ///< point at the next p_length bytes and skip them, if the file is in memory (NULL otherwise, nothing is read)
 	virtual String get_line() const;
 	virtual Vector<String> get_csv_line(String delim = ",") const;
 
@@ -78,6 +78,12 @@ size_t Memory::get_static_mem_usage() {
 	return MemoryPoolStatic::get_singleton()->get_total_usage();
 }
 
+uint64_t Memory::get_static_alloc_calls() {
+
+	ERR_FAIL_COND_V(!MemoryPoolStatic::get_singleton(), 0);
+	return MemoryPoolStatic::get_singleton()->get_alloc_calls();
+}
+
 void Memory::dump_static_mem_to_file(const char *p_file) {
 
 	MemoryPoolStatic::get_singleton()->dump_mem_to_file(p_file);
@@ -109,6 +115,16 @@ size_t Memory::get_dynamic_mem_usage() {
 	return MemoryPoolDynamic::get_singleton()->get_total_usage();
 }
 
+size_t Memory::get_dynamic_mem_reserved() {
+
+	return MemoryPoolDynamic::get_singleton()->get_reserved_mem();
+}
+
+void Memory::set_dynamic_background_compaction(bool p_enable) {
+
+	MemoryPoolDynamic::get_singleton()->set_background_compaction(p_enable);
+}
+
 _GlobalNil::_GlobalNil() {
 
 	color = 1;
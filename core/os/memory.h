@@ -188,6 +188,7 @@ public:
 	static size_t get_static_mem_available();
 	static size_t get_static_mem_usage();
 	static size_t get_static_mem_max_usage();
+	static uint64_t get_static_alloc_calls();
 	static void dump_static_mem_to_file(const char *p_file);
 
 	static MID alloc_dynamic(size_t p_bytes, const char *p_descr = "");
@@ -195,6 +196,8 @@ public:
 
 	static size_t get_dynamic_mem_available();
 	static size_t get_dynamic_mem_usage();
+	static size_t get_dynamic_mem_reserved();
+	static void set_dynamic_background_compaction(bool p_enable);
 };
 
 template <class T>
@@ -38,11 +38,13 @@ MemoryPoolDynamic *MemoryPoolDynamic::get_singleton() {
 
 MemoryPoolDynamic::MemoryPoolDynamic() {
 
-	ERR_FAIL_COND(singleton != NULL);
-	singleton = this;
+	//the first pool is the one Memory uses, others (like in tests) are private
+	if (!singleton)
+		singleton = this;
 }
 
 MemoryPoolDynamic::~MemoryPoolDynamic() {
 
-	singleton = NULL;
+	if (singleton == this)
+		singleton = NULL;
 }
@@ -63,6 +63,8 @@ protected:
 
 	virtual size_t get_available_mem() const = 0;
 	virtual size_t get_total_usage() const = 0;
+	virtual size_t get_reserved_mem() const { return get_total_usage(); } ///< includes memory held but not in use
+	virtual void set_background_compaction(bool p_enable) {}
 
 	MemoryPoolDynamic();
 
@@ -0,0 +1,647 @@
+/*************************************************************************/
+/*  memory_pool_dynamic_size_class.cpp                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "memory_pool_dynamic_size_class.h"
+#include "os/copymem.h"
+#include "os/memory.h"
+#include "os/os.h"
+#include "print_string.h"
+#include "safe_refcount.h"
+#include "ustring.h"
+
+int MemoryPoolDynamicSizeClass::_get_size_class(size_t p_size) {
+
+	if (p_size <= 64)
+		return p_size ? (int)((p_size - 1) >> 4) : 0;
+
+	//four classes per power of two from there on
+	int shift = 6;
+	while (((p_size - 1) >> (shift + 1)) != 0)
+		shift++;
+
+	return (shift - 6) * 4 + (int)((p_size - 1) >> (shift - 2));
+}
+
+size_t MemoryPoolDynamicSizeClass::_get_class_size(int p_class) {
+
+	if (p_class < 4)
+		return (p_class + 1) * 16;
+
+	int group = (p_class - 4) / 4;
+	int step = (p_class - 4) % 4;
+	return ((size_t)64 << group) + (size_t)(step + 1) * ((size_t)16 << group);
+}
+
+MemoryPoolDynamicSizeClass::Slot *MemoryPoolDynamicSizeClass::_get_slot(ID p_id) {
+
+	uint64_t check = p_id / MAX_SLOTS;
+	uint64_t idx = p_id % MAX_SLOTS;
+
+	if (slots[idx].check != check)
+		return NULL;
+
+	return &slots[idx];
+}
+
+const MemoryPoolDynamicSizeClass::Slot *MemoryPoolDynamicSizeClass::_get_slot(ID p_id) const {
+
+	uint64_t check = p_id / MAX_SLOTS;
+	uint64_t idx = p_id % MAX_SLOTS;
+
+	if (slots[idx].check != check)
+		return NULL;
+
+	return &slots[idx];
+}
+
+bool MemoryPoolDynamicSizeClass::_claim_slot(Slot *p_slot) {
+
+	//only succeeds if nobody holds a lock, lock() backs off while the flag is set
+	if (atomic_add(&p_slot->lock, (uint32_t)SLOT_MOVING) == (uint32_t)SLOT_MOVING)
+		return true;
+
+	atomic_sub(&p_slot->lock, (uint32_t)SLOT_MOVING);
+	return false;
+}
+
+void MemoryPoolDynamicSizeClass::_release_slot(Slot *p_slot) {
+
+	atomic_sub(&p_slot->lock, (uint32_t)SLOT_MOVING);
+}
+
+void MemoryPoolDynamicSizeClass::_page_add_slot(Page *p_page, uint32_t p_slot) {
+
+	Slot &s = slots[p_slot];
+	s.page_prev = MAX_SLOTS;
+	s.page_next = p_page->first_slot;
+	if (p_page->first_slot != MAX_SLOTS)
+		slots[p_page->first_slot].page_prev = p_slot;
+	p_page->first_slot = p_slot;
+}
+
+void MemoryPoolDynamicSizeClass::_page_remove_slot(Page *p_page, uint32_t p_slot) {
+
+	Slot &s = slots[p_slot];
+	if (s.page_prev != MAX_SLOTS)
+		slots[s.page_prev].page_next = s.page_next;
+	else
+		p_page->first_slot = s.page_next;
+	if (s.page_next != MAX_SLOTS)
+		slots[s.page_next].page_prev = s.page_prev;
+
+	s.page_prev = MAX_SLOTS;
+	s.page_next = MAX_SLOTS;
+}
+
+void MemoryPoolDynamicSizeClass::_link_page(Page *p_page) {
+
+	SizeClass &sc = size_classes[p_page->size_class];
+	p_page->prev = NULL;
+	p_page->next = sc.partial;
+	if (sc.partial)
+		sc.partial->prev = p_page;
+	sc.partial = p_page;
+}
+
+void MemoryPoolDynamicSizeClass::_unlink_page(Page *p_page) {
+
+	SizeClass &sc = size_classes[p_page->size_class];
+	if (p_page->prev)
+		p_page->prev->next = p_page->next;
+	else
+		sc.partial = p_page->next;
+	if (p_page->next)
+		p_page->next->prev = p_page->prev;
+
+	p_page->prev = NULL;
+	p_page->next = NULL;
+}
+
+MemoryPoolDynamicSizeClass::Page *MemoryPoolDynamicSizeClass::_create_page(int p_class) {
+
+	uint8_t *mem = (uint8_t *)memalloc(PAGE_SIZE);
+	if (!mem)
+		return NULL;
+
+	Page *page = memnew(Page);
+	page->mem = mem;
+	page->free_list = NULL;
+	page->size_class = p_class;
+	page->block_count = PAGE_SIZE / _get_class_size(p_class);
+	page->carved = 0;
+	page->live = 0;
+	page->first_slot = MAX_SLOTS;
+	_link_page(page);
+
+	size_classes[p_class].page_count++;
+	reserved += PAGE_SIZE;
+	if (reserved > max_reserved)
+		max_reserved = reserved;
+
+	return page;
+}
+
+void MemoryPoolDynamicSizeClass::_destroy_page(Page *p_page) {
+
+	size_classes[p_page->size_class].page_count--;
+	reserved -= PAGE_SIZE;
+	memfree(p_page->mem);
+	memdelete(p_page);
+}
+
+uint8_t *MemoryPoolDynamicSizeClass::_alloc_block(size_t p_size, size_t *r_capacity, Page **r_page) {
+
+	if (p_size > SMALL_MAX) {
+
+		uint8_t *mem = (uint8_t *)memalloc(p_size);
+		if (!mem)
+			return NULL;
+
+		reserved += p_size;
+		if (reserved > max_reserved)
+			max_reserved = reserved;
+
+		*r_capacity = p_size;
+		*r_page = NULL;
+		return mem;
+	}
+
+	int size_class = _get_size_class(p_size);
+	size_t class_size = _get_class_size(size_class);
+
+	Page *page = size_classes[size_class].partial;
+	if (!page) {
+		page = _create_page(size_class);
+		if (!page)
+			return NULL;
+	}
+
+	uint8_t *block;
+	if (page->free_list) {
+		block = page->free_list;
+		page->free_list = *(uint8_t **)block;
+	} else {
+		block = page->mem + page->carved * class_size;
+		page->carved++;
+	}
+
+	page->live++;
+	if (page->live == page->block_count)
+		_unlink_page(page); // full, stop handing it out
+
+	*r_capacity = class_size;
+	*r_page = page;
+	return block;
+}
+
+void MemoryPoolDynamicSizeClass::_free_block(uint8_t *p_mem, size_t p_capacity, Page *p_page) {
+
+	if (!p_page) {
+
+		reserved -= p_capacity;
+		memfree(p_mem);
+		return;
+	}
+
+	if (p_page->live == p_page->block_count)
+		_link_page(p_page); // was full, usable again
+
+	*(uint8_t **)p_mem = p_page->free_list;
+	p_page->free_list = p_mem;
+	p_page->live--;
+
+	//keep one empty page around per class so alloc/free pairs don't thrash
+	if (p_page->live == 0 && (p_page->prev || p_page->next)) {
+		_unlink_page(p_page);
+		_destroy_page(p_page);
+	}
+}
+
+MemoryPoolDynamic::ID MemoryPoolDynamicSizeClass::alloc(size_t p_amount, const char *p_description) {
+
+	_THREAD_SAFE_METHOD_
+
+	if (first_free_slot == MAX_SLOTS) {
+		ERR_EXPLAIN("Out of dynamic Memory IDs");
+		ERR_FAIL_V(INVALID_ID);
+	}
+
+	uint32_t idx = first_free_slot;
+	Slot &s = slots[idx];
+
+	s.mem = _alloc_block(p_amount, &s.capacity, &s.page);
+	if (!s.mem)
+		return INVALID_ID;
+	if (s.page)
+		_page_add_slot(s.page, idx);
+
+	first_free_slot = s.next_free;
+	s.size = p_amount;
+	s.descr = p_description;
+	s.lock = 0;
+
+	last_check++;
+	if (last_check * MAX_SLOTS + idx == INVALID_ID)
+		last_check++;
+	s.check = last_check;
+
+	total_usage += p_amount;
+	if (total_usage > max_usage)
+		max_usage = total_usage;
+
+	return s.check * MAX_SLOTS + (uint64_t)idx;
+}
+
+void MemoryPoolDynamicSizeClass::free(ID p_id) {
+
+	_THREAD_SAFE_METHOD_
+
+	Slot *s = _get_slot(p_id);
+	ERR_FAIL_COND(!s);
+
+	if (s->lock & SLOT_LOCK_MASK) {
+
+		ERR_PRINT("Freed ID Still locked");
+	}
+
+	total_usage -= s->size;
+	if (s->page)
+		_page_remove_slot(s->page, (uint32_t)(s - slots));
+	_free_block(s->mem, s->capacity, s->page);
+
+	s->mem = NULL;
+	s->page = NULL;
+	s->check = 0;
+	s->next_free = first_free_slot;
+	first_free_slot = (uint32_t)(s - slots);
+}
+
+Error MemoryPoolDynamicSizeClass::realloc(ID p_id, size_t p_amount) {
+
+	_THREAD_SAFE_METHOD_
+
+	Slot *s = _get_slot(p_id);
+	ERR_FAIL_COND_V(!s, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(!_claim_slot(s), ERR_LOCKED);
+
+	//stay in place unless it doesn't fit or would waste more than half the block
+	if (p_amount > s->capacity || (p_amount < s->capacity / 2 && s->capacity > 16)) {
+
+		size_t request = p_amount;
+		if (p_amount > s->capacity && p_amount > SMALL_MAX)
+			request = _get_class_size(_get_size_class(p_amount)); // leave room to keep growing
+
+		if (!s->page && request > SMALL_MAX) {
+
+			uint8_t *mem = (uint8_t *)memrealloc(s->mem, request);
+			if (!mem) {
+				_release_slot(s);
+				ERR_FAIL_V(ERR_OUT_OF_MEMORY);
+			}
+
+			reserved += request;
+			reserved -= s->capacity;
+			if (reserved > max_reserved)
+				max_reserved = reserved;
+
+			s->mem = mem;
+			s->capacity = request;
+
+		} else {
+
+			size_t capacity;
+			Page *page;
+			uint8_t *mem = _alloc_block(request, &capacity, &page);
+			if (!mem) {
+				_release_slot(s);
+				ERR_FAIL_V(ERR_OUT_OF_MEMORY);
+			}
+
+			copymem(mem, s->mem, MIN(s->size, p_amount));
+			uint32_t idx = (uint32_t)(s - slots);
+			if (s->page)
+				_page_remove_slot(s->page, idx);
+			_free_block(s->mem, s->capacity, s->page);
+
+			s->mem = mem;
+			s->capacity = capacity;
+			s->page = page;
+			if (page)
+				_page_add_slot(page, idx);
+		}
+	}
+
+	total_usage -= s->size;
+	s->size = p_amount;
+	total_usage += s->size;
+	if (total_usage > max_usage)
+		max_usage = total_usage;
+
+	_release_slot(s);
+
+	return OK;
+}
+
+bool MemoryPoolDynamicSizeClass::is_valid(ID p_id) {
+
+	return _get_slot(p_id) != NULL;
+}
+
+size_t MemoryPoolDynamicSizeClass::get_size(ID p_id) const {
+
+	const Slot *s = _get_slot(p_id);
+	ERR_FAIL_COND_V(!s, 0);
+
+	return s->size;
+}
+
+const char *MemoryPoolDynamicSizeClass::get_description(ID p_id) const {
+
+	const Slot *s = _get_slot(p_id);
+	ERR_FAIL_COND_V(!s, "");
+
+	return s->descr;
+}
+
+bool MemoryPoolDynamicSizeClass::is_locked(ID p_id) const {
+
+	const Slot *s = _get_slot(p_id);
+	ERR_FAIL_COND_V(!s, false);
+
+	return (s->lock & SLOT_LOCK_MASK) > 0;
+}
+
+Error MemoryPoolDynamicSizeClass::lock(ID p_id) {
+
+	Slot *s = _get_slot(p_id);
+	ERR_FAIL_COND_V(!s, ERR_INVALID_PARAMETER);
+
+	while (atomic_increment(&s->lock) & SLOT_MOVING) {
+
+		//being moved, back off until it's done
+		atomic_decrement(&s->lock);
+		while (*(volatile uint32_t *)&s->lock & SLOT_MOVING) {
+		}
+	}
+
+	return OK;
+}
+
+void *MemoryPoolDynamicSizeClass::get(ID p_id) {
+
+	const Slot *s = _get_slot(p_id);
+	ERR_FAIL_COND_V(!s, NULL);
+	ERR_FAIL_COND_V((s->lock & SLOT_LOCK_MASK) == 0, NULL);
+
+	return s->mem;
+}
+
+Error MemoryPoolDynamicSizeClass::unlock(ID p_id) {
+
+	Slot *s = _get_slot(p_id);
+	ERR_FAIL_COND_V(!s, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V((s->lock & SLOT_LOCK_MASK) == 0, ERR_INVALID_PARAMETER);
+
+	atomic_decrement(&s->lock);
+
+	return OK;
+}
+
+size_t MemoryPoolDynamicSizeClass::get_available_mem() const {
+
+	return Memory::get_static_mem_available();
+}
+
+size_t MemoryPoolDynamicSizeClass::get_total_usage() const {
+
+	return total_usage;
+}
+
+size_t MemoryPoolDynamicSizeClass::get_reserved_mem() const {
+
+	return reserved;
+}
+
+int MemoryPoolDynamicSizeClass::_compact_page(Page *p_page, int p_max_moves) {
+
+	size_t class_size = _get_class_size(p_page->size_class);
+	int moved = 0;
+
+	//take it out of the list so the moved blocks land in other pages
+	_unlink_page(p_page);
+
+	//only the page's own blocks are visited, the list is walked while they leave it
+	uint32_t next = p_page->first_slot;
+	while (next != MAX_SLOTS && moved < p_max_moves) {
+
+		uint32_t i = next;
+		Slot *s = &slots[i];
+		next = s->page_next;
+		if (!_claim_slot(s))
+			continue;
+
+		size_t capacity;
+		Page *page;
+		uint8_t *mem = _alloc_block(class_size, &capacity, &page);
+		if (!mem) {
+			_release_slot(s);
+			break;
+		}
+
+		copymem(mem, s->mem, s->size);
+
+		*(uint8_t **)s->mem = p_page->free_list;
+		p_page->free_list = s->mem;
+		p_page->live--;
+
+		_page_remove_slot(p_page, i);
+		_page_add_slot(page, i);
+
+		s->mem = mem;
+		s->page = page;
+		_release_slot(s);
+		moved++;
+	}
+
+	if (p_page->live == 0)
+		_destroy_page(p_page);
+	else
+		_link_page(p_page);
+
+	moves += moved;
+	return moved;
+}
+
+int MemoryPoolDynamicSizeClass::compact(int p_max_moves) {
+
+	int moved = 0;
+
+	for (int i = 0; i < SMALL_CLASSES && moved < p_max_moves; i++) {
+
+		_THREAD_SAFE_METHOD_
+
+		SizeClass &sc = size_classes[i];
+		if (!sc.partial || !sc.partial->next)
+			continue;
+
+		//evacuate the emptiest page if the others have room for its blocks
+		Page *victim = sc.partial;
+		int free_blocks = 0;
+		for (Page *p = sc.partial; p; p = p->next) {
+
+			free_blocks += p->block_count - p->live;
+			if (p->live < victim->live)
+				victim = p;
+		}
+
+		free_blocks -= victim->block_count - victim->live;
+		if (free_blocks < victim->live)
+			continue;
+
+		moved += _compact_page(victim, p_max_moves - moved);
+	}
+
+	return moved;
+}
+
+void MemoryPoolDynamicSizeClass::_compact_thread_func(void *p_ud) {
+
+	MemoryPoolDynamicSizeClass *pool = (MemoryPoolDynamicSizeClass *)p_ud;
+
+	while (!pool->compact_exit) {
+
+		pool->compact(COMPACT_MOVES_PER_STEP);
+		OS::get_singleton()->delay_usec(COMPACT_INTERVAL_USEC);
+	}
+}
+
+void MemoryPoolDynamicSizeClass::set_background_compaction(bool p_enable) {
+
+#ifndef NO_THREADS
+	if (p_enable == (compact_thread != NULL))
+		return;
+
+	if (p_enable) {
+
+		compact_exit = false;
+		compact_thread = Thread::create(_compact_thread_func, this);
+	} else {
+
+		compact_exit = true;
+		Thread::wait_to_finish(compact_thread);
+		memdelete(compact_thread);
+		compact_thread = NULL;
+	}
+#endif
+}
+
+MemoryPoolDynamicSizeClass::MemoryPoolDynamicSizeClass() {
+
+	for (int i = 0; i < MAX_SLOTS; i++) {
+
+		slots[i].lock = 0;
+		slots[i].next_free = i + 1;
+		slots[i].check = 0;
+		slots[i].mem = NULL;
+		slots[i].size = 0;
+		slots[i].capacity = 0;
+		slots[i].page = NULL;
+		slots[i].page_prev = MAX_SLOTS;
+		slots[i].page_next = MAX_SLOTS;
+		slots[i].descr = NULL;
+	}
+
+	for (int i = 0; i < SMALL_CLASSES; i++) {
+
+		size_classes[i].partial = NULL;
+		size_classes[i].page_count = 0;
+	}
+
+	first_free_slot = 0;
+	last_check = 0;
+	total_usage = 0;
+	max_usage = 0;
+	reserved = 0;
+	max_reserved = 0;
+	moves = 0;
+	compact_thread = NULL;
+	compact_exit = false;
+}
+
+MemoryPoolDynamicSizeClass::~MemoryPoolDynamicSizeClass() {
+
+	set_background_compaction(false);
+
+#ifdef DEBUG_MEMORY_ENABLED
+
+	if (OS::get_singleton()->is_stdout_verbose()) {
+
+		if (total_usage > 0) {
+
+			ERR_PRINT("DYNAMIC ALLOC: ** MEMORY LEAKS DETECTED **");
+			ERR_PRINT(String("DYNAMIC ALLOC: " + String::num(total_usage) + " bytes of memory in use at exit.").ascii().get_data());
+
+			ERR_PRINT("DYNAMIC ALLOC: Following is the list of leaked allocations:");
+
+			for (int i = 0; i < MAX_SLOTS; i++) {
+
+				if (slots[i].mem) {
+
+					ERR_PRINT(String("\t" + String::num(slots[i].size) + " bytes - " + String(slots[i].descr)).ascii().get_data());
+				}
+			}
+
+			ERR_PRINT("DYNAMIC ALLOC: End of Report.");
+
+			print_line("INFO: dynmem - max: " + itos(max_usage) + ", " + itos(total_usage) + " leaked.");
+		} else {
+
+			print_line("INFO: dynmem - max: " + itos(max_usage) + ", no leaks.");
+		}
+
+		print_line("INFO: dynmem - max reserved: " + itos(max_reserved) + ", compaction moves: " + itos(moves) + ".");
+	}
+
+#endif
+
+	//release the spare pages, leaked blocks keep theirs
+	for (int i = 0; i < SMALL_CLASSES; i++) {
+
+		Page *p = size_classes[i].partial;
+		while (p) {
+
+			Page *next = p->next;
+			if (p->live == 0) {
+				_unlink_page(p);
+				_destroy_page(p);
+			}
+			p = next;
+		}
+	}
+}
@@ -0,0 +1,161 @@
+/*************************************************************************/
+/*  memory_pool_dynamic_size_class.h                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef MEMORY_POOL_DYNAMIC_SIZE_CLASS_H
+#define MEMORY_POOL_DYNAMIC_SIZE_CLASS_H
+
+#include "os/memory_pool_dynamic.h"
+#include "os/thread.h"
+#include "os/thread_safe.h"
+#include "typedefs.h"
+
+/**
+ * Dynamic pool that rounds allocations up to size classes.
+ * Blocks of up to SMALL_MAX bytes are carved from pages shared by the
+ * allocations of the same class, larger ones are allocated on their own.
+ * The slack in a block lets realloc() grow in place, which is what
+ * DVector::resize() and push_back() ask for all the time.
+ *
+ * IDs resolve through a fixed slot table, so lock(), get(), unlock() and
+ * the size queries never take the mutex; alloc(), free(), realloc() and
+ * compact() do. A block is only moved after its slot is claimed with
+ * SLOT_MOVING, which fails while the block is locked and makes lock() wait
+ * until the move is done.
+ */
+
+class MemoryPoolDynamicSizeClass : public MemoryPoolDynamic {
+
+	_THREAD_SAFE_CLASS_
+
+	enum {
+		MAX_SLOTS = 65536,
+		PAGE_SIZE = 65536,
+		SMALL_MAX = 4096,
+		SMALL_CLASSES = 28,
+		COMPACT_MOVES_PER_STEP = 256,
+		COMPACT_INTERVAL_USEC = 100000
+	};
+
+	enum {
+		SLOT_LOCK_MASK = 0x7FFFFFFF,
+		SLOT_MOVING = 0x80000000
+	};
+
+	struct Page {
+
+		uint8_t *mem;
+		uint8_t *free_list; // freed blocks, linked through their first bytes
+		int size_class;
+		int block_count;
+		int carved; // blocks handed out at least once
+		int live;
+		uint32_t first_slot; // slots with a block here, linked through Slot::page_next
+		Page *prev;
+		Page *next;
+	};
+
+	struct SizeClass {
+
+		Page *partial; // pages with at least one free block
+		int page_count;
+	};
+
+	struct Slot {
+
+		uint32_t lock;
+		uint32_t next_free;
+		uint64_t check;
+		uint8_t *mem;
+		size_t size;
+		size_t capacity;
+		Page *page; // NULL for blocks allocated on their own
+		uint32_t page_prev;
+		uint32_t page_next;
+		const char *descr;
+	};
+
+	Slot slots[MAX_SLOTS];
+	uint32_t first_free_slot;
+	SizeClass size_classes[SMALL_CLASSES];
+	uint64_t last_check;
+	size_t total_usage;
+	size_t max_usage;
+	size_t reserved;
+	size_t max_reserved;
+	uint64_t moves;
+
+	Thread *compact_thread;
+	volatile bool compact_exit;
+
+	static int _get_size_class(size_t p_size);
+	static size_t _get_class_size(int p_class);
+
+	Slot *_get_slot(ID p_id);
+	const Slot *_get_slot(ID p_id) const;
+	bool _claim_slot(Slot *p_slot);
+	void _release_slot(Slot *p_slot);
+	void _page_add_slot(Page *p_page, uint32_t p_slot);
+	void _page_remove_slot(Page *p_page, uint32_t p_slot);
+
+	void _link_page(Page *p_page);
+	void _unlink_page(Page *p_page);
+	Page *_create_page(int p_class);
+	void _destroy_page(Page *p_page);
+
+	uint8_t *_alloc_block(size_t p_size, size_t *r_capacity, Page **r_page);
+	void _free_block(uint8_t *p_mem, size_t p_capacity, Page *p_page);
+	int _compact_page(Page *p_page, int p_max_moves);
+
+	static void _compact_thread_func(void *p_ud);
+
+public:
+	virtual ID alloc(size_t p_amount, const char *p_description);
+	virtual void free(ID p_id);
+	virtual Error realloc(ID p_id, size_t p_amount);
+	virtual bool is_valid(ID p_id);
+	virtual size_t get_size(ID p_id) const;
+	virtual const char *get_description(ID p_id) const;
+
+	virtual bool is_locked(ID p_id) const;
+	virtual Error lock(ID p_id);
+	virtual void *get(ID p_ID);
+	virtual Error unlock(ID p_id);
+
+	virtual size_t get_available_mem() const;
+	virtual size_t get_total_usage() const;
+	virtual size_t get_reserved_mem() const;
+
+	int compact(int p_max_moves); ///< move blocks out of the emptiest pages, returns how many were moved
+	virtual void set_background_compaction(bool p_enable);
+
+	MemoryPoolDynamicSizeClass();
+	virtual ~MemoryPoolDynamicSizeClass();
+};
+
+#endif
@@ -57,6 +57,7 @@ public:
 	virtual void *get_alloc_ptr(int p_alloc_idx) = 0;
 	virtual const char *get_alloc_description(int p_alloc_idx) = 0;
 	virtual size_t get_alloc_size(int p_alloc_idx) = 0;
+	virtual uint64_t get_alloc_calls() = 0; ///< allocations and reallocations made so far
 
 	virtual void dump_mem_to_file(const char *p_file) = 0;
 
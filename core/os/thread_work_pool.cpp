@@ -0,0 +1,120 @@
+/*************************************************************************/
+/*  thread_work_pool.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "thread_work_pool.h"
+#include "os/os.h"
+
+void ThreadWorkPool::_thread_function(void *p_user) {
+
+	ThreadData *thread = (ThreadData *)p_user;
+
+	while (true) {
+		thread->start->wait();
+		if (thread->exit) {
+			break;
+		}
+		thread->work->work();
+		thread->completed->post();
+	}
+}
+
+void ThreadWorkPool::_dispatch(BaseWork *p_work) {
+
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].work = p_work;
+		threads[i].start->post();
+	}
+
+	// the calling thread helps too, instead of just sleeping
+	p_work->work();
+
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].completed->wait();
+		threads[i].work = NULL;
+	}
+}
+
+void ThreadWorkPool::init(int p_thread_count) {
+
+	ERR_FAIL_COND(threads != NULL);
+
+	if (p_thread_count <= 0) {
+		p_thread_count = OS::get_singleton()->get_processor_count();
+	}
+
+	if (p_thread_count < 2 || !OS::get_singleton()->can_use_threads()) {
+		return; // do_work() will just loop on the calling thread
+	}
+
+	thread_count = p_thread_count - 1;
+	threads = memnew_arr(ThreadData, thread_count);
+
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].pool = this;
+		threads[i].exit = false;
+		threads[i].work = NULL;
+		threads[i].start = Semaphore::create();
+		threads[i].completed = Semaphore::create();
+		threads[i].thread = Thread::create(&ThreadWorkPool::_thread_function, &threads[i]);
+	}
+}
+
+void ThreadWorkPool::finish() {
+
+	if (!threads) {
+		return;
+	}
+
+	for (int i = 0; i < thread_count; i++) {
+		threads[i].exit = true;
+		threads[i].start->post();
+	}
+
+	for (int i = 0; i < thread_count; i++) {
+		Thread::wait_to_finish(threads[i].thread);
+		memdelete(threads[i].thread);
+		memdelete(threads[i].start);
+		memdelete(threads[i].completed);
+	}
+
+	memdelete_arr(threads);
+	threads = NULL;
+	thread_count = 0;
+}
+
+ThreadWorkPool::ThreadWorkPool() {
+
+	threads = NULL;
+	thread_count = 0;
+}
+
+ThreadWorkPool::~ThreadWorkPool() {
+
+	finish();
+}
@@ -237,10 +237,9 @@ public:
 
 	Ref(T *p_reference) {
 
+		reference = NULL;
 		if (p_reference)
 			ref_pointer(p_reference);
-		else
-			reference = NULL;
 	}
 
 	Ref(const Variant &p_variant) {
@@ -34,6 +34,7 @@
 #include "compressed_translation.h"
 #include "core/io/xml_parser.h"
 #include "core_string_names.h"
+#include "frame_allocator.h"
 #include "func_ref.h"
 #include "geometry.h"
 #include "globals.h"
@@ -45,6 +46,7 @@
 #include "io/pck_packer.h"
 #include "io/resource_format_binary.h"
 #include "io/resource_format_xml.h"
+#include "io/resource_load_queue.h"
 #include "io/stream_peer_ssl.h"
 #include "io/tcp_server.h"
 #include "io/translation_loader_po.h"
@@ -74,6 +76,9 @@ static IP *ip = NULL;
 
 static _Geometry *_geometry = NULL;
 
+static FrameAllocator *frame_allocator = NULL;
+static ResourceLoadQueue *resource_load_queue = NULL;
+
 extern Mutex *_global_mutex;
 
 extern void register_variant_methods();
@@ -89,6 +94,9 @@ void register_core_types() {
 
 	CoreStringNames::create();
 
+	frame_allocator = memnew(FrameAllocator(FrameAllocator::DEFAULT_BLOCK_SIZE, true));
+	resource_load_queue = memnew(ResourceLoadQueue(true));
+
 	resource_format_po = memnew(TranslationLoaderPO);
 	ResourceLoader::add_resource_format_loader(resource_format_po);
 
@@ -173,6 +181,8 @@ void register_core_singletons() {
 
 void unregister_core_types() {
 
+	memdelete(resource_load_queue);
+
 	memdelete(_resource_loader);
 	memdelete(_resource_saver);
 	memdelete(_os);
@@ -198,6 +208,8 @@ void unregister_core_types() {
 
 	ObjectDB::cleanup();
 
+	memdelete(frame_allocator);
+
 	unregister_variant_methods();
 
 	Color::cleanup();
@@ -153,26 +153,31 @@ void Resource::set_path(const String &p_path, bool p_take_over) {
 	if (path_cache == p_path)
 		return;
 
-	if (path_cache != "") {
+	{
+		//resources may be loaded from threads, see ResourceLoadQueue
+		GLOBAL_LOCK_FUNCTION
 
-		ResourceCache::resources.erase(path_cache);
-	}
+		if (path_cache != "") {
 
-	path_cache = "";
-	if (ResourceCache::resources.has(p_path)) {
-		if (p_take_over) {
+			ResourceCache::resources.erase(path_cache);
+		}
+
+		path_cache = "";
+		if (ResourceCache::resources.has(p_path)) {
+			if (p_take_over) {
 
-			ResourceCache::resources.get(p_path)->set_name("");
-		} else {
-			ERR_EXPLAIN("Another resource is loaded from path: " + p_path);
-			ERR_FAIL_COND(ResourceCache::resources.has(p_path));
+				ResourceCache::resources.get(p_path)->set_name("");
+			} else {
+				ERR_EXPLAIN("Another resource is loaded from path: " + p_path);
+				ERR_FAIL_COND(ResourceCache::resources.has(p_path));
+			}
 		}
-	}
-	path_cache = p_path;
+		path_cache = p_path;
 
-	if (path_cache != "") {
+		if (path_cache != "") {
 
-		ResourceCache::resources[path_cache] = this;
+			ResourceCache::resources[path_cache] = this;
+		}
 	}
 
 	_change_notify("resource/path");
@@ -364,8 +369,10 @@ Resource::Resource() {
 
 Resource::~Resource() {
 
-	if (path_cache != "")
+	if (path_cache != "") {
+		GLOBAL_LOCK_FUNCTION
 		ResourceCache::resources.erase(path_cache);
+	}
 	if (owners.size()) {
 		WARN_PRINT("Resource is still owned");
 	}
@@ -408,8 +415,24 @@ Resource *ResourceCache::get(const String &p_path) {
 	return *res;
 }
 
+Ref<Resource> ResourceCache::get_ref(const String &p_path) {
+
+	//holding the lock keeps the resource from being erased while referencing it,
+	//and Ref won't take a resource whose refcount already dropped to zero
+	GLOBAL_LOCK_FUNCTION
+
+	Resource **res = resources.getptr(p_path);
+	if (!res) {
+		return Ref<Resource>();
+	}
+
+	return Ref<Resource>(*res);
+}
+
 void ResourceCache::get_cached_resources(List<Ref<Resource> > *p_resources) {
 
+	GLOBAL_LOCK_FUNCTION
+
 	const String *K = NULL;
 	while ((K = resources.next(K))) {
 
@@ -420,6 +443,8 @@ void ResourceCache::get_cached_resources(List<Ref<Resource> > *p_resources) {
 
 int ResourceCache::get_cached_resource_count() {
 
+	GLOBAL_LOCK_FUNCTION
+
 	return resources.size();
 }
 
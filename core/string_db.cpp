@@ -29,6 +29,7 @@
 /*************************************************************************/
 #include "string_db.h"
 #include "os/os.h"
+#include "os/thread.h"
 #include "print_string.h"
 StaticCString StaticCString::create(const char *p_ptr) {
 	StaticCString scs;
@@ -36,7 +37,10 @@ StaticCString StaticCString::create(const char *p_ptr) {
 	return scs;
 }
 
-StringName::_Data *StringName::_table[STRING_TABLE_LEN];
+StringName::_Data *volatile StringName::_table[STRING_TABLE_LEN];
+StringName::_Data *StringName::_retired = NULL;
+StringName::_ReaderSlot StringName::_readers[READER_SLOTS];
+uint32_t StringName::_misses = 0;
 
 StringName _scs_create(const char *p_chr) {
 
@@ -52,6 +56,12 @@ void StringName::setup() {
 
 		_table[i] = NULL;
 	}
+	for (int i = 0; i < READER_SLOTS; i++) {
+
+		_readers[i].active = 0;
+		_readers[i].hits = 0;
+	}
+	_misses = 0;
 	configured = true;
 }
 
@@ -78,12 +88,36 @@ void StringName::cleanup() {
 			memdelete(d);
 		}
 	}
+	while (_retired) {
+
+		_Data *d = _retired;
+		_retired = d->retired_next;
+		memdelete(d);
+	}
 	if (OS::get_singleton()->is_stdout_verbose() && lost_strings) {
 		print_line("StringName: " + itos(lost_strings) + " unclaimed string names at exit.");
 	}
 	_global_unlock();
 }
 
+void StringName::_free_retired() {
+
+	//must be called with the global lock held, after unlinking
+	for (int i = 0; i < READER_SLOTS; i++) {
+
+		//atomic read, also a full barrier so the unlinking is visible before checking
+		if (atomic_add(&_readers[i].active, 0) != 0)
+			return; //someone may still be walking over them, try on the next unref
+	}
+
+	while (_retired) {
+
+		_Data *d = _retired;
+		_retired = d->retired_next;
+		memdelete(d);
+	}
+}
+
 void StringName::unref() {
 
 	ERR_FAIL_COND(!configured);
@@ -104,13 +138,129 @@ void StringName::unref() {
 		if (_data->next) {
 			_data->next->prev = _data->prev;
 		}
-		memdelete(_data);
+
+		//a lookup may be standing on it, keep its next pointer valid until it's safe to free
+		_data->retired_next = _retired;
+		_retired = _data;
+		_free_retired();
+
 		_global_unlock();
 	}
 
 	_data = NULL;
 }
 
+/* comparing against the stored name directly, get_name() would allocate a String for static names */
+
+static _FORCE_INLINE_ bool _name_equals(const char *p_cname, const String &p_name, const char *p_other) {
+
+	return p_cname ? (p_cname == p_other || strcmp(p_cname, p_other) == 0) : p_name == p_other;
+}
+
+static _FORCE_INLINE_ bool _name_equals(const char *p_cname, const String &p_name, const CharType *p_other) {
+
+	if (!p_cname)
+		return p_name == p_other;
+
+	while (*p_cname && CharType(*p_cname) == *p_other) {
+		p_cname++;
+		p_other++;
+	}
+	return CharType(*p_cname) == *p_other;
+}
+
+static _FORCE_INLINE_ bool _name_equals(const char *p_cname, const String &p_name, const String &p_other) {
+
+	return p_cname ? p_other == p_cname : p_name == p_other;
+}
+
+template <class T>
+StringName::_Data *StringName::_lookup(const T &p_name, uint32_t p_hash) {
+
+	//thread IDs may be aligned pointers, mix them before picking a slot
+	_ReaderSlot &slot = _readers[hash_one_uint64(Thread::get_caller_ID()) % READER_SLOTS];
+	atomic_increment(&slot.active); //full barrier, nothing unlinked from now on will be freed
+
+	_Data *d = _table[p_hash & STRING_TABLE_MASK];
+
+	while (d) {
+
+		// compare hash first
+		if (d->hash == p_hash && _name_equals(d->cname, d->name, p_name))
+			break;
+		d = d->next;
+	}
+
+	if (d && !d->refcount.ref())
+		d = NULL; //being released, the locked path will create it again
+
+	atomic_decrement(&slot.active);
+
+	if (d)
+		atomic_increment(&slot.hits);
+
+	return d;
+}
+
+template <class T>
+StringName::_Data *StringName::_intern(const T &p_name, uint32_t p_hash, const char *p_cname) {
+
+	_Data *d = _lookup(p_name, p_hash);
+	if (d)
+		return d;
+
+	_global_lock();
+
+	uint32_t idx = p_hash & STRING_TABLE_MASK;
+
+	//check again, it may have been added while not locked
+	d = _table[idx];
+	while (d) {
+
+		if (d->hash == p_hash && _name_equals(d->cname, d->name, p_name) && d->refcount.ref()) {
+			_global_unlock();
+			return d;
+		}
+		d = d->next;
+	}
+
+	d = memnew(_Data);
+	if (p_cname)
+		d->cname = p_cname;
+	else
+		d->name = p_name;
+	d->refcount.init();
+	d->hash = p_hash;
+	d->idx = idx;
+	d->next = _table[idx];
+	d->prev = NULL;
+
+	//also a full barrier, the entry is complete before lookups can reach it
+	atomic_increment(&_misses);
+
+	if (_table[idx])
+		_table[idx]->prev = d;
+	_table[idx] = d;
+
+	_global_unlock();
+
+	return d;
+}
+
+uint32_t StringName::get_intern_hits() {
+
+	uint32_t hits = 0;
+	for (int i = 0; i < READER_SLOTS; i++) {
+		hits += _readers[i].hits;
+	}
+	return hits;
+}
+
+uint32_t StringName::get_intern_misses() {
+
+	return _misses;
+}
+
 bool StringName::operator==(const String &p_name) const {
 
 	if (!_data) {
@@ -118,7 +268,7 @@ bool StringName::operator==(const String &p_name) const {
 		return (p_name.length() == 0);
 	}
 
-	return (_data->get_name() == p_name);
+	return _name_equals(_data->cname, _data->name, p_name);
 }
 
 bool StringName::operator==(const char *p_name) const {
@@ -128,7 +278,7 @@ bool StringName::operator==(const char *p_name) const {
 		return (p_name[0] == 0);
 	}
 
-	return (_data->get_name() == p_name);
+	return _name_equals(_data->cname, _data->name, p_name);
 }
 
 bool StringName::operator!=(const String &p_name) const {
@@ -182,44 +332,7 @@ StringName::StringName(const char *p_name) {
 
 	ERR_FAIL_COND(!p_name || !p_name[0]);
 
-	_global_lock();
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name)
-			break;
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			_global_unlock();
-			return;
-		} else {
-		}
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = NULL;
-	_data->next = _table[idx];
-	_data->prev = NULL;
-	if (_table[idx])
-		_table[idx]->prev = _data;
-	_table[idx] = _data;
-
-	_global_unlock();
+	_data = _intern(p_name, String::hash(p_name), NULL);
 }
 
 StringName::StringName(const StaticCString &p_static_string) {
@@ -230,44 +343,8 @@ StringName::StringName(const StaticCString &p_static_string) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	_global_lock();
-
-	uint32_t hash = String::hash(p_static_string.ptr);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr)
-			break;
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			_global_unlock();
-			return;
-		} else {
-		}
-	}
-
-	_data = memnew(_Data);
-
-	_data->refcount.init();
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = NULL;
-	if (_table[idx])
-		_table[idx]->prev = _data;
-	_table[idx] = _data;
-
-	_global_unlock();
+	//static names compare by pointer first, so looking them up again is cheap
+	_data = _intern(p_static_string.ptr, String::hash(p_static_string.ptr), p_static_string.ptr);
 }
 
 StringName::StringName(const String &p_name) {
@@ -279,43 +356,7 @@ StringName::StringName(const String &p_name) {
 	if (p_name.empty())
 		return;
 
-	_global_lock();
-
-	uint32_t hash = p_name.hash();
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_data = _table[idx];
-
-	while (_data) {
-
-		if (_data->hash == hash && _data->get_name() == p_name)
-			break;
-		_data = _data->next;
-	}
-
-	if (_data) {
-		if (_data->refcount.ref()) {
-			// exists
-			_global_unlock();
-			return;
-		} else {
-		}
-	}
-
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = NULL;
-	_data->next = _table[idx];
-	_data->prev = NULL;
-	if (_table[idx])
-		_table[idx]->prev = _data;
-	_table[idx] = _data;
-
-	_global_unlock();
+	_data = _intern(p_name, p_name.hash(), NULL);
 }
 
 StringName StringName::search(const char *p_name) {
@@ -326,29 +367,8 @@ StringName StringName::search(const char *p_name) {
 	if (!p_name[0])
 		return StringName();
 
-	_global_lock();
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name)
-			break;
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		_global_unlock();
-		return StringName(_data);
-	}
-
-	_global_unlock();
-	return StringName(); //does not exist
+	_Data *d = _lookup(p_name, String::hash(p_name));
+	return d ? StringName(d) : StringName(); //does not exist
 }
 
 StringName StringName::search(const CharType *p_name) {
@@ -359,57 +379,15 @@ StringName StringName::search(const CharType *p_name) {
 	if (!p_name[0])
 		return StringName();
 
-	_global_lock();
-
-	uint32_t hash = String::hash(p_name);
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name)
-			break;
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		_global_unlock();
-		return StringName(_data);
-	}
-
-	_global_unlock();
-	return StringName(); //does not exist
+	_Data *d = _lookup(p_name, String::hash(p_name));
+	return d ? StringName(d) : StringName(); //does not exist
 }
 StringName StringName::search(const String &p_name) {
 
 	ERR_FAIL_COND_V(p_name == "", StringName());
 
-	_global_lock();
-
-	uint32_t hash = p_name.hash();
-
-	uint32_t idx = hash & STRING_TABLE_MASK;
-
-	_Data *_data = _table[idx];
-
-	while (_data) {
-
-		// compare hash first
-		if (_data->hash == hash && p_name == _data->get_name())
-			break;
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		_global_unlock();
-		return StringName(_data);
-	}
-
-	_global_unlock();
-	return StringName(); //does not exist
+	_Data *d = _lookup(p_name, p_name.hash());
+	return d ? StringName(d) : StringName(); //does not exist
 }
 
 StringName::StringName() {
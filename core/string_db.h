@@ -50,7 +50,8 @@ class StringName {
 
 		STRING_TABLE_BITS = 12,
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MASK = STRING_TABLE_LEN - 1,
+		READER_SLOTS = 16
 	};
 
 	struct _Data {
@@ -62,15 +63,35 @@ class StringName {
 		int idx;
 		uint32_t hash;
 		_Data *prev;
-		_Data *next;
+		_Data *volatile next;
+		_Data *retired_next;
 		_Data() {
 			cname = NULL;
 			next = prev = NULL;
+			retired_next = NULL;
 			hash = 0;
 		}
 	};
 
-	static _Data *_table[STRING_TABLE_LEN];
+	/* Lookups walk the table without locking. Each reader marks itself active in the
+	 * slot picked by its thread ID, and unlinked entries are only freed (under the
+	 * global lock) once no slot is active. */
+	struct _ReaderSlot {
+		uint32_t active;
+		uint32_t hits;
+		uint8_t padding[56]; // one cache line per slot
+	};
+
+	static _Data *volatile _table[STRING_TABLE_LEN];
+	static _Data *_retired;
+	static _ReaderSlot _readers[READER_SLOTS];
+	static uint32_t _misses;
+
+	template <class T>
+	static _Data *_lookup(const T &p_name, uint32_t p_hash);
+	template <class T>
+	static _Data *_intern(const T &p_name, uint32_t p_hash, const char *p_cname);
+	static void _free_retired();
 
 	_Data *_data;
 
@@ -130,6 +151,9 @@ public:
 	static StringName search(const CharType *p_name);
 	static StringName search(const String &p_name);
 
+	static uint32_t get_intern_hits();
+	static uint32_t get_intern_misses();
+
 	struct AlphCompare {
 
 		_FORCE_INLINE_ bool operator()(const StringName &l, const StringName &r) const {
@@ -162,8 +162,29 @@ bool String::operator!=(const String &p_str) const {
 
 String String::operator+(const String &p_str) const {
 
-	String res = *this;
-	res += p_str;
+	if (empty())
+		return p_str;
+	if (p_str.empty())
+		return *this;
+
+	// build the result in one allocation, copying this string first would allocate twice
+	int len = length();
+	int other_len = p_str.length();
+
+	String res;
+	res.resize(len + other_len + 1);
+
+	CharType *dst = res.ptr();
+	const CharType *src = c_str();
+	for (int i = 0; i < len; i++)
+		dst[i] = src[i];
+
+	src = p_str.c_str();
+	for (int i = 0; i < other_len; i++)
+		dst[len + i] = src[i];
+
+	dst[len + other_len] = 0;
+
 	return res;
 }
 
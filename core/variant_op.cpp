@@ -2941,8 +2941,8 @@ bool Variant::iter_init(Variant &r_iter, bool &valid) const {
 			if (dic->empty())
 				return false;
 
-			const Variant *next = dic->next(NULL);
-			r_iter = *next;
+			//the iterator is the entry position, so stepping needs no lookup
+			r_iter = dic->next_position();
 			return true;
 
 		} break;
@@ -3065,11 +3065,11 @@ bool Variant::iter_next(Variant &r_iter, bool &valid) const {
 		case DICTIONARY: {
 
 			const Dictionary *dic = reinterpret_cast<const Dictionary *>(_data._mem);
-			const Variant *next = dic->next(&r_iter);
-			if (!next)
+			int pos = dic->next_position(r_iter);
+			if (pos < 0)
 				return false;
 
-			r_iter = *next;
+			r_iter = pos;
 			return true;
 
 		} break;
@@ -3198,7 +3198,13 @@ Variant Variant::iter_get(const Variant &r_iter, bool &r_valid) const {
 		} break;
 		case DICTIONARY: {
 
-			return r_iter; //iterator is the same as the key
+			const Dictionary *dic = reinterpret_cast<const Dictionary *>(_data._mem);
+			const Variant *key = dic->get_key_at_position(r_iter);
+			if (!key) {
+				r_valid = false;
+				return Variant();
+			}
+			return *key;
 
 		} break;
 		case ARRAY: {
@@ -92,7 +92,7 @@ class Vector {
 	void _unref(void *p_data);
 
 	void _copy_from(const Vector &p_from);
-	void _copy_on_write();
+	void _copy_on_write(int p_reserve = 0);
 
 public:
 	_FORCE_INLINE_ T *ptr() {
@@ -180,6 +180,23 @@ public:
 	void operator=(const Vector &p_from);
 	Vector(const Vector &p_from);
 
+#if __cplusplus >= 201103L
+	// moving takes over the buffer, no refcounting needed
+	void operator=(Vector &&p_from) {
+
+		if (_ptr == p_from._ptr)
+			return;
+		_unref(_ptr);
+		_ptr = p_from._ptr;
+		p_from._ptr = NULL;
+	}
+	Vector(Vector &&p_from) {
+
+		_ptr = p_from._ptr;
+		p_from._ptr = NULL;
+	}
+#endif
+
 	_FORCE_INLINE_ Vector();
 	_FORCE_INLINE_ ~Vector();
 };
@@ -209,14 +226,14 @@ void Vector<T>::_unref(void *p_data) {
 }
 
 template <class T>
-void Vector<T>::_copy_on_write() {
+void Vector<T>::_copy_on_write(int p_reserve) {
 
 	if (!_ptr)
 		return;
 
 	if (_get_refcount()->get() > 1) {
-		/* in use by more than me */
-		void *mem_new = memalloc(_get_alloc_size(*_get_size()));
+		/* in use by more than me, p_reserve allows resize() to allocate the final size at once */
+		void *mem_new = memalloc(_get_alloc_size(MAX(*_get_size(), p_reserve)));
 		SafeRefCount *src_new = (SafeRefCount *)mem_new;
 		src_new->init();
 		int *_size = (int *)(src_new + 1);
@@ -269,12 +286,13 @@ Error Vector<T>::resize(int p_size) {
 		return OK;
 	}
 
-	// possibly changing size, copy on write
-	_copy_on_write();
-
 	size_t alloc_size;
 	ERR_FAIL_COND_V(!_get_alloc_size_checked(p_size, &alloc_size), ERR_OUT_OF_MEMORY);
 
+	// possibly changing size, copy on write
+	bool copied = _ptr && _get_refcount()->get() > 1;
+	_copy_on_write(p_size);
+
 	if (p_size > size()) {
 
 		if (size() == 0) {
@@ -285,7 +303,9 @@ Error Vector<T>::resize(int p_size) {
 			_get_refcount()->init(); // init refcount
 			*_get_size() = 0; // init size (currently, none)
 
-		} else {
+		} else if (!copied && alloc_size != _get_alloc_size(*_get_size())) {
+			// allocations are rounded to a power of two, so only reallocate when that changes.
+			// a copy made above was already allocated for p_size.
 			void *_ptrnew = (T *)memrealloc((uint8_t *)_ptr - sizeof(int) - sizeof(SafeRefCount), alloc_size);
 			ERR_FAIL_COND_V(!_ptrnew, ERR_OUT_OF_MEMORY);
 			_ptr = (T *)((uint8_t *)_ptrnew + sizeof(int) + sizeof(SafeRefCount));
@@ -310,10 +330,12 @@ Error Vector<T>::resize(int p_size) {
 			t->~T();
 		}
 
-		void *_ptrnew = (T *)memrealloc((uint8_t *)_ptr - sizeof(int) - sizeof(SafeRefCount), alloc_size);
-		ERR_FAIL_COND_V(!_ptrnew, ERR_OUT_OF_MEMORY);
+		if (alloc_size != _get_alloc_size(*_get_size())) {
+			void *_ptrnew = (T *)memrealloc((uint8_t *)_ptr - sizeof(int) - sizeof(SafeRefCount), alloc_size);
+			ERR_FAIL_COND_V(!_ptrnew, ERR_OUT_OF_MEMORY);
 
-		_ptr = (T *)((uint8_t *)_ptrnew + sizeof(int) + sizeof(SafeRefCount));
+			_ptr = (T *)((uint8_t *)_ptrnew + sizeof(int) + sizeof(SafeRefCount));
+		}
 
 		*_get_size() = p_size;
 	}
@@ -1520,10 +1520,10 @@ void RasterizerGLES1::mesh_add_surface(RID p_mesh,VS::PrimitiveType p_primitive,
 			} break;
 			case VS::ARRAY_BONES: {
 
-				elem_size=VS::ARRAY_WEIGHTS_SIZE*sizeof(GLuint);
+				elem_size=VS::ARRAY_WEIGHTS_SIZE*sizeof(GLushort);
 				elem_count=VS::ARRAY_WEIGHTS_SIZE;
 				valid_local=false;
-				datatype=GL_FLOAT;
+				datatype=GL_UNSIGNED_SHORT;
 
 
 			} break;
@@ -1873,20 +1873,31 @@ Error RasterizerGLES1::_surface_set_arrays(Surface *p_surface, uint8_t *p_mem,ui
 
 				p_surface->max_bone=0;
 
-				for (int i=0;i<p_surface->array_len;i++) {
+				if (ai==VS::ARRAY_BONES) {
 
-					GLfloat data[VS::ARRAY_WEIGHTS_SIZE];
-					for (int j=0;j<VS::ARRAY_WEIGHTS_SIZE;j++) {
-						data[j]=src[i*VS::ARRAY_WEIGHTS_SIZE+j];
-						if (ai==VS::ARRAY_BONES) {
+					//skeleton_xform() reads bone indices as shorts
+					for (int i=0;i<p_surface->array_len;i++) {
 
+						GLushort data[VS::ARRAY_WEIGHTS_SIZE];
+						for (int j=0;j<VS::ARRAY_WEIGHTS_SIZE;j++) {
+							data[j]=src[i*VS::ARRAY_WEIGHTS_SIZE+j];
 							p_surface->max_bone=MAX(data[j],p_surface->max_bone);
 						}
+
+						copymem(&p_mem[a.ofs+i*stride], data, a.size);
 					}
 
-					copymem(&p_mem[a.ofs+i*stride], data, a.size);
+				} else {
+
+					for (int i=0;i<p_surface->array_len;i++) {
 
+						GLfloat data[VS::ARRAY_WEIGHTS_SIZE];
+						for (int j=0;j<VS::ARRAY_WEIGHTS_SIZE;j++) {
+							data[j]=src[i*VS::ARRAY_WEIGHTS_SIZE+j];
+						}
 
+						copymem(&p_mem[a.ofs+i*stride], data, a.size);
+					}
 				}
 
 			} break;
@@ -2684,106 +2695,46 @@ RID RasterizerGLES1::skeleton_create() {
 	ERR_FAIL_COND_V(!skeleton,RID());
 	return skeleton_owner.make_rid( skeleton );
 }
-#if 0
-template <bool USE_NORMAL, bool USE_TANGENT, bool INPLACE>
-void RasterizerGLES1::_skeleton_xform(const uint8_t *p_src_array, int p_src_stride, uint8_t *p_dst_array, int p_dst_stride, int p_elements, const uint8_t *p_src_bones, const uint8_t *p_src_weights, const Skeleton::Bone *p_bone_xforms) {
-
-	uint32_t basesize = 3;
-	if (USE_NORMAL)
-		basesize += 3;
-	if (USE_TANGENT)
-		basesize += 4;
-
-	uint32_t extra = (p_dst_stride - basesize * 4);
-	const int dstvec_size = 3 + (USE_NORMAL ? 3 : 0) + (USE_TANGENT ? 4 : 0);
-	float dstcopy[dstvec_size];
-
-	for (int i = 0; i < p_elements; i++) {
-
-		uint32_t ss = p_src_stride * i;
-		uint32_t ds = p_dst_stride * i;
-		const uint16_t *bi = (const uint16_t *)&p_src_bones[ss];
-		const float *bw = (const float *)&p_src_weights[ss];
-		const float *src_vec = (const float *)&p_src_array[ss];
-		float *dst_vec;
-		if (INPLACE)
-			dst_vec = dstcopy;
-		else
-			dst_vec = (float *)&p_dst_array[ds];
-
-		dst_vec[0] = 0.0;
-		dst_vec[1] = 0.0;
-		dst_vec[2] = 0.0;
-		//conditionals simply removed by optimizer
-		if (USE_NORMAL) {
-
-			dst_vec[3] = 0.0;
-			dst_vec[4] = 0.0;
-			dst_vec[5] = 0.0;
 
-			if (USE_TANGENT) {
+void RasterizerGLES1::_skeleton_xform(uint32_t p_format, const uint8_t *p_src_array, int p_src_stride, uint8_t *p_dst_array, int p_dst_stride, int p_elements, const uint8_t *p_src_bones, const uint8_t *p_src_weights, int p_bones_stride, const Skeleton::Bone *p_bone_xforms) {
 
-				dst_vec[6] = 0.0;
-				dst_vec[7] = 0.0;
-				dst_vec[8] = 0.0;
-				dst_vec[9] = src_vec[9];
-			}
-		} else {
-
-			if (USE_TANGENT) {
-
-				dst_vec[3] = 0.0;
-				dst_vec[4] = 0.0;
-				dst_vec[5] = 0.0;
-				dst_vec[6] = src_vec[6];
-			}
-		}
+	SkeletonXformArrays arrays;
+	arrays.src=p_src_array;
+	arrays.src_stride=p_src_stride;
+	arrays.dst=p_dst_array;
+	arrays.dst_stride=p_dst_stride;
+	arrays.bones=p_src_bones;
+	arrays.weights=p_src_weights;
+	arrays.bones_stride=p_bones_stride;
+	arrays.bone_mtx=&p_bone_xforms[0].mtx[0][0];
+	arrays.elements=p_elements;
 
-#define _XFORM_BONE(m_idx)                                                                     \
-	if (bw[m_idx] == 0)                                                                        \
-		goto end;                                                                              \
-	p_bone_xforms[bi[m_idx]].transform_add_mul3(&src_vec[0], &dst_vec[0], bw[m_idx]);          \
-	if (USE_NORMAL) {                                                                          \
-		p_bone_xforms[bi[m_idx]].transform3_add_mul3(&src_vec[3], &dst_vec[3], bw[m_idx]);     \
-		if (USE_TANGENT) {                                                                     \
-			p_bone_xforms[bi[m_idx]].transform3_add_mul3(&src_vec[6], &dst_vec[6], bw[m_idx]); \
-		}                                                                                      \
-	} else {                                                                                   \
-		if (USE_TANGENT) {                                                                     \
-			p_bone_xforms[bi[m_idx]].transform3_add_mul3(&src_vec[3], &dst_vec[3], bw[m_idx]); \
-		}                                                                                      \
-	}
-
-		_XFORM_BONE(0);
-		_XFORM_BONE(1);
-		_XFORM_BONE(2);
-		_XFORM_BONE(3);
-
-	end:
+	bool use_normal = p_format&VS::ARRAY_FORMAT_NORMAL;
+	bool use_tangent = p_format&VS::ARRAY_FORMAT_TANGENT;
 
-		if (INPLACE) {
+	//no skinning threads here, the whole mesh is done in one go
+	if (p_src_array==p_dst_array) {
 
-			const uint8_t *esp = (const uint8_t *)dstcopy;
-			uint8_t *edp = (uint8_t *)&p_dst_array[ds];
-
-			for (uint32_t j = 0; j < dstvec_size * 4; j++) {
-
-				edp[j] = esp[j];
-			}
-
-		} else {
-			//copy extra stuff
-			const uint8_t *esp = (const uint8_t *)&src_vec[basesize];
-			uint8_t *edp = (uint8_t *)&dst_vec[basesize];
-
-			for (uint32_t j = 0; j < extra; j++) {
+		if (use_normal && use_tangent)
+			skeleton_xform<true,true,true>(arrays,0,p_elements);
+		else if (use_normal)
+			skeleton_xform<true,false,true>(arrays,0,p_elements);
+		else if (use_tangent)
+			skeleton_xform<false,true,true>(arrays,0,p_elements);
+		else
+			skeleton_xform<false,false,true>(arrays,0,p_elements);
+	} else {
 
-				edp[j] = esp[j];
-			}
-		}
+		if (use_normal && use_tangent)
+			skeleton_xform<true,true,false>(arrays,0,p_elements);
+		else if (use_normal)
+			skeleton_xform<true,false,false>(arrays,0,p_elements);
+		else if (use_tangent)
+			skeleton_xform<false,true,false>(arrays,0,p_elements);
+		else
+			skeleton_xform<false,false,false>(arrays,0,p_elements);
 	}
 }
-#endif
 void RasterizerGLES1::skeleton_resize(RID p_skeleton,int p_bones) {
 
 
@@ -2810,7 +2761,20 @@ void RasterizerGLES1::skeleton_bone_set_transform(RID p_skeleton,int p_bone, con
 	ERR_FAIL_COND(!skeleton);
 	ERR_FAIL_INDEX( p_bone, skeleton->bones.size() );
 
-	skeleton->bones[p_bone] = p_transform;
+	Skeleton::Bone &b = skeleton->bones[p_bone];
+
+	b.mtx[0][0]=p_transform.basis[0][0];
+	b.mtx[0][1]=p_transform.basis[1][0];
+	b.mtx[0][2]=p_transform.basis[2][0];
+	b.mtx[1][0]=p_transform.basis[0][1];
+	b.mtx[1][1]=p_transform.basis[1][1];
+	b.mtx[1][2]=p_transform.basis[2][1];
+	b.mtx[2][0]=p_transform.basis[0][2];
+	b.mtx[2][1]=p_transform.basis[1][2];
+	b.mtx[2][2]=p_transform.basis[2][2];
+	b.mtx[3][0]=p_transform.origin[0];
+	b.mtx[3][1]=p_transform.origin[1];
+	b.mtx[3][2]=p_transform.origin[2];
 }
 
 Transform RasterizerGLES1::skeleton_bone_get_transform(RID p_skeleton,int p_bone) {
@@ -2819,8 +2783,23 @@ Transform RasterizerGLES1::skeleton_bone_get_transform(RID p_skeleton,int p_bone
 	ERR_FAIL_COND_V(!skeleton, Transform());
 	ERR_FAIL_INDEX_V( p_bone, skeleton->bones.size(), Transform() );
 
-	// something
-	return skeleton->bones[p_bone];
+	const Skeleton::Bone &b = skeleton->bones[p_bone];
+
+	Transform t;
+	t.basis[0][0]=b.mtx[0][0];
+	t.basis[1][0]=b.mtx[0][1];
+	t.basis[2][0]=b.mtx[0][2];
+	t.basis[0][1]=b.mtx[1][0];
+	t.basis[1][1]=b.mtx[1][1];
+	t.basis[2][1]=b.mtx[1][2];
+	t.basis[0][2]=b.mtx[2][0];
+	t.basis[1][2]=b.mtx[2][1];
+	t.basis[2][2]=b.mtx[2][2];
+	t.origin[0]=b.mtx[3][0];
+	t.origin[1]=b.mtx[3][1];
+	t.origin[2]=b.mtx[3][2];
+
+	return t;
 }
 
 
@@ -4087,102 +4066,27 @@ Error RasterizerGLES1::_setup_geometry(const Geometry *p_geometry, const Materia
 						}
 					}
 
-				} else if (skeleton_valid) {
-
-					base = skinned_buffer;
-					//copy stuff and get it ready for the skeleton
+					if (skeleton_valid) {
+						//morphed vertices are skinned in place, bones and weights stay in the local array
 
-					int len = surf->array_len;
-					int src_stride = surf->stride;
-					int dst_stride = surf->stride - ( surf->array[VS::ARRAY_BONES].size + surf->array[VS::ARRAY_WEIGHTS].size );
+						const uint8_t *src_weights=&surf->array_local[surf->array[VS::ARRAY_WEIGHTS].ofs];
+						const uint8_t *src_bones=&surf->array_local[surf->array[VS::ARRAY_BONES].ofs];
+						const Skeleton::Bone *skeleton = &p_skeleton->bones[0];
 
-					for(int i=0;i<len;i++) {
-						const uint8_t *src = &surf->array_local[i*src_stride];
-						uint8_t *dst = &base[i*dst_stride];
-						memcpy(dst,src,dst_stride);
+						_skeleton_xform(surf->format, base, stride, base, stride, surf->array_len, src_bones, src_weights, surf->stride, skeleton);
 					}
 
+				} else if (skeleton_valid) {
 
-					stride=dst_stride;
-				}
-
-
-				if (skeleton_valid) {
-					//transform stuff
-
+					base = skinned_buffer;
+					//skinning copies the rest of each vertex, dropping bones and weights
+					int dst_stride = surf->stride - ( surf->array[VS::ARRAY_BONES].size + surf->array[VS::ARRAY_WEIGHTS].size );
 					const uint8_t *src_weights=&surf->array_local[surf->array[VS::ARRAY_WEIGHTS].ofs];
 					const uint8_t *src_bones=&surf->array_local[surf->array[VS::ARRAY_BONES].ofs];
-					int src_stride = surf->stride;
-					int count = surf->array_len;
-					const Transform *skeleton = &p_skeleton->bones[0];
-
-					for(int i=0;i<VS::ARRAY_MAX-1;i++) {
-
-						const Surface::ArrayData& ad=surf->array[i];
-						if (ad.size==0)
-							continue;
-
-						int ofs = ad.ofs;
-
-
-						switch(i) {
-
-							case VS::ARRAY_VERTEX: {
-								for(int k=0;k<count;k++) {
-
-									float *ptr=  (float*)&base[ofs+k*stride];
-									const GLfloat* weights = reinterpret_cast<const GLfloat*>(&src_weights[k*src_stride]);
-									const GLfloat *bones = reinterpret_cast<const GLfloat*>(&src_bones[k*src_stride]);
-
-									Vector3 src( ptr[0], ptr[1], ptr[2] );
-									Vector3 dst;
-									for(int j=0;j<VS::ARRAY_WEIGHTS_SIZE;j++) {
-
-										float w = weights[j];
-										if (w==0)
-											break;
-
-										//print_line("accum "+itos(i)+" += "+rtos(Math::ftoi(bones[j]))+" * "+skeleton[ Math::ftoi(bones[j]) ]+" * "+rtos(w));
-										dst+=skeleton[ Math::fast_ftoi(bones[j]) ].xform(src) * w;
-									}
-
-									ptr[0]=dst.x;
-									ptr[1]=dst.y;
-									ptr[2]=dst.z;
-
-								} break;
-
-							} break;
-							case VS::ARRAY_NORMAL:
-							case VS::ARRAY_TANGENT: {
-								for(int k=0;k<count;k++) {
-
-									float *ptr=  (float*)&base[ofs+k*stride];
-									const GLfloat* weights = reinterpret_cast<const GLfloat*>(&src_weights[k*src_stride]);
-									const GLfloat *bones = reinterpret_cast<const GLfloat*>(&src_bones[k*src_stride]);
-
-									Vector3 src( ptr[0], ptr[1], ptr[2] );
-									Vector3 dst;
-									for(int j=0;j<VS::ARRAY_WEIGHTS_SIZE;j++) {
-
-										float w = weights[j];
-										if (w==0)
-											break;
-
-										//print_line("accum "+itos(i)+" += "+rtos(Math::ftoi(bones[j]))+" * "+skeleton[ Math::ftoi(bones[j]) ]+" * "+rtos(w));
-										dst+=skeleton[ Math::fast_ftoi(bones[j]) ].basis.xform(src) * w;
-									}
-
-									ptr[0]=dst.x;
-									ptr[1]=dst.y;
-									ptr[2]=dst.z;
-
-								} break;
-
-							} break;
-						}
-					}
+					const Skeleton::Bone *skeleton = &p_skeleton->bones[0];
 
+					_skeleton_xform(surf->format, surf->array_local, surf->stride, base, dst_stride, surf->array_len, src_bones, src_weights, surf->stride, skeleton);
+					stride=dst_stride;
 				}
 
 
@@ -5399,30 +5303,14 @@ void RasterizerGLES1::canvas_draw_line(const Point2& p_from, const Point2& p_to,
 
 }
 
-static void _draw_textured_quad(const Rect2& p_rect, const Rect2& p_src_region, const Size2& p_tex_size,bool p_flip_h=false,bool p_flip_v=false ) {
-	Vector3 texcoords[4]= {
-		Vector3( p_src_region.pos.x/p_tex_size.width,
-		p_src_region.pos.y/p_tex_size.height, 0),
-
-		Vector3((p_src_region.pos.x+p_src_region.size.width)/p_tex_size.width,
-		p_src_region.pos.y/p_tex_size.height, 0),
-
-		Vector3( (p_src_region.pos.x+p_src_region.size.width)/p_tex_size.width,
-		(p_src_region.pos.y+p_src_region.size.height)/p_tex_size.height, 0),
+static void _draw_textured_quad(const Rect2& p_rect, const Rect2& p_src_region, const Size2& p_tex_size,bool p_flip_h=false,bool p_flip_v=false,bool p_transpose=false ) {
 
-		Vector3( p_src_region.pos.x/p_tex_size.width,
-		(p_src_region.pos.y+p_src_region.size.height)/p_tex_size.height, 0)
-	};
+	Vector2 uvs[4];
+	RasterizerCanvasBatch::get_textured_quad_uvs(p_src_region,p_tex_size,p_flip_h,p_flip_v,p_transpose,uvs);
 
-
-	if (p_flip_h) {
-		SWAP( texcoords[0], texcoords[1] );
-		SWAP( texcoords[2], texcoords[3] );
-	}
-	if (p_flip_v) {
-		SWAP( texcoords[1], texcoords[2] );
-		SWAP( texcoords[0], texcoords[3] );
-	}
+	Vector3 texcoords[4];
+	for(int i=0;i<4;i++)
+		texcoords[i]=Vector3(uvs[i].x,uvs[i].y,0);
 
 	Vector3 coords[4]= {
 		Vector3( p_rect.pos.x, p_rect.pos.y, 0 ),
@@ -5467,12 +5355,12 @@ void RasterizerGLES1::canvas_draw_rect(const Rect2& p_rect, int p_flags, const R
 		if (!(p_flags&CANVAS_RECT_REGION)) {
 
 			Rect2 region = Rect2(0,0,texture->width,texture->height);
-			_draw_textured_quad(p_rect,region,region.size,p_flags&CANVAS_RECT_FLIP_H,p_flags&CANVAS_RECT_FLIP_V);
+			_draw_textured_quad(p_rect,region,region.size,p_flags&CANVAS_RECT_FLIP_H,p_flags&CANVAS_RECT_FLIP_V,p_flags&CANVAS_RECT_TRANSPOSE);
 
 		} else {
 
 
-			_draw_textured_quad(p_rect, p_source, Size2(texture->width,texture->height),p_flags&CANVAS_RECT_FLIP_H,p_flags&CANVAS_RECT_FLIP_V );
+			_draw_textured_quad(p_rect, p_source, Size2(texture->width,texture->height),p_flags&CANVAS_RECT_FLIP_H,p_flags&CANVAS_RECT_FLIP_V,p_flags&CANVAS_RECT_TRANSPOSE );
 
 		}
 	} else {
@@ -5496,6 +5384,11 @@ void RasterizerGLES1::_canvas_item_render_commands(CanvasItem *p_item, CanvasIte
 
 // 		CanvasItem::Command **commands = &cc->commands[0];
 
+		//a transformed batch doesn't depend on the modelview matrix set by TYPE_TRANSFORM
+		bool batchable = c->type == CanvasItem::Command::TYPE_RECT || c->type == CanvasItem::Command::TYPE_STYLE || c->type == CanvasItem::Command::TYPE_POLYGON || c->type == CanvasItem::Command::TYPE_POLYGON_PTR || (c->type == CanvasItem::Command::TYPE_TRANSFORM && canvas_batch.has_transform());
+		if (!batchable) {
+			_canvas_batch_flush();
+		}
 
 
 
@@ -5510,6 +5403,10 @@ void RasterizerGLES1::_canvas_item_render_commands(CanvasItem *p_item, CanvasIte
 
 				CanvasItem::CommandRect *rect = static_cast<CanvasItem::CommandRect *>(c);
 
+				if (!use_normalmap && use_canvas_batching && _canvas_batch_rect(rect))
+					break;
+				_canvas_batch_flush();
+
 				int flags = rect->flags;
 //  				if (use_normalmap)
 // 					_canvas_normal_set_flip(Vector2((flags & CANVAS_RECT_FLIP_H) ? -1 : 1, (flags & CANVAS_RECT_FLIP_V) ? -1 : 1));
@@ -5519,6 +5416,9 @@ void RasterizerGLES1::_canvas_item_render_commands(CanvasItem *p_item, CanvasIte
 			case CanvasItem::Command::TYPE_STYLE: {
 
 				CanvasItem::CommandStyle *style = static_cast<CanvasItem::CommandStyle *>(c);
+				if (!use_normalmap && use_canvas_batching && _canvas_batch_style_box(style))
+					break;
+				_canvas_batch_flush();
 // 				if (use_normalmap)
 // 					_canvas_normal_set_flip(Vector2(1, 1));
 				canvas_draw_style_box(style->rect, style->source, style->texture, style->margin, style->draw_center, style->color);
@@ -5536,6 +5436,9 @@ void RasterizerGLES1::_canvas_item_render_commands(CanvasItem *p_item, CanvasIte
 // 				if (use_normalmap)
 //  					_canvas_normal_set_flip(Vector2(1, 1));
 				CanvasItem::CommandPolygon *polygon = static_cast<CanvasItem::CommandPolygon *>(c);
+				if (!use_normalmap && use_canvas_batching && _canvas_batch_polygon(polygon->count, polygon->indices.ptr(), polygon->points.ptr(), polygon->uvs.ptr(), polygon->colors.ptr(), polygon->texture, polygon->colors.size() == 1))
+					break;
+				_canvas_batch_flush();
 				canvas_draw_polygon(polygon->count, polygon->indices.ptr(), polygon->points.ptr(), polygon->uvs.ptr(), polygon->colors.ptr(), polygon->texture, polygon->colors.size() == 1);
 
 			} break;
@@ -5545,6 +5448,9 @@ void RasterizerGLES1::_canvas_item_render_commands(CanvasItem *p_item, CanvasIte
 //  				if (use_normalmap)
 //  					_canvas_normal_set_flip(Vector2(1, 1));
 				CanvasItem::CommandPolygonPtr *polygon = static_cast<CanvasItem::CommandPolygonPtr *>(c);
+				if (!use_normalmap && use_canvas_batching && _canvas_batch_polygon(polygon->count, polygon->indices, polygon->points, polygon->uvs, polygon->colors, polygon->texture, false))
+					break;
+				_canvas_batch_flush();
 				canvas_draw_polygon(polygon->count, polygon->indices, polygon->points, polygon->uvs, polygon->colors, polygon->texture, false);
 			} break;
 			case CanvasItem::Command::TYPE_CIRCLE: {
@@ -5569,6 +5475,8 @@ void RasterizerGLES1::_canvas_item_render_commands(CanvasItem *p_item, CanvasIte
 
 				CanvasItem::CommandTransform *transform = static_cast<CanvasItem::CommandTransform *>(c);
 				canvas_set_transform(transform->xform);
+				if (canvas_batch.has_transform())
+					canvas_batch.set_transform(canvas_item_xform * transform->xform);
 			} break;
 			case CanvasItem::Command::TYPE_BLEND_MODE: {
 
@@ -5652,9 +5560,15 @@ void RasterizerGLES1::canvas_render_items(CanvasItem *p_item_list, int p_z, cons
 
 
 
+		//the batch is kept open across items until the blend mode or clip changes
+		if (ci->blend_mode != blend_mode)
+			_canvas_batch_flush();
+
 		canvas_begin_rect(ci->final_transform);
 		canvas_set_opacity(ci->final_opacity);
 		canvas_set_blend_mode(ci->blend_mode);
+		canvas_item_xform = ci->final_transform;
+		canvas_batch.set_transform(ci->final_transform);
 
 
 
@@ -5664,6 +5578,7 @@ void RasterizerGLES1::canvas_render_items(CanvasItem *p_item_list, int p_z, cons
 
 		if (current_clip != ci->final_clip_owner) {
 
+			_canvas_batch_flush();
 			current_clip = ci->final_clip_owner;
 
 			//setup clip
@@ -5759,6 +5674,8 @@ void RasterizerGLES1::canvas_render_items(CanvasItem *p_item_list, int p_z, cons
 
 					//intersects this light
 
+					_canvas_batch_flush();
+
 					if (!light_used || mode != light->mode) {
 
 						mode = light->mode;
@@ -5808,6 +5725,7 @@ void RasterizerGLES1::canvas_render_items(CanvasItem *p_item_list, int p_z, cons
 
 		if (reclip) {
 
+			_canvas_batch_flush();
 			glEnable(GL_SCISSOR_TEST);
 			//glScissor(viewport.x+current_clip->final_clip_rect.pos.x,viewport.y+ (viewport.height-(current_clip->final_clip_rect.pos.y+current_clip->final_clip_rect.size.height)),
 			//current_clip->final_clip_rect.size.width,current_clip->final_clip_rect.size.height);
@@ -5836,13 +5754,14 @@ void RasterizerGLES1::canvas_render_items(CanvasItem *p_item_list, int p_z, cons
 		canvas_end_rect();
 	}
 
+	_canvas_batch_flush();
+
 	if (current_clip) {
 		glDisable(GL_SCISSOR_TEST);
 	}
 }
 
 void RasterizerGLES1::canvas_draw_style_box(const Rect2 &p_rect, const Rect2 &p_src_region, RID p_texture, const float *p_margin, bool p_draw_center, const Color &p_modulate) {
-	print_line("canvas_draw_style_box");
 	_set_glcoloro( p_modulate,canvas_opacity );
 
 
@@ -5853,61 +5772,19 @@ void RasterizerGLES1::canvas_draw_style_box(const Rect2 &p_rect, const Rect2 &p_
 	//glActiveTexture(GL_TEXTURE0);
 	glBindTexture( GL_TEXTURE_2D,texture->tex_id );
 
+	Rect2 region = p_src_region;
+	if (region.size.width <= 0)
+		region.size.width = texture->width;
+	if (region.size.height <= 0)
+		region.size.height = texture->height;
 
-	/* CORNERS */
-
-	_draw_textured_quad( // top left
-		Rect2( p_rect.pos, Size2(p_margin[MARGIN_LEFT],p_margin[MARGIN_TOP])),
-		Rect2( Point2(), Size2(p_margin[MARGIN_LEFT],p_margin[MARGIN_TOP])),
-		Size2( texture->width, texture->height ) );
-
-	_draw_textured_quad( // top right
-		Rect2( Point2( p_rect.pos.x + p_rect.size.width - p_margin[MARGIN_RIGHT], p_rect.pos.y), Size2(p_margin[MARGIN_RIGHT],p_margin[MARGIN_TOP])),
-		Rect2( Point2(texture->width-p_margin[MARGIN_RIGHT],0), Size2(p_margin[MARGIN_RIGHT],p_margin[MARGIN_TOP])),
-		Size2( texture->width, texture->height ) );
-
-
-	_draw_textured_quad( // bottom left
-		Rect2( Point2(p_rect.pos.x,p_rect.pos.y + p_rect.size.height - p_margin[MARGIN_BOTTOM]), Size2(p_margin[MARGIN_LEFT],p_margin[MARGIN_BOTTOM])),
-		Rect2( Point2(0,texture->height-p_margin[MARGIN_BOTTOM]), Size2(p_margin[MARGIN_LEFT],p_margin[MARGIN_BOTTOM])),
-		Size2( texture->width, texture->height ) );
-
-	_draw_textured_quad( // bottom right
-		Rect2( Point2( p_rect.pos.x + p_rect.size.width - p_margin[MARGIN_RIGHT], p_rect.pos.y + p_rect.size.height - p_margin[MARGIN_BOTTOM]), Size2(p_margin[MARGIN_RIGHT],p_margin[MARGIN_BOTTOM])),
-		Rect2( Point2(texture->width-p_margin[MARGIN_RIGHT],texture->height-p_margin[MARGIN_BOTTOM]), Size2(p_margin[MARGIN_RIGHT],p_margin[MARGIN_BOTTOM])),
-		Size2( texture->width, texture->height ) );
-
-	Rect2 rect_center( p_rect.pos+Point2( p_margin[MARGIN_LEFT], p_margin[MARGIN_TOP]), Size2( p_rect.size.width - p_margin[MARGIN_LEFT] - p_margin[MARGIN_RIGHT], p_rect.size.height - p_margin[MARGIN_TOP] - p_margin[MARGIN_BOTTOM] ));
-
-	Rect2 src_center( Point2( p_margin[MARGIN_LEFT], p_margin[MARGIN_TOP]), Size2( texture->width - p_margin[MARGIN_LEFT] - p_margin[MARGIN_RIGHT], texture->height - p_margin[MARGIN_TOP] - p_margin[MARGIN_BOTTOM] ));
+	Rect2 rects[9];
+	Rect2 sources[9];
+	int count = RasterizerCanvasBatch::get_style_box_quads(p_rect, region, p_margin, p_draw_center, rects, sources);
 
+	for (int i = 0; i < count; i++) {
 
-	_draw_textured_quad( // top
-		Rect2( Point2(rect_center.pos.x,p_rect.pos.y),Size2(rect_center.size.width,p_margin[MARGIN_TOP])),
-		Rect2( Point2(p_margin[MARGIN_LEFT],0), Size2(src_center.size.width,p_margin[MARGIN_TOP])),
-		Size2( texture->width, texture->height ) );
-
-	_draw_textured_quad( // bottom
-		Rect2( Point2(rect_center.pos.x,rect_center.pos.y+rect_center.size.height),Size2(rect_center.size.width,p_margin[MARGIN_BOTTOM])),
-		Rect2( Point2(p_margin[MARGIN_LEFT],src_center.pos.y+src_center.size.height), Size2(src_center.size.width,p_margin[MARGIN_BOTTOM])),
-		Size2( texture->width, texture->height ) );
-
-	_draw_textured_quad( // left
-		Rect2( Point2(p_rect.pos.x,rect_center.pos.y),Size2(p_margin[MARGIN_LEFT],rect_center.size.height)),
-		Rect2( Point2(0,p_margin[MARGIN_TOP]), Size2(p_margin[MARGIN_LEFT],src_center.size.height)),
-		Size2( texture->width, texture->height ) );
-
-	_draw_textured_quad( // right
-		Rect2( Point2(rect_center.pos.x+rect_center.size.width,rect_center.pos.y),Size2(p_margin[MARGIN_RIGHT],rect_center.size.height)),
-		Rect2( Point2(src_center.pos.x+src_center.size.width,p_margin[MARGIN_TOP]), Size2(p_margin[MARGIN_RIGHT],src_center.size.height)),
-		Size2( texture->width, texture->height ) );
-
-	if (p_draw_center) {
-
-		_draw_textured_quad(
-			rect_center,
-			src_center,
-			Size2( texture->width, texture->height ));
+		_draw_textured_quad(rects[i], sources[i], Size2(texture->width, texture->height));
 	}
 
 }
@@ -5948,7 +5825,6 @@ static uint16_t _draw_poly_indices[_max_draw_poly_indices];
 static float _verts3[_max_draw_poly_indices];
 
 void RasterizerGLES1::canvas_draw_polygon(int p_vertex_count, const int* p_indices, const Vector2* p_vertices, const Vector2* p_uvs, const Color* p_colors,const RID& p_texture,bool p_singlecolor) {
-	print_line("canvas_draw_polygon");
 	bool do_colors=false;
 
 	//reset_state();
@@ -5961,8 +5837,6 @@ void RasterizerGLES1::canvas_draw_polygon(int p_vertex_count, const int* p_indic
 	} else
 		do_colors=true;
 
-	glColor4f(1, 1, 1, 1);
-
 	Texture* texture = NULL;
 	if (p_texture.is_valid()) {
 		glEnable(GL_TEXTURE_2D);
@@ -5971,6 +5845,8 @@ void RasterizerGLES1::canvas_draw_polygon(int p_vertex_count, const int* p_indic
 			//glActiveTexture(GL_TEXTURE0);
 			glBindTexture( GL_TEXTURE_2D,texture->tex_id );
 		}
+	} else {
+		glDisable(GL_TEXTURE_2D);
 	}
 
 	glEnableClientState(GL_VERTEX_ARRAY);
@@ -6011,6 +5887,133 @@ void RasterizerGLES1::canvas_draw_polygon(int p_vertex_count, const int* p_indic
 
 }
 
+bool RasterizerGLES1::_canvas_batch_begin(const RID &p_texture, int p_vertices, int p_indices) {
+
+	if (!RasterizerCanvasBatch::fits(p_vertices, p_indices))
+		return false; //would never fit, draw it on its own
+
+	if (!canvas_batch.can_add(p_texture, p_vertices, p_indices))
+		_canvas_batch_flush();
+
+	return true;
+}
+
+bool RasterizerGLES1::_canvas_batch_rect(const CanvasItem::CommandRect *p_rect) {
+
+	Texture *texture = NULL;
+	if (p_rect->texture.is_valid()) {
+		texture = texture_owner.get(p_rect->texture);
+		if (!texture)
+			return false;
+	}
+
+	if (!_canvas_batch_begin(p_rect->texture, RasterizerCanvasBatch::QUAD_VERTICES, RasterizerCanvasBatch::QUAD_INDICES))
+		return false;
+
+	Color m = p_rect->modulate;
+	m.a *= canvas_opacity;
+
+	Size2 tex_size = texture ? Size2(texture->width, texture->height) : Size2();
+	canvas_batch.add_rect(p_rect->texture, tex_size, p_rect->rect, p_rect->flags, p_rect->source, m);
+
+	return true;
+}
+
+bool RasterizerGLES1::_canvas_batch_style_box(const CanvasItem::CommandStyle *p_style) {
+
+	Texture *texture = texture_owner.get(p_style->texture);
+	if (!texture)
+		return false;
+
+	if (!_canvas_batch_begin(p_style->texture, RasterizerCanvasBatch::STYLE_BOX_VERTICES, RasterizerCanvasBatch::STYLE_BOX_INDICES))
+		return false;
+
+	Color m = p_style->color;
+	m.a *= canvas_opacity;
+
+	canvas_batch.add_style_box(p_style->texture, Size2(texture->width, texture->height), p_style->rect, p_style->source, p_style->margin, p_style->draw_center, m);
+
+	return true;
+}
+
+bool RasterizerGLES1::_canvas_batch_polygon(int p_vertex_count, const int *p_indices, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, const RID &p_texture, bool p_singlecolor) {
+
+	RID tex;
+	if (p_texture.is_valid()) {
+		if (!texture_owner.get(p_texture))
+			return false;
+		tex = p_texture;
+	}
+
+	if (!_canvas_batch_begin(tex, p_vertex_count, p_vertex_count))
+		return false;
+
+	Color m(1, 1, 1, canvas_opacity);
+	if (p_singlecolor) {
+		m = *p_colors;
+		m.a *= canvas_opacity;
+	}
+
+	canvas_batch.add_polygon(tex, p_vertex_count, p_indices, p_vertices, p_uvs, p_singlecolor ? NULL : p_colors, m);
+
+	return true;
+}
+
+void RasterizerGLES1::_canvas_batch_flush() {
+
+	if (canvas_batch.is_empty())
+		return;
+
+	Texture *texture = canvas_batch.get_texture().is_valid() ? texture_owner.get(canvas_batch.get_texture()) : NULL;
+
+	if (texture) {
+
+		glEnable(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, texture->tex_id);
+	} else {
+
+		glDisable(GL_TEXTURE_2D);
+	}
+
+	if (canvas_batch.has_transform()) {
+
+		//vertices are in canvas space already, only the viewport mapping is left
+		glMatrixMode(GL_MODELVIEW);
+		glPushMatrix();
+		glLoadIdentity();
+		glScalef(2.0 / viewport.width, -2.0 / viewport.height, 0);
+		glTranslatef((-(viewport.width / 2.0)), (-(viewport.height / 2.0)), 0);
+	}
+
+	const RasterizerCanvasBatch::Vertex *vertices = canvas_batch.get_vertices();
+	int stride = sizeof(RasterizerCanvasBatch::Vertex);
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(2, GL_FLOAT, stride, &vertices[0].vertex);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glColorPointer(4, GL_FLOAT, stride, &vertices[0].color);
+
+	if (texture) {
+
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(2, GL_FLOAT, stride, &vertices[0].uv);
+	} else {
+
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	}
+
+	glDrawElements(GL_TRIANGLES, canvas_batch.get_index_count(), GL_UNSIGNED_SHORT, canvas_batch.get_indices());
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+	if (canvas_batch.has_transform())
+		glPopMatrix();
+
+	canvas_batch.clear();
+}
+
 RID RasterizerGLES1::canvas_light_occluder_create() {
 
 	CanvasOccluder *co = memnew(CanvasOccluder);
@@ -6966,6 +6969,8 @@ void RasterizerGLES1::init() {
 	skinned_buffer_size = GLOBAL_DEF("rasterizer/skinned_buffer_size",DEFAULT_SKINNED_BUFFER_SIZE);
 	skinned_buffer = memnew_arr( uint8_t, skinned_buffer_size );
 
+	use_canvas_batching = GLOBAL_DEF("rasterizer/use_canvas_batching",true);
+
 	glGenTextures(1, &white_tex);
 	unsigned char whitetexdata[8*8*3];
 	for(int i=0;i<8*8*3;i++) {
@@ -54,6 +54,8 @@
 
 
 #include "servers/visual/particle_system_sw.h"
+#include "servers/visual/rasterizer_canvas_batch.h"
+#include "drivers/gles2/skeleton_xform_gles2.h"
 
 /**
         @author Juan Linietsky <reduzio@gmail.com>
@@ -447,7 +449,21 @@ class RasterizerGLES1 : public Rasterizer {
 
 	struct Skeleton {
 
-		Vector<Transform> bones;
+		struct Bone {
+
+			float mtx[4][4]; //column major, as skeleton_xform() reads it
+
+			Bone() {
+				for(int i=0;i<4;i++) {
+					for(int j=0;j<4;j++) {
+
+						mtx[i][j]=(i==j)?1:0;
+					}
+				}
+			}
+		};
+
+		Vector<Bone> bones;
 
 	};
 
@@ -457,9 +473,7 @@ class RasterizerGLES1 : public Rasterizer {
 
 	void _setup_skeleton(const Skeleton *p_skeleton);
 
-//
-	// template <bool USE_NORMAL, bool USE_TANGENT, bool INPLACE>
-	// void _skeleton_xform(const uint8_t *p_src_array, int p_src_stride, uint8_t *p_dst_array, int p_dst_stride, int p_elements, const uint8_t *p_src_bones, const uint8_t *p_src_weights, const Skeleton::Bone *p_bone_xforms);
+	void _skeleton_xform(uint32_t p_format, const uint8_t *p_src_array, int p_src_stride, uint8_t *p_dst_array, int p_dst_stride, int p_elements, const uint8_t *p_src_bones, const uint8_t *p_src_weights, int p_bones_stride, const Skeleton::Bone *p_bone_xforms);
 
 	Vector<float> skel_default;
 	struct Light {
@@ -937,6 +951,18 @@ struct LightInstance {
 	template <bool use_normalmap>
 	_FORCE_INLINE_ void _canvas_item_render_commands(CanvasItem *p_item, CanvasItem *current_clip, bool &reclip);
 
+	/* CANVAS BATCHING */
+
+	bool use_canvas_batching;
+	RasterizerCanvasBatch canvas_batch;
+	Matrix32 canvas_item_xform;
+
+	bool _canvas_batch_begin(const RID &p_texture, int p_vertices, int p_indices);
+	bool _canvas_batch_rect(const CanvasItem::CommandRect *p_rect);
+	bool _canvas_batch_style_box(const CanvasItem::CommandStyle *p_style);
+	bool _canvas_batch_polygon(int p_vertex_count, const int *p_indices, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, const RID &p_texture, bool p_singlecolor);
+	void _canvas_batch_flush();
+
 public:
 
 	/* TEXTURE API */
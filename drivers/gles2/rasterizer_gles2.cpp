@@ -5133,102 +5133,44 @@ void RasterizerGLES2::_setup_light(uint16_t p_light) {
 }
 
 template <bool USE_NORMAL, bool USE_TANGENT, bool INPLACE>
-void RasterizerGLES2::_skeleton_xform(const uint8_t *p_src_array, int p_src_stride, uint8_t *p_dst_array, int p_dst_stride, int p_elements, const uint8_t *p_src_bones, const uint8_t *p_src_weights, const Skeleton::Bone *p_bone_xforms) {
-
-	uint32_t basesize = 3;
-	if (USE_NORMAL)
-		basesize += 3;
-	if (USE_TANGENT)
-		basesize += 4;
-
-	uint32_t extra = (p_dst_stride - basesize * 4);
-	const int dstvec_size = 3 + (USE_NORMAL ? 3 : 0) + (USE_TANGENT ? 4 : 0);
-	float dstcopy[dstvec_size];
-
-	for (int i = 0; i < p_elements; i++) {
-
-		uint32_t ss = p_src_stride * i;
-		uint32_t ds = p_dst_stride * i;
-		const uint16_t *bi = (const uint16_t *)&p_src_bones[ss];
-		const float *bw = (const float *)&p_src_weights[ss];
-		const float *src_vec = (const float *)&p_src_array[ss];
-		float *dst_vec;
-		if (INPLACE)
-			dst_vec = dstcopy;
-		else
-			dst_vec = (float *)&p_dst_array[ds];
-
-		dst_vec[0] = 0.0;
-		dst_vec[1] = 0.0;
-		dst_vec[2] = 0.0;
-		//conditionals simply removed by optimizer
-		if (USE_NORMAL) {
-
-			dst_vec[3] = 0.0;
-			dst_vec[4] = 0.0;
-			dst_vec[5] = 0.0;
-
-			if (USE_TANGENT) {
-
-				dst_vec[6] = 0.0;
-				dst_vec[7] = 0.0;
-				dst_vec[8] = 0.0;
-				dst_vec[9] = src_vec[9];
-			}
-		} else {
-
-			if (USE_TANGENT) {
-
-				dst_vec[3] = 0.0;
-				dst_vec[4] = 0.0;
-				dst_vec[5] = 0.0;
-				dst_vec[6] = src_vec[6];
-			}
-		}
-
-#define _XFORM_BONE(m_idx)                                                                     \
-	if (bw[m_idx] == 0)                                                                        \
-		goto end;                                                                              \
-	p_bone_xforms[bi[m_idx]].transform_add_mul3(&src_vec[0], &dst_vec[0], bw[m_idx]);          \
-	if (USE_NORMAL) {                                                                          \
-		p_bone_xforms[bi[m_idx]].transform3_add_mul3(&src_vec[3], &dst_vec[3], bw[m_idx]);     \
-		if (USE_TANGENT) {                                                                     \
-			p_bone_xforms[bi[m_idx]].transform3_add_mul3(&src_vec[6], &dst_vec[6], bw[m_idx]); \
-		}                                                                                      \
-	} else {                                                                                   \
-		if (USE_TANGENT) {                                                                     \
-			p_bone_xforms[bi[m_idx]].transform3_add_mul3(&src_vec[3], &dst_vec[3], bw[m_idx]); \
-		}                                                                                      \
-	}
-
-		_XFORM_BONE(0);
-		_XFORM_BONE(1);
-		_XFORM_BONE(2);
-		_XFORM_BONE(3);
-
-	end:
-
-		if (INPLACE) {
-
-			const uint8_t *esp = (const uint8_t *)dstcopy;
-			uint8_t *edp = (uint8_t *)&p_dst_array[ds];
-
-			for (uint32_t j = 0; j < dstvec_size * 4; j++) {
-
-				edp[j] = esp[j];
-			}
-
-		} else {
-			//copy extra stuff
-			const uint8_t *esp = (const uint8_t *)&src_vec[basesize];
-			uint8_t *edp = (uint8_t *)&dst_vec[basesize];
-
-			for (uint32_t j = 0; j < extra; j++) {
+void RasterizerGLES2::_skeleton_xform_chunk(uint32_t p_chunk, const SkeletonXformArrays *p_arrays) {
+
+	int from = p_chunk * SKINNING_CHUNK_SIZE;
+	int to = MIN(from + SKINNING_CHUNK_SIZE, p_arrays->elements);
+	skeleton_xform<USE_NORMAL, USE_TANGENT, INPLACE>(*p_arrays, from, to);
+}
+
+void RasterizerGLES2::_skeleton_xform(uint32_t p_format, const uint8_t *p_src_array, int p_src_stride, uint8_t *p_dst_array, int p_dst_stride, int p_elements, const uint8_t *p_src_bones, const uint8_t *p_src_weights, const Skeleton::Bone *p_bone_xforms) {
+
+	SkeletonXformArrays arrays;
+	arrays.src = p_src_array;
+	arrays.src_stride = p_src_stride;
+	arrays.dst = p_dst_array;
+	arrays.dst_stride = p_dst_stride;
+	arrays.bones = p_src_bones;
+	arrays.weights = p_src_weights;
+	arrays.bones_stride = p_src_stride;
+	arrays.bone_mtx = &p_bone_xforms[0].mtx[0][0];
+	arrays.elements = p_elements;
+
+	bool use_normal = p_format & VS::ARRAY_FORMAT_NORMAL;
+	bool use_tangent = p_format & VS::ARRAY_FORMAT_TANGENT;
+	bool inplace = p_src_array == p_dst_array;
+
+	void (RasterizerGLES2::*chunk_func)(uint32_t, const SkeletonXformArrays *);
+
+	if (use_normal && use_tangent)
+		chunk_func = inplace ? &RasterizerGLES2::_skeleton_xform_chunk<true, true, true> : &RasterizerGLES2::_skeleton_xform_chunk<true, true, false>;
+	else if (use_normal)
+		chunk_func = inplace ? &RasterizerGLES2::_skeleton_xform_chunk<true, false, true> : &RasterizerGLES2::_skeleton_xform_chunk<true, false, false>;
+	else if (use_tangent)
+		chunk_func = inplace ? &RasterizerGLES2::_skeleton_xform_chunk<false, true, true> : &RasterizerGLES2::_skeleton_xform_chunk<false, true, false>;
+	else
+		chunk_func = inplace ? &RasterizerGLES2::_skeleton_xform_chunk<false, false, true> : &RasterizerGLES2::_skeleton_xform_chunk<false, false, false>;
 
-				edp[j] = esp[j];
-			}
-		}
-	}
+	// vertices are independent, so big meshes are split in chunks between the skinning threads
+	int chunk_count = (p_elements + SKINNING_CHUNK_SIZE - 1) / SKINNING_CHUNK_SIZE;
+	skinning_work_pool.do_work(chunk_count, this, chunk_func, (const SkeletonXformArrays *)&arrays);
 }
 
 Error RasterizerGLES2::_setup_geometry(const Geometry *p_geometry, const Material *p_material, const Skeleton *p_skeleton, const float *p_morphs) {
@@ -5444,14 +5386,7 @@ Error RasterizerGLES2::_setup_geometry(const Geometry *p_geometry, const Materia
 						const uint8_t *src_bones = &surf->array_local[surf->array[VS::ARRAY_BONES].ofs];
 						const Skeleton::Bone *skeleton = &p_skeleton->bones[0];
 
-						if (surf->format & VS::ARRAY_FORMAT_NORMAL && surf->format & VS::ARRAY_FORMAT_TANGENT)
-							_skeleton_xform<true, true, true>(base, surf->stride, base, surf->stride, surf->array_len, src_bones, src_weights, skeleton);
-						else if (surf->format & (VS::ARRAY_FORMAT_NORMAL))
-							_skeleton_xform<true, false, true>(base, surf->stride, base, surf->stride, surf->array_len, src_bones, src_weights, skeleton);
-						else if (surf->format & (VS::ARRAY_FORMAT_TANGENT))
-							_skeleton_xform<false, true, true>(base, surf->stride, base, surf->stride, surf->array_len, src_bones, src_weights, skeleton);
-						else
-							_skeleton_xform<false, false, true>(base, surf->stride, base, surf->stride, surf->array_len, src_bones, src_weights, skeleton);
+						_skeleton_xform(surf->format, base, surf->stride, base, surf->stride, surf->array_len, src_bones, src_weights, skeleton);
 					}
 
 					stride = skeleton_valid ? surf->stride : surf->local_stride;
@@ -5548,14 +5483,7 @@ Error RasterizerGLES2::_setup_geometry(const Geometry *p_geometry, const Materia
 					const uint8_t *src_bones = &surf->array_local[surf->array[VS::ARRAY_BONES].ofs];
 					const Skeleton::Bone *skeleton = &p_skeleton->bones[0];
 
-					if (surf->format & VS::ARRAY_FORMAT_NORMAL && surf->format & VS::ARRAY_FORMAT_TANGENT)
-						_skeleton_xform<true, true, false>(surf->array_local, surf->stride, base, dst_stride, surf->array_len, src_bones, src_weights, skeleton);
-					else if (surf->format & (VS::ARRAY_FORMAT_NORMAL))
-						_skeleton_xform<true, false, false>(surf->array_local, surf->stride, base, dst_stride, surf->array_len, src_bones, src_weights, skeleton);
-					else if (surf->format & (VS::ARRAY_FORMAT_TANGENT))
-						_skeleton_xform<false, true, false>(surf->array_local, surf->stride, base, dst_stride, surf->array_len, src_bones, src_weights, skeleton);
-					else
-						_skeleton_xform<false, false, false>(surf->array_local, surf->stride, base, dst_stride, surf->array_len, src_bones, src_weights, skeleton);
+					_skeleton_xform(surf->format, surf->array_local, surf->stride, base, dst_stride, surf->array_len, src_bones, src_weights, skeleton);
 
 					stride = dst_stride;
 				}
@@ -7680,6 +7608,7 @@ void RasterizerGLES2::canvas_draw_line(const Point2 &p_from, const Point2 &p_to,
 	glLineWidth(p_width);
 	_draw_primitive(2, verts, 0, 0, 0);
 	_rinfo.ci_draw_commands++;
+	_rinfo.draw_calls++;
 }
 
 void RasterizerGLES2::_draw_gui_primitive(int p_points, const Vector2 *p_vertices, const Color *p_colors, const Vector2 *p_uvs) {
@@ -7757,6 +7686,7 @@ void RasterizerGLES2::_draw_gui_primitive(int p_points, const Vector2 *p_vertice
 
 #endif
 	_rinfo.ci_draw_commands++;
+	_rinfo.draw_calls++;
 }
 
 void RasterizerGLES2::_draw_gui_primitive2(int p_points, const Vector2 *p_vertices, const Color *p_colors, const Vector2 *p_uvs, const Vector2 *p_uvs2) {
@@ -7791,35 +7721,13 @@ void RasterizerGLES2::_draw_gui_primitive2(int p_points, const Vector2 *p_vertic
 
 	glDrawArrays(prim[p_points], 0, p_points);
 	_rinfo.ci_draw_commands++;
+	_rinfo.draw_calls++;
 }
 
 void RasterizerGLES2::_draw_textured_quad(const Rect2 &p_rect, const Rect2 &p_src_region, const Size2 &p_tex_size, bool p_h_flip, bool p_v_flip, bool p_transpose) {
 
-	Vector2 texcoords[4] = {
-		Vector2(p_src_region.pos.x / p_tex_size.width,
-				p_src_region.pos.y / p_tex_size.height),
-
-		Vector2((p_src_region.pos.x + p_src_region.size.width) / p_tex_size.width,
-				p_src_region.pos.y / p_tex_size.height),
-
-		Vector2((p_src_region.pos.x + p_src_region.size.width) / p_tex_size.width,
-				(p_src_region.pos.y + p_src_region.size.height) / p_tex_size.height),
-
-		Vector2(p_src_region.pos.x / p_tex_size.width,
-				(p_src_region.pos.y + p_src_region.size.height) / p_tex_size.height)
-	};
-
-	if (p_transpose) {
-		SWAP(texcoords[1], texcoords[3]);
-	}
-	if (p_h_flip) {
-		SWAP(texcoords[0], texcoords[1]);
-		SWAP(texcoords[2], texcoords[3]);
-	}
-	if (p_v_flip) {
-		SWAP(texcoords[1], texcoords[2]);
-		SWAP(texcoords[0], texcoords[3]);
-	}
+	Vector2 texcoords[4];
+	RasterizerCanvasBatch::get_textured_quad_uvs(p_src_region, p_tex_size, p_h_flip, p_v_flip, p_transpose, texcoords);
 
 	Vector2 coords[4] = {
 		Vector2(p_rect.pos.x, p_rect.pos.y),
@@ -7901,57 +7809,14 @@ void RasterizerGLES2::canvas_draw_style_box(const Rect2 &p_rect, const Rect2 &p_
 		region.size.width = texture->width;
 	if (region.size.height <= 0)
 		region.size.height = texture->height;
-	/* CORNERS */
-	_draw_textured_quad( // top left
-			Rect2(p_rect.pos, Size2(p_margin[MARGIN_LEFT], p_margin[MARGIN_TOP])),
-			Rect2(region.pos, Size2(p_margin[MARGIN_LEFT], p_margin[MARGIN_TOP])),
-			Size2(texture->width, texture->height));
-
-	_draw_textured_quad( // top right
-			Rect2(Point2(p_rect.pos.x + p_rect.size.width - p_margin[MARGIN_RIGHT], p_rect.pos.y), Size2(p_margin[MARGIN_RIGHT], p_margin[MARGIN_TOP])),
-			Rect2(Point2(region.pos.x + region.size.width - p_margin[MARGIN_RIGHT], region.pos.y), Size2(p_margin[MARGIN_RIGHT], p_margin[MARGIN_TOP])),
-			Size2(texture->width, texture->height));
-
-	_draw_textured_quad( // bottom left
-			Rect2(Point2(p_rect.pos.x, p_rect.pos.y + p_rect.size.height - p_margin[MARGIN_BOTTOM]), Size2(p_margin[MARGIN_LEFT], p_margin[MARGIN_BOTTOM])),
-			Rect2(Point2(region.pos.x, region.pos.y + region.size.height - p_margin[MARGIN_BOTTOM]), Size2(p_margin[MARGIN_LEFT], p_margin[MARGIN_BOTTOM])),
-			Size2(texture->width, texture->height));
 
-	_draw_textured_quad( // bottom right
-			Rect2(Point2(p_rect.pos.x + p_rect.size.width - p_margin[MARGIN_RIGHT], p_rect.pos.y + p_rect.size.height - p_margin[MARGIN_BOTTOM]), Size2(p_margin[MARGIN_RIGHT], p_margin[MARGIN_BOTTOM])),
-			Rect2(Point2(region.pos.x + region.size.width - p_margin[MARGIN_RIGHT], region.pos.y + region.size.height - p_margin[MARGIN_BOTTOM]), Size2(p_margin[MARGIN_RIGHT], p_margin[MARGIN_BOTTOM])),
-			Size2(texture->width, texture->height));
+	Rect2 rects[9];
+	Rect2 sources[9];
+	int count = RasterizerCanvasBatch::get_style_box_quads(p_rect, region, p_margin, p_draw_center, rects, sources);
 
-	Rect2 rect_center(p_rect.pos + Point2(p_margin[MARGIN_LEFT], p_margin[MARGIN_TOP]), Size2(p_rect.size.width - p_margin[MARGIN_LEFT] - p_margin[MARGIN_RIGHT], p_rect.size.height - p_margin[MARGIN_TOP] - p_margin[MARGIN_BOTTOM]));
+	for (int i = 0; i < count; i++) {
 
-	Rect2 src_center(Point2(region.pos.x + p_margin[MARGIN_LEFT], region.pos.y + p_margin[MARGIN_TOP]), Size2(region.size.width - p_margin[MARGIN_LEFT] - p_margin[MARGIN_RIGHT], region.size.height - p_margin[MARGIN_TOP] - p_margin[MARGIN_BOTTOM]));
-
-	_draw_textured_quad( // top
-			Rect2(Point2(rect_center.pos.x, p_rect.pos.y), Size2(rect_center.size.width, p_margin[MARGIN_TOP])),
-			Rect2(Point2(src_center.pos.x, region.pos.y), Size2(src_center.size.width, p_margin[MARGIN_TOP])),
-			Size2(texture->width, texture->height));
-
-	_draw_textured_quad( // bottom
-			Rect2(Point2(rect_center.pos.x, rect_center.pos.y + rect_center.size.height), Size2(rect_center.size.width, p_margin[MARGIN_BOTTOM])),
-			Rect2(Point2(src_center.pos.x, src_center.pos.y + src_center.size.height), Size2(src_center.size.width, p_margin[MARGIN_BOTTOM])),
-			Size2(texture->width, texture->height));
-
-	_draw_textured_quad( // left
-			Rect2(Point2(p_rect.pos.x, rect_center.pos.y), Size2(p_margin[MARGIN_LEFT], rect_center.size.height)),
-			Rect2(Point2(region.pos.x, region.pos.y + p_margin[MARGIN_TOP]), Size2(p_margin[MARGIN_LEFT], src_center.size.height)),
-			Size2(texture->width, texture->height));
-
-	_draw_textured_quad( // right
-			Rect2(Point2(rect_center.pos.x + rect_center.size.width, rect_center.pos.y), Size2(p_margin[MARGIN_RIGHT], rect_center.size.height)),
-			Rect2(Point2(src_center.pos.x + src_center.size.width, region.pos.y + p_margin[MARGIN_TOP]), Size2(p_margin[MARGIN_RIGHT], src_center.size.height)),
-			Size2(texture->width, texture->height));
-
-	if (p_draw_center) {
-
-		_draw_textured_quad(
-				rect_center,
-				src_center,
-				Size2(texture->width, texture->height));
+		_draw_textured_quad(rects[i], sources[i], Size2(texture->width, texture->height));
 	}
 
 	_rinfo.ci_draw_commands++;
@@ -8085,11 +7950,147 @@ void RasterizerGLES2::canvas_draw_polygon(int p_vertex_count, const int *p_indic
 #endif
 
 	_rinfo.ci_draw_commands++;
+	_rinfo.draw_calls++;
 };
 
+bool RasterizerGLES2::_canvas_batch_begin(const RID &p_texture, int p_vertices, int p_indices) {
+
+	if (!RasterizerCanvasBatch::fits(p_vertices, p_indices))
+		return false;
+
+	if (!canvas_batch.can_add(p_texture, p_vertices, p_indices))
+		_canvas_batch_flush();
+
+	return true;
+}
+
+bool RasterizerGLES2::_canvas_batch_rect(const CanvasItem::CommandRect *p_rect) {
+
+	Texture *texture = p_rect->texture.is_valid() ? texture_owner.get(p_rect->texture) : NULL;
+
+	if (p_rect->texture.is_valid() && !texture)
+		return false;
+
+	if (texture && p_rect->flags & CANVAS_RECT_TILE && !(texture->flags & VS::TEXTURE_FLAG_REPEAT))
+		return false; //needs the wrap mode changed for this rect only
+
+	if (!_canvas_batch_begin(p_rect->texture, RasterizerCanvasBatch::QUAD_VERTICES, RasterizerCanvasBatch::QUAD_INDICES))
+		return false;
+
+	Color m = p_rect->modulate;
+	m.a *= canvas_opacity;
+
+	Size2 tex_size = texture ? Size2(texture->width, texture->height) : Size2();
+	canvas_batch.add_rect(p_rect->texture, tex_size, p_rect->rect, p_rect->flags, p_rect->source, m);
+
+	_rinfo.ci_draw_commands++;
+	return true;
+}
+
+bool RasterizerGLES2::_canvas_batch_style_box(const CanvasItem::CommandStyle *p_style) {
+
+	Texture *texture = p_style->texture.is_valid() ? texture_owner.get(p_style->texture) : NULL;
+	if (!texture)
+		return false;
+
+	if (!_canvas_batch_begin(p_style->texture, RasterizerCanvasBatch::STYLE_BOX_VERTICES, RasterizerCanvasBatch::STYLE_BOX_INDICES))
+		return false;
+
+	Color m = p_style->color;
+	m.a *= canvas_opacity;
+
+	canvas_batch.add_style_box(p_style->texture, Size2(texture->width, texture->height), p_style->rect, p_style->source, p_style->margin, p_style->draw_center, m);
+
+	_rinfo.ci_draw_commands++;
+	return true;
+}
+
+bool RasterizerGLES2::_canvas_batch_polygon(int p_vertex_count, const int *p_indices, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, const RID &p_texture, bool p_singlecolor) {
+
+	RID tex;
+	if (p_texture.is_valid()) {
+		if (!texture_owner.get(p_texture))
+			return false;
+		tex = p_texture;
+	}
+
+	if (!_canvas_batch_begin(tex, p_vertex_count, p_vertex_count))
+		return false;
+
+	// same colors canvas_draw_polygon sets
+	Color m(1, 1, 1, canvas_opacity);
+	if (p_singlecolor) {
+		m = *p_colors;
+		m.a *= canvas_opacity;
+	}
+
+	canvas_batch.add_polygon(tex, p_vertex_count, p_indices, p_vertices, p_uvs, p_singlecolor ? NULL : p_colors, m);
+
+	_rinfo.ci_draw_commands++;
+	return true;
+}
+
+void RasterizerGLES2::_canvas_batch_flush() {
+
+	if (canvas_batch.is_empty())
+		return;
+
+	_bind_canvas_texture(canvas_batch.get_texture());
+
+	if (canvas_batch.has_transform()) {
+		canvas_shader.set_uniform(CanvasShaderGLES2::MODELVIEW_MATRIX, Matrix32());
+		canvas_shader.set_uniform(CanvasShaderGLES2::EXTRA_MATRIX, Matrix32());
+	}
+
+	typedef RasterizerCanvasBatch::Vertex Vertex;
+
+#ifndef GLES_NO_CLIENT_ARRAYS
+
+	const uint8_t *base = (const uint8_t *)canvas_batch.get_vertices();
+	const uint16_t *indices = canvas_batch.get_indices();
+
+#else
+
+	glBindBuffer(GL_ARRAY_BUFFER, canvas_batch_buffer);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, canvas_batch.get_vertex_count() * sizeof(Vertex), canvas_batch.get_vertices());
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, canvas_batch_index_buffer);
+	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, canvas_batch.get_index_count() * sizeof(uint16_t), canvas_batch.get_indices());
+	const uint8_t *base = NULL;
+	const uint16_t *indices = NULL;
+
+#endif
+
+	glEnableVertexAttribArray(VS::ARRAY_VERTEX);
+	glVertexAttribPointer(VS::ARRAY_VERTEX, 2, GL_FLOAT, false, sizeof(Vertex), base + offsetof(Vertex, vertex));
+	glEnableVertexAttribArray(VS::ARRAY_TEX_UV);
+	glVertexAttribPointer(VS::ARRAY_TEX_UV, 2, GL_FLOAT, false, sizeof(Vertex), base + offsetof(Vertex, uv));
+	glEnableVertexAttribArray(VS::ARRAY_COLOR);
+	glVertexAttribPointer(VS::ARRAY_COLOR, 4, GL_FLOAT, false, sizeof(Vertex), base + offsetof(Vertex, color));
+
+	glDrawElements(GL_TRIANGLES, canvas_batch.get_index_count(), GL_UNSIGNED_SHORT, indices);
+
+	// the other canvas draw functions expect a constant color
+	glDisableVertexAttribArray(VS::ARRAY_COLOR);
+	glDisableVertexAttribArray(VS::ARRAY_TEX_UV);
+
+#ifdef GLES_NO_CLIENT_ARRAYS
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+#endif
+
+	if (canvas_batch.has_transform()) {
+		canvas_shader.set_uniform(CanvasShaderGLES2::MODELVIEW_MATRIX, canvas_item_xform);
+		canvas_shader.set_uniform(CanvasShaderGLES2::EXTRA_MATRIX, canvas_extra_xform);
+	}
+
+	_rinfo.draw_calls++;
+	canvas_batch.clear();
+}
+
 void RasterizerGLES2::canvas_set_transform(const Matrix32 &p_transform) {
 
 	canvas_shader.set_uniform(CanvasShaderGLES2::EXTRA_MATRIX, p_transform);
+	canvas_extra_xform = p_transform;
 
 	//canvas_transform = Variant(p_transform);
 }
@@ -8555,6 +8556,22 @@ void RasterizerGLES2::_canvas_item_render_commands(CanvasItem *p_item, CanvasIte
 
 		CanvasItem::Command *c = commands[i];
 
+		switch (c->type) {
+			case CanvasItem::Command::TYPE_RECT:
+			case CanvasItem::Command::TYPE_STYLE:
+			case CanvasItem::Command::TYPE_POLYGON:
+			case CanvasItem::Command::TYPE_POLYGON_PTR: {
+			} break;
+			case CanvasItem::Command::TYPE_TRANSFORM: {
+				//a transformed batch doesn't use the extra matrix
+				if (!canvas_batch.has_transform())
+					_canvas_batch_flush();
+			} break;
+			default: {
+				_canvas_batch_flush();
+			}
+		}
+
 		switch (c->type) {
 			case CanvasItem::Command::TYPE_LINE: {
 
@@ -8564,6 +8581,9 @@ void RasterizerGLES2::_canvas_item_render_commands(CanvasItem *p_item, CanvasIte
 			case CanvasItem::Command::TYPE_RECT: {
 
 				CanvasItem::CommandRect *rect = static_cast<CanvasItem::CommandRect *>(c);
+				if (!use_normalmap && use_canvas_batching && _canvas_batch_rect(rect))
+					break;
+				_canvas_batch_flush();
 //						canvas_draw_rect(rect->rect,rect->region,rect->source,rect->flags&CanvasItem::CommandRect::FLAG_TILE,rect->flags&CanvasItem::CommandRect::FLAG_FLIP_H,rect->flags&CanvasItem::CommandRect::FLAG_FLIP_V,rect->texture,rect->modulate);
 #if 0
 				int flags=0;
@@ -8594,6 +8614,9 @@ void RasterizerGLES2::_canvas_item_render_commands(CanvasItem *p_item, CanvasIte
 			case CanvasItem::Command::TYPE_STYLE: {
 
 				CanvasItem::CommandStyle *style = static_cast<CanvasItem::CommandStyle *>(c);
+				if (!use_normalmap && use_canvas_batching && _canvas_batch_style_box(style))
+					break;
+				_canvas_batch_flush();
 				if (use_normalmap)
 					_canvas_normal_set_flip(Vector2(1, 1));
 				canvas_draw_style_box(style->rect, style->source, style->texture, style->margin, style->draw_center, style->color);
@@ -8611,6 +8634,9 @@ void RasterizerGLES2::_canvas_item_render_commands(CanvasItem *p_item, CanvasIte
 				if (use_normalmap)
 					_canvas_normal_set_flip(Vector2(1, 1));
 				CanvasItem::CommandPolygon *polygon = static_cast<CanvasItem::CommandPolygon *>(c);
+				if (!use_normalmap && use_canvas_batching && _canvas_batch_polygon(polygon->count, polygon->indices.ptr(), polygon->points.ptr(), polygon->uvs.ptr(), polygon->colors.ptr(), polygon->texture, polygon->colors.size() == 1))
+					break;
+				_canvas_batch_flush();
 				canvas_draw_polygon(polygon->count, polygon->indices.ptr(), polygon->points.ptr(), polygon->uvs.ptr(), polygon->colors.ptr(), polygon->texture, polygon->colors.size() == 1);
 
 			} break;
@@ -8620,6 +8646,9 @@ void RasterizerGLES2::_canvas_item_render_commands(CanvasItem *p_item, CanvasIte
 				if (use_normalmap)
 					_canvas_normal_set_flip(Vector2(1, 1));
 				CanvasItem::CommandPolygonPtr *polygon = static_cast<CanvasItem::CommandPolygonPtr *>(c);
+				if (!use_normalmap && use_canvas_batching && _canvas_batch_polygon(polygon->count, polygon->indices, polygon->points, polygon->uvs, polygon->colors, polygon->texture, false))
+					break;
+				_canvas_batch_flush();
 				canvas_draw_polygon(polygon->count, polygon->indices, polygon->points, polygon->uvs, polygon->colors, polygon->texture, false);
 			} break;
 			case CanvasItem::Command::TYPE_CIRCLE: {
@@ -8644,6 +8673,8 @@ void RasterizerGLES2::_canvas_item_render_commands(CanvasItem *p_item, CanvasIte
 
 				CanvasItem::CommandTransform *transform = static_cast<CanvasItem::CommandTransform *>(c);
 				canvas_set_transform(transform->xform);
+				if (canvas_batch.has_transform())
+					canvas_batch.set_transform(canvas_item_xform * transform->xform);
 			} break;
 			case CanvasItem::Command::TYPE_BLEND_MODE: {
 
@@ -8820,12 +8851,16 @@ void RasterizerGLES2::canvas_render_items(CanvasItem *p_item_list, int p_z, cons
 
 	bool reset_modulate = false;
 	bool prev_distance_field = false;
+	bool prev_unshaded = false;
 
 	while (p_item_list) {
 
 		CanvasItem *ci = p_item_list;
 
+		//the batch is kept open across items until some state it's drawn with changes
+
 		if (ci->vp_render) {
+			_canvas_batch_flush();
 			if (draw_viewport_func) {
 				draw_viewport_func(ci->vp_render->owner, ci->vp_render->udata, ci->vp_render->rect);
 			}
@@ -8843,6 +8878,7 @@ void RasterizerGLES2::canvas_render_items(CanvasItem *p_item_list, int p_z, cons
 
 		if (prev_distance_field != ci->distance_field) {
 
+			_canvas_batch_flush();
 			canvas_shader.set_conditional(CanvasShaderGLES2::USE_DISTANCE_FIELD, ci->distance_field);
 			prev_distance_field = ci->distance_field;
 			rebind_shader = true;
@@ -8850,6 +8886,7 @@ void RasterizerGLES2::canvas_render_items(CanvasItem *p_item_list, int p_z, cons
 
 		if (current_clip != ci->final_clip_owner) {
 
+			_canvas_batch_flush();
 			current_clip = ci->final_clip_owner;
 
 			//setup clip
@@ -8891,6 +8928,7 @@ void RasterizerGLES2::canvas_render_items(CanvasItem *p_item_list, int p_z, cons
 
 		if (ci->copy_back_buffer && framebuffer.active && framebuffer.scale == 1) {
 
+			_canvas_batch_flush();
 			Rect2 rect;
 			int x, y;
 
@@ -8929,6 +8967,7 @@ void RasterizerGLES2::canvas_render_items(CanvasItem *p_item_list, int p_z, cons
 
 		if (material != canvas_last_material || rebind_shader) {
 
+			_canvas_batch_flush();
 			Shader *shader = NULL;
 			if (material && material->shader.is_valid()) {
 				shader = shader_owner.get(material->shader);
@@ -8958,11 +8997,22 @@ void RasterizerGLES2::canvas_render_items(CanvasItem *p_item_list, int p_z, cons
 
 		if (material && shader_cache) {
 
+			//custom vertex code runs on item space vertices, so these aren't transformed and are drawn at the item end
+			_canvas_batch_flush();
+			canvas_batch.clear_transform();
 			_canvas_item_setup_shader_uniforms(material, shader_cache);
+		} else {
+
+			canvas_batch.set_transform(ci->final_transform);
 		}
 
 		bool unshaded = (material && material->shading_mode == VS::CANVAS_ITEM_SHADING_UNSHADED) || ci->blend_mode != VS::MATERIAL_BLEND_MODE_MIX;
 
+		if (unshaded != prev_unshaded) {
+			_canvas_batch_flush();
+			prev_unshaded = unshaded;
+		}
+
 		if (unshaded) {
 			canvas_shader.set_uniform(CanvasShaderGLES2::MODULATE, Color(1, 1, 1, 1));
 			reset_modulate = true;
@@ -8973,11 +9023,15 @@ void RasterizerGLES2::canvas_render_items(CanvasItem *p_item_list, int p_z, cons
 
 		canvas_shader.set_uniform(CanvasShaderGLES2::MODELVIEW_MATRIX, ci->final_transform);
 		canvas_shader.set_uniform(CanvasShaderGLES2::EXTRA_MATRIX, Matrix32());
+		canvas_item_xform = ci->final_transform;
+		canvas_extra_xform = Matrix32();
 
 		bool reclip = false;
 
 		if (ci == p_item_list || ci->blend_mode != canvas_blend_mode) {
 
+			_canvas_batch_flush();
+
 			switch (ci->blend_mode) {
 
 				case VS::MATERIAL_BLEND_MODE_MIX: {
@@ -9030,6 +9084,8 @@ void RasterizerGLES2::canvas_render_items(CanvasItem *p_item_list, int p_z, cons
 
 					//intersects this light
 
+					_canvas_batch_flush();
+
 					if (!light_used || mode != light->mode) {
 
 						mode = light->mode;
@@ -9138,6 +9194,7 @@ void RasterizerGLES2::canvas_render_items(CanvasItem *p_item_list, int p_z, cons
 
 				canvas_shader.set_uniform(CanvasShaderGLES2::MODELVIEW_MATRIX, ci->final_transform);
 				canvas_shader.set_uniform(CanvasShaderGLES2::EXTRA_MATRIX, Matrix32());
+				canvas_extra_xform = Matrix32();
 				if (canvas_use_modulate)
 					canvas_shader.set_uniform(CanvasShaderGLES2::MODULATE, canvas_modulate);
 
@@ -9150,8 +9207,12 @@ void RasterizerGLES2::canvas_render_items(CanvasItem *p_item_list, int p_z, cons
 			}
 		}
 
+		if (material && shader_cache)
+			_canvas_batch_flush();
+
 		if (reclip) {
 
+			_canvas_batch_flush();
 			glEnable(GL_SCISSOR_TEST);
 			//glScissor(viewport.x+current_clip->final_clip_rect.pos.x,viewport.y+ (viewport.height-(current_clip->final_clip_rect.pos.y+current_clip->final_clip_rect.size.height)),
 			//current_clip->final_clip_rect.size.width,current_clip->final_clip_rect.size.height);
@@ -9179,6 +9240,8 @@ void RasterizerGLES2::canvas_render_items(CanvasItem *p_item_list, int p_z, cons
 		p_item_list = p_item_list->next;
 	}
 
+	_canvas_batch_flush();
+
 	if (current_clip) {
 		glDisable(GL_SCISSOR_TEST);
 	}
@@ -10407,6 +10470,17 @@ void RasterizerGLES2::init() {
 #endif
 	glBindBuffer(GL_ARRAY_BUFFER, 0); //unbind
 
+#ifdef GLES_NO_CLIENT_ARRAYS
+	glGenBuffers(1, &canvas_batch_buffer);
+	glBindBuffer(GL_ARRAY_BUFFER, canvas_batch_buffer);
+	glBufferData(GL_ARRAY_BUFFER, RasterizerCanvasBatch::MAX_VERTICES * sizeof(RasterizerCanvasBatch::Vertex), NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glGenBuffers(1, &canvas_batch_index_buffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, canvas_batch_index_buffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, RasterizerCanvasBatch::MAX_INDICES * sizeof(uint16_t), NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+#endif
+
 #ifdef GLES_NO_CLIENT_ARRAYS //webgl indices buffer
 	glGenBuffers(1, &indices_buffer);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices_buffer);
@@ -10417,6 +10491,12 @@ void RasterizerGLES2::init() {
 	shader_time_rollback = GLOBAL_DEF("rasterizer/shader_time_rollback", 300);
 	time_scale = 1.0f;
 
+	// only used without hardware skinning, 1 keeps it on the render thread, 0 uses one thread per processor
+	int skinning_threads = GLOBAL_DEF("rasterizer/skinning_thread_count", 1);
+	Globals::get_singleton()->set_custom_property_info("rasterizer/skinning_thread_count", PropertyInfo(Variant::INT, "rasterizer/skinning_thread_count", PROPERTY_HINT_RANGE, "0,64,1"));
+	if (!use_hw_skeleton_xform)
+		skinning_work_pool.init(skinning_threads);
+
 	using_canvas_bg = false;
 	_update_framebuffer();
 	DEBUG_TEST_ERROR("Initializing");
@@ -10424,6 +10504,8 @@ void RasterizerGLES2::init() {
 
 void RasterizerGLES2::finish() {
 
+	skinning_work_pool.finish();
+
 	free(default_material);
 	free(shadow_material);
 	free(shadow_material_double_sided);
@@ -10725,6 +10807,7 @@ RasterizerGLES2::RasterizerGLES2(bool p_compress_arrays, bool p_keep_ram_copy, b
 	use_shadow_mapping = true;
 	use_fast_texture_filter = !bool(GLOBAL_DEF("rasterizer/trilinear_mipmap_filter", true));
 	low_memory_2d = bool(GLOBAL_DEF("rasterizer/low_memory_2d_mode", false));
+	use_canvas_batching = bool(GLOBAL_DEF("rasterizer/use_canvas_batching", true));
 	skel_default.resize(1024 * 4);
 	for (int i = 0; i < 1024 / 3; i++) {
 
@@ -40,6 +40,7 @@
 #include "image.h"
 #include "list.h"
 #include "map.h"
+#include "os/thread_work_pool.h"
 #include "rid.h"
 #include "self_list.h"
 #include "servers/visual_server.h"
@@ -53,12 +54,14 @@
 #endif
 
 #include "drivers/gles2/shader_compiler_gles2.h"
+#include "drivers/gles2/skeleton_xform_gles2.h"
 #include "drivers/gles2/shaders/blur.glsl.gen.h"
 #include "drivers/gles2/shaders/canvas.glsl.gen.h"
 #include "drivers/gles2/shaders/canvas_shadow.glsl.gen.h"
 #include "drivers/gles2/shaders/copy.glsl.gen.h"
 #include "drivers/gles2/shaders/material.glsl.gen.h"
 #include "servers/visual/particle_system_sw.h"
+#include "servers/visual/rasterizer_canvas_batch.h"
 
 /**
         @author Juan Linietsky <reduzio@gmail.com>
@@ -71,6 +74,7 @@ class RasterizerGLES2 : public Rasterizer {
 		LIGHT_SPOT_BIT = 0x80,
 		DEFAULT_SKINNED_BUFFER_SIZE = 2048, // 10k vertices
 		MAX_HW_LIGHTS = 1,
+		SKINNING_CHUNK_SIZE = 1024, // vertices skinned by each work item
 	};
 
 	uint8_t *skinned_buffer;
@@ -560,19 +564,6 @@ class RasterizerGLES2 : public Rasterizer {
 				}
 			}
 
-			_ALWAYS_INLINE_ void transform_add_mul3(const float *p_src, float *r_dst, float p_weight) const {
-
-				r_dst[0] += ((mtx[0][0] * p_src[0]) + (mtx[1][0] * p_src[1]) + (mtx[2][0] * p_src[2]) + mtx[3][0]) * p_weight;
-				r_dst[1] += ((mtx[0][1] * p_src[0]) + (mtx[1][1] * p_src[1]) + (mtx[2][1] * p_src[2]) + mtx[3][1]) * p_weight;
-				r_dst[2] += ((mtx[0][2] * p_src[0]) + (mtx[1][2] * p_src[1]) + (mtx[2][2] * p_src[2]) + mtx[3][2]) * p_weight;
-			}
-			_ALWAYS_INLINE_ void transform3_add_mul3(const float *p_src, float *r_dst, float p_weight) const {
-
-				r_dst[0] += ((mtx[0][0] * p_src[0]) + (mtx[1][0] * p_src[1]) + (mtx[2][0] * p_src[2])) * p_weight;
-				r_dst[1] += ((mtx[0][1] * p_src[0]) + (mtx[1][1] * p_src[1]) + (mtx[2][1] * p_src[2])) * p_weight;
-				r_dst[2] += ((mtx[0][2] * p_src[0]) + (mtx[1][2] * p_src[1]) + (mtx[2][2] * p_src[2])) * p_weight;
-			}
-
 			_ALWAYS_INLINE_ AABB transform_aabb(const AABB &p_aabb) const {
 
 				float vertices[8][3] = {
@@ -622,8 +613,11 @@ class RasterizerGLES2 : public Rasterizer {
 	mutable RID_Owner<Skeleton> skeleton_owner;
 	mutable SelfList<Skeleton>::List _skeleton_dirty_list;
 
+	ThreadWorkPool skinning_work_pool;
+
 	template <bool USE_NORMAL, bool USE_TANGENT, bool INPLACE>
-	void _skeleton_xform(const uint8_t *p_src_array, int p_src_stride, uint8_t *p_dst_array, int p_dst_stride, int p_elements, const uint8_t *p_src_bones, const uint8_t *p_src_weights, const Skeleton::Bone *p_bone_xforms);
+	void _skeleton_xform_chunk(uint32_t p_chunk, const SkeletonXformArrays *p_arrays);
+	void _skeleton_xform(uint32_t p_format, const uint8_t *p_src_array, int p_src_stride, uint8_t *p_dst_array, int p_dst_stride, int p_elements, const uint8_t *p_src_bones, const uint8_t *p_src_weights, const Skeleton::Bone *p_bone_xforms);
 
 	struct Light {
 
@@ -1291,6 +1285,24 @@ class RasterizerGLES2 : public Rasterizer {
 
 	template <bool use_normalmap>
 	_FORCE_INLINE_ void _canvas_item_render_commands(CanvasItem *p_item, CanvasItem *current_clip, bool &reclip);
+
+	/* CANVAS BATCHING */
+
+	bool use_canvas_batching;
+	RasterizerCanvasBatch canvas_batch;
+	// what MODELVIEW_MATRIX and EXTRA_MATRIX hold for the item being drawn, a transformed batch is drawn without them
+	Matrix32 canvas_item_xform;
+	Matrix32 canvas_extra_xform;
+#ifdef GLES_NO_CLIENT_ARRAYS
+	GLuint canvas_batch_buffer;
+	GLuint canvas_batch_index_buffer;
+#endif
+
+	_FORCE_INLINE_ bool _canvas_batch_begin(const RID &p_texture, int p_vertices, int p_indices);
+	bool _canvas_batch_rect(const CanvasItem::CommandRect *p_rect);
+	bool _canvas_batch_style_box(const CanvasItem::CommandStyle *p_style);
+	bool _canvas_batch_polygon(int p_vertex_count, const int *p_indices, const Vector2 *p_vertices, const Vector2 *p_uvs, const Color *p_colors, const RID &p_texture, bool p_singlecolor);
+	void _canvas_batch_flush();
 	_FORCE_INLINE_ void _canvas_item_setup_shader_params(CanvasItemMaterial *material, Shader *p_shader);
 	_FORCE_INLINE_ void _canvas_item_setup_shader_uniforms(CanvasItemMaterial *material, Shader *p_shader);
 
@@ -0,0 +1,225 @@
+/*************************************************************************/
+/*  skeleton_xform_gles2.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef SKELETON_XFORM_GLES2_H
+#define SKELETON_XFORM_GLES2_H
+
+#include "os/copymem.h"
+#include "typedefs.h"
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SKELETON_XFORM_SIMD
+
+typedef __m128 SkinVec4;
+
+static _ALWAYS_INLINE_ SkinVec4 _skin_zero() { return _mm_setzero_ps(); }
+static _ALWAYS_INLINE_ SkinVec4 _skin_load(const float *p_src) { return _mm_loadu_ps(p_src); }
+static _ALWAYS_INLINE_ SkinVec4 _skin_mul_add(SkinVec4 p_a, SkinVec4 p_b, float p_s) { return _mm_add_ps(p_a, _mm_mul_ps(p_b, _mm_set1_ps(p_s))); }
+static _ALWAYS_INLINE_ void _skin_store3(float *r_dst, SkinVec4 p_v) {
+
+	_mm_storel_pi((__m64 *)r_dst, p_v);
+	_mm_store_ss(r_dst + 2, _mm_movehl_ps(p_v, p_v));
+}
+
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SKELETON_XFORM_SIMD
+
+typedef float32x4_t SkinVec4;
+
+static _ALWAYS_INLINE_ SkinVec4 _skin_zero() { return vdupq_n_f32(0); }
+static _ALWAYS_INLINE_ SkinVec4 _skin_load(const float *p_src) { return vld1q_f32(p_src); }
+static _ALWAYS_INLINE_ SkinVec4 _skin_mul_add(SkinVec4 p_a, SkinVec4 p_b, float p_s) { return vmlaq_n_f32(p_a, p_b, p_s); }
+static _ALWAYS_INLINE_ void _skin_store3(float *r_dst, SkinVec4 p_v) {
+
+	vst1_f32(r_dst, vget_low_f32(p_v));
+	vst1q_lane_f32(r_dst + 2, p_v, 2);
+}
+
+#endif
+
+/**
+ * CPU skinning, used when skeletons can't be transformed on the GPU.
+ * Vertices are interleaved: position, then normal and tangent if present.
+ * Bone indices (4 x uint16) and weights (4 x float, a zero weight ends the
+ * list) are read with bones_stride, which differs from the source stride
+ * when the vertices were morphed into another buffer first. Bones are
+ * column major 4x4 float matrices, 16 floats each. Only elements in
+ * [p_from, p_to) are processed, so a mesh can be split between threads.
+ */
+
+struct SkeletonXformArrays {
+
+	const uint8_t *src;
+	int src_stride;
+	uint8_t *dst; // may be the same as src, then INPLACE must be set
+	int dst_stride;
+	const uint8_t *bones;
+	const uint8_t *weights;
+	int bones_stride; // stride of bones and weights
+	const float *bone_mtx;
+	int elements;
+};
+
+static _ALWAYS_INLINE_ void _skeleton_transform_add_mul3(const float *p_mtx, const float *p_src, float *r_dst, float p_weight) {
+
+	r_dst[0] += ((p_mtx[0] * p_src[0]) + (p_mtx[4] * p_src[1]) + (p_mtx[8] * p_src[2]) + p_mtx[12]) * p_weight;
+	r_dst[1] += ((p_mtx[1] * p_src[0]) + (p_mtx[5] * p_src[1]) + (p_mtx[9] * p_src[2]) + p_mtx[13]) * p_weight;
+	r_dst[2] += ((p_mtx[2] * p_src[0]) + (p_mtx[6] * p_src[1]) + (p_mtx[10] * p_src[2]) + p_mtx[14]) * p_weight;
+}
+
+static _ALWAYS_INLINE_ void _skeleton_transform3_add_mul3(const float *p_mtx, const float *p_src, float *r_dst, float p_weight) {
+
+	r_dst[0] += ((p_mtx[0] * p_src[0]) + (p_mtx[4] * p_src[1]) + (p_mtx[8] * p_src[2])) * p_weight;
+	r_dst[1] += ((p_mtx[1] * p_src[0]) + (p_mtx[5] * p_src[1]) + (p_mtx[9] * p_src[2])) * p_weight;
+	r_dst[2] += ((p_mtx[2] * p_src[0]) + (p_mtx[6] * p_src[1]) + (p_mtx[10] * p_src[2])) * p_weight;
+}
+
+template <bool USE_NORMAL, bool USE_TANGENT, bool INPLACE>
+void skeleton_xform_scalar(const SkeletonXformArrays &p_arrays, int p_from, int p_to) {
+
+	const int dstvec_size = 3 + (USE_NORMAL ? 3 : 0) + (USE_TANGENT ? 4 : 0);
+	const int extra = p_arrays.dst_stride - dstvec_size * 4;
+	float dstcopy[dstvec_size];
+
+	for (int i = p_from; i < p_to; i++) {
+
+		uint32_t ss = p_arrays.src_stride * i;
+		uint32_t ds = p_arrays.dst_stride * i;
+		uint32_t bs = p_arrays.bones_stride * i;
+		const uint16_t *bi = (const uint16_t *)&p_arrays.bones[bs];
+		const float *bw = (const float *)&p_arrays.weights[bs];
+		const float *src_vec = (const float *)&p_arrays.src[ss];
+		float *dst_vec = INPLACE ? dstcopy : (float *)&p_arrays.dst[ds];
+
+		for (int j = 0; j < dstvec_size; j++)
+			dst_vec[j] = 0.0;
+		if (USE_TANGENT)
+			dst_vec[dstvec_size - 1] = src_vec[dstvec_size - 1];
+
+		for (int j = 0; j < 4; j++) {
+
+			if (bw[j] == 0)
+				break;
+
+			const float *mtx = &p_arrays.bone_mtx[bi[j] * 16];
+			_skeleton_transform_add_mul3(mtx, &src_vec[0], &dst_vec[0], bw[j]);
+			//conditionals simply removed by optimizer
+			if (USE_NORMAL)
+				_skeleton_transform3_add_mul3(mtx, &src_vec[3], &dst_vec[3], bw[j]);
+			if (USE_TANGENT)
+				_skeleton_transform3_add_mul3(mtx, &src_vec[USE_NORMAL ? 6 : 3], &dst_vec[USE_NORMAL ? 6 : 3], bw[j]);
+		}
+
+		if (INPLACE)
+			copymem(&p_arrays.dst[ds], dstcopy, dstvec_size * 4);
+		else
+			copymem(&dst_vec[dstvec_size], &src_vec[dstvec_size], extra); //copy extra stuff
+	}
+}
+
+#ifdef SKELETON_XFORM_SIMD
+
+template <bool USE_NORMAL, bool USE_TANGENT, bool INPLACE>
+void skeleton_xform_simd(const SkeletonXformArrays &p_arrays, int p_from, int p_to) {
+
+	const int dstvec_size = 3 + (USE_NORMAL ? 3 : 0) + (USE_TANGENT ? 4 : 0);
+	const int extra = p_arrays.dst_stride - dstvec_size * 4;
+	const int tangent_ofs = USE_NORMAL ? 6 : 3;
+
+	for (int i = p_from; i < p_to; i++) {
+
+		uint32_t ss = p_arrays.src_stride * i;
+		uint32_t ds = p_arrays.dst_stride * i;
+		uint32_t bs = p_arrays.bones_stride * i;
+		const uint16_t *bi = (const uint16_t *)&p_arrays.bones[bs];
+		const float *bw = (const float *)&p_arrays.weights[bs];
+		const float *src_vec = (const float *)&p_arrays.src[ss];
+		float *dst_vec = (float *)&p_arrays.dst[ds];
+
+		//blend the bone matrices first, then transform everything once with the result
+		SkinVec4 col0 = _skin_zero();
+		SkinVec4 col1 = _skin_zero();
+		SkinVec4 col2 = _skin_zero();
+		SkinVec4 col3 = _skin_zero();
+
+		for (int j = 0; j < 4; j++) {
+
+			float w = bw[j];
+			if (w == 0)
+				break;
+
+			const float *mtx = &p_arrays.bone_mtx[bi[j] * 16];
+			col0 = _skin_mul_add(col0, _skin_load(&mtx[0]), w);
+			col1 = _skin_mul_add(col1, _skin_load(&mtx[4]), w);
+			col2 = _skin_mul_add(col2, _skin_load(&mtx[8]), w);
+			col3 = _skin_mul_add(col3, _skin_load(&mtx[12]), w);
+		}
+
+		//everything is read before writing, so src and dst can be the same
+		SkinVec4 vertex = _skin_mul_add(_skin_mul_add(_skin_mul_add(col3, col0, src_vec[0]), col1, src_vec[1]), col2, src_vec[2]);
+		SkinVec4 normal;
+		SkinVec4 tangent;
+		float tangent_w = 0;
+
+		if (USE_NORMAL)
+			normal = _skin_mul_add(_skin_mul_add(_skin_mul_add(_skin_zero(), col0, src_vec[3]), col1, src_vec[4]), col2, src_vec[5]);
+		if (USE_TANGENT) {
+			const float *src_tangent = &src_vec[tangent_ofs];
+			tangent = _skin_mul_add(_skin_mul_add(_skin_mul_add(_skin_zero(), col0, src_tangent[0]), col1, src_tangent[1]), col2, src_tangent[2]);
+			tangent_w = src_tangent[3];
+		}
+
+		_skin_store3(&dst_vec[0], vertex);
+		if (USE_NORMAL)
+			_skin_store3(&dst_vec[3], normal);
+		if (USE_TANGENT) {
+			_skin_store3(&dst_vec[tangent_ofs], tangent);
+			dst_vec[tangent_ofs + 3] = tangent_w;
+		}
+
+		if (!INPLACE)
+			copymem(&dst_vec[dstvec_size], &src_vec[dstvec_size], extra); //copy extra stuff
+	}
+}
+
+#endif
+
+template <bool USE_NORMAL, bool USE_TANGENT, bool INPLACE>
+_FORCE_INLINE_ void skeleton_xform(const SkeletonXformArrays &p_arrays, int p_from, int p_to) {
+
+#ifdef SKELETON_XFORM_SIMD
+	skeleton_xform_simd<USE_NORMAL, USE_TANGENT, INPLACE>(p_arrays, p_from, p_to);
+#else
+	skeleton_xform_scalar<USE_NORMAL, USE_TANGENT, INPLACE>(p_arrays, p_from, p_to);
+#endif
+}
+
+#endif // SKELETON_XFORM_GLES2_H
@@ -117,6 +117,7 @@ void *MemoryPoolStaticMalloc::_alloc(size_t p_bytes, const char *p_description)
 		max_mem = total_mem;
 
 	total_pointers++;
+	alloc_calls++;
 
 	if (total_pointers > max_pointers)
 		max_pointers = total_pointers;
@@ -191,6 +192,7 @@ void *MemoryPoolStaticMalloc::_realloc(void *p_memory, size_t p_bytes) {
 	ERR_FAIL_COND_V(new_ringptr == 0, NULL); /// reallocation failed
 
 	/* actualize mem used */
+	alloc_calls++;
 	total_mem -= new_ringptr->size;
 	new_ringptr->size = p_bytes;
 	total_mem += new_ringptr->size;
@@ -345,6 +347,10 @@ size_t MemoryPoolStaticMalloc::get_alloc_size(int p_alloc_idx) {
 
 	return 0;
 }
+uint64_t MemoryPoolStaticMalloc::get_alloc_calls() {
+
+	return alloc_calls;
+}
 
 void MemoryPoolStaticMalloc::dump_mem_to_file(const char *p_file) {
 
@@ -373,6 +379,7 @@ MemoryPoolStaticMalloc::MemoryPoolStaticMalloc() {
 	max_pointers = 0;
 
 #endif
+	alloc_calls = 0;
 
 	mutex = NULL;
 #ifndef NO_THREADS
@@ -51,6 +51,7 @@ class MemoryPoolStaticMalloc : public MemoryPoolStatic {
 
 	size_t max_mem;
 	int max_pointers;
+	uint64_t alloc_calls;
 
 	Mutex *mutex;
 
@@ -71,6 +72,7 @@ public:
 	virtual void *get_alloc_ptr(int p_alloc_idx);
 	virtual const char *get_alloc_description(int p_alloc_idx);
 	virtual size_t get_alloc_size(int p_alloc_idx);
+	virtual uint64_t get_alloc_calls();
 
 	void dump_mem_to_file(const char *p_file);
 
@@ -34,13 +34,14 @@
 #include "core/os/thread_dummy.h"
 #include "memory_pool_static_malloc.h"
 #include "mutex_posix.h"
-#include "os/memory_pool_dynamic_static.h"
+#include "os/memory_pool_dynamic_size_class.h"
 #include "semaphore_posix.h"
 #include "thread_posix.h"
 
 //#include "core/io/file_access_buffered_fa.h"
 #include "dir_access_unix.h"
 #include "file_access_unix.h"
+#include "packed_source_mmap_unix.h"
 #include "packet_peer_udp_posix.h"
 #include "stream_peer_tcp_posix.h"
 #include "tcp_server_posix.h"
@@ -114,7 +115,7 @@ int OS_Unix::unix_initialize_audio(int p_audio_driver) {
 }
 
 static MemoryPoolStaticMalloc *mempool_static = NULL;
-static MemoryPoolDynamicStatic *mempool_dynamic = NULL;
+static MemoryPoolDynamicSizeClass *mempool_dynamic = NULL;
 
 // Very simple signal handler to reap processes where ::execute was called with
 // !p_blocking
@@ -143,6 +144,9 @@ void OS_Unix::initialize_core() {
 	DirAccess::make_default<DirAccessUnix>(DirAccess::ACCESS_RESOURCES);
 	DirAccess::make_default<DirAccessUnix>(DirAccess::ACCESS_USERDATA);
 	DirAccess::make_default<DirAccessUnix>(DirAccess::ACCESS_FILESYSTEM);
+#ifndef SYMBIAN_ENABLED
+	PackedSourceMMapUnix::make_default();
+#endif
 
 #ifndef NO_NETWORK
 	TCPServerPosix::make_default();
@@ -151,7 +155,7 @@ void OS_Unix::initialize_core() {
 	IP_Unix::make_default();
 #endif
 	mempool_static = new MemoryPoolStaticMalloc;
-	mempool_dynamic = memnew(MemoryPoolDynamicStatic);
+	mempool_dynamic = memnew(MemoryPoolDynamicSizeClass);
 
 	ticks_start = 0;
 	ticks_start = get_ticks_usec();
@@ -0,0 +1,115 @@
+/*************************************************************************/
+/*  packed_source_mmap_unix.cpp                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "packed_source_mmap_unix.h"
+
+#if defined(UNIX_ENABLED) && !defined(SYMBIAN_ENABLED)
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+PackedSourcePCK *PackedSourceMMapUnix::create_mmap_unix() {
+
+	return memnew(PackedSourceMMapUnix);
+}
+
+void PackedSourceMMapUnix::make_default() {
+
+	create_func = create_mmap_unix;
+}
+
+bool PackedSourceMMapUnix::try_open_pack(const String &p_path) {
+
+	if (mappings.has(p_path))
+		return PackedSourcePCK::try_open_pack(p_path);
+
+	Mapping mapping;
+	mapping.data = NULL;
+	mapping.size = 0;
+
+	int fd = open(p_path.utf8().get_data(), O_RDONLY);
+	if (fd != -1) {
+
+		struct stat st;
+		if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && uint64_t(st.st_size) <= uint64_t(~size_t(0))) {
+
+			void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (data != MAP_FAILED) {
+				mapping.data = (uint8_t *)data;
+				mapping.size = st.st_size;
+			}
+		}
+
+		//the mapping stays valid after closing
+		close(fd);
+	}
+
+	if (!PackedSourcePCK::try_open_pack(p_path)) {
+
+		if (mapping.data)
+			munmap(mapping.data, mapping.size);
+		return false;
+	}
+
+	if (mapping.data)
+		mappings[p_path] = mapping;
+
+	return true;
+}
+
+FileAccess *PackedSourceMMapUnix::get_file(const String &p_path, PackedData::PackedFile *p_file) {
+
+	Map<String, Mapping>::Element *E = mappings.find(p_file->pack);
+	if (!E || p_file->offset + p_file->size > E->get().size)
+		return PackedSourcePCK::get_file(p_path, p_file);
+
+	uint8_t *data = E->get().data + p_file->offset;
+
+	//start reading the file in ahead of the loader
+	uint8_t *page = E->get().data + (p_file->offset & ~uint64_t(page_size - 1));
+	madvise(page, (data - page) + p_file->size, MADV_WILLNEED);
+
+	return _open_compressed(memnew(FileAccessPack(p_path, *p_file, data)), p_file);
+}
+
+PackedSourceMMapUnix::PackedSourceMMapUnix() {
+
+	page_size = sysconf(_SC_PAGESIZE);
+}
+
+PackedSourceMMapUnix::~PackedSourceMMapUnix() {
+
+	for (Map<String, Mapping>::Element *E = mappings.front(); E; E = E->next()) {
+		munmap(E->get().data, E->get().size);
+	}
+}
+
+#endif
@@ -0,0 +1,69 @@
+/*************************************************************************/
+/*  packed_source_mmap_unix.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef PACKED_SOURCE_MMAP_UNIX_H
+#define PACKED_SOURCE_MMAP_UNIX_H
+
+#include "io/file_access_pack.h"
+
+#if defined(UNIX_ENABLED) && !defined(SYMBIAN_ENABLED)
+
+/**
+ * Maps each pack into memory once and serves the files inside it straight
+ * from the mapping, so any amount of them can be open at the same time
+ * without a file handle each, and loaders can point into the data through
+ * FileAccess::get_direct_buffer() instead of copying it. Packs that can't
+ * be mapped (not a regular file, or no address space left on 32 bits) are
+ * read through FileAccess as before.
+ */
+class PackedSourceMMapUnix : public PackedSourcePCK {
+
+	struct Mapping {
+
+		uint8_t *data;
+		size_t size;
+	};
+
+	Map<String, Mapping> mappings;
+	size_t page_size;
+
+	static PackedSourcePCK *create_mmap_unix();
+
+public:
+	virtual bool try_open_pack(const String &p_path);
+	virtual FileAccess *get_file(const String &p_path, PackedData::PackedFile *p_file);
+
+	static void make_default();
+
+	PackedSourceMMapUnix();
+	~PackedSourceMMapUnix();
+};
+
+#endif
+#endif
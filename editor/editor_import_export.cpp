@@ -1023,16 +1023,6 @@ Error EditorExportPlatform::export_project_files(EditorExportSaveFunction p_func
 	return OK;
 }
 
-static int _get_pad(int p_alignment, int p_n) {
-
-	int rest = p_n % p_alignment;
-	int pad = 0;
-	if (rest > 0) {
-		pad = p_alignment - rest;
-	};
-
-	return pad;
-};
 
 void EditorExportPlatform::gen_export_flags(Vector<String> &r_flags, int p_flags) {
 
@@ -1092,35 +1082,10 @@ Error EditorExportPlatform::save_pack_file(void *p_userdata, const String &p_pat
 
 	PackData *pd = (PackData *)p_userdata;
 
-	CharString cs = p_path.utf8();
-	pd->f->store_32(cs.length());
-	pd->f->store_buffer((uint8_t *)cs.get_data(), cs.length());
-	TempData td;
-	td.pos = pd->f->get_pos();
-	td.ofs = pd->ftmp->get_pos();
-	td.size = p_data.size();
-	pd->file_ofs.push_back(td);
-	pd->f->store_64(0); //ofs
-	pd->f->store_64(0); //size
-	{
-		MD5_CTX ctx;
-		MD5Init(&ctx);
-		MD5Update(&ctx, (unsigned char *)p_data.ptr(), p_data.size());
-		MD5Final(&ctx);
-		pd->f->store_buffer(ctx.digest, 16);
-	}
 	pd->ep->step(TTR("Storing File:") + " " + p_path, 2 + p_file * 100 / p_total, false);
 	pd->count++;
-	pd->ftmp->store_buffer(p_data.ptr(), p_data.size());
-	if (pd->alignment > 1) {
 
-		int pad = _get_pad(pd->alignment, pd->ftmp->get_pos());
-		for (int i = 0; i < pad; i++) {
-
-			pd->ftmp->store_8(0);
-		};
-	};
-	return OK;
+	return pd->packer->add_buffer(p_path, p_data);
 }
 
 Error EditorExportPlatform::save_zip_file(void *p_userdata, const String &p_path, const Vector<uint8_t> &p_data, int p_file, int p_total) {
@@ -1176,75 +1141,30 @@ Error EditorExportPlatform::save_pack(FileAccess *dst, bool p_make_bundles, int
 
 	EditorProgress ep("savepack", TTR("Packing"), 102);
 
-	String tmppath = EditorSettings::get_singleton()->get_settings_path() + "/tmp/packtmp";
-	FileAccess *tmp = FileAccess::open(tmppath, FileAccess::WRITE);
 	uint64_t ofs_begin = dst->get_pos();
 
-	dst->store_32(0x43504447); //GDPK
-	dst->store_32(0); //pack version
-	dst->store_32(VERSION_MAJOR);
-	dst->store_32(VERSION_MINOR);
-	dst->store_32(0); //hmph
-	for (int i = 0; i < 16; i++) {
-		//reserved
-		dst->store_32(0);
-	}
-
-	size_t fcountpos = dst->get_pos();
-	dst->store_32(0);
+	Ref<PCKPacker> packer = memnew(PCKPacker);
+	packer->set_compression(EditorImportExport::get_singleton()->get_pack_compression());
+	Error err = packer->pck_start_at(dst, p_alignment);
+	if (err)
+		return err;
 
 	PackData pd;
+	pd.packer = packer.ptr();
 	pd.ep = &ep;
-	pd.f = dst;
-	pd.ftmp = tmp;
 	pd.count = 0;
-	pd.alignment = p_alignment;
-	Error err = export_project_files(save_pack_file, &pd, p_make_bundles);
-	memdelete(tmp);
+	err = export_project_files(save_pack_file, &pd, p_make_bundles);
 	if (err)
 		return err;
 
-	if (p_alignment > 1) {
-		int pad = _get_pad(p_alignment, dst->get_pos());
-		for (int i = 0; i < pad; i++) {
-
-			dst->store_8(0);
-		};
-	};
-
-	size_t ofsplus = dst->get_pos();
-	//append file
-
-	tmp = FileAccess::open(tmppath, FileAccess::READ);
-
-	ERR_FAIL_COND_V(!tmp, ERR_CANT_OPEN;)
-	const int bufsize = 16384;
-	uint8_t buf[bufsize];
-
-	while (true) {
-
-		int got = tmp->get_buffer(buf, bufsize);
-		if (got <= 0)
-			break;
-		dst->store_buffer(buf, got);
-	}
-
-	memdelete(tmp);
+	err = packer->flush();
+	if (err)
+		return err;
 
+	//trailer, so the pack can also be found at the end of an executable
 	dst->store_64(dst->get_pos() - ofs_begin);
 	dst->store_32(0x43504447); //GDPK
 
-	//fix offsets
-
-	dst->seek(fcountpos);
-	dst->store_32(pd.count);
-	for (int i = 0; i < pd.file_ofs.size(); i++) {
-
-		dst->seek(pd.file_ofs[i].pos);
-		dst->store_64(pd.file_ofs[i].ofs + ofsplus);
-		dst->store_64(pd.file_ofs[i].size);
-	}
-
 	return OK;
 }
 
@@ -1712,6 +1632,16 @@ bool EditorImportExport::get_convert_text_scenes() const {
 	return convert_text_scenes;
 }
 
+void EditorImportExport::set_pack_compression(PCKPacker::CompressionMode p_mode) {
+
+	pack_compression = p_mode;
+}
+
+PCKPacker::CompressionMode EditorImportExport::get_pack_compression() const {
+
+	return pack_compression;
+}
+
 void EditorImportExport::load_config() {
 
 	Ref<ConfigFile> cf = memnew(ConfigFile);
@@ -1760,6 +1690,11 @@ void EditorImportExport::load_config() {
 		convert_text_scenes = cf->get_value("convert_scenes", "convert_text_scenes");
 	}
 
+	if (cf->has_section("pack")) {
+
+		pack_compression = PCKPacker::CompressionMode(int(cf->get_value("pack", "compression")));
+	}
+
 	if (cf->has_section("export_filter_files")) {
 
 		String eff = "export_filter_files";
@@ -1998,6 +1933,7 @@ void EditorImportExport::save_config() {
 	}
 
 	cf->set_value("convert_scenes", "convert_text_scenes", convert_text_scenes);
+	cf->set_value("pack", "compression", pack_compression);
 
 	cf->set_value("script", "encrypt_key", script_key);
 
@@ -2163,6 +2099,7 @@ EditorImportExport::EditorImportExport() {
 	sample_action_trim = false;
 
 	convert_text_scenes = true;
+	pack_compression = PCKPacker::COMPRESSION_NONE;
 }
 
 EditorImportExport::~EditorImportExport() {
@@ -30,6 +30,7 @@
 #ifndef EDITOR_IMPORT_EXPORT_H
 #define EDITOR_IMPORT_EXPORT_H
 
+#include "io/pck_packer.h"
 #include "resource.h"
 #include "scene/main/node.h"
 #include "scene/resources/texture.h"
@@ -99,21 +100,11 @@ protected:
 	virtual String find_export_template(String template_file_name, String *err = NULL) const;
 	virtual bool exists_export_template(String template_file_name, String *err = NULL) const;
 
-	struct TempData {
-
-		uint64_t pos;
-		uint64_t ofs;
-		uint64_t size;
-	};
-
 	struct PackData {
 
-		FileAccess *ftmp;
-		FileAccess *f;
-		Vector<TempData> file_ofs;
+		PCKPacker *packer;
 		EditorProgress *ep;
 		int count;
-		int alignment;
 	};
 
 	struct ZipData {
@@ -303,6 +294,7 @@ protected:
 	bool sample_action_trim;
 
 	bool convert_text_scenes;
+	PCKPacker::CompressionMode pack_compression;
 
 	static EditorImportExport *singleton;
 
@@ -393,6 +385,9 @@ public:
 	void set_convert_text_scenes(bool p_convert);
 	bool get_convert_text_scenes() const;
 
+	void set_pack_compression(PCKPacker::CompressionMode p_mode);
+	PCKPacker::CompressionMode get_pack_compression() const;
+
 	void load_config();
 	void save_config();
 
@@ -301,6 +301,7 @@ void ProjectExportDialog::_notification(int p_what) {
 			_update_platform();
 			export_mode->select(EditorImportExport::get_singleton()->get_export_filter());
 			convert_text_scenes->set_pressed(EditorImportExport::get_singleton()->get_convert_text_scenes());
+			pack_compression->select(EditorImportExport::get_singleton()->get_pack_compression());
 			filters->set_text(EditorImportExport::get_singleton()->get_export_custom_filter());
 			filters_exclude->set_text(EditorImportExport::get_singleton()->get_export_custom_filter_exclude());
 			filters_exclude_dir->set_text(EditorImportExport::get_singleton()->get_export_custom_filter_exclude_dir());
@@ -423,6 +424,12 @@ void ProjectExportDialog::_export_mode_changed(int p_idx) {
 	_save_export_cfg();
 }
 
+void ProjectExportDialog::_pack_compression_changed(int p_idx) {
+
+	EditorImportExport::get_singleton()->set_pack_compression(PCKPacker::CompressionMode(p_idx));
+	_save_export_cfg();
+}
+
 void ProjectExportDialog::_export_action(const String &p_file) {
 
 	String location = Globals::get_singleton()->globalize_path(p_file).get_base_dir().replace("\\", "/");
@@ -1234,6 +1241,7 @@ void ProjectExportDialog::_bind_methods() {
 	ObjectTypeDB::bind_method(_MD("_platform_selected"), &ProjectExportDialog::_platform_selected);
 	ObjectTypeDB::bind_method(_MD("_prop_edited"), &ProjectExportDialog::_prop_edited);
 	ObjectTypeDB::bind_method(_MD("_export_mode_changed"), &ProjectExportDialog::_export_mode_changed);
+	ObjectTypeDB::bind_method(_MD("_pack_compression_changed"), &ProjectExportDialog::_pack_compression_changed);
 	ObjectTypeDB::bind_method(_MD("_filters_edited"), &ProjectExportDialog::_filters_edited);
 	ObjectTypeDB::bind_method(_MD("_filters_exclude_edited"), &ProjectExportDialog::_filters_exclude_edited);
 	ObjectTypeDB::bind_method(_MD("_filters_exclude_dir_edited"), &ProjectExportDialog::_filters_exclude_dir_edited);
@@ -1358,6 +1366,14 @@ ProjectExportDialog::ProjectExportDialog(EditorNode *p_editor) {
 	vb->add_child(convert_text_scenes);
 	convert_text_scenes->connect("toggled", this, "_export_mode_changed");
 
+	pack_compression = memnew(OptionButton);
+	pack_compression->add_item(TTR("None"));
+	pack_compression->add_item(TTR("Fast (FastLZ)"));
+	pack_compression->add_item(TTR("Small (Deflate)"));
+	pack_compression->add_item(TTR("Small, fast to load (Zstd)"));
+	vb->add_margin_child(TTR("Compress files in the pack:"), pack_compression);
+	pack_compression->connect("item_selected", this, "_pack_compression_changed");
+
 	image_vb = memnew(VBoxContainer);
 	image_vb->set_name(TTR("Images"));
 	image_action = memnew(OptionButton);
@@ -109,6 +109,7 @@ private:
 
 	OptionButton *export_mode;
 	CheckButton *convert_text_scenes;
+	OptionButton *pack_compression;
 	VBoxContainer *tree_vb;
 
 	VBoxContainer *image_vb;
@@ -147,6 +148,7 @@ private:
 	EditorFileDialog *keystore_file_dialog;
 
 	void _export_mode_changed(int p_idx);
+	void _pack_compression_changed(int p_idx);
 	void _prop_edited(String what);
 
 	void _update_platform();
@@ -30,8 +30,11 @@
 #include "main.h"
 #include "core/register_core_types.h"
 #include "drivers/register_driver_types.h"
+#include "frame_allocator.h"
 #include "globals.h"
 #include "input_map.h"
+#include "io/compression.h"
+#include "io/resource_load_queue.h"
 #include "io/resource_loader.h"
 #include "message_queue.h"
 #include "modules/register_module_types.h"
@@ -790,6 +793,12 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 
 	OS::get_singleton()->set_iterations_per_second(GLOBAL_DEF("physics/fixed_fps", 60));
 	OS::get_singleton()->set_target_fps(GLOBAL_DEF("debug/force_fps", 0));
+	Memory::set_dynamic_background_compaction(GLOBAL_DEF("memory/dynamic_pool/background_compaction", false));
+
+	Compression::zstd_level = GLOBAL_DEF("compression/zstd_level", 3);
+	Globals::get_singleton()->set_custom_property_info("compression/zstd_level", PropertyInfo(Variant::INT, "compression/zstd_level", PROPERTY_HINT_RANGE, "-5,22,1"));
+	GLOBAL_DEF("compression/binary_resource_mode", Compression::MODE_FASTLZ);
+	Globals::get_singleton()->set_custom_property_info("compression/binary_resource_mode", PropertyInfo(Variant::INT, "compression/binary_resource_mode", PROPERTY_HINT_ENUM, "FastLZ,Deflate,Zstd"));
 
 	if (!OS::get_singleton()->_verbose_stdout) //overrided
 		OS::get_singleton()->_verbose_stdout = GLOBAL_DEF("debug/verbose_stdout", false);
@@ -1580,6 +1589,9 @@ bool Main::iteration() {
 		ScriptServer::get_language(i)->frame();
 	}
 
+	//everything allocated as frame memory is released at once
+	FrameAllocator::get_singleton()->reset();
+
 	if (script_debugger) {
 		if (script_debugger->is_profiling()) {
 			script_debugger->profiling_set_frame_times(USEC_TO_SEC(frame_time), USEC_TO_SEC(idle_process_ticks), USEC_TO_SEC(fixed_process_ticks), frame_slice);
@@ -1651,6 +1663,9 @@ void Main::cleanup() {
 
 	OS::get_singleton()->delete_main_loop();
 
+	//drop queued loads while the types they create are still registered
+	ResourceLoadQueue::get_singleton()->finish();
+
 	OS::get_singleton()->_cmdline.clear();
 	OS::get_singleton()->_execpath = "";
 	OS::get_singleton()->_local_clipboard = "";
@@ -1664,6 +1679,8 @@ void Main::cleanup() {
 	unregister_scene_types();
 	unregister_server_types();
 
+	Memory::set_dynamic_background_compaction(false);
+
 	OS::get_singleton()->finalize();
 
 	if (packed_data)
@@ -67,6 +67,9 @@ void Performance::_bind_methods() {
 	BIND_CONSTANT(PHYSICS_3D_ACTIVE_OBJECTS);
 	BIND_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
+	BIND_CONSTANT(STRING_NAME_INTERN_HITS);
+	BIND_CONSTANT(STRING_NAME_INTERN_MISSES);
+	BIND_CONSTANT(MEMORY_DYNAMIC_RESERVED);
 
 	BIND_CONSTANT(MONITOR_MAX);
 }
@@ -103,6 +106,9 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/active_objects",
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
+		"string_name/intern_hits",
+		"string_name/intern_misses",
+		"memory/dynamic_reserved",
 
 	};
 
@@ -148,6 +154,9 @@ float Performance::get_monitor(Monitor p_monitor) const {
 		case PHYSICS_3D_ACTIVE_OBJECTS: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_ACTIVE_OBJECTS);
 		case PHYSICS_3D_COLLISION_PAIRS: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_COLLISION_PAIRS);
 		case PHYSICS_3D_ISLAND_COUNT: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_ISLAND_COUNT);
+		case STRING_NAME_INTERN_HITS: return StringName::get_intern_hits();
+		case STRING_NAME_INTERN_MISSES: return StringName::get_intern_misses();
+		case MEMORY_DYNAMIC_RESERVED: return Memory::get_dynamic_mem_reserved();
 
 		default: {}
 	}
@@ -76,6 +76,9 @@ public:
 		PHYSICS_3D_COLLISION_PAIRS,
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
+		STRING_NAME_INTERN_HITS,
+		STRING_NAME_INTERN_MISSES,
+		MEMORY_DYNAMIC_RESERVED,
 		MONITOR_MAX
 	};
 
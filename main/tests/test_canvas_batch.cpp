@@ -0,0 +1,442 @@
+/*************************************************************************/
+/*  test_canvas_batch.cpp                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_canvas_batch.h"
+
+#include "math_funcs.h"
+#include "print_string.h"
+#include "rid.h"
+#include "servers/visual/rasterizer_canvas_batch.h"
+#include "vector.h"
+
+namespace TestCanvasBatch {
+
+/* BATCHED VS UNBATCHED CANVAS GEOMETRY */
+
+enum {
+	TEST_ITEMS = 400,
+	TEST_TEXTURES = 3
+};
+
+struct Vertex {
+
+	Vector2 vertex;
+	Vector2 uv;
+	Color color;
+};
+
+// one canvas command as the rasterizers receive it
+struct Command {
+
+	enum Type {
+		TYPE_RECT,
+		TYPE_STYLE,
+		TYPE_POLYGON,
+		TYPE_TRANSFORM
+	};
+
+	Type type;
+	RID texture;
+	Size2 tex_size;
+	Rect2 rect;
+	Rect2 source;
+	int flags;
+	float margin[4];
+	bool draw_center;
+	Color color;
+	Vector<Vector2> points;
+	Vector<Vector2> uvs;
+	Vector<Color> colors;
+	Vector<int> indices;
+	Matrix32 xform;
+};
+
+struct Item {
+
+	Matrix32 xform;
+	float opacity;
+	Vector<Command> commands;
+};
+
+// the geometry sent to the GPU, in canvas space, as triangles
+struct Draw {
+
+	RID texture;
+	Vector<Vertex> triangles;
+};
+
+static Vector2 _random_point(float p_range) {
+
+	return Vector2(Math::random(-p_range, p_range), Math::random(-p_range, p_range));
+}
+
+static Color _random_color() {
+
+	return Color(Math::randf(), Math::randf(), Math::randf(), Math::randf());
+}
+
+static Vector<Item> _make_items(const RID *p_textures) {
+
+	Vector<Item> items;
+	items.resize(TEST_ITEMS);
+
+	for (int i = 0; i < TEST_ITEMS; i++) {
+
+		Item &item = items[i];
+		item.xform = Matrix32(Math::random(-Math_PI, Math_PI), _random_point(500));
+		item.xform.scale_basis(Size2(Math::random(0.5, 2), Math::random(0.5, 2)));
+		item.opacity = Math::random(0.2, 1);
+
+		int count = 1 + Math::rand() % 4;
+		for (int j = 0; j < count; j++) {
+
+			Command c;
+			// most items share a texture, as sprites from one atlas do
+			int tex = Math::rand() % (TEST_TEXTURES + 2);
+			c.texture = tex < TEST_TEXTURES ? p_textures[tex] : p_textures[0];
+			c.tex_size = Size2(64 << (tex % TEST_TEXTURES), 32 << (tex % TEST_TEXTURES));
+			c.rect = Rect2(_random_point(100), Size2(Math::random(1, 200), Math::random(1, 200)));
+			c.source = Rect2(Math::random(0, 16), Math::random(0, 16), Math::random(8, 32), Math::random(8, 32));
+			c.flags = Math::rand() & (Rasterizer::CANVAS_RECT_REGION | Rasterizer::CANVAS_RECT_FLIP_H | Rasterizer::CANVAS_RECT_FLIP_V | Rasterizer::CANVAS_RECT_TRANSPOSE);
+			c.color = _random_color();
+			c.draw_center = Math::rand() & 1;
+			for (int k = 0; k < 4; k++)
+				c.margin[k] = Math::random(0, 8);
+
+			switch (Math::rand() % 6) {
+				case 0: {
+
+					c.type = Command::TYPE_RECT;
+					c.texture = RID();
+				} break;
+				case 1:
+				case 2: {
+
+					c.type = Command::TYPE_RECT;
+				} break;
+				case 3: {
+
+					c.type = Command::TYPE_STYLE;
+				} break;
+				case 4: {
+
+					c.type = Command::TYPE_POLYGON;
+					int points = 3 + Math::rand() % 6;
+					int color_mode = Math::rand() % 3; // none, single, per vertex
+					for (int k = 0; k < points; k++) {
+						c.points.push_back(_random_point(100));
+						c.uvs.push_back(Vector2(Math::randf(), Math::randf()));
+						if (color_mode == 2 || (color_mode == 1 && k == 0))
+							c.colors.push_back(_random_color());
+					}
+					// a fan, or unindexed triangles when the point count allows
+					if (points % 3 || Math::rand() & 1) {
+						for (int k = 1; k < points - 1; k++) {
+							c.indices.push_back(0);
+							c.indices.push_back(k);
+							c.indices.push_back(k + 1);
+						}
+					}
+					if (Math::rand() % 3 == 0)
+						c.texture = RID();
+				} break;
+				case 5: {
+
+					c.type = Command::TYPE_TRANSFORM;
+					c.xform = Matrix32(Math::random(-Math_PI, Math_PI), _random_point(50));
+				} break;
+			}
+
+			item.commands.push_back(c);
+		}
+	}
+
+	return items;
+}
+
+/* UNBATCHED REFERENCE */
+
+static void _fan(Draw &r_draw, const Matrix32 &p_xform, const Vector2 *p_points, const Vector2 *p_uvs, const Color &p_color) {
+
+	// unbatched quads are drawn as a triangle fan
+	static const int fan[6] = { 0, 1, 2, 0, 2, 3 };
+	for (int i = 0; i < 6; i++) {
+
+		Vertex v;
+		v.vertex = p_xform.xform(p_points[fan[i]]);
+		v.uv = p_uvs ? p_uvs[fan[i]] : Vector2();
+		v.color = p_color;
+		r_draw.triangles.push_back(v);
+	}
+}
+
+static void _quad_points(const Rect2 &p_rect, Vector2 *r_points) {
+
+	r_points[0] = p_rect.pos;
+	r_points[1] = p_rect.pos + Vector2(p_rect.size.width, 0);
+	r_points[2] = p_rect.pos + p_rect.size;
+	r_points[3] = p_rect.pos + Vector2(0, p_rect.size.height);
+}
+
+static void _unbatched(const Vector<Item> &p_items, Vector<Draw> &r_draws) {
+
+	for (int i = 0; i < p_items.size(); i++) {
+
+		const Item &item = p_items[i];
+		Matrix32 xform = item.xform;
+
+		for (int j = 0; j < item.commands.size(); j++) {
+
+			const Command &c = item.commands[j];
+			Color m = c.color;
+			m.a *= item.opacity;
+
+			Draw draw;
+			draw.texture = c.texture;
+			Vector2 points[4];
+
+			switch (c.type) {
+				case Command::TYPE_RECT: {
+
+					_quad_points(c.rect, points);
+					if (!c.texture.is_valid()) {
+						_fan(draw, xform, points, NULL, m);
+						break;
+					}
+
+					// uv of each corner, written out instead of swapping like the rasterizers
+					Rect2 region = (c.flags & Rasterizer::CANVAS_RECT_REGION) ? c.source : Rect2(Point2(), c.tex_size);
+					static const int corners[4][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+					Vector2 uvs[4];
+					for (int k = 0; k < 4; k++) {
+						int x = corners[k][0];
+						int y = corners[k][1];
+						if (c.flags & Rasterizer::CANVAS_RECT_FLIP_V)
+							y = 1 - y;
+						if (c.flags & Rasterizer::CANVAS_RECT_FLIP_H)
+							x = 1 - x;
+						if (c.flags & Rasterizer::CANVAS_RECT_TRANSPOSE)
+							SWAP(x, y);
+						uvs[k] = (region.pos + region.size * Vector2(x, y)) / c.tex_size;
+					}
+					_fan(draw, xform, points, uvs, m);
+				} break;
+				case Command::TYPE_STYLE: {
+
+					Rect2 region = c.source;
+					Rect2 rects[9];
+					Rect2 sources[9];
+					int count = RasterizerCanvasBatch::get_style_box_quads(c.rect, region, c.margin, c.draw_center, rects, sources);
+					for (int k = 0; k < count; k++) {
+						Vector2 uvs[4];
+						_quad_points(rects[k], points);
+						_quad_points(sources[k], uvs);
+						for (int l = 0; l < 4; l++)
+							uvs[l] = uvs[l] / c.tex_size;
+						_fan(draw, xform, points, uvs, m);
+					}
+				} break;
+				case Command::TYPE_POLYGON: {
+
+					// the colors canvas_draw_polygon sets
+					bool single = c.colors.size() == 1;
+					Color pm(1, 1, 1, item.opacity);
+					if (single) {
+						pm = c.colors[0];
+						pm.a *= item.opacity;
+					}
+					int count = c.indices.size() ? c.indices.size() : c.points.size();
+					for (int k = 0; k < count; k++) {
+						int idx = c.indices.size() ? c.indices[k] : k;
+						Vertex v;
+						v.vertex = xform.xform(c.points[idx]);
+						v.uv = c.texture.is_valid() ? c.uvs[idx] : Vector2();
+						v.color = (c.colors.size() && !single) ? c.colors[idx] : pm;
+						draw.triangles.push_back(v);
+					}
+				} break;
+				case Command::TYPE_TRANSFORM: {
+
+					xform = item.xform * c.xform;
+					continue;
+				} break;
+			}
+
+			r_draws.push_back(draw);
+		}
+	}
+}
+
+/* BATCHED, AS THE RASTERIZERS DRIVE IT */
+
+static void _flush(RasterizerCanvasBatch &p_batch, Vector<Draw> &r_draws) {
+
+	if (p_batch.is_empty())
+		return;
+
+	Draw draw;
+	draw.texture = p_batch.get_texture();
+	const RasterizerCanvasBatch::Vertex *vertices = p_batch.get_vertices();
+	const uint16_t *indices = p_batch.get_indices();
+	for (int i = 0; i < p_batch.get_index_count(); i++) {
+
+		Vertex v;
+		v.vertex = vertices[indices[i]].vertex;
+		v.uv = vertices[indices[i]].uv;
+		v.color = vertices[indices[i]].color;
+		draw.triangles.push_back(v);
+	}
+	r_draws.push_back(draw);
+	p_batch.clear();
+}
+
+static void _batched(const Vector<Item> &p_items, Vector<Draw> &r_draws) {
+
+	RasterizerCanvasBatch batch;
+
+	for (int i = 0; i < p_items.size(); i++) {
+
+		const Item &item = p_items[i];
+		batch.set_transform(item.xform);
+
+		for (int j = 0; j < item.commands.size(); j++) {
+
+			const Command &c = item.commands[j];
+			Color m = c.color;
+			m.a *= item.opacity;
+
+			switch (c.type) {
+				case Command::TYPE_RECT: {
+
+					if (!batch.can_add(c.texture, RasterizerCanvasBatch::QUAD_VERTICES, RasterizerCanvasBatch::QUAD_INDICES))
+						_flush(batch, r_draws);
+					batch.add_rect(c.texture, c.tex_size, c.rect, c.flags, c.source, m);
+				} break;
+				case Command::TYPE_STYLE: {
+
+					if (!batch.can_add(c.texture, RasterizerCanvasBatch::STYLE_BOX_VERTICES, RasterizerCanvasBatch::STYLE_BOX_INDICES))
+						_flush(batch, r_draws);
+					batch.add_style_box(c.texture, c.tex_size, c.rect, c.source, c.margin, c.draw_center, m);
+				} break;
+				case Command::TYPE_POLYGON: {
+
+					bool single = c.colors.size() == 1;
+					Color pm(1, 1, 1, item.opacity);
+					if (single) {
+						pm = c.colors[0];
+						pm.a *= item.opacity;
+					}
+					int count = c.indices.size() ? c.indices.size() : c.points.size();
+					if (!batch.can_add(c.texture, count, count))
+						_flush(batch, r_draws);
+					batch.add_polygon(c.texture, count, c.indices.size() ? c.indices.ptr() : NULL, c.points.ptr(), c.uvs.ptr(), (c.colors.size() && !single) ? c.colors.ptr() : NULL, pm);
+				} break;
+				case Command::TYPE_TRANSFORM: {
+
+					batch.set_transform(item.xform * c.xform);
+				} break;
+			}
+		}
+	}
+
+	_flush(batch, r_draws);
+}
+
+static bool _compare(const Vector<Draw> &p_unbatched, const Vector<Draw> &p_batched, int *r_expected_draws) {
+
+	// batches must hold the same triangles in the same order, only split where the texture changes or one is full
+	int b = 0;
+	int b_ofs = 0;
+	*r_expected_draws = 0;
+	float max_diff = 0;
+
+	for (int i = 0; i < p_unbatched.size(); i++) {
+
+		const Draw &u = p_unbatched[i];
+		if (i == 0 || u.texture != p_unbatched[i - 1].texture)
+			(*r_expected_draws)++;
+
+		for (int j = 0; j < u.triangles.size(); j++) {
+
+			if (b < p_batched.size() && b_ofs == p_batched[b].triangles.size()) {
+				b++;
+				b_ofs = 0;
+			}
+			if (b >= p_batched.size() || p_batched[b].texture != u.texture) {
+				print_line("Batch " + itos(b) + " is missing geometry of command " + itos(i) + ".");
+				return false;
+			}
+
+			const Vertex &uv = u.triangles[j];
+			const Vertex &bv = p_batched[b].triangles[b_ofs++];
+			max_diff = MAX(max_diff, uv.vertex.distance_to(bv.vertex));
+			max_diff = MAX(max_diff, uv.uv.distance_to(bv.uv));
+			for (int k = 0; k < 4; k++)
+				max_diff = MAX(max_diff, Math::abs(uv.color.components[k] - bv.color.components[k]));
+		}
+	}
+
+	if (b != p_batched.size() - 1 || b_ofs != p_batched[b].triangles.size()) {
+		print_line("Batches hold more geometry than the commands.");
+		return false;
+	}
+
+	print_line("Max difference: " + rtos(max_diff));
+	return max_diff < 1e-3;
+}
+
+MainLoop *test() {
+
+	RID_Owner<int> texture_owner;
+	int texture_data[TEST_TEXTURES];
+	RID textures[TEST_TEXTURES];
+	for (int i = 0; i < TEST_TEXTURES; i++)
+		textures[i] = texture_owner.make_rid(&texture_data[i]);
+
+	Vector<Item> items = _make_items(textures);
+
+	Vector<Draw> unbatched;
+	Vector<Draw> batched;
+	_unbatched(items, unbatched);
+	_batched(items, batched);
+
+	int expected_draws;
+	bool ok = _compare(unbatched, batched, &expected_draws);
+	// a batch can also end because it's full, but not this often with a few hundred items
+	ok = ok && batched.size() <= expected_draws + expected_draws / 4 + 1;
+
+	print_line("Commands: " + itos(unbatched.size()) + ", texture changes: " + itos(expected_draws) + ", batches: " + itos(batched.size()));
+	print_line(ok ? "Batched geometry matches." : "Batched geometry differs!");
+
+	for (int i = 0; i < TEST_TEXTURES; i++)
+		texture_owner.free(textures[i]);
+
+	return NULL;
+}
+}
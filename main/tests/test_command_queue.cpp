@@ -0,0 +1,222 @@
+/*************************************************************************/
+/*  test_command_queue.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2016 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_command_queue.h"
+
+#include "command_queue_mt.h"
+#include "os/os.h"
+#include "os/thread.h"
+#include "print_string.h"
+
+namespace TestCommandQueue {
+
+/* THROUGHPUT BENCHMARK */
+
+enum {
+	CQ_COMMANDS_PER_THREAD = 200000,
+	CQ_RET_COMMANDS_PER_THREAD = 20000,
+	CQ_MAX_PRODUCERS = 8
+};
+
+class CQReceiver {
+public:
+	uint64_t sum;
+	bool exit;
+
+	void add(int p_value) { sum += p_value; }
+	void add_transform(int p_value, Transform p_xform) { sum += p_value; }
+	int echo(int p_value) {
+		sum++;
+		return p_value;
+	}
+	void quit() { exit = true; }
+};
+
+struct CQBenchmark {
+
+	CommandQueueMT *queue;
+	CQReceiver receiver;
+};
+
+static void _cq_consumer(void *p_userdata) {
+
+	CQBenchmark *bench = (CQBenchmark *)p_userdata;
+
+	while (!bench->receiver.exit) {
+		bench->queue->wait_and_flush_one();
+	}
+}
+
+static void _cq_producer(void *p_userdata) {
+
+	CQBenchmark *bench = (CQBenchmark *)p_userdata;
+	Transform xform;
+
+	for (int i = 0; i < CQ_COMMANDS_PER_THREAD; i++) {
+
+		// mix small commands with bigger ones, like a server receiving transforms
+		if (i & 1)
+			bench->queue->push(&bench->receiver, &CQReceiver::add_transform, 1, xform);
+		else
+			bench->queue->push(&bench->receiver, &CQReceiver::add, 1);
+	}
+}
+
+/* RETURN VALUES FROM SEVERAL PRODUCERS */
+
+struct CQRetProducer {
+
+	CQBenchmark *bench;
+	int index;
+	int mismatches;
+};
+
+static void _cq_ret_producer(void *p_userdata) {
+
+	CQRetProducer *producer = (CQRetProducer *)p_userdata;
+
+	for (int i = 0; i < CQ_RET_COMMANDS_PER_THREAD; i++) {
+
+		// a wait woken by another producer's command returns before this one ran
+		int value = producer->index * CQ_RET_COMMANDS_PER_THREAD + i;
+		int ret = -1;
+		producer->bench->queue->push_and_ret(&producer->bench->receiver, &CQReceiver::echo, value, &ret);
+		if (ret != value)
+			producer->mismatches++;
+	}
+}
+
+static bool _cq_ret_test(const String &p_name, bool p_lockless, int p_producers) {
+
+	CQBenchmark bench;
+	bench.queue = memnew(CommandQueueMT(true, p_lockless));
+	bench.receiver.sum = 0;
+	bench.receiver.exit = false;
+
+	Thread *consumer = Thread::create(_cq_consumer, &bench);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	CQRetProducer producer_data[CQ_MAX_PRODUCERS];
+	Thread *producers[CQ_MAX_PRODUCERS];
+	for (int i = 0; i < p_producers; i++) {
+		producer_data[i].bench = &bench;
+		producer_data[i].index = i;
+		producer_data[i].mismatches = 0;
+		producers[i] = Thread::create(_cq_ret_producer, &producer_data[i]);
+	}
+
+	int mismatches = 0;
+	for (int i = 0; i < p_producers; i++) {
+		Thread::wait_to_finish(producers[i]);
+		memdelete(producers[i]);
+		mismatches += producer_data[i].mismatches;
+	}
+
+	bench.queue->push(&bench.receiver, &CQReceiver::quit);
+	Thread::wait_to_finish(consumer);
+	memdelete(consumer);
+
+	uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, 1);
+	uint64_t expected = (uint64_t)CQ_RET_COMMANDS_PER_THREAD * p_producers;
+
+	print_line(p_name + " push_and_ret, " + itos(p_producers) + " producers: " + itos(elapsed) + " usec, " + itos(expected * 1000000 / elapsed) + " calls/sec");
+
+	memdelete(bench.queue);
+
+	if (mismatches || bench.receiver.sum != expected) {
+		print_line("\tFAIL: " + itos(mismatches) + " calls returned before their command ran, executed " + itos(bench.receiver.sum) + " commands, expected " + itos(expected));
+		return false;
+	}
+
+	return true;
+}
+
+static bool _cq_benchmark(const String &p_name, bool p_lockless, int p_producers) {
+
+	CQBenchmark bench;
+	bench.queue = memnew(CommandQueueMT(true, p_lockless));
+	bench.receiver.sum = 0;
+	bench.receiver.exit = false;
+
+	Thread *consumer = Thread::create(_cq_consumer, &bench);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	Thread *producers[CQ_MAX_PRODUCERS];
+	for (int i = 0; i < p_producers; i++) {
+		producers[i] = Thread::create(_cq_producer, &bench);
+	}
+
+	for (int i = 0; i < p_producers; i++) {
+		Thread::wait_to_finish(producers[i]);
+		memdelete(producers[i]);
+	}
+
+	bench.queue->push(&bench.receiver, &CQReceiver::quit);
+	Thread::wait_to_finish(consumer);
+	memdelete(consumer);
+
+	uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, 1);
+	uint64_t expected = (uint64_t)CQ_COMMANDS_PER_THREAD * p_producers;
+
+	print_line(p_name + ", " + itos(p_producers) + " producers: " + itos(elapsed) + " usec, " + itos(expected * 1000000 / elapsed) + " commands/sec");
+
+	memdelete(bench.queue);
+
+	if (bench.receiver.sum != expected) {
+		print_line("\tFAIL: executed " + itos(bench.receiver.sum) + " commands, expected " + itos(expected));
+		return false;
+	}
+
+	return true;
+}
+
+MainLoop *test() {
+
+	print_line("CommandQueueMT benchmark: " + itos(CQ_COMMANDS_PER_THREAD) + " commands per producer");
+
+	bool ok = true;
+
+	for (int producers = 1; producers <= CQ_MAX_PRODUCERS; producers *= 2) {
+
+		ok = _cq_benchmark("Mutex", false, producers) && ok;
+		ok = _cq_benchmark("Lock-free", true, producers) && ok;
+	}
+
+	for (int producers = 1; producers <= CQ_MAX_PRODUCERS; producers *= 2) {
+
+		ok = _cq_ret_test("Mutex", false, producers) && ok;
+		ok = _cq_ret_test("Lock-free", true, producers) && ok;
+	}
+
+	print_line(ok ? "All commands executed." : "Some commands were lost or returned early!");
+
+	return NULL;
+}
+}
@@ -0,0 +1,214 @@
+/*************************************************************************/
+/*  test_compression.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_compression.h"
+
+#include "globals.h"
+#include "io/compression.h"
+#include "math_funcs.h"
+#include "os/dir_access.h"
+#include "os/file_access.h"
+#include "os/os.h"
+#include "print_string.h"
+#include "vector.h"
+
+namespace TestCompression {
+
+/* COMPRESSION BENCHMARK */
+
+enum {
+	// what FileAccessCompressed and the pack exporter use
+	BLOCK_SIZE = 16384,
+	DECOMPRESS_PASSES = 5,
+	MAX_TOTAL_SIZE = 32 * 1024 * 1024
+};
+
+struct Block {
+
+	int src_ofs;
+	int src_size;
+	int comp_ofs;
+	int comp_size;
+};
+
+struct Method {
+
+	const char *name;
+	Compression::Mode mode;
+	int level;
+};
+
+static void _gather(const String &p_dir, Vector<String> &r_files) {
+
+	DirAccess *da = DirAccess::open(p_dir);
+	if (!da)
+		return;
+
+	Vector<String> subdirs;
+	da->list_dir_begin();
+	String n = da->get_next();
+	while (n != String()) {
+
+		// skips ".", ".." and hidden folders such as .git or .import
+		if (!n.begins_with(".")) {
+
+			if (da->current_is_dir())
+				subdirs.push_back(p_dir.plus_file(n));
+			else
+				r_files.push_back(p_dir.plus_file(n));
+		}
+		n = da->get_next();
+	}
+	da->list_dir_end();
+	memdelete(da);
+
+	for (int i = 0; i < subdirs.size(); i++)
+		_gather(subdirs[i], r_files);
+}
+
+static String _mbs(uint64_t p_bytes, uint64_t p_usec) {
+
+	return rtos(Math::stepify(double(p_bytes) / MAX(p_usec, 1), 0.1)) + " MB/s";
+}
+
+MainLoop *test() {
+
+	Vector<String> files;
+	_gather("res://", files);
+
+	// files are split in blocks separately, as they are when saved compressed
+	Vector<uint8_t> data;
+	Vector<Block> blocks;
+	int file_count = 0;
+
+	for (int i = 0; i < files.size() && data.size() < MAX_TOTAL_SIZE; i++) {
+
+		FileAccess *f = FileAccess::open(files[i], FileAccess::READ);
+		if (!f)
+			continue;
+
+		int len = MIN(f->get_len(), size_t(MAX_TOTAL_SIZE - data.size()));
+		if (len == 0) {
+			memdelete(f);
+			continue;
+		}
+
+		int ofs = data.size();
+		data.resize(ofs + len);
+		f->get_buffer(&data[ofs], len);
+		memdelete(f);
+
+		for (int j = 0; j < len; j += BLOCK_SIZE) {
+
+			Block b;
+			b.src_ofs = ofs + j;
+			b.src_size = MIN(BLOCK_SIZE, len - j);
+			b.comp_ofs = 0;
+			b.comp_size = 0;
+			blocks.push_back(b);
+		}
+		file_count++;
+	}
+
+	if (data.size() == 0) {
+
+		print_line("Compression benchmark: no files found in res://, run it with -path pointing to a project.");
+		return NULL;
+	}
+
+	print_line("Compression benchmark: " + itos(file_count) + " files from " + Globals::get_singleton()->get_resource_path() + ", " + itos(data.size() / 1024) + " KiB in " + itos(blocks.size()) + " blocks of " + itos(BLOCK_SIZE / 1024) + " KiB");
+
+	const Method methods[] = {
+		{ "FastLZ", Compression::MODE_FASTLZ, 0 },
+		{ "Deflate", Compression::MODE_DEFLATE, 0 },
+		{ "Zstd -5", Compression::MODE_ZSTD, -5 },
+		{ "Zstd 1", Compression::MODE_ZSTD, 1 },
+		{ "Zstd 3", Compression::MODE_ZSTD, 3 },
+		{ "Zstd 9", Compression::MODE_ZSTD, 9 },
+		{ "Zstd 19", Compression::MODE_ZSTD, 19 },
+	};
+
+	int zstd_level = Compression::zstd_level;
+	Vector<uint8_t> comp;
+	Vector<uint8_t> dst;
+	dst.resize(BLOCK_SIZE);
+	bool all_ok = true;
+
+	for (int m = 0; m < int(sizeof(methods) / sizeof(methods[0])); m++) {
+
+		const Method &method = methods[m];
+		Compression::zstd_level = method.level;
+
+		comp.resize(blocks.size() * Compression::get_max_compressed_buffer_size(BLOCK_SIZE, method.mode));
+		int comp_total = 0;
+		bool ok = true;
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < blocks.size() && ok; i++) {
+
+			Block &b = blocks[i];
+			b.comp_ofs = comp_total;
+			b.comp_size = Compression::compress(&comp[comp_total], &data[b.src_ofs], b.src_size, method.mode);
+			if (b.comp_size < 0)
+				ok = false;
+			else
+				comp_total += b.comp_size;
+		}
+		uint64_t compress_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		if (!ok) {
+			print_line(String(method.name) + ": compression failed!");
+			all_ok = false;
+			continue;
+		}
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int p = 0; p < DECOMPRESS_PASSES; p++) {
+
+			for (int i = 0; i < blocks.size(); i++) {
+
+				const Block &b = blocks[i];
+				Compression::decompress(dst.ptr(), b.src_size, &comp[b.comp_ofs], b.comp_size, method.mode);
+				if (p == 0 && memcmp(dst.ptr(), &data[b.src_ofs], b.src_size) != 0)
+					ok = false;
+			}
+		}
+		uint64_t decompress_usec = (OS::get_singleton()->get_ticks_usec() - begin) / DECOMPRESS_PASSES;
+
+		print_line(String(method.name) + ": " + rtos(Math::stepify(comp_total * 100.0 / data.size(), 0.1)) + "% of the original size, compress " + _mbs(data.size(), compress_usec) + ", decompress " + _mbs(data.size(), decompress_usec) + (ok ? "" : " (data does not match!)"));
+		all_ok = all_ok && ok;
+	}
+
+	Compression::zstd_level = zstd_level;
+
+	print_line(all_ok ? "All methods decompress to the original data." : "Some methods did not decompress to the original data!");
+
+	return NULL;
+}
+}
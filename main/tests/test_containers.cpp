@@ -28,7 +28,11 @@
 /*************************************************************************/
 #include "test_containers.h"
 #include "dvector.h"
+#include "hash_map.h"
+#include "map.h"
 #include "math_funcs.h"
+#include "oa_hash_map.h"
+#include "os/os.h"
 #include "print_string.h"
 #include "set.h"
 
@@ -38,8 +42,289 @@
 
 namespace TestContainers {
 
+/* MAP BENCHMARK */
+
+enum {
+	MAP_ELEMENTS = 100000,
+	MAP_LOOKUP_ROUNDS = 10
+};
+
+static void _print_timing(const String &p_name, const String &p_op, uint64_t p_begin) {
+
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - p_begin;
+	print_line("\t" + p_name + " " + p_op + ": " + itos(elapsed) + " usec");
+}
+
+template <class T>
+static bool _benchmark_hash_map(const String &p_name, const Vector<String> &p_keys) {
+
+	T map;
+	bool ok = true;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_keys.size(); i++) {
+		map[p_keys[i]] = i;
+	}
+	_print_timing(p_name, "insert", begin);
+
+	int64_t sum = 0;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int r = 0; r < MAP_LOOKUP_ROUNDS; r++) {
+		for (int i = 0; i < p_keys.size(); i++) {
+			const int *v = map.getptr(p_keys[i]);
+			if (v)
+				sum += *v;
+		}
+	}
+	_print_timing(p_name, "lookup", begin);
+
+	int count = 0;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int r = 0; r < MAP_LOOKUP_ROUNDS; r++) {
+		const String *k = NULL;
+		while ((k = map.next(k))) {
+			count++;
+		}
+	}
+	_print_timing(p_name, "iterate", begin);
+
+	int64_t expected = (int64_t)p_keys.size() * (p_keys.size() - 1) / 2 * MAP_LOOKUP_ROUNDS;
+	if (sum != expected || count != p_keys.size() * MAP_LOOKUP_ROUNDS) {
+		print_line("\tFAIL: " + p_name + " returned wrong values");
+		ok = false;
+	}
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_keys.size(); i += 2) {
+		map.erase(p_keys[i]);
+	}
+	_print_timing(p_name, "erase half", begin);
+
+	for (int i = 0; i < p_keys.size(); i++) {
+		if (map.has(p_keys[i]) != (i & 1)) {
+			print_line("\tFAIL: " + p_name + " has wrong keys after erasing");
+			ok = false;
+			break;
+		}
+	}
+
+	return ok;
+}
+
+static bool _benchmark_map(const Vector<String> &p_keys) {
+
+	Map<String, int> map;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_keys.size(); i++) {
+		map[p_keys[i]] = i;
+	}
+	_print_timing("Map", "insert", begin);
+
+	int64_t sum = 0;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int r = 0; r < MAP_LOOKUP_ROUNDS; r++) {
+		for (int i = 0; i < p_keys.size(); i++) {
+			Map<String, int>::Element *E = map.find(p_keys[i]);
+			if (E)
+				sum += E->get();
+		}
+	}
+	_print_timing("Map", "lookup", begin);
+
+	int count = 0;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int r = 0; r < MAP_LOOKUP_ROUNDS; r++) {
+		for (Map<String, int>::Element *E = map.front(); E; E = E->next()) {
+			count++;
+		}
+	}
+	_print_timing("Map", "iterate", begin);
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_keys.size(); i += 2) {
+		map.erase(p_keys[i]);
+	}
+	_print_timing("Map", "erase half", begin);
+
+	int64_t expected = (int64_t)p_keys.size() * (p_keys.size() - 1) / 2 * MAP_LOOKUP_ROUNDS;
+	return sum == expected && count == p_keys.size() * MAP_LOOKUP_ROUNDS && map.size() == p_keys.size() / 2;
+}
+
+static bool _benchmark_maps() {
+
+	Vector<String> keys;
+	keys.resize(MAP_ELEMENTS);
+	for (int i = 0; i < MAP_ELEMENTS; i++) {
+		keys[i] = "key_" + itos(i);
+	}
+
+	print_line("Map benchmark: " + itos(MAP_ELEMENTS) + " String keys, " + itos(MAP_LOOKUP_ROUNDS) + " lookup and iteration rounds");
+
+	bool ok = true;
+	ok = _benchmark_hash_map<HashMap<String, int> >("HashMap", keys) && ok;
+	ok = _benchmark_hash_map<OAHashMap<String, int> >("OAHashMap", keys) && ok;
+	ok = _benchmark_map(keys) && ok;
+
+	print_line(ok ? "All maps returned the right values." : "Some maps returned wrong values!");
+
+	return ok;
+}
+
+/* DICTIONARY */
+
+enum {
+	DICT_ELEMENTS = 1000
+};
+
+static bool _check(bool p_ok, const String &p_what) {
+
+	if (!p_ok)
+		print_line("\tFAIL: Dictionary " + p_what);
+	return p_ok;
+}
+
+// true if the dictionary holds exactly "key_<i>": i for each i in p_order, iterated in that order
+static bool _dictionary_matches(const Dictionary &p_dict, const Vector<int> &p_order) {
+
+	if (p_dict.size() != p_order.size())
+		return false;
+
+	int idx = 0;
+	for (const Variant *k = p_dict.next(); k; k = p_dict.next(k)) {
+
+		if (idx >= p_order.size() || *k != Variant("key_" + itos(p_order[idx])) || p_dict[*k] != Variant(p_order[idx]))
+			return false;
+		idx++;
+	}
+
+	return idx == p_order.size();
+}
+
+static bool _test_dictionary() {
+
+	print_line("Dictionary: insertion order, erasing while iterating, compaction, copy on write");
+
+	bool ok = true;
+
+	// insertion order, with keys hashing all over the index
+	Dictionary dict;
+	Vector<int> order;
+	for (int i = 0; i < DICT_ELEMENTS; i++) {
+		int n = (i * 7919) % DICT_ELEMENTS;
+		dict["key_" + itos(n)] = n;
+		order.push_back(n);
+	}
+	ok = _check(_dictionary_matches(dict, order), "does not iterate in insertion order") && ok;
+
+	// overwriting a value keeps the key in place
+	dict["key_" + itos(order[0])] = order[0];
+	ok = _check(_dictionary_matches(dict, order), "moved a key when its value was set again") && ok;
+
+	// keys() and values() follow the same order
+	Array keys = dict.keys();
+	Array values = dict.values();
+	bool same_order = keys.size() == order.size() && values.size() == order.size();
+	for (int i = 0; same_order && i < order.size(); i++)
+		same_order = keys[i] == Variant("key_" + itos(order[i])) && values[i] == Variant(order[i]);
+	ok = _check(same_order, "keys() or values() differ from the iteration order") && ok;
+
+	// erasing the current key while iterating with next() goes on from the following one
+	int visited = 0;
+	Vector<int> kept;
+	for (const Variant *k = dict.next(); k; k = dict.next(k)) {
+
+		int n = dict[*k];
+		if (visited >= order.size() || n != order[visited])
+			break;
+		if (n % 3 == 0)
+			dict.erase(*k);
+		else
+			kept.push_back(n);
+		visited++;
+	}
+	ok = _check(visited == order.size(), "skipped or repeated keys when erasing while iterating") && ok;
+	ok = _check(_dictionary_matches(dict, kept), "kept wrong keys after erasing while iterating") && ok;
+
+	// the same through Variant iteration, as a script for loop does it
+	Variant var_dict = dict;
+	Variant iter;
+	bool valid = true;
+	visited = 0;
+	Vector<int> var_kept;
+	if (var_dict.iter_init(iter, valid)) {
+		do {
+			Variant k = var_dict.iter_get(iter, valid);
+			int n = dict[k];
+			if (visited >= kept.size() || n != kept[visited])
+				break;
+			if (n % 2 == 0)
+				dict.erase(k);
+			else
+				var_kept.push_back(n);
+			visited++;
+		} while (var_dict.iter_next(iter, valid));
+	}
+	var_dict = Variant();
+	ok = _check(valid && visited == kept.size(), "for loop skipped or repeated keys when erasing") && ok;
+	ok = _check(_dictionary_matches(dict, var_kept), "kept wrong keys after erasing in a for loop") && ok;
+
+	// many erases followed by inserts compact the holes away, order and lookups survive
+	Dictionary churn;
+	Vector<int> live;
+	for (int i = 0; i < DICT_ELEMENTS * 10; i++) {
+
+		churn["key_" + itos(i)] = i;
+		live.push_back(i);
+		if (live.size() > 16) {
+			churn.erase("key_" + itos(live[0]));
+			live.remove(0);
+		}
+	}
+	ok = _check(_dictionary_matches(churn, live), "lost order or keys after compacting") && ok;
+	bool erased_gone = true;
+	for (int i = 0; i < live[0]; i += 97)
+		erased_gone = erased_gone && !churn.has("key_" + itos(i));
+	ok = _check(erased_gone, "still has erased keys after compacting") && ok;
+
+	// a copy is independent of the original once either is modified
+	Dictionary original;
+	Vector<int> original_order;
+	for (int i = 0; i < 32; i++) {
+		original["key_" + itos(i)] = i;
+		original_order.push_back(i);
+	}
+
+	Dictionary copy = original;
+	copy.erase("key_0");
+	copy["key_100"] = 100;
+	copy["key_1"] = 1;
+	Vector<int> copy_order = original_order;
+	copy_order.remove(0);
+	copy_order.push_back(100);
+	ok = _check(_dictionary_matches(original, original_order), "original changed when its copy was modified") && ok;
+	ok = _check(_dictionary_matches(copy, copy_order), "copy is wrong after being modified") && ok;
+
+	Dictionary copy2 = original;
+	original.clear();
+	ok = _check(_dictionary_matches(copy2, original_order) && original.empty(), "copy changed when the original was cleared") && ok;
+
+	// shared dictionaries see each other's changes
+	Dictionary shared(true);
+	Dictionary shared_ref = shared;
+	shared_ref["key_5"] = 5;
+	ok = _check(shared.has("key_5"), "shared copy did not see a change") && ok;
+
+	print_line(ok ? "Dictionary behaves as expected." : "Dictionary misbehaves!");
+
+	return ok;
+}
+
 MainLoop *test() {
 
+	_benchmark_maps();
+	_test_dictionary();
+
 	/*
 	HashMap<int,int> int_map;
 
@@ -566,10 +566,11 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 
 			switch (code[ip]) {
 
-				case GDFunction::OPCODE_OPERATOR: {
+				case GDFunction::OPCODE_OPERATOR:
+				case GDFunction::OPCODE_OPERATOR_NUMERIC: {
 
 					int op = code[ip + 1];
-					txt += "op ";
+					txt += code[ip] == GDFunction::OPCODE_OPERATOR_NUMERIC ? "op-num " : "op ";
 
 					String opname = Variant::get_operator_name(Variant::Operator(op));
 
@@ -724,7 +725,7 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 
 					int argc = code[ip + 1];
 					if (ret) {
-						txt += DADDR(4 + argc) + "=";
+						txt += DADDR(5 + argc) + "=";
 					}
 
 					txt += DADDR(2) + ".";
@@ -734,11 +735,11 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 					for (int i = 0; i < argc; i++) {
 						if (i > 0)
 							txt += ", ";
-						txt += DADDR(4 + i);
+						txt += DADDR(5 + i);
 					}
 					txt += ")";
 
-					incr = 5 + argc;
+					incr = 6 + argc;
 
 				} break;
 				case GDFunction::OPCODE_CALL_BUILT_IN: {
@@ -827,6 +828,17 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 
 					incr = 3;
 				} break;
+				case GDFunction::OPCODE_JUMP_IF_NOT_COMPARE: {
+
+					txt += " jump-if-not ";
+					txt += DADDR(2);
+					txt += " " + Variant::get_operator_name(Variant::Operator(code[ip + 1])) + " ";
+					txt += DADDR(3);
+					txt += " to ";
+					txt += itos(code[ip + 4]);
+
+					incr = 5;
+				} break;
 				case GDFunction::OPCODE_JUMP_TO_DEF_ARGUMENT: {
 
 					txt += " jump-to-default-argument ";
@@ -851,6 +863,18 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 					txt += " for-loop " + DADDR(4) + " in " + DADDR(2) + " counter " + DADDR(1) + " end " + itos(code[ip + 3]);
 					incr += 5;
 
+				} break;
+				case GDFunction::OPCODE_ITERATE_RANGE_BEGIN: {
+
+					txt += " for-range-init " + DADDR(5) + " from " + DADDR(1) + " to " + DADDR(2) + " step " + DADDR(3) + " end " + itos(code[ip + 4]);
+					incr += 6;
+
+				} break;
+				case GDFunction::OPCODE_ITERATE_RANGE: {
+
+					txt += " for-range-loop " + DADDR(5) + " counter " + DADDR(1) + " to " + DADDR(2) + " step " + DADDR(3) + " end " + itos(code[ip + 4]);
+					incr += 6;
+
 				} break;
 				case GDFunction::OPCODE_LINE: {
 
@@ -888,8 +912,128 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 	}
 }
 
+static const char *_benchmark_code =
+		"extends Reference\n"
+		"\n"
+		"static func int_arithmetic():\n"
+		"\tvar acc = 0\n"
+		"\tvar i = 0\n"
+		"\twhile i < 1000000:\n"
+		"\t\tacc = (acc + i * 3) % 65521\n"
+		"\t\ti += 1\n"
+		"\treturn acc\n"
+		"\n"
+		"static func float_arithmetic():\n"
+		"\tvar acc = 0.0\n"
+		"\tfor i in range(1000000):\n"
+		"\t\tacc = acc * 0.5 + i / 3.0\n"
+		"\treturn acc\n"
+		"\n"
+		"static func range_loop():\n"
+		"\tvar acc = 0\n"
+		"\tfor i in range(10, 2000000, 3):\n"
+		"\t\tacc = (acc + i) % 1000003\n"
+		"\treturn acc\n"
+		"\n"
+		"static func nested_compare():\n"
+		"\tvar hits = 0\n"
+		"\tfor x in range(1000):\n"
+		"\t\tfor y in range(1000):\n"
+		"\t\t\tif x < y:\n"
+		"\t\t\t\thits += 1\n"
+		"\treturn hits\n"
+		"\n"
+		"static func mixed_types():\n"
+		"\tvar acc = 0\n"
+		"\tvar s = \"\"\n"
+		"\tfor i in range(200000):\n"
+		"\t\tif i % 1000 == 0:\n"
+		"\t\t\ts = s + \"x\"\n"
+		"\t\tacc += s.length() + i * 0.5\n"
+		"\treturn acc\n"
+		"\n"
+		"static func native_calls():\n"
+		"\tvar obj = Reference.new()\n"
+		"\tvar acc = 0\n"
+		"\tfor i in range(200000):\n"
+		"\t\tif obj.is_type(\"Reference\"):\n"
+		"\t\t\tacc += obj.get_instance_ID() - obj.get_instance_ID() + 1\n"
+		"\treturn acc\n";
+
+static const char *_benchmark_functions[] = {
+	"int_arithmetic",
+	"float_arithmetic",
+	"range_loop",
+	"nested_compare",
+	"mixed_types",
+	"native_calls",
+	NULL
+};
+
+static Ref<GDScript> _benchmark_compile(bool p_specialized) {
+
+	GDParser parser;
+	Error err = parser.parse(_benchmark_code);
+	if (err) {
+		print_line("Parse Error:\n" + itos(parser.get_error_line()) + ":" + itos(parser.get_error_column()) + ":" + parser.get_error());
+		return Ref<GDScript>();
+	}
+
+	Ref<GDScript> script = memnew(GDScript);
+
+	GDCompiler gdc;
+	gdc.set_specialized_opcodes(p_specialized);
+	err = gdc.compile(&parser, script.ptr());
+	if (err) {
+		print_line("Compile Error:\n" + itos(gdc.get_error_line()) + ":" + itos(gdc.get_error_column()) + ":" + gdc.get_error());
+		return Ref<GDScript>();
+	}
+
+	return script;
+}
+
+static MainLoop *_benchmark() {
+
+	Ref<GDScript> generic = _benchmark_compile(false);
+	Ref<GDScript> specialized = _benchmark_compile(true);
+	if (generic.is_null() || specialized.is_null())
+		return NULL;
+
+	print_line("GDScript benchmark, generic vs specialized opcodes:");
+
+	for (int i = 0; _benchmark_functions[i]; i++) {
+
+		StringName name = _benchmark_functions[i];
+		Variant::CallError ce;
+
+		Object *generic_obj = generic.ptr();
+		Object *specialized_obj = specialized.ptr();
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		Variant generic_ret = generic_obj->call(name, NULL, 0, ce);
+		uint64_t generic_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		Variant specialized_ret = specialized_obj->call(name, NULL, 0, ce);
+		uint64_t specialized_time = OS::get_singleton()->get_ticks_usec() - begin;
+
+		String txt = String(name) + ": " + itos(generic_time) + " usec -> " + itos(specialized_time) + " usec";
+		if (specialized_time > 0)
+			txt += " (" + rtos(double(generic_time) / double(specialized_time)) + "x)";
+		if (generic_ret != specialized_ret)
+			txt += " MISMATCH: " + String(generic_ret) + " != " + String(specialized_ret);
+
+		print_line(txt);
+	}
+
+	return NULL;
+}
+
 MainLoop *test(TestType p_test) {
 
+	if (p_test == TEST_BENCHMARK)
+		return _benchmark();
+
 	List<String> cmdlargs = OS::get_singleton()->get_cmdline_args();
 
 	if (cmdlargs.empty()) {
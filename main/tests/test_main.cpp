@@ -31,6 +31,9 @@
 
 #ifdef DEBUG_ENABLED
 
+#include "test_canvas_batch.h"
+#include "test_command_queue.h"
+#include "test_compression.h"
 #include "test_containers.h"
 #include "test_detailer.h"
 #include "test_gdscript.h"
@@ -38,13 +41,18 @@
 #include "test_image.h"
 #include "test_io.h"
 #include "test_math.h"
+#include "test_memory_pool.h"
 #include "test_misc.h"
+#include "test_pack.h"
 #include "test_particles.h"
 #include "test_physics.h"
 #include "test_physics_2d.h"
 #include "test_python.h"
 #include "test_render.h"
+#include "test_resource_load_queue.h"
 #include "test_shader_lang.h"
+#include "test_signals.h"
+#include "test_skinning.h"
 #include "test_sound.h"
 #include "test_string.h"
 
@@ -63,6 +71,16 @@ const char **tests_get_names() {
 		"shaderlang",
 		#endif
 		"physics",
+		"physics_broadphase",
+		"command_queue",
+		"memory_pool",
+		"signals",
+		"resource_load_queue",
+		"skinning",
+		"canvas_batch",
+		"compression",
+		"pack",
+		"gd_benchmark",
 		NULL
 	};
 
@@ -91,6 +109,51 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestPhysics::test();
 	}
 
+	if (p_test == "physics_broadphase") {
+
+		return TestPhysics::test_broadphase();
+	}
+
+	if (p_test == "command_queue") {
+
+		return TestCommandQueue::test();
+	}
+
+	if (p_test == "memory_pool") {
+
+		return TestMemoryPool::test();
+	}
+
+	if (p_test == "signals") {
+
+		return TestSignals::test();
+	}
+
+	if (p_test == "resource_load_queue") {
+
+		return TestResourceLoadQueue::test();
+	}
+
+	if (p_test == "skinning") {
+
+		return TestSkinning::test();
+	}
+
+	if (p_test == "canvas_batch") {
+
+		return TestCanvasBatch::test();
+	}
+
+	if (p_test == "compression") {
+
+		return TestCompression::test();
+	}
+
+	if (p_test == "pack") {
+
+		return TestPack::test();
+	}
+
 	if (p_test == "physics_2d") {
 
 		return TestPhysics2D::test();
@@ -160,6 +223,11 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestGDScript::test(TestGDScript::TEST_BYTECODE);
 	}
 
+	if (p_test == "gd_benchmark") {
+
+		return TestGDScript::test(TestGDScript::TEST_BENCHMARK);
+	}
+
 	if (p_test == "image") {
 
 		return TestImage::test();
@@ -0,0 +1,289 @@
+/*************************************************************************/
+/*  test_memory_pool.cpp                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_memory_pool.h"
+
+#include "os/memory_pool_dynamic_size_class.h"
+#include "os/os.h"
+#include "os/thread.h"
+#include "print_string.h"
+
+namespace TestMemoryPool {
+
+/* CONCURRENT LOCK AND COMPACTION STRESS */
+
+enum {
+	MP_BLOCKS = 4096,
+	MP_READERS = 4,
+	MP_LOCKS_PER_READER = 100000,
+	MP_CHURN_ALLOCS = 20000,
+	MP_MOVES_PER_STEP = 64
+};
+
+static const int block_sizes[] = { 24, 48, 100, 200, 700, 1500, 4000 };
+
+struct MPStress {
+
+	MemoryPoolDynamicSizeClass *pool;
+	uint64_t ids[MP_BLOCKS]; // MemoryPoolDynamic::ID
+	uint64_t fillers[MP_BLOCKS]; // share pages with the blocks, freeing them leaves holes
+	uint32_t counts[MP_BLOCKS]; // times each block was written, by the reader owning it
+	volatile bool done;
+	uint64_t moves;
+};
+
+struct MPReader {
+
+	MPStress *stress;
+	int index;
+	int errors;
+};
+
+struct MPChurn {
+
+	MPStress *stress;
+	int errors;
+};
+
+static int _block_size(int p_block) {
+
+	return block_sizes[p_block % (sizeof(block_sizes) / sizeof(block_sizes[0]))];
+}
+
+// the first word counts writes, the rest is a pattern that tells blocks apart
+static void _fill(uint8_t *p_mem, int p_size, int p_block) {
+
+	*(uint32_t *)p_mem = 0;
+	for (int i = 4; i < p_size; i++)
+		p_mem[i] = (p_block * 7 + i) & 0xFF;
+}
+
+static bool _verify(const uint8_t *p_mem, int p_size, int p_block) {
+
+	for (int i = 4; i < p_size; i++) {
+		if (p_mem[i] != ((p_block * 7 + i) & 0xFF))
+			return false;
+	}
+	return true;
+}
+
+static bool _verify_all(MPStress *p_stress, const String &p_when) {
+
+	int errors = 0;
+	for (int i = 0; i < MP_BLOCKS; i++) {
+
+		uint64_t id = p_stress->ids[i];
+		p_stress->pool->lock(id);
+		const uint8_t *mem = (const uint8_t *)p_stress->pool->get(id);
+		if (!mem || !_verify(mem, _block_size(i), i) || *(const uint32_t *)mem != p_stress->counts[i])
+			errors++;
+		p_stress->pool->unlock(id);
+	}
+
+	if (errors)
+		print_line("\tFAIL: " + itos(errors) + " blocks have the wrong contents " + p_when);
+	return errors == 0;
+}
+
+static void _mp_reader(void *p_userdata) {
+
+	MPReader *reader = (MPReader *)p_userdata;
+	MPStress *stress = reader->stress;
+	uint32_t seed = reader->index + 1;
+
+	for (int i = 0; i < MP_LOCKS_PER_READER; i++) {
+
+		// each reader writes only its own blocks, so no write is lost to another one
+		seed = seed * 1103515245 + 12345;
+		int block = ((seed >> 8) % (MP_BLOCKS / MP_READERS)) * MP_READERS + reader->index;
+
+		uint64_t id = stress->ids[block];
+		stress->pool->lock(id);
+		uint8_t *mem = (uint8_t *)stress->pool->get(id);
+		if (!mem || !_verify(mem, _block_size(block), block)) {
+			reader->errors++;
+		} else {
+			(*(uint32_t *)mem)++;
+			stress->counts[block]++;
+		}
+		stress->pool->unlock(id);
+	}
+}
+
+static void _mp_compactor(void *p_userdata) {
+
+	MPStress *stress = (MPStress *)p_userdata;
+
+	while (!stress->done) {
+		stress->moves += stress->pool->compact(MP_MOVES_PER_STEP);
+	}
+}
+
+static void _mp_churn(void *p_userdata) {
+
+	// the remaining fillers go away bit by bit, so pages holding locked blocks keep being evacuated,
+	// while allocations coming and going fill pages up and empty them
+	MPChurn *churn = (MPChurn *)p_userdata;
+	MPStress *stress = churn->stress;
+	MemoryPoolDynamicSizeClass *pool = stress->pool;
+
+	for (int i = 0; i < MP_CHURN_ALLOCS; i++) {
+
+		int filler = (i / 2) * 4 + 3;
+		if (i % 2 == 0 && filler < MP_BLOCKS)
+			pool->free(stress->fillers[filler]);
+
+		int size = _block_size(i);
+		uint64_t id = pool->alloc(size, "churn");
+		if (!pool->is_valid(id)) {
+			churn->errors++;
+			continue;
+		}
+
+		pool->lock(id);
+		_fill((uint8_t *)pool->get(id), size, i);
+		pool->unlock(id);
+
+		int grown = _block_size(i + 1);
+		if (grown > size && pool->realloc(id, grown) == OK) {
+
+			pool->lock(id);
+			if (!_verify((const uint8_t *)pool->get(id), size, i))
+				churn->errors++;
+			pool->unlock(id);
+		}
+
+		pool->free(id);
+	}
+}
+
+MainLoop *test() {
+
+	print_line("MemoryPoolDynamicSizeClass stress: " + itos(MP_READERS) + " readers, " + itos(MP_LOCKS_PER_READER) + " locks each, compacting meanwhile");
+
+	MPStress *stress = memnew(MPStress);
+	stress->pool = memnew(MemoryPoolDynamicSizeClass);
+	stress->done = false;
+	stress->moves = 0;
+
+	bool ok = true;
+
+	for (int i = 0; i < MP_BLOCKS; i++) {
+
+		stress->ids[i] = stress->pool->alloc(_block_size(i), "stress");
+		stress->fillers[i] = stress->pool->alloc(_block_size(i), "filler");
+		stress->counts[i] = 0;
+
+		stress->pool->lock(stress->ids[i]);
+		_fill((uint8_t *)stress->pool->get(stress->ids[i]), _block_size(i), i);
+		stress->pool->unlock(stress->ids[i]);
+	}
+
+	// free three fillers in four, every page is left with holes
+	for (int i = 0; i < MP_BLOCKS; i++) {
+
+		if (i % 4 != 3)
+			stress->pool->free(stress->fillers[i]);
+	}
+
+	// evacuating pages alone must give the holes back without touching the data
+	size_t reserved = stress->pool->get_reserved_mem();
+	int evacuated = 0;
+	for (int moved = stress->pool->compact(MP_MOVES_PER_STEP); moved; moved = stress->pool->compact(MP_MOVES_PER_STEP))
+		evacuated += moved;
+
+	print_line("Evacuation: moved " + itos(evacuated) + " blocks, reserved " + itos(reserved / 1024) + " KiB before, " + itos(stress->pool->get_reserved_mem() / 1024) + " KiB after");
+	if (evacuated == 0 || stress->pool->get_reserved_mem() >= reserved) {
+		print_line("\tFAIL: compaction did not release any page");
+		ok = false;
+	}
+	ok = _verify_all(stress, "after evacuating pages") && ok;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	Thread *compactor = Thread::create(_mp_compactor, stress);
+
+	MPChurn churn;
+	churn.stress = stress;
+	churn.errors = 0;
+	Thread *churn_thread = Thread::create(_mp_churn, &churn);
+
+	MPReader reader_data[MP_READERS];
+	Thread *readers[MP_READERS];
+	for (int i = 0; i < MP_READERS; i++) {
+		reader_data[i].stress = stress;
+		reader_data[i].index = i;
+		reader_data[i].errors = 0;
+		readers[i] = Thread::create(_mp_reader, &reader_data[i]);
+	}
+
+	int errors = 0;
+	for (int i = 0; i < MP_READERS; i++) {
+		Thread::wait_to_finish(readers[i]);
+		memdelete(readers[i]);
+		errors += reader_data[i].errors;
+	}
+
+	Thread::wait_to_finish(churn_thread);
+	memdelete(churn_thread);
+
+	stress->done = true;
+	Thread::wait_to_finish(compactor);
+	memdelete(compactor);
+
+	uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, 1);
+	uint64_t locks = (uint64_t)MP_LOCKS_PER_READER * MP_READERS;
+
+	print_line("Concurrent: " + itos(elapsed) + " usec, " + itos(locks * 1000000 / elapsed) + " locks/sec, " + itos(stress->moves) + " blocks moved meanwhile");
+
+	if (errors || churn.errors) {
+		print_line("\tFAIL: " + itos(errors) + " locked blocks and " + itos(churn.errors) + " churned blocks had the wrong contents");
+		ok = false;
+	}
+	if (stress->moves == 0) {
+		print_line("\tFAIL: no block was moved while the readers locked them");
+		ok = false;
+	}
+	ok = _verify_all(stress, "after the concurrent run") && ok;
+
+	for (int i = 0; i < MP_BLOCKS; i++)
+		stress->pool->free(stress->ids[i]);
+	if (stress->pool->get_total_usage() != 0) {
+		print_line("\tFAIL: " + itos(stress->pool->get_total_usage()) + " bytes still in use after freeing everything");
+		ok = false;
+	}
+
+	memdelete(stress->pool);
+	memdelete(stress);
+
+	print_line(ok ? "All blocks kept their contents." : "Some blocks lost their contents!");
+
+	return NULL;
+}
+}
@@ -0,0 +1,268 @@
+/*************************************************************************/
+/*  test_pack.cpp                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_pack.h"
+
+#include "io/file_access_pack.h"
+#include "io/pck_packer.h"
+#include "os/dir_access.h"
+#include "os/file_access.h"
+#include "os/os.h"
+#include "print_string.h"
+#include "vector.h"
+
+namespace TestPack {
+
+/* PACK ROUND TRIP */
+
+enum {
+	TEXT_SIZE = 100000, // several compression blocks
+	RANDOM_SIZE = 5000,
+	ALIGNMENT = 16,
+	MODE_COUNT = PCKPacker::COMPRESSION_ZSTD + 1
+};
+
+static const char *mode_names[MODE_COUNT] = { "none", "fastlz", "deflate", "zstd" };
+
+static bool _check(bool p_ok, const String &p_what) {
+
+	if (!p_ok)
+		print_line("\tFAIL: " + p_what);
+	return p_ok;
+}
+
+static Vector<uint8_t> _make_text() {
+
+	String line = "The quick brown fox jumps over the lazy dog, ";
+	Vector<uint8_t> data;
+	data.resize(TEXT_SIZE);
+	for (int i = 0; i < TEXT_SIZE; i++)
+		data[i] = line[i % line.length()] + (i / 997) % 3;
+	return data;
+}
+
+static Vector<uint8_t> _make_random() {
+
+	// bits no compressor can shrink, so the packer stores them as they are
+	uint32_t seed = 0x1234567;
+	Vector<uint8_t> data;
+	data.resize(RANDOM_SIZE);
+	for (int i = 0; i < RANDOM_SIZE; i++) {
+		seed = seed * 1103515245 + 12345;
+		data[i] = seed >> 24;
+	}
+	return data;
+}
+
+static Vector<uint8_t> _make_buffer(const String &p_text) {
+
+	CharString cs = p_text.utf8();
+	Vector<uint8_t> data;
+	data.resize(cs.length());
+	for (int i = 0; i < cs.length(); i++)
+		data[i] = cs[i];
+	return data;
+}
+
+static String _dir(int p_mode) {
+
+	return "res://test_pack/" + String(mode_names[p_mode]);
+}
+
+static bool _read_back(const String &p_path, const Vector<uint8_t> &p_data) {
+
+	PackedData *pd = PackedData::get_singleton();
+	if (!_check(pd->has_path(p_path), p_path + " is not in the pack"))
+		return false;
+
+	FileAccess *f = pd->try_open_path(p_path);
+	if (!_check(f != NULL, p_path + " can't be opened"))
+		return false;
+
+	bool ok = _check(f->get_len() == size_t(p_data.size()), p_path + " has the wrong length");
+
+	Vector<uint8_t> read;
+	read.resize(p_data.size() + 1);
+	int len = f->get_buffer(read.ptr(), p_data.size() + 1);
+	ok = _check(len == p_data.size() && memcmp(read.ptr(), p_data.ptr(), len) == 0, p_path + " reads back different data") && ok;
+	ok = _check(f->eof_reached(), p_path + " doesn't reach the end") && ok;
+
+	if (p_data.size() > 1) {
+
+		// seek back and forth, across compression blocks when compressed
+		int positions[] = { p_data.size() / 2, 1, p_data.size() - 1, 0 };
+		for (int i = 0; i < 4; i++) {
+
+			f->seek(positions[i]);
+			int n = MIN(1000, p_data.size() - positions[i]);
+			len = f->get_buffer(read.ptr(), n);
+			ok = _check(len == n && memcmp(read.ptr(), &p_data[positions[i]], n) == 0 && f->get_pos() == size_t(positions[i] + n), p_path + " reads wrong data after seeking to " + itos(positions[i])) && ok;
+		}
+	}
+
+	memdelete(f);
+	return ok;
+}
+
+static bool _stored_raw(const String &p_pack, const Vector<uint8_t> &p_data) {
+
+	FileAccess *f = FileAccess::open(p_pack, FileAccess::READ);
+	if (!f)
+		return false;
+
+	Vector<uint8_t> pack;
+	pack.resize(f->get_len());
+	f->get_buffer(pack.ptr(), pack.size());
+	memdelete(f);
+
+	for (int i = 0; i + p_data.size() <= pack.size(); i += ALIGNMENT) {
+
+		if (memcmp(&pack[i], p_data.ptr(), p_data.size()) == 0)
+			return true;
+	}
+	return false;
+}
+
+static bool _list(const String &p_dir, Vector<String> &r_dirs, Vector<String> &r_files) {
+
+	DirAccessPack *da = memnew(DirAccessPack);
+	if (da->change_dir(p_dir) != OK) {
+		memdelete(da);
+		return false;
+	}
+
+	da->list_dir_begin();
+	for (String n = da->get_next(); n != String(); n = da->get_next()) {
+
+		if (da->current_is_dir())
+			r_dirs.push_back(n);
+		else
+			r_files.push_back(n);
+	}
+	da->list_dir_end();
+	memdelete(da);
+
+	return true;
+}
+
+static bool _check_listing(int p_modes) {
+
+	Vector<String> dirs;
+	Vector<String> files;
+	bool ok = _check(_list("res://test_pack", dirs, files), "res://test_pack can't be listed");
+	ok = _check(dirs.size() == p_modes && files.size() == 1 && files[0] == "shared.txt", "res://test_pack lists " + itos(dirs.size()) + " folders and " + itos(files.size()) + " files") && ok;
+
+	for (int m = 0; m < p_modes; m++) {
+
+		dirs.clear();
+		files.clear();
+		ok = _check(_list(_dir(m), dirs, files), _dir(m) + " can't be listed") && ok;
+		ok = _check(dirs.size() == 0 && files.size() == 3 && files.find("text.txt") != -1 && files.find("empty.bin") != -1 && files.find("random.bin") != -1, _dir(m) + " lists the wrong files") && ok;
+	}
+
+	return ok;
+}
+
+MainLoop *test() {
+
+	print_line("Pack round trip: " + itos(MODE_COUNT) + " compression modes");
+
+	Vector<uint8_t> text = _make_text();
+	Vector<uint8_t> random = _make_random();
+	Vector<uint8_t> empty;
+
+	PackedData *pd = PackedData::get_singleton();
+	Vector<String> packs;
+	bool ok = true;
+
+	for (int m = 0; m < MODE_COUNT; m++) {
+
+		String pack = OS::get_singleton()->get_data_dir().plus_file("test_pack_" + String(mode_names[m]) + ".pck");
+		packs.push_back(pack);
+
+		PCKPacker packer;
+		packer.set_compression(PCKPacker::CompressionMode(m));
+		if (!_check(packer.pck_start(pack, ALIGNMENT) == OK, "can't create " + pack)) {
+			ok = false;
+			continue;
+		}
+
+		// every pack replaces shared.txt, the last one added must win
+		packer.add_buffer(_dir(m) + "/text.txt", text);
+		packer.add_buffer(_dir(m) + "/empty.bin", empty);
+		packer.add_buffer(_dir(m) + "/random.bin", random);
+		packer.add_buffer("res://test_pack/shared.txt", _make_buffer(mode_names[m]));
+		packer.flush();
+
+		ok = _check(pd->add_pack(pack) == OK, "can't add " + pack) && ok;
+
+		ok = _read_back(_dir(m) + "/text.txt", text) && ok;
+		ok = _read_back(_dir(m) + "/empty.bin", empty) && ok;
+		ok = _read_back(_dir(m) + "/random.bin", random) && ok;
+		ok = _read_back("res://test_pack/shared.txt", _make_buffer(mode_names[m])) && ok;
+		ok = _check(_stored_raw(pack, random), String(mode_names[m]) + " compressed data that doesn't shrink") && ok;
+		if (m != PCKPacker::COMPRESSION_NONE)
+			ok = _check(!_stored_raw(pack, text), String(mode_names[m]) + " didn't compress text") && ok;
+
+		// the names of indexed packs are only read when listing, after each new pack too
+		if (m == 1 || m == MODE_COUNT - 1)
+			ok = _check_listing(m + 1) && ok;
+	}
+
+	ok = _check(!pd->has_path("res://test_pack/missing.txt") && pd->try_open_path("res://test_pack/missing.txt") == NULL, "a missing file was found") && ok;
+
+	// an index count that doesn't fit in the pack is refused before anything is allocated
+	String corrupt = OS::get_singleton()->get_data_dir().plus_file("test_pack_corrupt.pck");
+	packs.push_back(corrupt);
+	PCKPacker packer;
+	if (packer.pck_start(corrupt, ALIGNMENT) == OK) {
+
+		packer.add_buffer("res://test_pack/corrupt.txt", text);
+		packer.flush();
+
+		FileAccess *f = FileAccess::open(corrupt, FileAccess::READ_WRITE);
+		if (f) {
+			f->seek(21 * 4); // file count
+			f->store_32(0x08000000);
+			memdelete(f);
+		}
+		ok = _check(pd->add_pack(corrupt) != OK && !pd->has_path("res://test_pack/corrupt.txt"), "a pack with a corrupt index count was added") && ok;
+	}
+
+	// the packs stay referenced, so they are only removed from disk
+	DirAccess *da = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+	for (int i = 0; i < packs.size(); i++)
+		da->remove(packs[i]);
+	memdelete(da);
+
+	print_line(ok ? "All packs read back as written." : "Packs did not read back as written!");
+
+	return NULL;
+}
+}
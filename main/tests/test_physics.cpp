@@ -34,6 +34,9 @@
 #include "os/os.h"
 #include "print_string.h"
 #include "quick_hull.h"
+#include "servers/physics/body_sw.h"
+#include "servers/physics/broad_phase_bvh.h"
+#include "servers/physics/broad_phase_octree.h"
 #include "servers/physics_server.h"
 #include "servers/visual_server.h"
 
@@ -615,4 +618,112 @@ MainLoop *test() {
 
 	return memnew(TestPhysicsMainLoop);
 }
+
+/* BROADPHASE BENCHMARK */
+
+enum {
+	BP_BODY_COUNT = 10000,
+	BP_FRAMES = 100
+};
+
+static void *_bp_pair(CollisionObjectSW *p_A, int p_subindex_A, CollisionObjectSW *p_B, int p_subindex_B, void *p_userdata) {
+
+	(*(int *)p_userdata)++;
+	return NULL;
+}
+
+static void _bp_unpair(CollisionObjectSW *p_A, int p_subindex_A, CollisionObjectSW *p_B, int p_subindex_B, void *p_data, void *p_userdata) {
+
+	(*(int *)p_userdata)--;
+}
+
+static void _bp_benchmark(const String &p_name, BroadPhaseSW::CreateFunction p_create, const Vector<BodySW *> &p_bodies, const Vector<Vector3> &p_positions, const Vector<Vector3> &p_velocities) {
+
+	const float extent = 60.0;
+	const float step = 1.0 / 60.0;
+	const Vector3 half_size(0.5, 0.5, 0.5);
+
+	BroadPhaseSW *bp = p_create();
+	int pair_count = 0;
+	bp->set_pair_callback(_bp_pair, &pair_count);
+	bp->set_unpair_callback(_bp_unpair, &pair_count);
+
+	int count = p_bodies.size();
+	Vector<BroadPhaseSW::ID> ids;
+	ids.resize(count);
+	Vector<Vector3> positions = p_positions;
+	Vector<Vector3> velocities = p_velocities;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < count; i++) {
+		ids[i] = bp->create(p_bodies[i]);
+		bp->set_static(ids[i], false);
+		bp->move(ids[i], AABB(positions[i] - half_size, half_size * 2));
+	}
+	bp->update();
+
+	uint64_t insert_time = OS::get_singleton()->get_ticks_usec() - begin;
+	uint64_t move_time = 0;
+	uint64_t update_time = 0;
+
+	for (int f = 0; f < BP_FRAMES; f++) {
+
+		begin = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < count; i++) {
+
+			Vector3 &pos = positions[i];
+			Vector3 &vel = velocities[i];
+			pos += vel * step;
+			for (int j = 0; j < 3; j++) {
+				if (Math::abs(pos[j]) > extent) {
+					vel[j] = -vel[j];
+				}
+			}
+			bp->move(ids[i], AABB(pos - half_size, half_size * 2));
+		}
+
+		uint64_t moved = OS::get_singleton()->get_ticks_usec();
+		bp->update();
+		uint64_t updated = OS::get_singleton()->get_ticks_usec();
+
+		move_time += moved - begin;
+		update_time += updated - moved;
+	}
+
+	print_line(p_name + ": insert " + itos(insert_time) + " usec, move " + itos(move_time / BP_FRAMES) + " usec/frame, update " + itos(update_time / BP_FRAMES) + " usec/frame, " + itos(pair_count) + " pairs");
+
+	for (int i = 0; i < count; i++) {
+		bp->remove(ids[i]);
+	}
+
+	memdelete(bp);
+}
+
+MainLoop *test_broadphase() {
+
+	print_line("Broadphase benchmark: " + itos(BP_BODY_COUNT) + " moving bodies, " + itos(BP_FRAMES) + " frames");
+
+	Math::seed(1234);
+
+	Vector<BodySW *> bodies;
+	Vector<Vector3> positions;
+	Vector<Vector3> velocities;
+
+	for (int i = 0; i < BP_BODY_COUNT; i++) {
+		bodies.push_back(memnew(BodySW));
+		positions.push_back(Vector3(Math::random(-60.0, 60.0), Math::random(-60.0, 60.0), Math::random(-60.0, 60.0)));
+		velocities.push_back(Vector3(Math::random(-5.0, 5.0), Math::random(-5.0, 5.0), Math::random(-5.0, 5.0)));
+	}
+
+	_bp_benchmark("Octree", BroadPhaseOctree::_create, bodies, positions, velocities);
+	_bp_benchmark("BVH", BroadPhaseBVH::_create, bodies, positions, velocities);
+
+	for (int i = 0; i < bodies.size(); i++) {
+		memdelete(bodies[i]);
+	}
+
+	return NULL;
+}
 } // namespace TestPhysics
@@ -0,0 +1,339 @@
+/*************************************************************************/
+/*  test_resource_load_queue.cpp                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2016 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_resource_load_queue.h"
+
+#include "io/resource_load_queue.h"
+#include "io/resource_loader.h"
+#include "map.h"
+#include "os/mutex.h"
+#include "os/os.h"
+#include "print_string.h"
+
+namespace TestResourceLoadQueue {
+
+enum {
+	RLQ_FAN_OUT = 8,
+	RLQ_POLL_LEAVES = 4,
+	RLQ_MAX_POLLS = 1000,
+	RLQ_LOAD_DELAY_USEC = 2000
+};
+
+/* Loader for made up ".rlqtest" files, the dependencies of each path are set by the
+   test. A load keeps what it finds of its dependencies in the cache (like a real loader
+   keeps its subresources) and counts the ones that weren't there. */
+
+class RLQTestLoader : public ResourceFormatLoader {
+
+	Mutex *mutex;
+	Map<String, Vector<String> > dependencies;
+	Map<String, int> load_counts;
+	int missing_dependencies;
+
+	Vector<String> _get_dependencies(const String &p_path) {
+
+		MutexLock lock(mutex);
+		const Map<String, Vector<String> >::Element *E = dependencies.find(p_path);
+		return E ? E->get() : Vector<String>();
+	}
+
+public:
+	void set_dependencies(const String &p_path, const Vector<String> &p_dependencies) {
+
+		MutexLock lock(mutex);
+		dependencies[p_path] = p_dependencies;
+	}
+
+	int get_load_count(const String &p_path) {
+
+		MutexLock lock(mutex);
+		const Map<String, int>::Element *E = load_counts.find(p_path);
+		return E ? E->get() : 0;
+	}
+
+	int get_missing_dependencies() {
+
+		MutexLock lock(mutex);
+		return missing_dependencies;
+	}
+
+	void reset() {
+
+		MutexLock lock(mutex);
+		dependencies.clear();
+		load_counts.clear();
+		missing_dependencies = 0;
+	}
+
+	virtual RES load(const String &p_path, const String &p_original_path, Error *r_error) {
+
+		OS::get_singleton()->delay_usec(RLQ_LOAD_DELAY_USEC);
+
+		Vector<String> deps = _get_dependencies(p_original_path);
+		Array loaded;
+		int missing = 0;
+		for (int i = 0; i < deps.size(); i++) {
+
+			RES dep = ResourceCache::get_ref(deps[i]);
+			if (dep.is_valid())
+				loaded.push_back(dep);
+			else
+				missing++;
+		}
+
+		RES res = memnew(Resource);
+		res->set_meta("dependencies", loaded);
+
+		mutex->lock();
+		load_counts[p_original_path]++;
+		missing_dependencies += missing;
+		mutex->unlock();
+
+		if (r_error)
+			*r_error = OK;
+		return res;
+	}
+
+	virtual void get_recognized_extensions(List<String> *p_extensions) const { p_extensions->push_back("rlqtest"); }
+	virtual bool handles_type(const String &p_type) const { return p_type == "Resource"; }
+	virtual String get_resource_type(const String &p_path) const { return p_path.extension() == "rlqtest" ? "Resource" : ""; }
+
+	virtual void get_dependencies(const String &p_path, List<String> *p_dependencies, bool p_add_types) {
+
+		Vector<String> deps = _get_dependencies(p_path);
+		for (int i = 0; i < deps.size(); i++) {
+			p_dependencies->push_back(p_add_types ? deps[i] + "::Resource" : deps[i]);
+		}
+	}
+
+	RLQTestLoader() {
+
+		mutex = Mutex::create();
+		missing_dependencies = 0;
+	}
+
+	~RLQTestLoader() { memdelete(mutex); }
+};
+
+static RLQTestLoader *rlq_loader = NULL; //loaders can't be removed, so it stays registered
+
+static bool _check(bool p_condition, const String &p_what) {
+
+	if (!p_condition)
+		print_line("\tFAIL: " + p_what);
+	return p_condition;
+}
+
+static bool _check_released(ResourceLoadQueue *p_queue, const String &p_path) {
+
+	bool ok = _check(p_queue->get_status(p_path) == ResourceLoadQueue::STATUS_INVALID, p_path + " still has a task after get()");
+	ok = _check(!ResourceCache::has(p_path), p_path + " still cached after the last reference went away") && ok;
+	return ok;
+}
+
+static bool _fan_out_test() {
+
+	// root needs RLQ_FAN_OUT leaves, which all share a base
+	String root = "res://rlq_fan/root.rlqtest";
+	String base = "res://rlq_fan/base.rlqtest";
+
+	rlq_loader->reset();
+
+	Vector<String> leaves;
+	for (int i = 0; i < RLQ_FAN_OUT; i++) {
+
+		String leaf = "res://rlq_fan/leaf" + itos(i) + ".rlqtest";
+		leaves.push_back(leaf);
+
+		Vector<String> leaf_deps;
+		leaf_deps.push_back(base);
+		rlq_loader->set_dependencies(leaf, leaf_deps);
+	}
+	rlq_loader->set_dependencies(root, leaves);
+
+	ResourceLoadQueue *queue = memnew(ResourceLoadQueue);
+	queue->set_thread_count(2);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	queue->request(root);
+
+	Error err;
+	RES res = queue->get(root, &err);
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+	ResourceLoadQueue::Stats stats = queue->get_stats();
+	print_line("Fan out, " + itos(RLQ_FAN_OUT + 2) + " resources on 2 threads: " + itos(elapsed) + " usec");
+
+	bool ok = _check(err == OK && res.is_valid(), "root failed to load");
+	ok = _check(stats.requested == 1 && stats.dependencies == RLQ_FAN_OUT + 1, "queued " + itos(stats.dependencies) + " dependencies, expected " + itos(RLQ_FAN_OUT + 1)) && ok;
+	ok = _check(stats.loaded == RLQ_FAN_OUT + 2 && stats.failed == 0 && stats.pending == 0, "loaded " + itos(stats.loaded) + ", failed " + itos(stats.failed) + ", pending " + itos(stats.pending)) && ok;
+	ok = _check(rlq_loader->get_missing_dependencies() == 0, itos(rlq_loader->get_missing_dependencies()) + " dependencies were not loaded first") && ok;
+	ok = _check(rlq_loader->get_load_count(base) == 1, "shared base loaded " + itos(rlq_loader->get_load_count(base)) + " times") && ok;
+	for (int i = 0; i < leaves.size(); i++) {
+		ok = _check(rlq_loader->get_load_count(leaves[i]) == 1, leaves[i] + " loaded " + itos(rlq_loader->get_load_count(leaves[i])) + " times") && ok;
+	}
+	if (res.is_valid()) {
+		Array deps = res->get_meta("dependencies");
+		ok = _check(deps.size() == RLQ_FAN_OUT, "root did not get all of its dependencies") && ok;
+	}
+
+	res = RES();
+	ok = _check_released(queue, root) && ok;
+	ok = _check_released(queue, base) && ok;
+	ok = _check_released(queue, leaves[0]) && ok;
+
+	memdelete(queue);
+
+	return ok;
+}
+
+static bool _cycle_test() {
+
+	// a and b need each other, one of them has to load without the other
+	String a = "res://rlq_cycle/a.rlqtest";
+	String b = "res://rlq_cycle/b.rlqtest";
+
+	rlq_loader->reset();
+
+	Vector<String> a_deps;
+	a_deps.push_back(b);
+	rlq_loader->set_dependencies(a, a_deps);
+	Vector<String> b_deps;
+	b_deps.push_back(a);
+	rlq_loader->set_dependencies(b, b_deps);
+
+	ResourceLoadQueue *queue = memnew(ResourceLoadQueue);
+	queue->set_thread_count(2);
+
+	queue->request(a);
+
+	Error err;
+	RES res = queue->get(a, &err);
+
+	bool ok = _check(err == OK && res.is_valid(), "resource in a cycle failed to load");
+	ok = _check(rlq_loader->get_load_count(a) == 1 && rlq_loader->get_load_count(b) == 1, "cycle loaded a " + itos(rlq_loader->get_load_count(a)) + " and b " + itos(rlq_loader->get_load_count(b)) + " times") && ok;
+	ok = _check(rlq_loader->get_missing_dependencies() == 1, "cycle left " + itos(rlq_loader->get_missing_dependencies()) + " dependencies out, expected 1") && ok;
+
+	res = RES();
+	ok = _check_released(queue, a) && ok;
+	ok = _check_released(queue, b) && ok;
+
+	memdelete(queue);
+
+	return ok;
+}
+
+static bool _polling_test() {
+
+	// without workers every get_status() runs one step: discovering the root, each leaf, loading the root
+	String root = "res://rlq_poll/root.rlqtest";
+
+	rlq_loader->reset();
+
+	Vector<String> leaves;
+	for (int i = 0; i < RLQ_POLL_LEAVES; i++) {
+		leaves.push_back("res://rlq_poll/leaf" + itos(i) + ".rlqtest");
+	}
+	rlq_loader->set_dependencies(root, leaves);
+
+	ResourceLoadQueue *queue = memnew(ResourceLoadQueue);
+	queue->set_thread_count(0);
+
+	queue->request(root);
+
+	int polls = 0;
+	ResourceLoadQueue::Status status = ResourceLoadQueue::STATUS_QUEUED;
+	while (status != ResourceLoadQueue::STATUS_LOADED && status != ResourceLoadQueue::STATUS_FAILED && polls < RLQ_MAX_POLLS) {
+		status = queue->get_status(root);
+		polls++;
+	}
+
+	bool ok = _check(status == ResourceLoadQueue::STATUS_LOADED, "polling never finished the load");
+	ok = _check(polls == RLQ_POLL_LEAVES + 2, "polling took " + itos(polls) + " steps, expected " + itos(RLQ_POLL_LEAVES + 2)) && ok;
+	ok = _check(rlq_loader->get_missing_dependencies() == 0, "polling loaded the root before its dependencies") && ok;
+
+	RES res = queue->get(root);
+	ok = _check(res.is_valid(), "no resource after polling") && ok;
+
+	res = RES();
+	ok = _check_released(queue, root) && ok;
+
+	memdelete(queue);
+
+	return ok;
+}
+
+static bool _release_test() {
+
+	// each request is released by one get(), the task goes away with the last one
+	String path = "res://rlq_release/res.rlqtest";
+
+	rlq_loader->reset();
+
+	ResourceLoadQueue *queue = memnew(ResourceLoadQueue);
+	queue->set_thread_count(2);
+
+	queue->request(path);
+	queue->request(path);
+
+	RES first = queue->get(path);
+	bool ok = _check(first.is_valid(), "first get() returned nothing");
+	ok = _check(queue->get_status(path) == ResourceLoadQueue::STATUS_LOADED, "task released while a request was left") && ok;
+
+	RES second = queue->get(path);
+	ok = _check(second.is_valid() && second == first, "second get() returned a different resource") && ok;
+	ok = _check(rlq_loader->get_load_count(path) == 1, "requested twice, loaded " + itos(rlq_loader->get_load_count(path)) + " times") && ok;
+	ok = _check(queue->get_stats().requested == 1, "two requests for a pending task counted as " + itos(queue->get_stats().requested)) && ok;
+
+	first = RES();
+	second = RES();
+	ok = _check_released(queue, path) && ok;
+
+	memdelete(queue);
+
+	return ok;
+}
+
+MainLoop *test() {
+
+	if (!rlq_loader) {
+		rlq_loader = memnew(RLQTestLoader);
+		ResourceLoader::add_resource_format_loader(rlq_loader);
+	}
+
+	bool ok = true;
+	ok = _fan_out_test() && ok;
+	ok = _cycle_test() && ok;
+	ok = _polling_test() && ok;
+	ok = _release_test() && ok;
+
+	print_line(ok ? "All resource load queue tests passed." : "Some resource load queue tests failed!");
+
+	return NULL;
+}
+}
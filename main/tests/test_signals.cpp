@@ -0,0 +1,150 @@
+/*************************************************************************/
+/*  test_signals.cpp                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2016 Juan Linietsky, Ariel Manzur.                 */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_signals.h"
+
+#include "object.h"
+#include "object_type_db.h"
+#include "os/os.h"
+#include "print_string.h"
+
+namespace TestSignals {
+
+/* EMISSION BENCHMARK */
+
+enum {
+	SIGNAL_EMISSIONS = 200000,
+	SIGNAL_MAX_TARGETS = 8
+};
+
+class SignalBenchTarget : public Object {
+
+	OBJ_TYPE(SignalBenchTarget, Object);
+
+public:
+	int64_t sum;
+
+	void _on_signal(int p_value) { sum += p_value; }
+	void _on_signal_bound(int p_value, int p_bound) { sum += p_value * p_bound; }
+
+	static void _bind_methods() {
+
+		ObjectTypeDB::bind_method(_MD("_on_signal", "value"), &SignalBenchTarget::_on_signal);
+		ObjectTypeDB::bind_method(_MD("_on_signal_bound", "value", "bound"), &SignalBenchTarget::_on_signal_bound);
+	}
+
+	SignalBenchTarget() { sum = 0; }
+};
+
+static bool _signal_benchmark(const String &p_name, int p_targets, bool p_binds) {
+
+	Object *emitter = memnew(Object);
+	emitter->add_user_signal(MethodInfo("bench", PropertyInfo(Variant::INT, "value")));
+
+	SignalBenchTarget *targets[SIGNAL_MAX_TARGETS];
+	for (int i = 0; i < p_targets; i++) {
+
+		targets[i] = memnew(SignalBenchTarget);
+		if (p_binds)
+			emitter->connect("bench", targets[i], "_on_signal_bound", varray(2));
+		else
+			emitter->connect("bench", targets[i], "_on_signal");
+	}
+
+	StringName signal = "bench";
+	Variant value = 1;
+	const Variant *args[1] = { &value };
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	for (int i = 0; i < SIGNAL_EMISSIONS; i++) {
+		emitter->emit_signal(signal, args, 1);
+	}
+
+	uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, 1);
+
+	print_line(p_name + ", " + itos(p_targets) + " targets: " + itos(elapsed) + " usec, " + itos((uint64_t)SIGNAL_EMISSIONS * 1000000 / elapsed) + " emissions/sec");
+
+	bool ok = true;
+	int64_t expected = (int64_t)SIGNAL_EMISSIONS * (p_binds ? 2 : 1);
+
+	for (int i = 0; i < p_targets; i++) {
+
+		if (targets[i]->sum != expected) {
+			print_line("\tFAIL: target " + itos(i) + " received " + itos(targets[i]->sum) + ", expected " + itos(expected));
+			ok = false;
+		}
+		memdelete(targets[i]);
+	}
+
+	memdelete(emitter);
+
+	return ok;
+}
+
+static bool _signal_oneshot_test() {
+
+	// one shot connections must still be disconnected after the first emission
+	Object *emitter = memnew(Object);
+	emitter->add_user_signal(MethodInfo("bench", PropertyInfo(Variant::INT, "value")));
+
+	SignalBenchTarget *target = memnew(SignalBenchTarget);
+	emitter->connect("bench", target, "_on_signal", Vector<Variant>(), Object::CONNECT_ONESHOT);
+
+	emitter->emit_signal("bench", 1);
+	emitter->emit_signal("bench", 1);
+
+	bool ok = target->sum == 1 && !emitter->is_connected("bench", target, "_on_signal");
+	if (!ok)
+		print_line("\tFAIL: one shot connection received " + itos(target->sum) + " emissions");
+
+	memdelete(target);
+	memdelete(emitter);
+
+	return ok;
+}
+
+MainLoop *test() {
+
+	print_line("Signal emission benchmark: " + itos(SIGNAL_EMISSIONS) + " emissions");
+
+	bool ok = true;
+
+	for (int targets = 1; targets <= SIGNAL_MAX_TARGETS; targets *= 2) {
+
+		ok = _signal_benchmark("Plain", targets, false) && ok;
+		ok = _signal_benchmark("Bound arguments", targets, true) && ok;
+	}
+
+	ok = _signal_oneshot_test() && ok;
+
+	print_line(ok ? "All signals received." : "Some signals were lost!");
+
+	return NULL;
+}
+}
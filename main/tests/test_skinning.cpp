@@ -0,0 +1,195 @@
+/*************************************************************************/
+/*  test_skinning.cpp                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "test_skinning.h"
+
+#include "drivers/gles2/skeleton_xform_gles2.h"
+#include "math_funcs.h"
+#include "os/os.h"
+#include "os/thread_work_pool.h"
+#include "print_string.h"
+#include "vector.h"
+
+namespace TestSkinning {
+
+/* SKINNING BENCHMARK */
+
+enum {
+	SKIN_VERTICES = 65536,
+	SKIN_BONES = 64,
+	SKIN_ITERATIONS = 20,
+	SKIN_CHUNK_SIZE = 1024,
+	SRC_STRIDE = 72, // vertex, normal, tangent, uv, 4 bones, 4 weights
+	DST_STRIDE = 48, // same without bones and weights
+	BONES_OFS = 48,
+	WEIGHTS_OFS = 56
+};
+
+struct SkinningJob {
+
+	SkeletonXformArrays arrays;
+
+	void skin_chunk(uint32_t p_chunk, int p_unused) {
+
+		int from = p_chunk * SKIN_CHUNK_SIZE;
+		skeleton_xform<true, true, false>(arrays, from, MIN(from + SKIN_CHUNK_SIZE, arrays.elements));
+	}
+};
+
+static void _make_mesh(Vector<uint8_t> &r_src, Vector<float> &r_bones) {
+
+	r_src.resize(SKIN_VERTICES * SRC_STRIDE);
+	for (int i = 0; i < SKIN_VERTICES; i++) {
+
+		uint8_t *v = &r_src[i * SRC_STRIDE];
+		float *attribs = (float *)v;
+		for (int j = 0; j < 12; j++)
+			attribs[j] = Math::random(-1.0, 1.0);
+
+		// four weights per vertex, as exported meshes have
+		uint16_t *bones = (uint16_t *)&v[BONES_OFS];
+		float *weights = (float *)&v[WEIGHTS_OFS];
+		float total = 0;
+		for (int j = 0; j < 4; j++) {
+			bones[j] = Math::rand() % SKIN_BONES;
+			weights[j] = Math::random(0.1, 1.0);
+			total += weights[j];
+		}
+		for (int j = 0; j < 4; j++)
+			weights[j] /= total;
+	}
+
+	r_bones.resize(SKIN_BONES * 16);
+	for (int i = 0; i < SKIN_BONES * 16; i++)
+		r_bones[i] = (i % 4 == 3) ? (i % 16 == 15 ? 1.0 : 0.0) : Math::random(-1.0, 1.0);
+}
+
+static uint64_t _report(const String &p_name, uint64_t p_begin) {
+
+	uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - p_begin, 1);
+	print_line(p_name + ": " + itos(elapsed / SKIN_ITERATIONS) + " usec per mesh, " + itos((uint64_t)SKIN_VERTICES * SKIN_ITERATIONS * 1000000 / elapsed) + " vertices/sec");
+	return elapsed;
+}
+
+static float _max_difference(const Vector<uint8_t> &p_a, const Vector<uint8_t> &p_b, int p_b_stride = DST_STRIDE) {
+
+	float diff = 0;
+	for (int i = 0; i < SKIN_VERTICES; i++) {
+
+		const float *a = (const float *)&p_a[i * DST_STRIDE];
+		const float *b = (const float *)&p_b[i * p_b_stride];
+		for (int j = 0; j < DST_STRIDE / 4; j++)
+			diff = MAX(diff, Math::abs(a[j] - b[j]));
+	}
+	return diff;
+}
+
+MainLoop *test() {
+
+	Vector<uint8_t> src;
+	Vector<float> bone_mtx;
+	_make_mesh(src, bone_mtx);
+
+	Vector<uint8_t> dst_scalar;
+	Vector<uint8_t> dst_simd;
+	Vector<uint8_t> dst_threaded;
+	dst_scalar.resize(SKIN_VERTICES * DST_STRIDE);
+	dst_simd.resize(SKIN_VERTICES * DST_STRIDE);
+	dst_threaded.resize(SKIN_VERTICES * DST_STRIDE);
+
+	SkinningJob job;
+	job.arrays.src = src.ptr();
+	job.arrays.src_stride = SRC_STRIDE;
+	job.arrays.dst_stride = DST_STRIDE;
+	job.arrays.bones = &src[BONES_OFS];
+	job.arrays.weights = &src[WEIGHTS_OFS];
+	job.arrays.bones_stride = SRC_STRIDE;
+	job.arrays.bone_mtx = bone_mtx.ptr();
+	job.arrays.elements = SKIN_VERTICES;
+
+	print_line("Skinning benchmark: " + itos(SKIN_VERTICES) + " vertices with normal and tangent, 4 bone weights");
+
+	job.arrays.dst = dst_scalar.ptr();
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < SKIN_ITERATIONS; i++)
+		skeleton_xform_scalar<true, true, false>(job.arrays, 0, SKIN_VERTICES);
+	_report("Scalar", begin);
+
+	job.arrays.dst = dst_simd.ptr();
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < SKIN_ITERATIONS; i++)
+		skeleton_xform<true, true, false>(job.arrays, 0, SKIN_VERTICES);
+#ifdef SKELETON_XFORM_SIMD
+	_report("SIMD", begin);
+#else
+	_report("Default (no SIMD on this platform)", begin);
+#endif
+
+	ThreadWorkPool work_pool;
+	work_pool.init();
+	job.arrays.dst = dst_threaded.ptr();
+	int chunk_count = (SKIN_VERTICES + SKIN_CHUNK_SIZE - 1) / SKIN_CHUNK_SIZE;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < SKIN_ITERATIONS; i++)
+		work_pool.do_work(chunk_count, &job, &SkinningJob::skin_chunk, 0);
+	_report("Threaded, " + itos(work_pool.get_thread_count()) + " threads", begin);
+	work_pool.finish();
+
+	// morphed meshes are skinned in place, leaving the uvs, bones and weights after each vertex alone
+	Vector<uint8_t> inplace_scalar = src;
+	Vector<uint8_t> inplace = src;
+	SkeletonXformArrays inplace_arrays = job.arrays;
+	inplace_arrays.dst_stride = SRC_STRIDE;
+
+	inplace_arrays.src = inplace_arrays.dst = inplace_scalar.ptr();
+	skeleton_xform_scalar<true, true, true>(inplace_arrays, 0, SKIN_VERTICES);
+	inplace_arrays.src = inplace_arrays.dst = inplace.ptr();
+	begin = OS::get_singleton()->get_ticks_usec();
+	skeleton_xform<true, true, true>(inplace_arrays, 0, SKIN_VERTICES);
+	uint64_t inplace_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	print_line("In place: " + itos(inplace_usec) + " usec per mesh");
+
+	// blending the matrices first rounds differently than adding each bone's result
+	float simd_diff = _max_difference(dst_scalar, dst_simd);
+	float threaded_diff = _max_difference(dst_simd, dst_threaded);
+	float inplace_scalar_diff = _max_difference(dst_scalar, inplace_scalar, SRC_STRIDE);
+	float inplace_diff = _max_difference(dst_simd, inplace, SRC_STRIDE);
+	bool untouched = true;
+	for (int i = 0; i < SKIN_VERTICES; i++) {
+		if (memcmp(&inplace[i * SRC_STRIDE + DST_STRIDE], &src[i * SRC_STRIDE + DST_STRIDE], SRC_STRIDE - DST_STRIDE) != 0)
+			untouched = false;
+	}
+	bool ok = simd_diff < 1e-4 && threaded_diff == 0 && inplace_scalar_diff == 0 && inplace_diff == 0 && untouched;
+
+	print_line("Max difference to scalar: " + rtos(simd_diff) + ", threaded to single: " + rtos(threaded_diff) + ", in place to copied: " + rtos(MAX(inplace_scalar_diff, inplace_diff)));
+	print_line(ok ? "Skinning results match." : "Skinning results differ!");
+
+	return NULL;
+}
+}
@@ -864,6 +864,56 @@ bool test_29() {
 	return state;
 };
 
+bool test_30() {
+
+	OS::get_singleton()->print("\n\nTest 30: Allocation count\n");
+
+	bool state = true;
+
+	// appending one character at a time must only reallocate when the rounded capacity grows
+	uint64_t begin = Memory::get_static_alloc_calls();
+	String s;
+	for (int i = 0; i < 1000; i++) {
+		s += CharType('a' + i % 26);
+	}
+	uint64_t append_calls = Memory::get_static_alloc_calls() - begin;
+
+	OS::get_singleton()->print("\tAppending 1000 characters: %i allocations\n", (int)append_calls);
+	if (s.length() != 1000 || s[999] != CharType('a' + 999 % 26))
+		state = false;
+
+	// concatenating two strings allocates the result once
+	String a = "Hello, ";
+	String b = "World";
+	begin = Memory::get_static_alloc_calls();
+	String c = a + b;
+	uint64_t concat_calls = Memory::get_static_alloc_calls() - begin;
+
+	OS::get_singleton()->print("\tConcatenating: %i allocations\n", (int)concat_calls);
+	if (c != "Hello, World")
+		state = false;
+
+	// growing a shared copy allocates the copy at its final size
+	String d = a;
+	begin = Memory::get_static_alloc_calls();
+	d += b;
+	uint64_t cow_calls = Memory::get_static_alloc_calls() - begin;
+
+	OS::get_singleton()->print("\tAppending to a shared copy: %i allocations\n", (int)cow_calls);
+	if (d != "Hello, World" || a != "Hello, ")
+		state = false;
+
+	// counting is only done by the memory debugger, zero means it's not compiled in
+	if (Memory::get_static_alloc_calls() > 0) {
+		if (append_calls > 16 || concat_calls > 1 || cow_calls > 1)
+			state = false;
+	} else {
+		OS::get_singleton()->print("\tAllocation counting not available in this build\n");
+	}
+
+	return state;
+}
+
 typedef bool (*TestFunc)(void);
 
 TestFunc test_funcs[] = {
@@ -897,6 +947,7 @@ TestFunc test_funcs[] = {
 	test_27,
 	test_28,
 	test_29,
+	test_30,
 	0
 
 };
@@ -61,7 +61,41 @@ bool GDCompiler::_create_unary_operator(CodeGen &codegen, const GDParser::Operat
 	return true;
 }
 
-bool GDCompiler::_create_binary_operator(CodeGen &codegen, const GDParser::OperatorNode *on, Variant::Operator op, int p_stack_level, bool p_initializer) {
+static bool _is_numeric_operator(Variant::Operator p_op) {
+
+	switch (p_op) {
+		case Variant::OP_EQUAL:
+		case Variant::OP_NOT_EQUAL:
+		case Variant::OP_LESS:
+		case Variant::OP_LESS_EQUAL:
+		case Variant::OP_GREATER:
+		case Variant::OP_GREATER_EQUAL:
+		case Variant::OP_ADD:
+		case Variant::OP_SUBSTRACT:
+		case Variant::OP_MULTIPLY:
+		case Variant::OP_DIVIDE:
+		case Variant::OP_MODULE: return true;
+		default: return false;
+	}
+}
+
+static Variant::Operator _get_comparison_operator(const GDParser::Node *p_node) {
+
+	if (p_node->type != GDParser::Node::TYPE_OPERATOR)
+		return Variant::OP_MAX;
+
+	switch (static_cast<const GDParser::OperatorNode *>(p_node)->op) {
+		case GDParser::OperatorNode::OP_EQUAL: return Variant::OP_EQUAL;
+		case GDParser::OperatorNode::OP_NOT_EQUAL: return Variant::OP_NOT_EQUAL;
+		case GDParser::OperatorNode::OP_LESS: return Variant::OP_LESS;
+		case GDParser::OperatorNode::OP_LESS_EQUAL: return Variant::OP_LESS_EQUAL;
+		case GDParser::OperatorNode::OP_GREATER: return Variant::OP_GREATER;
+		case GDParser::OperatorNode::OP_GREATER_EQUAL: return Variant::OP_GREATER_EQUAL;
+		default: return Variant::OP_MAX;
+	}
+}
+
+bool GDCompiler::_create_binary_operator(CodeGen &codegen, const GDParser::OperatorNode *on, Variant::Operator op, int p_stack_level, bool p_initializer, GDFunction::Opcode p_opcode) {
 
 	ERR_FAIL_COND_V(on->arguments.size() != 2, false);
 
@@ -75,13 +109,83 @@ bool GDCompiler::_create_binary_operator(CodeGen &codegen, const GDParser::Opera
 	if (src_address_b < 0)
 		return false;
 
-	codegen.opcodes.push_back(GDFunction::OPCODE_OPERATOR); // perform operator
+	if (p_opcode == GDFunction::OPCODE_OPERATOR && specialized_opcodes && _is_numeric_operator(op))
+		p_opcode = GDFunction::OPCODE_OPERATOR_NUMERIC;
+
+	codegen.opcodes.push_back(p_opcode); // perform operator
 	codegen.opcodes.push_back(op); //which operator
 	codegen.opcodes.push_back(src_address_a); // argument 1
 	codegen.opcodes.push_back(src_address_b); // argument 2 (unary only takes one parameter)
 	return true;
 }
 
+int GDCompiler::_create_jump_if_not(CodeGen &codegen, const GDParser::Node *p_condition, int p_stack_level) {
+
+	Variant::Operator op = specialized_opcodes ? _get_comparison_operator(p_condition) : Variant::OP_MAX;
+
+	if (op != Variant::OP_MAX) {
+		//compare and jump in a single opcode, the boolean is never stored
+		if (!_create_binary_operator(codegen, static_cast<const GDParser::OperatorNode *>(p_condition), op, p_stack_level, false, GDFunction::OPCODE_JUMP_IF_NOT_COMPARE))
+			return -1;
+	} else {
+
+		int ret = _parse_expression(codegen, p_condition, p_stack_level, false);
+		if (ret < 0)
+			return -1;
+
+		codegen.opcodes.push_back(GDFunction::OPCODE_JUMP_IF_NOT);
+		codegen.opcodes.push_back(ret);
+	}
+
+	int jump_addr = codegen.opcodes.size();
+	codegen.opcodes.push_back(0); //temporary
+	return jump_addr;
+}
+
+const GDParser::OperatorNode *GDCompiler::_get_range_call(const GDParser::Node *p_expression) const {
+
+	if (p_expression->type != GDParser::Node::TYPE_OPERATOR)
+		return NULL;
+
+	const GDParser::OperatorNode *on = static_cast<const GDParser::OperatorNode *>(p_expression);
+	if (on->op != GDParser::OperatorNode::OP_CALL || on->arguments.size() < 2 || on->arguments.size() > 4)
+		return NULL;
+
+	if (on->arguments[0]->type != GDParser::Node::TYPE_BUILT_IN_FUNCTION || static_cast<const GDParser::BuiltInFunctionNode *>(on->arguments[0])->function != GDFunctions::GEN_RANGE)
+		return NULL;
+
+	return on;
+}
+
+bool GDCompiler::_create_range_arguments(CodeGen &codegen, const GDParser::OperatorNode *p_range, int p_from_pos, int p_to_pos, int p_step_pos, int p_stack_level) {
+
+	//same defaults as range(): from 0, step 1
+	int positions[3] = { p_from_pos, p_to_pos, p_step_pos };
+	const GDParser::Node *values[3] = { NULL, NULL, NULL };
+
+	int argc = p_range->arguments.size() - 1;
+	for (int i = 0; i < argc; i++)
+		values[argc == 1 ? 1 : i] = p_range->arguments[i + 1];
+
+	for (int i = 0; i < 3; i++) {
+
+		int src;
+		if (values[i]) {
+			src = _parse_expression(codegen, values[i], p_stack_level);
+			if (src < 0)
+				return false;
+		} else {
+			src = codegen.get_constant_pos(i == 2 ? 1 : 0) | (GDFunction::ADDR_TYPE_LOCAL_CONSTANT << GDFunction::ADDR_BITS);
+		}
+
+		codegen.opcodes.push_back(GDFunction::OPCODE_ASSIGN);
+		codegen.opcodes.push_back(positions[i]);
+		codegen.opcodes.push_back(src);
+	}
+
+	return true;
+}
+
 /*
 int GDCompiler::_parse_subexpression(CodeGen& codegen,const GDParser::Node *p_expression) {
 
@@ -483,8 +587,11 @@ int GDCompiler::_parse_expression(CodeGen &codegen, const GDParser::Node *p_expr
 						codegen.opcodes.push_back(p_root ? GDFunction::OPCODE_CALL : GDFunction::OPCODE_CALL_RETURN); // perform operator
 						codegen.opcodes.push_back(on->arguments.size() - 2);
 						codegen.alloc_call(on->arguments.size() - 2);
-						for (int i = 0; i < arguments.size(); i++)
+						for (int i = 0; i < arguments.size(); i++) {
 							codegen.opcodes.push_back(arguments[i]);
+							if (i == 1)
+								codegen.opcodes.push_back(specialized_opcodes ? codegen.call_cache_count++ : -1); //method cache for this call site
+						}
 					}
 				} break;
 				case GDParser::OperatorNode::OP_YIELD: {
@@ -1022,15 +1129,10 @@ Error GDCompiler::_parse_block(CodeGen &codegen, const GDParser::BlockNode *p_bl
 						codegen.opcodes.push_back(cf->line);
 						codegen.current_line = cf->line;
 #endif
-						int ret = _parse_expression(codegen, cf->arguments[0], p_stack_level, false);
-						if (ret < 0)
+						int else_addr = _create_jump_if_not(codegen, cf->arguments[0], p_stack_level);
+						if (else_addr < 0)
 							return ERR_PARSE_ERROR;
 
-						codegen.opcodes.push_back(GDFunction::OPCODE_JUMP_IF_NOT);
-						codegen.opcodes.push_back(ret);
-						int else_addr = codegen.opcodes.size();
-						codegen.opcodes.push_back(0); //temporary
-
 						Error err = _parse_block(codegen, cf->body, p_stack_level, p_break_addr, p_continue_addr);
 						if (err)
 							return err;
@@ -1065,34 +1167,72 @@ Error GDCompiler::_parse_block(CodeGen &codegen, const GDParser::BlockNode *p_bl
 						codegen.push_stack_identifiers();
 						codegen.add_stack_identifier(static_cast<const GDParser::IdentifierNode *>(cf->arguments[0])->name, iter_stack_pos);
 
-						int ret = _parse_expression(codegen, cf->arguments[1], slevel, false);
-						if (ret < 0)
-							return ERR_COMPILATION_FAILED;
+						const GDParser::OperatorNode *range = specialized_opcodes ? _get_range_call(cf->arguments[1]) : NULL;
+						int break_pos;
+						int continue_pos;
 
-						//assign container
-						codegen.opcodes.push_back(GDFunction::OPCODE_ASSIGN);
-						codegen.opcodes.push_back(container_pos);
-						codegen.opcodes.push_back(ret);
+						if (range) {
+							//for x in range(): count in the counter, the array is never built
+							int step_pos = (slevel++) | (GDFunction::ADDR_TYPE_STACK << GDFunction::ADDR_BITS);
+							codegen.alloc_stack(slevel);
+
+							if (!_create_range_arguments(codegen, range, counter_pos, container_pos, step_pos, slevel))
+								return ERR_COMPILATION_FAILED;
+
+							//begin loop
+							codegen.opcodes.push_back(GDFunction::OPCODE_ITERATE_RANGE_BEGIN);
+							codegen.opcodes.push_back(counter_pos);
+							codegen.opcodes.push_back(container_pos);
+							codegen.opcodes.push_back(step_pos);
+							codegen.opcodes.push_back(codegen.opcodes.size() + 5);
+							codegen.opcodes.push_back(iterator_pos);
+							codegen.opcodes.push_back(range->arguments.size() - 1); //argument count, for error messages
+							codegen.opcodes.push_back(GDFunction::OPCODE_JUMP); //skip code for next
+							codegen.opcodes.push_back(codegen.opcodes.size() + 9);
+							//break loop
+							break_pos = codegen.opcodes.size();
+							codegen.opcodes.push_back(GDFunction::OPCODE_JUMP); //skip code for next
+							codegen.opcodes.push_back(0); //skip code for next
+							//next loop
+							continue_pos = codegen.opcodes.size();
+							codegen.opcodes.push_back(GDFunction::OPCODE_ITERATE_RANGE);
+							codegen.opcodes.push_back(counter_pos);
+							codegen.opcodes.push_back(container_pos);
+							codegen.opcodes.push_back(step_pos);
+							codegen.opcodes.push_back(break_pos);
+							codegen.opcodes.push_back(iterator_pos);
+
+						} else {
 
-						//begin loop
-						codegen.opcodes.push_back(GDFunction::OPCODE_ITERATE_BEGIN);
-						codegen.opcodes.push_back(counter_pos);
-						codegen.opcodes.push_back(container_pos);
-						codegen.opcodes.push_back(codegen.opcodes.size() + 4);
-						codegen.opcodes.push_back(iterator_pos);
-						codegen.opcodes.push_back(GDFunction::OPCODE_JUMP); //skip code for next
-						codegen.opcodes.push_back(codegen.opcodes.size() + 8);
-						//break loop
-						int break_pos = codegen.opcodes.size();
-						codegen.opcodes.push_back(GDFunction::OPCODE_JUMP); //skip code for next
-						codegen.opcodes.push_back(0); //skip code for next
-						//next loop
-						int continue_pos = codegen.opcodes.size();
-						codegen.opcodes.push_back(GDFunction::OPCODE_ITERATE);
-						codegen.opcodes.push_back(counter_pos);
-						codegen.opcodes.push_back(container_pos);
-						codegen.opcodes.push_back(break_pos);
-						codegen.opcodes.push_back(iterator_pos);
+							int ret = _parse_expression(codegen, cf->arguments[1], slevel, false);
+							if (ret < 0)
+								return ERR_COMPILATION_FAILED;
+
+							//assign container
+							codegen.opcodes.push_back(GDFunction::OPCODE_ASSIGN);
+							codegen.opcodes.push_back(container_pos);
+							codegen.opcodes.push_back(ret);
+
+							//begin loop
+							codegen.opcodes.push_back(GDFunction::OPCODE_ITERATE_BEGIN);
+							codegen.opcodes.push_back(counter_pos);
+							codegen.opcodes.push_back(container_pos);
+							codegen.opcodes.push_back(codegen.opcodes.size() + 4);
+							codegen.opcodes.push_back(iterator_pos);
+							codegen.opcodes.push_back(GDFunction::OPCODE_JUMP); //skip code for next
+							codegen.opcodes.push_back(codegen.opcodes.size() + 8);
+							//break loop
+							break_pos = codegen.opcodes.size();
+							codegen.opcodes.push_back(GDFunction::OPCODE_JUMP); //skip code for next
+							codegen.opcodes.push_back(0); //skip code for next
+							//next loop
+							continue_pos = codegen.opcodes.size();
+							codegen.opcodes.push_back(GDFunction::OPCODE_ITERATE);
+							codegen.opcodes.push_back(counter_pos);
+							codegen.opcodes.push_back(container_pos);
+							codegen.opcodes.push_back(break_pos);
+							codegen.opcodes.push_back(iterator_pos);
+						}
 
 						Error err = _parse_block(codegen, cf->body, slevel, break_pos, continue_pos);
 						if (err)
@@ -1114,12 +1254,10 @@ Error GDCompiler::_parse_block(CodeGen &codegen, const GDParser::BlockNode *p_bl
 						codegen.opcodes.push_back(0);
 						int continue_addr = codegen.opcodes.size();
 
-						int ret = _parse_expression(codegen, cf->arguments[0], p_stack_level, false);
-						if (ret < 0)
+						int jump_addr = _create_jump_if_not(codegen, cf->arguments[0], p_stack_level);
+						if (jump_addr < 0)
 							return ERR_PARSE_ERROR;
-						codegen.opcodes.push_back(GDFunction::OPCODE_JUMP_IF_NOT);
-						codegen.opcodes.push_back(ret);
-						codegen.opcodes.push_back(break_addr);
+						codegen.opcodes[jump_addr] = break_addr;
 						Error err = _parse_block(codegen, cf->body, p_stack_level, break_addr, continue_addr);
 						if (err)
 							return err;
@@ -1228,6 +1366,7 @@ Error GDCompiler::_parse_function(GDScript *p_script, const GDParser::ClassNode
 	codegen.stack_max = 0;
 	codegen.current_line = 0;
 	codegen.call_max = 0;
+	codegen.call_cache_count = 0;
 	codegen.debug_stack = ScriptDebugger::get_singleton() != NULL;
 	Vector<StringName> argnames;
 
@@ -1380,6 +1519,13 @@ Error GDCompiler::_parse_function(GDScript *p_script, const GDParser::ClassNode
 	gdfunc->_argument_count = p_func ? p_func->arguments.size() : 0;
 	gdfunc->_stack_size = codegen.stack_max;
 	gdfunc->_call_size = codegen.call_max;
+	gdfunc->_call_cache_count = codegen.call_cache_count;
+	if (codegen.call_cache_count) {
+		gdfunc->call_cache.resize(codegen.call_cache_count);
+		gdfunc->_call_cache_ptr = &gdfunc->call_cache[0];
+	} else {
+		gdfunc->_call_cache_ptr = NULL;
+	}
 	gdfunc->name = func_name;
 #ifdef DEBUG_ENABLED
 	if (ScriptDebugger::get_singleton()) {
@@ -1883,4 +2029,6 @@ int GDCompiler::get_error_column() const {
 }
 
 GDCompiler::GDCompiler() {
+
+	specialized_opcodes = true;
 }
@@ -124,6 +124,7 @@ class GDCompiler {
 		int current_line;
 		int stack_max;
 		int call_max;
+		int call_cache_count;
 	};
 
 #if 0
@@ -140,7 +141,10 @@ class GDCompiler {
 	void _set_error(const String &p_error, const GDParser::Node *p_node);
 
 	bool _create_unary_operator(CodeGen &codegen, const GDParser::OperatorNode *on, Variant::Operator op, int p_stack_level);
-	bool _create_binary_operator(CodeGen &codegen, const GDParser::OperatorNode *on, Variant::Operator op, int p_stack_level, bool p_initializer = false);
+	bool _create_binary_operator(CodeGen &codegen, const GDParser::OperatorNode *on, Variant::Operator op, int p_stack_level, bool p_initializer = false, GDFunction::Opcode p_opcode = GDFunction::OPCODE_OPERATOR);
+	int _create_jump_if_not(CodeGen &codegen, const GDParser::Node *p_condition, int p_stack_level);
+	const GDParser::OperatorNode *_get_range_call(const GDParser::Node *p_expression) const;
+	bool _create_range_arguments(CodeGen &codegen, const GDParser::OperatorNode *p_range, int p_from_pos, int p_to_pos, int p_step_pos, int p_stack_level);
 
 	//int _parse_subexpression(CodeGen& codegen,const GDParser::BlockNode *p_block,const GDParser::Node *p_expression);
 	int _parse_assign_right_expression(CodeGen &codegen, const GDParser::OperatorNode *p_expression, int p_stack_level);
@@ -152,10 +156,13 @@ class GDCompiler {
 	int err_column;
 	StringName source;
 	String error;
+	bool specialized_opcodes;
 
 public:
 	Error compile(const GDParser *p_parser, GDScript *p_script, bool p_keep_state = false);
 
+	void set_specialized_opcodes(bool p_enable) { specialized_opcodes = p_enable; } // numeric, compare-and-jump and range opcodes plus native call caches, on by default
+
 	String get_error() const;
 	int get_error_line() const;
 	int get_error_column() const;
@@ -1,6 +1,7 @@
 #include "gd_function.h"
 #include "gd_functions.h"
 #include "gd_script.h"
+#include "core_string_names.h"
 #include "os/os.h"
 
 Variant *GDFunction::_get_variant(int p_address, GDInstance *p_instance, GDScript *p_script, Variant &self, Variant *p_stack, String &r_error) const {
@@ -100,6 +101,48 @@ String GDFunction::_get_call_error(const Variant::CallError &p_err, const String
 	return err_text;
 }
 
+MethodBind *GDFunction::_get_call_cache_method(int p_cache, Object *p_object, const StringName &p_method) {
+
+	GDScript *script = NULL;
+	ScriptInstance *si = p_object->get_script_instance();
+	if (si) {
+		if (si->is_placeholder() || si->get_language() != GDScriptLanguage::get_singleton())
+			return NULL;
+		script = static_cast<GDInstance *>(si)->script.ptr();
+	}
+
+	const StringName &type = p_object->get_type_name();
+	uint32_t version = GDScriptLanguage::get_singleton()->call_cache_version;
+	CallCache &cache = _call_cache_ptr[p_cache];
+
+	if (cache.method && cache.type == type && cache.script == script && cache.version == version)
+		return cache.method;
+
+	//miss, resolve the same way Object::call() would and only cache plain native calls
+
+	if (p_method == CoreStringNames::get_singleton()->_free)
+		return NULL;
+
+	if (ObjectTypeDB::overrides_call(type))
+		return NULL; //these handle call() themselves
+
+	for (GDScript *s = script; s; s = s->_base) {
+		if (s->member_functions.has(p_method))
+			return NULL; //script function, goes through the instance
+	}
+
+	MethodBind *method = ObjectTypeDB::get_method(type, p_method);
+	if (!method)
+		return NULL;
+
+	cache.type = type;
+	cache.script = script;
+	cache.version = version;
+	cache.method = method;
+
+	return method;
+}
+
 static String _get_var_type(const Variant *p_type) {
 
 	String basestr;
@@ -131,6 +174,96 @@ static String _get_var_type(const Variant *p_type) {
 	return basestr;
 }
 
+// compare int/float operands directly, returns false if the types need Variant::evaluate()
+static _FORCE_INLINE_ bool _compare_numeric(Variant::Operator p_op, const Variant &p_a, const Variant &p_b, bool &r_result) {
+
+	Variant::Type type_a = p_a.get_type();
+	Variant::Type type_b = p_b.get_type();
+
+	if (type_a == Variant::INT && type_b == Variant::INT) {
+
+		int a = p_a;
+		int b = p_b;
+
+		switch (p_op) {
+			case Variant::OP_EQUAL: r_result = a == b; return true;
+			case Variant::OP_NOT_EQUAL: r_result = a != b; return true;
+			case Variant::OP_LESS: r_result = a < b; return true;
+			case Variant::OP_LESS_EQUAL: r_result = a <= b; return true;
+			case Variant::OP_GREATER: r_result = a > b; return true;
+			case Variant::OP_GREATER_EQUAL: r_result = a >= b; return true;
+			default: return false;
+		}
+	}
+
+	if (!p_a.is_num() || !p_b.is_num())
+		return false;
+
+	double a = p_a;
+	double b = p_b;
+
+	switch (p_op) {
+		case Variant::OP_EQUAL: r_result = a == b; return true;
+		case Variant::OP_NOT_EQUAL: r_result = a != b; return true;
+		case Variant::OP_LESS: r_result = a < b; return true;
+		case Variant::OP_LESS_EQUAL: r_result = a <= b; return true;
+		case Variant::OP_GREATER: r_result = a > b; return true;
+		case Variant::OP_GREATER_EQUAL: r_result = a >= b; return true;
+		default: return false;
+	}
+}
+
+// same results as Variant::evaluate() for int/float operands, returns false if the generic path must be taken
+static _FORCE_INLINE_ bool _evaluate_numeric(Variant::Operator p_op, const Variant &p_a, const Variant &p_b, Variant &r_ret) {
+
+	Variant::Type type_a = p_a.get_type();
+	Variant::Type type_b = p_b.get_type();
+
+	if (type_a == Variant::INT && type_b == Variant::INT) {
+
+		int a = p_a;
+		int b = p_b;
+
+		switch (p_op) {
+			case Variant::OP_ADD: r_ret = a + b; return true;
+			case Variant::OP_SUBSTRACT: r_ret = a - b; return true;
+			case Variant::OP_MULTIPLY: r_ret = a * b; return true;
+			case Variant::OP_DIVIDE: {
+				if (b == 0)
+					return false; //let evaluate() report it
+				r_ret = a / b;
+				return true;
+			}
+			case Variant::OP_MODULE: {
+				if (b == 0)
+					return false;
+				r_ret = a % b;
+				return true;
+			}
+			default: {}
+		}
+	} else if (p_a.is_num() && p_b.is_num()) {
+
+		double a = p_a;
+		double b = p_b;
+
+		switch (p_op) {
+			case Variant::OP_ADD: r_ret = a + b; return true;
+			case Variant::OP_SUBSTRACT: r_ret = a - b; return true;
+			case Variant::OP_MULTIPLY: r_ret = a * b; return true;
+			case Variant::OP_DIVIDE: r_ret = a / b; return true;
+			default: {}
+		}
+	}
+
+	bool result;
+	if (!_compare_numeric(p_op, p_a, p_b, result))
+		return false;
+
+	r_ret = result;
+	return true;
+}
+
 Variant GDFunction::call(GDInstance *p_instance, const Variant **p_args, int p_argcount, Variant::CallError &r_err, CallState *p_state) {
 
 	if (!_code_ptr) {
@@ -236,6 +369,9 @@ Variant GDFunction::call(GDInstance *p_instance, const Variant **p_args, int p_a
 
 	String err_text;
 
+	//call caches are only used and filled from the main thread, so they need no locking
+	bool use_call_cache = _call_cache_count && Thread::get_caller_ID() == Thread::get_main_ID();
+
 #ifdef DEBUG_ENABLED
 
 	if (ScriptDebugger::get_singleton())
@@ -277,6 +413,23 @@ Variant GDFunction::call(GDInstance *p_instance, const Variant **p_args, int p_a
 		int last_opcode = _code_ptr[ip];
 		switch (_code_ptr[ip]) {
 
+			case OPCODE_OPERATOR_NUMERIC: {
+
+				CHECK_SPACE(5);
+
+				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 1];
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+				GET_VARIANT_PTR(dst, 4);
+
+				if (_evaluate_numeric(op, *a, *b, *dst)) {
+					ip += 5;
+					continue;
+				}
+
+				//not numbers, fall through to the generic operator
+			}
 			case OPCODE_OPERATOR: {
 
 				CHECK_SPACE(5);
@@ -600,7 +753,7 @@ Variant GDFunction::call(GDInstance *p_instance, const Variant **p_args, int p_a
 			case OPCODE_CALL_RETURN:
 			case OPCODE_CALL: {
 
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 				bool call_ret = _code_ptr[ip] == OPCODE_CALL_RETURN;
 
 				int argc = _code_ptr[ip + 1];
@@ -610,8 +763,11 @@ Variant GDFunction::call(GDInstance *p_instance, const Variant **p_args, int p_a
 				ERR_BREAK(nameg < 0 || nameg >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[nameg];
 
+				int cache = _code_ptr[ip + 4]; //-1 if the site has no cache
+				ERR_BREAK(cache >= _call_cache_count);
+
 				ERR_BREAK(argc < 0);
-				ip += 4;
+				ip += 5;
 				CHECK_SPACE(argc + 1);
 				Variant **argptrs = call_args;
 
@@ -629,7 +785,28 @@ Variant GDFunction::call(GDInstance *p_instance, const Variant **p_args, int p_a
 
 #endif
 				Variant::CallError err;
-				if (call_ret) {
+				Object *obj = NULL;
+				MethodBind *method = NULL;
+
+				if (use_call_cache && cache >= 0 && base->get_type() == Variant::OBJECT) {
+
+					obj = *base;
+#ifdef DEBUG_ENABLED
+					if (obj && ScriptDebugger::get_singleton() && !base->is_ref() && !ObjectDB::instance_validate(obj))
+						obj = NULL; //let call_ptr() report it
+#endif
+					if (obj)
+						method = _get_call_cache_method(cache, obj, *methodname);
+				}
+
+				if (method) {
+
+					Variant r = obj->call_method_bind(method, (const Variant **)argptrs, argc, err);
+					if (call_ret && err.error == Variant::CallError::CALL_OK) {
+						GET_VARIANT_PTR(ret, argc);
+						*ret = r;
+					}
+				} else if (call_ret) {
 
 					GET_VARIANT_PTR(ret, argc);
 					base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err);
@@ -940,6 +1117,56 @@ Variant GDFunction::call(GDInstance *p_instance, const Variant **p_args, int p_a
 				ip += 3;
 			}
 				continue;
+			case OPCODE_JUMP_IF_NOT_COMPARE: {
+
+				CHECK_SPACE(5);
+
+				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 1];
+				ERR_BREAK(op >= Variant::OP_MAX);
+
+				GET_VARIANT_PTR(a, 2);
+				GET_VARIANT_PTR(b, 3);
+
+				bool result;
+				if (!_compare_numeric(op, *a, *b, result)) {
+
+					bool valid;
+					Variant ret;
+					Variant::evaluate(op, *a, *b, ret, valid);
+
+					if (!valid) {
+#ifdef DEBUG_ENABLED
+
+						if (ret.get_type() == Variant::STRING) {
+							//return a string when invalid with the error
+							err_text = ret;
+							err_text += " in operator '" + Variant::get_operator_name(op) + "'.";
+						} else {
+							err_text = "Invalid operands '" + Variant::get_type_name(a->get_type()) + "' and '" + Variant::get_type_name(b->get_type()) + "' in operator '" + Variant::get_operator_name(op) + "'.";
+						}
+#endif
+						break;
+					}
+
+					result = ret.booleanize(valid);
+#ifdef DEBUG_ENABLED
+					if (!valid) {
+
+						err_text = "cannot evaluate conditional expression of type: " + Variant::get_type_name(ret.get_type());
+						break;
+					}
+#endif
+				}
+
+				if (!result) {
+					int to = _code_ptr[ip + 4];
+					ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+					continue;
+				}
+				ip += 5;
+			}
+				continue;
 			case OPCODE_JUMP_TO_DEF_ARGUMENT: {
 
 				CHECK_SPACE(2);
@@ -1012,6 +1239,79 @@ Variant GDFunction::call(GDInstance *p_instance, const Variant **p_args, int p_a
 				ip += 5; //loop again
 			}
 				continue;
+			case OPCODE_ITERATE_RANGE_BEGIN: {
+
+				CHECK_SPACE(13); //space for this and regular iterate
+
+				GET_VARIANT_PTR(counter, 1);
+				GET_VARIANT_PTR(to, 2);
+				GET_VARIANT_PTR(step, 3);
+
+#ifdef DEBUG_ENABLED
+				if (!counter->is_num() || !to->is_num() || !step->is_num()) {
+
+					const Variant *arg = !counter->is_num() ? counter : (!to->is_num() ? to : step);
+					int errorarg = !counter->is_num() ? 0 : (!to->is_num() ? 1 : 2);
+					if (_code_ptr[ip + 6] == 1)
+						errorarg--; //range(to), the start is not an argument
+					err_text = "Invalid type in built-in function 'range'. Cannot convert argument " + itos(errorarg + 1) + " from " + Variant::get_type_name(arg->get_type()) + " to " + Variant::get_type_name(Variant::REAL) + ".";
+					break;
+				}
+#endif
+				int from = *counter;
+				int end = *to;
+				int incr = *step;
+
+				if (incr == 0) {
+					err_text = "Error calling built-in function 'range': step argument is zero!";
+					break;
+				}
+
+				//store as ints, so the regular iterate can trust the types
+				*counter = from;
+				*to = end;
+				*step = incr;
+
+				if (incr > 0 ? from >= end : from <= end) {
+					int jumpto = _code_ptr[ip + 4];
+					ERR_BREAK(jumpto < 0 || jumpto > _code_size);
+					ip = jumpto;
+					continue;
+				}
+
+				GET_VARIANT_PTR(iterator, 5);
+				*iterator = from;
+
+				ip += 7; //skip regular iterate which is always next
+			}
+				continue;
+			case OPCODE_ITERATE_RANGE: {
+
+				CHECK_SPACE(6);
+
+				GET_VARIANT_PTR(counter, 1);
+				GET_VARIANT_PTR(to, 2);
+				GET_VARIANT_PTR(step, 3);
+
+				int incr = *step;
+				int end = *to;
+				int64_t next = int64_t(counter->operator int()) + incr; //can't overflow near the int limits
+
+				if (incr > 0 ? next >= end : next <= end) {
+					int jumpto = _code_ptr[ip + 4];
+					ERR_BREAK(jumpto < 0 || jumpto > _code_size);
+					ip = jumpto;
+					continue;
+				}
+
+				*counter = int(next);
+
+				GET_VARIANT_PTR(iterator, 5);
+				*iterator = int(next);
+
+				ip += 6; //loop again
+			}
+				continue;
 			case OPCODE_ASSERT: {
 				CHECK_SPACE(2);
 				GET_VARIANT_PTR(test, 1);
@@ -1270,6 +1570,8 @@ GDFunction::GDFunction() :
 
 	_stack_size = 0;
 	_call_size = 0;
+	_call_cache_ptr = NULL;
+	_call_cache_count = 0;
 	name = "<anonymous>";
 #ifdef DEBUG_ENABLED
 	_func_cname = NULL;
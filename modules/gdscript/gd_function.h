@@ -10,11 +10,13 @@
 
 class GDInstance;
 class GDScript;
+class MethodBind;
 
 class GDFunction {
 public:
 	enum Opcode {
 		OPCODE_OPERATOR,
+		OPCODE_OPERATOR_NUMERIC, //int/float fast path, falls back to OPCODE_OPERATOR
 		OPCODE_EXTENDS_TEST,
 		OPCODE_SET,
 		OPCODE_GET,
@@ -37,10 +39,13 @@ public:
 		OPCODE_JUMP,
 		OPCODE_JUMP_IF,
 		OPCODE_JUMP_IF_NOT,
+		OPCODE_JUMP_IF_NOT_COMPARE, //comparison fused with jump-if-not, result is not stored
 		OPCODE_JUMP_TO_DEF_ARGUMENT,
 		OPCODE_RETURN,
 		OPCODE_ITERATE_BEGIN,
 		OPCODE_ITERATE,
+		OPCODE_ITERATE_RANGE_BEGIN, //for x in range(), iterates ints without building the array
+		OPCODE_ITERATE_RANGE,
 		OPCODE_ASSERT,
 		OPCODE_BREAKPOINT,
 		OPCODE_LINE,
@@ -103,6 +108,27 @@ private:
 
 	List<StackDebug> stack_debug;
 
+	// native method resolved by an OPCODE_CALL site, valid while the object type, script and cache version match
+	struct CallCache {
+
+		StringName type;
+		GDScript *script;
+		uint32_t version;
+		MethodBind *method;
+
+		CallCache() {
+			script = NULL;
+			version = 0;
+			method = NULL;
+		}
+	};
+
+	Vector<CallCache> call_cache;
+	CallCache *_call_cache_ptr;
+	int _call_cache_count;
+
+	MethodBind *_get_call_cache_method(int p_cache, Object *p_object, const StringName &p_method);
+
 	_FORCE_INLINE_ Variant *_get_variant(int p_address, GDInstance *p_instance, GDScript *p_script, Variant &self, Variant *p_stack, String &r_error) const;
 	_FORCE_INLINE_ String _get_call_error(const Variant::CallError &p_err, const String &p_where, const Variant **argptrs) const;
 
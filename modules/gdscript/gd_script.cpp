@@ -509,6 +509,8 @@ Error GDScript::reload(bool p_keep_state) {
 
 	bool can_run = ScriptServer::is_scripting_enabled() || parser.is_tool_script();
 
+	GDScriptLanguage::get_singleton()->call_cache_version++; //functions and methods are about to change
+
 	GDCompiler compiler;
 	err = compiler.compile(&parser, this, p_keep_state);
 
@@ -822,6 +824,9 @@ GDScript::GDScript() :
 }
 
 GDScript::~GDScript() {
+
+	GDScriptLanguage::get_singleton()->call_cache_version++; //the address may be reused by another script
+
 	for (Map<StringName, GDFunction *>::Element *E = member_functions.front(); E; E = E->next()) {
 		memdelete(E->get());
 	}
@@ -1706,6 +1711,7 @@ GDScriptLanguage::GDScriptLanguage() {
 #endif
 	profiling = false;
 	script_frame_time = 0;
+	call_cache_version = 0;
 
 	_debug_call_stack_pos = 0;
 	int dmcs = GLOBAL_DEF("debug/script_max_call_stack", 1024);
@@ -265,6 +265,8 @@ class GDScriptLanguage : public ScriptLanguage {
 	bool profiling;
 	uint64_t script_frame_time;
 
+	uint32_t call_cache_version; //bumped when scripts are recompiled or freed, invalidates GDFunction call caches
+
 public:
 	int calls;
 
@@ -36,7 +36,7 @@
 #include "drivers/windows/semaphore_windows.h"
 #include "drivers/windows/thread_windows.h"
 #include "main/main.h"
-#include "os/memory_pool_dynamic_static.h"
+#include "os/memory_pool_dynamic_size_class.h"
 #include "os_windows.h"
 
 #include "scene/resources/texture.h"
@@ -198,7 +198,7 @@ void OS_Windows::initialize_core() {
 
 	mempool_static = new MemoryPoolStaticMalloc;
 #if 1
-	mempool_dynamic = memnew(MemoryPoolDynamicStatic);
+	mempool_dynamic = memnew(MemoryPoolDynamicSizeClass);
 #else
 #define DYNPOOL_SIZE 4 * 1024 * 1024
 	void *buffer = malloc(DYNPOOL_SIZE);
@@ -82,7 +82,7 @@ void VisualInstance::_notification(int p_what) {
 		case NOTIFICATION_TRANSFORM_CHANGED: {
 
 			Transform gt = get_global_transform();
-			VisualServer::get_singleton()->instance_set_transform(instance, gt);
+			get_tree()->_set_instance_transform(instance, gt);
 		} break;
 		case NOTIFICATION_EXIT_WORLD: {
 
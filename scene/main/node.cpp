@@ -297,9 +297,8 @@ void Node::move_child(Node *p_child, int p_pos) {
 	for (int i = 0; i < data.children.size(); i++) {
 		data.children[i]->notification(NOTIFICATION_MOVED_IN_PARENT);
 	}
-	for (const Map<StringName, GroupData>::Element *E = p_child->data.grouped.front(); E; E = E->next()) {
-		E->get().group->changed = true;
-	}
+	//the whole subtree moved, any group with a node in it may be out of order now
+	p_child->_propagate_group_order_changed();
 
 	data.blocked--;
 }
@@ -738,6 +737,17 @@ void Node::add_child_below_node(Node *p_node, Node *p_child, bool p_legible_uniq
 	}
 }
 
+void Node::_propagate_group_order_changed() {
+
+	for (const Map<StringName, GroupData>::Element *E = data.grouped.front(); E; E = E->next()) {
+		E->get().group->changed = true;
+	}
+
+	for (int i = 0; i < data.children.size(); i++) {
+		data.children[i]->_propagate_group_order_changed();
+	}
+}
+
 void Node::_propagate_validate_owner() {
 
 	if (data.owner) {
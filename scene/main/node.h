@@ -135,6 +135,7 @@ private:
 	void _propagate_ready();
 	void _propagate_exit_tree();
 	void _propagate_validate_owner();
+	void _propagate_group_order_changed();
 	void _print_stray_nodes();
 	void _propagate_pause_owner(Node *p_owner);
 	Array _get_node_and_resource(const NodePath &p_path);
@@ -64,34 +64,47 @@ void SceneTree::node_removed(Node *p_node) {
 
 SceneTree::Group *SceneTree::add_to_group(const StringName &p_group, Node *p_node) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E) {
-		E = group_map.insert(p_group, Group());
+	Group *g = group_map.getptr(p_group);
+	if (!g) {
+		group_map.set(p_group, Group());
+		g = group_map.getptr(p_group);
 	}
 
-	if (E->get().nodes.find(p_node) != -1) {
+	if (g->nodes.find(p_node) != -1) {
 		ERR_EXPLAIN("Already in group: " + p_group);
-		ERR_FAIL_V(&E->get());
+		ERR_FAIL_V(g);
 	}
-	E->get().nodes.push_back(p_node);
-	//E->get().last_tree_version=0;
-	E->get().changed = true;
-	return &E->get();
+	//goes past the sorted part, _update_group_order() only needs to place the new ones
+	g->nodes.push_back(p_node);
+	//g->last_tree_version=0;
+	return g;
 }
 
 void SceneTree::remove_from_group(const StringName &p_group, Node *p_node) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	ERR_FAIL_COND(!E);
+	Group *g = group_map.getptr(p_group);
+	ERR_FAIL_COND(!g);
 
-	E->get().nodes.erase(p_node);
-	if (E->get().nodes.empty())
-		group_map.erase(E);
+	//removing keeps the order of the rest
+	int idx = g->nodes.find(p_node);
+	if (idx != -1) {
+		g->nodes.remove(idx);
+		if (idx < g->sorted)
+			g->sorted--;
+	}
+	if (g->nodes.empty())
+		group_map.erase(p_group);
 }
 
 void SceneTree::_flush_transform_notifications() {
 
 	SelfList<Node> *n = xform_change_list.first();
+	if (!n)
+		return;
+
+	bool was_batching = xform_instances_batching;
+	xform_instances_batching = true;
+
 	while (n) {
 
 		Node *node = n->self();
@@ -100,6 +113,26 @@ void SceneTree::_flush_transform_notifications() {
 		n = nx;
 		node->notification(NOTIFICATION_TRANSFORM_CHANGED);
 	}
+
+	xform_instances_batching = was_batching;
+
+	if (!xform_instances_batching && xform_instances.size()) {
+
+		VisualServer::get_singleton()->instances_set_transforms(xform_instances, xform_instance_transforms);
+		xform_instances.clear();
+		xform_instance_transforms.clear();
+	}
+}
+
+void SceneTree::_set_instance_transform(RID p_instance, const Transform &p_transform) {
+
+	if (!xform_instances_batching) {
+		VisualServer::get_singleton()->instance_set_transform(p_instance, p_transform);
+		return;
+	}
+
+	xform_instances.push_back(p_instance);
+	xform_instance_transforms.push_back(p_transform);
 }
 
 void SceneTree::_flush_ugc() {
@@ -124,26 +157,55 @@ void SceneTree::_flush_ugc() {
 
 void SceneTree::_update_group_order(Group &g) {
 
-	if (!g.changed)
-		return;
-	if (g.nodes.empty())
-		return;
+	if (g.changed) {
+		g.sorted = 0;
+		g.changed = false;
+	}
 
-	Node **nodes = &g.nodes[0];
 	int node_count = g.nodes.size();
+	if (g.sorted >= node_count)
+		return;
+
+	Node **nodes = g.nodes.ptr();
+	Node::Comparator compare;
+
+	if (g.sorted == 0 || node_count - g.sorted > GROUP_INCREMENTAL_SORT_MAX) {
 
-	SortArray<Node *, Node::Comparator> node_sort;
-	node_sort.sort(nodes, node_count);
-	g.changed = false;
+		SortArray<Node *, Node::Comparator> node_sort;
+		node_sort.sort(nodes, node_count);
+
+	} else {
+
+		//few nodes were added since the last sort, binary insert them into the sorted part
+		for (int i = g.sorted; i < node_count; i++) {
+
+			Node *node = nodes[i];
+			int lo = 0;
+			int hi = i;
+			while (lo < hi) {
+				int mid = (lo + hi) / 2;
+				if (compare(node, nodes[mid]))
+					hi = mid;
+				else
+					lo = mid + 1;
+			}
+
+			if (lo < i) {
+				movemem(&nodes[lo + 1], &nodes[lo], (i - lo) * sizeof(Node *));
+				nodes[lo] = node;
+			}
+		}
+	}
+
+	g.sorted = node_count;
 }
 
 void SceneTree::call_group(uint32_t p_call_flags, const StringName &p_group, const StringName &p_function, VARIANT_ARG_DECLARE) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *g = group_map.getptr(p_group);
+	if (!g)
 		return;
-	Group &g = E->get();
-	if (g.nodes.empty())
+	if (g->nodes.empty())
 		return;
 
 	if (p_call_flags & GROUP_CALL_UNIQUE && !(p_call_flags & GROUP_CALL_REALTIME)) {
@@ -170,11 +232,11 @@ void SceneTree::call_group(uint32_t p_call_flags, const StringName &p_group, con
 		return;
 	}
 
-	_update_group_order(g);
+	_update_group_order(*g);
 
-	Vector<Node *> nodes_copy = g.nodes;
-	Node **nodes = &nodes_copy[0];
-	int node_count = nodes_copy.size();
+	const Vector<Node *> snapshot = g->nodes;
+	int node_count = snapshot.size();
+	Node *const *nodes = snapshot.ptr();
 
 	call_lock++;
 
@@ -218,18 +280,17 @@ void SceneTree::call_group(uint32_t p_call_flags, const StringName &p_group, con
 
 void SceneTree::notify_group(uint32_t p_call_flags, const StringName &p_group, int p_notification) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *g = group_map.getptr(p_group);
+	if (!g)
 		return;
-	Group &g = E->get();
-	if (g.nodes.empty())
+	if (g->nodes.empty())
 		return;
 
-	_update_group_order(g);
+	_update_group_order(*g);
 
-	Vector<Node *> nodes_copy = g.nodes;
-	Node **nodes = &nodes_copy[0];
-	int node_count = nodes_copy.size();
+	const Vector<Node *> snapshot = g->nodes;
+	int node_count = snapshot.size();
+	Node *const *nodes = snapshot.ptr();
 
 	call_lock++;
 
@@ -267,18 +328,17 @@ void SceneTree::notify_group(uint32_t p_call_flags, const StringName &p_group, i
 
 void SceneTree::set_group(uint32_t p_call_flags, const StringName &p_group, const String &p_name, const Variant &p_value) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *g = group_map.getptr(p_group);
+	if (!g)
 		return;
-	Group &g = E->get();
-	if (g.nodes.empty())
+	if (g->nodes.empty())
 		return;
 
-	_update_group_order(g);
+	_update_group_order(*g);
 
-	Vector<Node *> nodes_copy = g.nodes;
-	Node **nodes = &nodes_copy[0];
-	int node_count = nodes_copy.size();
+	const Vector<Node *> snapshot = g->nodes;
+	int node_count = snapshot.size();
+	Node *const *nodes = snapshot.ptr();
 
 	call_lock++;
 
@@ -790,21 +850,17 @@ bool SceneTree::is_paused() const {
 
 void SceneTree::_call_input_pause(const StringName &p_group, const StringName &p_method, const InputEvent &p_input) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *g = group_map.getptr(p_group);
+	if (!g)
 		return;
-	Group &g = E->get();
-	if (g.nodes.empty())
+	if (g->nodes.empty())
 		return;
 
-	_update_group_order(g);
+	_update_group_order(*g);
 
-	//copy, so copy on write happens in case something is removed from process while being called
-	//performance is not lost because only if something is added/removed the vector is copied.
-	Vector<Node *> nodes_copy = g.nodes;
-
-	int node_count = nodes_copy.size();
-	Node **nodes = &nodes_copy[0];
+	const Vector<Node *> snapshot = g->nodes;
+	int node_count = snapshot.size();
+	Node *const *nodes = snapshot.ptr();
 
 	Variant arg = p_input;
 	const Variant *v[1] = { &arg };
@@ -835,21 +891,17 @@ void SceneTree::_call_input_pause(const StringName &p_group, const StringName &p
 
 void SceneTree::_notify_group_pause(const StringName &p_group, int p_notification) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *g = group_map.getptr(p_group);
+	if (!g)
 		return;
-	Group &g = E->get();
-	if (g.nodes.empty())
+	if (g->nodes.empty())
 		return;
 
-	_update_group_order(g);
-
-	//copy, so copy on write happens in case something is removed from process while being called
-	//performance is not lost because only if something is added/removed the vector is copied.
-	Vector<Node *> nodes_copy = g.nodes;
+	_update_group_order(*g);
 
-	int node_count = nodes_copy.size();
-	Node **nodes = &nodes_copy[0];
+	const Vector<Node *> snapshot = g->nodes;
+	int node_count = snapshot.size();
+	Node *const *nodes = snapshot.ptr();
 
 	call_lock++;
 
@@ -918,18 +970,18 @@ int64_t SceneTree::get_frame() const {
 Array SceneTree::_get_nodes_in_group(const StringName &p_group) {
 
 	Array ret;
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *g = group_map.getptr(p_group);
+	if (!g)
 		return ret;
 
-	_update_group_order(E->get()); //update order just in case
-	int nc = E->get().nodes.size();
+	_update_group_order(*g); //update order just in case
+	int nc = g->nodes.size();
 	if (nc == 0)
 		return ret;
 
 	ret.resize(nc);
 
-	Node **ptr = E->get().nodes.ptr();
+	Node **ptr = g->nodes.ptr();
 	for (int i = 0; i < nc; i++) {
 
 		ret[i] = ptr[i];
@@ -944,15 +996,15 @@ bool SceneTree::has_group(const StringName &p_identifier) const {
 }
 void SceneTree::get_nodes_in_group(const StringName &p_group, List<Node *> *p_list) {
 
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E)
+	Group *g = group_map.getptr(p_group);
+	if (!g)
 		return;
 
-	_update_group_order(E->get()); //update order just in case
-	int nc = E->get().nodes.size();
+	_update_group_order(*g); //update order just in case
+	int nc = g->nodes.size();
 	if (nc == 0)
 		return;
-	Node **ptr = E->get().nodes.ptr();
+	Node **ptr = g->nodes.ptr();
 	for (int i = 0; i < nc; i++) {
 
 		p_list->push_back(ptr[i]);
@@ -1628,6 +1680,7 @@ SceneTree::SceneTree() {
 	singleton = this;
 	_quit = false;
 	accept_quit = true;
+	xform_instances_batching = false;
 	initialized = false;
 #ifdef TOOLS_ENABLED
 	editor_hint = false;
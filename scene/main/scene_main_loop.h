@@ -30,6 +30,7 @@
 #ifndef SCENE_MAIN_LOOP_H
 #define SCENE_MAIN_LOOP_H
 
+#include "hash_map.h"
 #include "os/main_loop.h"
 #include "os/thread_safe.h"
 #include "scene/resources/world.h"
@@ -70,12 +71,23 @@ public:
 	};
 
 private:
+	enum {
+		GROUP_INCREMENTAL_SORT_MAX = 32 // more additions than this are sorted from scratch
+	};
+
+	/* Calls on a group iterate a copy of nodes. The copy shares the buffer, so it costs
+	   nothing unless nodes are added to or removed from the group meanwhile, which
+	   then go to a buffer of the group's own and don't affect the loop. */
 	struct Group {
 
 		Vector<Node *> nodes;
 		//uint64_t last_tree_version;
-		bool changed;
-		Group() { changed = false; };
+		int sorted; // nodes before this are in tree order, the rest were added since
+		bool changed; // a member moved in the tree, everything needs sorting
+		Group() {
+			sorted = 0;
+			changed = false;
+		};
 	};
 
 	Viewport *root;
@@ -96,7 +108,7 @@ private:
 	bool pause;
 	int root_lock;
 
-	Map<StringName, Group> group_map;
+	HashMap<StringName, Group, StringNameHasher> group_map;
 	bool _quit;
 	bool initialized;
 	bool input_handled;
@@ -177,6 +189,13 @@ private:
 
 	SelfList<Node>::List xform_change_list;
 
+	// visual instance transforms changed while flushing notifications, sent to the server in one call
+	friend class VisualInstance;
+	bool xform_instances_batching;
+	Vector<RID> xform_instances;
+	Vector<Transform> xform_instance_transforms;
+	void _set_instance_transform(RID p_instance, const Transform &p_transform);
+
 #ifdef DEBUG_ENABLED
 
 	Map<int, NodePath> live_edit_node_path_cache;
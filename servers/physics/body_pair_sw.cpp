@@ -222,6 +222,9 @@ bool BodyPairSW::setup(float p_step) {
 
 	offset_B = B->get_transform().get_origin() - A->get_transform().get_origin();
 
+	dynamic_A = A->get_inv_mass() != 0;
+	dynamic_B = B->get_inv_mass() != 0;
+
 	validate_contacts();
 
 	Vector3 offset_A = A->get_transform().get_origin();
@@ -349,12 +352,16 @@ bool BodyPairSW::setup(float p_step) {
 		c.depth = depth;
 
 		Vector3 j_vec = c.normal * c.acc_normal_impulse + c.acc_tangent_impulse;
-		A->apply_impulse(c.rA, -j_vec);
-		B->apply_impulse(c.rB, j_vec);
+		if (dynamic_A)
+			A->apply_impulse(c.rA, -j_vec);
+		if (dynamic_B)
+			B->apply_impulse(c.rB, j_vec);
 		c.acc_bias_impulse = 0;
 		Vector3 jb_vec = c.normal * c.acc_bias_impulse;
-		A->apply_bias_impulse(c.rA, -jb_vec);
-		B->apply_bias_impulse(c.rB, jb_vec);
+		if (dynamic_A)
+			A->apply_bias_impulse(c.rA, -jb_vec);
+		if (dynamic_B)
+			B->apply_bias_impulse(c.rB, jb_vec);
 
 		c.bounce = MAX(A->get_bounce(), B->get_bounce());
 		if (c.bounce) {
@@ -399,8 +406,10 @@ void BodyPairSW::solve(float p_step) {
 
 			Vector3 jb = c.normal * (c.acc_bias_impulse - jbnOld);
 
-			A->apply_bias_impulse(c.rA, -jb);
-			B->apply_bias_impulse(c.rB, jb);
+			if (dynamic_A)
+				A->apply_bias_impulse(c.rA, -jb);
+			if (dynamic_B)
+				B->apply_bias_impulse(c.rB, jb);
 
 			c.active = true;
 		}
@@ -420,8 +429,10 @@ void BodyPairSW::solve(float p_step) {
 
 			Vector3 j = c.normal * (c.acc_normal_impulse - jnOld);
 
-			A->apply_impulse(c.rA, -j);
-			B->apply_impulse(c.rB, j);
+			if (dynamic_A)
+				A->apply_impulse(c.rA, -j);
+			if (dynamic_B)
+				B->apply_impulse(c.rB, j);
 
 			c.active = true;
 		}
@@ -465,8 +476,10 @@ void BodyPairSW::solve(float p_step) {
 
 			jt = c.acc_tangent_impulse - jtOld;
 
-			A->apply_impulse(c.rA, -jt);
-			B->apply_impulse(c.rB, jt);
+			if (dynamic_A)
+				A->apply_impulse(c.rA, -jt);
+			if (dynamic_B)
+				B->apply_impulse(c.rB, jt);
 
 			c.active = true;
 		}
@@ -500,6 +513,8 @@ BodyPairSW::BodyPairSW(BodySW *p_A, int p_shape_A, BodySW *p_B, int p_shape_B) :
 	B->add_constraint(this, 1);
 	contact_count = 0;
 	collided = false;
+	dynamic_A = false;
+	dynamic_B = false;
 }
 
 BodyPairSW::~BodyPairSW() {
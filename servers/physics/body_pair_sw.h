@@ -76,6 +76,11 @@ class BodyPairSW : public ConstraintSW {
 	bool collided;
 	int cc;
 
+	// bodies with no inverse mass (static, kinematic) can be in several islands solved
+	// on different threads, impulses would not move them anyway so they are never written
+	bool dynamic_A;
+	bool dynamic_B;
+
 	static void _contact_added_callback(const Vector3 &p_point_A, const Vector3 &p_point_B, void *p_userdata);
 
 	void contact_added_callback(const Vector3 &p_point_A, const Vector3 &p_point_B);
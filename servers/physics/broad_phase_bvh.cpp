@@ -0,0 +1,690 @@
+/*************************************************************************/
+/*  broad_phase_bvh.cpp                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "broad_phase_bvh.h"
+#include "collision_object_sw.h"
+
+int BroadPhaseBVH::_alloc_node() {
+
+	int idx;
+
+	if (free_node == -1) {
+
+		idx = nodes.size();
+		nodes.resize(idx + 1);
+	} else {
+
+		idx = free_node;
+		free_node = nodes[idx].parent;
+	}
+
+	Node &n = nodes[idx];
+	n.parent = -1;
+	n.children[0] = -1;
+	n.children[1] = -1;
+	n.height = 0;
+	n.element = NULL;
+
+	return idx;
+}
+
+void BroadPhaseBVH::_free_node(int p_node) {
+
+	Node &n = nodes[p_node];
+	n.parent = free_node;
+	n.height = -1;
+	n.element = NULL;
+	free_node = p_node;
+}
+
+void BroadPhaseBVH::_insert_leaf(int p_leaf) {
+
+	Node *n = nodes.ptr();
+
+	if (root == -1) {
+
+		root = p_leaf;
+		n[root].parent = -1;
+		return;
+	}
+
+	// find the cheapest sibling, using the surface area as cost
+
+	AABB leaf_aabb = n[p_leaf].aabb;
+	int index = root;
+
+	while (!n[index].is_leaf()) {
+
+		int child0 = n[index].children[0];
+		int child1 = n[index].children[1];
+
+		real_t area = _get_surface(n[index].aabb);
+		real_t combined_area = _get_surface(n[index].aabb.merge(leaf_aabb));
+
+		// cost of creating a new parent for this node and the new leaf
+		real_t cost = 2.0 * combined_area;
+		// minimum cost of pushing the leaf further down the tree
+		real_t inheritance_cost = 2.0 * (combined_area - area);
+
+		real_t cost0 = _get_surface(n[child0].aabb.merge(leaf_aabb)) + inheritance_cost;
+		if (!n[child0].is_leaf()) {
+			cost0 -= _get_surface(n[child0].aabb);
+		}
+
+		real_t cost1 = _get_surface(n[child1].aabb.merge(leaf_aabb)) + inheritance_cost;
+		if (!n[child1].is_leaf()) {
+			cost1 -= _get_surface(n[child1].aabb);
+		}
+
+		if (cost < cost0 && cost < cost1) {
+			break;
+		}
+
+		index = cost0 < cost1 ? child0 : child1;
+	}
+
+	int sibling = index;
+
+	int new_parent = _alloc_node();
+	n = nodes.ptr(); // may have been reallocated
+
+	int old_parent = n[sibling].parent;
+	n[new_parent].parent = old_parent;
+	n[new_parent].aabb = leaf_aabb.merge(n[sibling].aabb);
+	n[new_parent].height = n[sibling].height + 1;
+	n[new_parent].children[0] = sibling;
+	n[new_parent].children[1] = p_leaf;
+	n[sibling].parent = new_parent;
+	n[p_leaf].parent = new_parent;
+
+	if (old_parent != -1) {
+
+		if (n[old_parent].children[0] == sibling) {
+			n[old_parent].children[0] = new_parent;
+		} else {
+			n[old_parent].children[1] = new_parent;
+		}
+	} else {
+
+		root = new_parent;
+	}
+
+	// walk back up, fixing heights and volumes
+
+	index = n[p_leaf].parent;
+	while (index != -1) {
+
+		index = _balance(index);
+
+		int child0 = n[index].children[0];
+		int child1 = n[index].children[1];
+
+		n[index].height = 1 + MAX(n[child0].height, n[child1].height);
+		n[index].aabb = n[child0].aabb.merge(n[child1].aabb);
+
+		index = n[index].parent;
+	}
+}
+
+void BroadPhaseBVH::_remove_leaf(int p_leaf) {
+
+	Node *n = nodes.ptr();
+
+	if (p_leaf == root) {
+
+		root = -1;
+		return;
+	}
+
+	int parent = n[p_leaf].parent;
+	int grand_parent = n[parent].parent;
+	int sibling = n[parent].children[0] == p_leaf ? n[parent].children[1] : n[parent].children[0];
+
+	if (grand_parent != -1) {
+
+		// replace the parent by the sibling
+		if (n[grand_parent].children[0] == parent) {
+			n[grand_parent].children[0] = sibling;
+		} else {
+			n[grand_parent].children[1] = sibling;
+		}
+		n[sibling].parent = grand_parent;
+		_free_node(parent);
+
+		int index = grand_parent;
+		while (index != -1) {
+
+			index = _balance(index);
+
+			int child0 = n[index].children[0];
+			int child1 = n[index].children[1];
+
+			n[index].aabb = n[child0].aabb.merge(n[child1].aabb);
+			n[index].height = 1 + MAX(n[child0].height, n[child1].height);
+
+			index = n[index].parent;
+		}
+	} else {
+
+		root = sibling;
+		n[sibling].parent = -1;
+		_free_node(parent);
+	}
+}
+
+int BroadPhaseBVH::_balance(int p_index) {
+
+	// performs a left or right rotation if the node is unbalanced, returns the new root of the subtree
+
+	Node *n = nodes.ptr();
+	Node &A = n[p_index];
+
+	if (A.is_leaf() || A.height < 2) {
+		return p_index;
+	}
+
+	int iB = A.children[0];
+	int iC = A.children[1];
+	Node &B = n[iB];
+	Node &C = n[iC];
+
+	int balance = C.height - B.height;
+
+	if (balance > 1) {
+
+		// rotate C up
+		int iF = C.children[0];
+		int iG = C.children[1];
+		Node &F = n[iF];
+		Node &G = n[iG];
+
+		C.children[0] = p_index;
+		C.parent = A.parent;
+		A.parent = iC;
+
+		if (C.parent != -1) {
+			if (n[C.parent].children[0] == p_index) {
+				n[C.parent].children[0] = iC;
+			} else {
+				n[C.parent].children[1] = iC;
+			}
+		} else {
+			root = iC;
+		}
+
+		if (F.height > G.height) {
+			C.children[1] = iF;
+			A.children[1] = iG;
+			G.parent = p_index;
+			A.aabb = B.aabb.merge(G.aabb);
+			C.aabb = A.aabb.merge(F.aabb);
+			A.height = 1 + MAX(B.height, G.height);
+			C.height = 1 + MAX(A.height, F.height);
+		} else {
+			C.children[1] = iG;
+			A.children[1] = iF;
+			F.parent = p_index;
+			A.aabb = B.aabb.merge(F.aabb);
+			C.aabb = A.aabb.merge(G.aabb);
+			A.height = 1 + MAX(B.height, F.height);
+			C.height = 1 + MAX(A.height, G.height);
+		}
+
+		return iC;
+	}
+
+	if (balance < -1) {
+
+		// rotate B up
+		int iD = B.children[0];
+		int iE = B.children[1];
+		Node &D = n[iD];
+		Node &E = n[iE];
+
+		B.children[0] = p_index;
+		B.parent = A.parent;
+		A.parent = iB;
+
+		if (B.parent != -1) {
+			if (n[B.parent].children[0] == p_index) {
+				n[B.parent].children[0] = iB;
+			} else {
+				n[B.parent].children[1] = iB;
+			}
+		} else {
+			root = iB;
+		}
+
+		if (D.height > E.height) {
+			B.children[1] = iD;
+			A.children[0] = iE;
+			E.parent = p_index;
+			A.aabb = C.aabb.merge(E.aabb);
+			B.aabb = A.aabb.merge(D.aabb);
+			A.height = 1 + MAX(C.height, E.height);
+			B.height = 1 + MAX(A.height, D.height);
+		} else {
+			B.children[1] = iE;
+			A.children[0] = iD;
+			D.parent = p_index;
+			A.aabb = C.aabb.merge(D.aabb);
+			B.aabb = A.aabb.merge(E.aabb);
+			A.height = 1 + MAX(C.height, D.height);
+			B.height = 1 + MAX(A.height, E.height);
+		}
+
+		return iB;
+	}
+
+	return p_index;
+}
+
+void BroadPhaseBVH::_set_moved(Element *p_elem) {
+
+	if (p_elem->moved)
+		return;
+
+	p_elem->moved = true;
+	moved_elements.push_back(p_elem);
+}
+
+void BroadPhaseBVH::_report_pair(Element *p_elem, Element *p_with, PairData *p_pair, bool p_colliding) {
+
+	// always report in ID order, so the result doesn't depend on which of both moved
+	if (p_elem->self > p_with->self) {
+		SWAP(p_elem, p_with);
+	}
+
+	if (p_colliding) {
+		if (pair_callback) {
+			p_pair->ud = pair_callback(p_elem->owner, p_elem->subindex, p_with->owner, p_with->subindex, pair_userdata);
+		}
+	} else {
+		if (unpair_callback) {
+			unpair_callback(p_elem->owner, p_elem->subindex, p_with->owner, p_with->subindex, p_pair->ud, unpair_userdata);
+		}
+		p_pair->ud = NULL;
+	}
+
+	p_pair->colliding = p_colliding;
+}
+
+void BroadPhaseBVH::_unpair(Element *p_elem, Map<Element *, PairData *>::Element *p_pair) {
+
+	Element *with = p_pair->key();
+	PairData *pd = p_pair->get();
+
+	if (pd->colliding) {
+		_report_pair(p_elem, with, pd, false);
+	}
+
+	with->paired.erase(p_elem);
+	p_elem->paired.erase(p_pair);
+	memdelete(pd);
+}
+
+void BroadPhaseBVH::_find_pairs(Element *p_elem) {
+
+	const Node *n = nodes.ptr();
+	const AABB &fat_aabb = n[p_elem->leaf].aabb;
+
+	// drop the potential pairs that no longer overlap
+
+	Map<Element *, PairData *>::Element *E = p_elem->paired.front();
+	while (E) {
+
+		Map<Element *, PairData *>::Element *N = E->next();
+
+		if (!fat_aabb.intersects(n[E->key()->leaf].aabb)) {
+			_unpair(p_elem, E);
+		}
+
+		E = N;
+	}
+
+	// look for new ones
+
+	int stack[STACK_SIZE];
+	int stack_size = 0;
+	stack[stack_size++] = root;
+
+	while (stack_size) {
+
+		const Node &node = n[stack[--stack_size]];
+
+		if (!node.aabb.intersects(fat_aabb))
+			continue;
+
+		if (node.is_leaf()) {
+
+			Element *with = node.element;
+
+			if (with == p_elem || with->owner == p_elem->owner)
+				continue;
+			if (p_elem->paired.has(with))
+				continue;
+
+			PairData *pd = memnew(PairData);
+			pd->colliding = false;
+			pd->ud = NULL;
+			p_elem->paired[with] = pd;
+			with->paired[p_elem] = pd;
+
+		} else {
+
+			ERR_BREAK(stack_size + 2 > STACK_SIZE);
+			stack[stack_size++] = node.children[0];
+			stack[stack_size++] = node.children[1];
+		}
+	}
+}
+
+void BroadPhaseBVH::_check_motion(Element *p_elem) {
+
+	for (Map<Element *, PairData *>::Element *E = p_elem->paired.front(); E; E = E->next()) {
+
+		Element *with = E->key();
+		bool pairing = p_elem->aabb.intersects(with->aabb) && (!p_elem->_static || !with->_static);
+
+		if (pairing != E->get()->colliding) {
+			_report_pair(p_elem, with, E->get(), pairing);
+		}
+	}
+}
+
+BroadPhaseSW::ID BroadPhaseBVH::create(CollisionObjectSW *p_object_, int p_subindex) {
+
+	ERR_FAIL_COND_V(!p_object_, 0);
+
+	current++;
+
+	Element e;
+	e.self = current;
+	e.owner = p_object_;
+	e._static = false;
+	e.moved = false;
+	e.reinserted = false;
+	e.subindex = p_subindex;
+	e.leaf = -1;
+
+	element_map[current] = e;
+	return current;
+}
+
+void BroadPhaseBVH::move(ID p_id, const AABB &p_aabb) {
+
+	Map<ID, Element>::Element *E = element_map.find(p_id);
+	ERR_FAIL_COND(!E);
+
+	Element *e = &E->get();
+
+	if (e->leaf == -1) {
+
+		e->leaf = _alloc_node();
+		Node &leaf = nodes[e->leaf];
+		leaf.aabb = p_aabb.grow(margin);
+		leaf.element = e;
+		_insert_leaf(e->leaf);
+		e->reinserted = true;
+
+	} else if (!nodes[e->leaf].aabb.encloses(p_aabb)) {
+
+		// left the enlarged volume, reinsert. Also enlarge towards where it's moving,
+		// so it doesn't need to be reinserted again next step.
+		// The extension is clamped, so teleporting doesn't leave a huge volume behind.
+		AABB fat_aabb = p_aabb.grow(margin);
+		Vector3 motion = (p_aabb.pos - e->aabb.pos) * 2.0;
+		for (int i = 0; i < 3; i++) {
+			real_t limit = p_aabb.size[i] + margin;
+			motion[i] = CLAMP(motion[i], -limit, limit);
+			if (motion[i] < 0) {
+				fat_aabb.pos[i] += motion[i];
+				fat_aabb.size[i] -= motion[i];
+			} else {
+				fat_aabb.size[i] += motion[i];
+			}
+		}
+
+		_remove_leaf(e->leaf);
+		nodes[e->leaf].aabb = fat_aabb;
+		_insert_leaf(e->leaf);
+		e->reinserted = true;
+	}
+
+	e->aabb = p_aabb;
+	_set_moved(e);
+}
+
+void BroadPhaseBVH::set_static(ID p_id, bool p_static) {
+
+	Map<ID, Element>::Element *E = element_map.find(p_id);
+	ERR_FAIL_COND(!E);
+
+	if (E->get()._static == p_static)
+		return;
+
+	E->get()._static = p_static;
+	_set_moved(&E->get());
+}
+
+void BroadPhaseBVH::remove(ID p_id) {
+
+	Map<ID, Element>::Element *E = element_map.find(p_id);
+	ERR_FAIL_COND(!E);
+
+	Element *e = &E->get();
+
+	//unpair must be done immediately on removal to avoid potential invalid pointers
+	while (e->paired.front()) {
+		_unpair(e, e->paired.front());
+	}
+
+	if (e->leaf != -1) {
+		_remove_leaf(e->leaf);
+		_free_node(e->leaf);
+	}
+
+	if (e->moved) {
+		moved_elements.erase(e);
+	}
+
+	element_map.erase(E);
+}
+
+CollisionObjectSW *BroadPhaseBVH::get_object(ID p_id) const {
+
+	const Map<ID, Element>::Element *E = element_map.find(p_id);
+	ERR_FAIL_COND_V(!E, NULL);
+	return E->get().owner;
+}
+
+bool BroadPhaseBVH::is_static(ID p_id) const {
+
+	const Map<ID, Element>::Element *E = element_map.find(p_id);
+	ERR_FAIL_COND_V(!E, false);
+	return E->get()._static;
+}
+
+int BroadPhaseBVH::get_subindex(ID p_id) const {
+
+	const Map<ID, Element>::Element *E = element_map.find(p_id);
+	ERR_FAIL_COND_V(!E, -1);
+	return E->get().subindex;
+}
+
+int BroadPhaseBVH::cull_segment(const Vector3 &p_from, const Vector3 &p_to, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices) {
+
+	if (root == -1 || p_max_results <= 0)
+		return 0;
+
+	int rc = 0;
+
+	const Node *n = nodes.ptr();
+	int stack[STACK_SIZE];
+	int stack_size = 0;
+	stack[stack_size++] = root;
+
+	while (stack_size) {
+
+		const Node &node = n[stack[--stack_size]];
+
+		if (!node.aabb.intersects_segment(p_from, p_to))
+			continue;
+
+		if (node.is_leaf()) {
+
+			const Element *e = node.element;
+			if (!e->aabb.intersects_segment(p_from, p_to))
+				continue;
+
+			p_results[rc] = e->owner;
+			if (p_result_indices)
+				p_result_indices[rc] = e->subindex;
+			rc++;
+			if (rc >= p_max_results)
+				break;
+
+		} else {
+
+			ERR_BREAK(stack_size + 2 > STACK_SIZE);
+			stack[stack_size++] = node.children[0];
+			stack[stack_size++] = node.children[1];
+		}
+	}
+
+	return rc;
+}
+
+int BroadPhaseBVH::cull_aabb(const AABB &p_aabb, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices) {
+
+	if (root == -1 || p_max_results <= 0)
+		return 0;
+
+	int rc = 0;
+
+	const Node *n = nodes.ptr();
+	int stack[STACK_SIZE];
+	int stack_size = 0;
+	stack[stack_size++] = root;
+
+	while (stack_size) {
+
+		const Node &node = n[stack[--stack_size]];
+
+		if (!node.aabb.intersects(p_aabb))
+			continue;
+
+		if (node.is_leaf()) {
+
+			const Element *e = node.element;
+			if (!e->aabb.intersects(p_aabb))
+				continue;
+
+			p_results[rc] = e->owner;
+			if (p_result_indices)
+				p_result_indices[rc] = e->subindex;
+			rc++;
+			if (rc >= p_max_results)
+				break;
+
+		} else {
+
+			ERR_BREAK(stack_size + 2 > STACK_SIZE);
+			stack[stack_size++] = node.children[0];
+			stack[stack_size++] = node.children[1];
+		}
+	}
+
+	return rc;
+}
+
+void BroadPhaseBVH::set_pair_callback(PairCallback p_pair_callback, void *p_userdata) {
+
+	pair_callback = p_pair_callback;
+	pair_userdata = p_userdata;
+}
+
+void BroadPhaseBVH::set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) {
+
+	unpair_callback = p_unpair_callback;
+	unpair_userdata = p_userdata;
+}
+
+void BroadPhaseBVH::update() {
+
+	// only the elements that moved can have started or stopped overlapping something
+
+	for (int i = 0; i < moved_elements.size(); i++) {
+
+		Element *e = moved_elements[i];
+		if (e->reinserted) {
+			_find_pairs(e);
+			e->reinserted = false;
+		}
+	}
+
+	for (int i = 0; i < moved_elements.size(); i++) {
+
+		Element *e = moved_elements[i];
+		_check_motion(e);
+		e->moved = false;
+	}
+
+	moved_elements.clear();
+}
+
+BroadPhaseSW *BroadPhaseBVH::_create() {
+
+	return memnew(BroadPhaseBVH);
+}
+
+BroadPhaseBVH::BroadPhaseBVH() {
+
+	root = -1;
+	free_node = -1;
+	current = 0;
+	margin = 0.1;
+	pair_callback = NULL;
+	pair_userdata = NULL;
+	unpair_callback = NULL;
+	unpair_userdata = NULL;
+}
+
+BroadPhaseBVH::~BroadPhaseBVH() {
+
+	for (Map<ID, Element>::Element *E = element_map.front(); E; E = E->next()) {
+
+		// pairs are shared between both elements, delete them only once
+		for (Map<Element *, PairData *>::Element *F = E->get().paired.front(); F; F = F->next()) {
+			if (E->get().self < F->key()->self) {
+				memdelete(F->get());
+			}
+		}
+	}
+}
@@ -0,0 +1,141 @@
+/*************************************************************************/
+/*  broad_phase_bvh.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef BROAD_PHASE_BVH_H
+#define BROAD_PHASE_BVH_H
+
+#include "broad_phase_sw.h"
+#include "map.h"
+#include "vector.h"
+
+/**
+ * Dynamic AABB tree broadphase. Leaves store an enlarged AABB (grown by a
+ * margin and by the last motion), so objects moving a little don't need to be
+ * reinserted. The tree is kept balanced with rotations as leaves come and go.
+ *
+ * Elements whose enlarged AABBs overlap are kept as potential pairs, and only
+ * reported once the actual AABBs overlap. The tree is only queried again for
+ * the elements that were reinserted since the last update().
+ */
+
+class BroadPhaseBVH : public BroadPhaseSW {
+
+	struct Element;
+
+	struct PairData {
+
+		bool colliding;
+		void *ud;
+	};
+
+	struct Element {
+
+		ID self;
+		CollisionObjectSW *owner;
+		bool _static;
+		bool moved;
+		bool reinserted;
+		AABB aabb;
+		int subindex;
+		int leaf;
+		Map<Element *, PairData *> paired;
+	};
+
+	struct Node {
+
+		AABB aabb;
+		int parent; // next free node, when not in use
+		int children[2];
+		int height; // -1 when not in use
+		Element *element;
+
+		_FORCE_INLINE_ bool is_leaf() const { return children[0] == -1; }
+	};
+
+	enum {
+		STACK_SIZE = 256
+	};
+
+	Vector<Node> nodes;
+	int root;
+	int free_node;
+
+	Map<ID, Element> element_map;
+	Vector<Element *> moved_elements;
+
+	ID current;
+	real_t margin;
+
+	PairCallback pair_callback;
+	void *pair_userdata;
+	UnpairCallback unpair_callback;
+	void *unpair_userdata;
+
+	_FORCE_INLINE_ static real_t _get_surface(const AABB &p_aabb) {
+		return (p_aabb.size.x * p_aabb.size.y + p_aabb.size.y * p_aabb.size.z + p_aabb.size.z * p_aabb.size.x) * 2.0;
+	}
+
+	int _alloc_node();
+	void _free_node(int p_node);
+
+	void _insert_leaf(int p_leaf);
+	void _remove_leaf(int p_leaf);
+	int _balance(int p_index);
+
+	void _set_moved(Element *p_elem);
+	void _report_pair(Element *p_elem, Element *p_with, PairData *p_pair, bool p_colliding);
+	void _unpair(Element *p_elem, Map<Element *, PairData *>::Element *p_pair);
+	void _find_pairs(Element *p_elem);
+	void _check_motion(Element *p_elem);
+
+public:
+	// 0 is an invalid ID
+	virtual ID create(CollisionObjectSW *p_object_, int p_subindex = 0);
+	virtual void move(ID p_id, const AABB &p_aabb);
+	virtual void set_static(ID p_id, bool p_static);
+	virtual void remove(ID p_id);
+
+	virtual CollisionObjectSW *get_object(ID p_id) const;
+	virtual bool is_static(ID p_id) const;
+	virtual int get_subindex(ID p_id) const;
+
+	virtual int cull_segment(const Vector3 &p_from, const Vector3 &p_to, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices = NULL);
+	virtual int cull_aabb(const AABB &p_aabb, CollisionObjectSW **p_results, int p_max_results, int *p_result_indices = NULL);
+
+	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata);
+	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata);
+
+	virtual void update();
+
+	static BroadPhaseSW *_create();
+	BroadPhaseBVH();
+	~BroadPhaseBVH();
+};
+
+#endif // BROAD_PHASE_BVH_H
@@ -111,6 +111,9 @@ ConeTwistJointSW::ConeTwistJointSW(BodySW *rbA, BodySW *rbB, const Transform &rb
 }
 
 bool ConeTwistJointSW::setup(float p_step) {
+
+	_update_dynamic();
+
 	m_appliedImpulse = real_t(0.);
 
 	//set bias, sign, clear accumulator
@@ -264,8 +267,10 @@ void ConeTwistJointSW::solve(real_t timeStep) {
 			real_t impulse = depth * tau / timeStep * jacDiagABInv - rel_vel * jacDiagABInv;
 			m_appliedImpulse += impulse;
 			Vector3 impulse_vector = normal * impulse;
-			A->apply_impulse(pivotAInW - A->get_transform().origin, impulse_vector);
-			B->apply_impulse(pivotBInW - B->get_transform().origin, -impulse_vector);
+			if (dynamic_A)
+				A->apply_impulse(pivotAInW - A->get_transform().origin, impulse_vector);
+			if (dynamic_B)
+				B->apply_impulse(pivotBInW - B->get_transform().origin, -impulse_vector);
 		}
 	}
 
@@ -286,8 +291,10 @@ void ConeTwistJointSW::solve(real_t timeStep) {
 
 			Vector3 impulse = m_swingAxis * impulseMag;
 
-			A->apply_torque_impulse(impulse);
-			B->apply_torque_impulse(-impulse);
+			if (dynamic_A)
+				A->apply_torque_impulse(impulse);
+			if (dynamic_B)
+				B->apply_torque_impulse(-impulse);
 		}
 
 		// solve twist limit
@@ -302,8 +309,10 @@ void ConeTwistJointSW::solve(real_t timeStep) {
 
 			Vector3 impulse = m_twistAxis * impulseMag;
 
-			A->apply_torque_impulse(impulse);
-			B->apply_torque_impulse(-impulse);
+			if (dynamic_A)
+				A->apply_torque_impulse(impulse);
+			if (dynamic_B)
+				B->apply_torque_impulse(-impulse);
 		}
 	}
 }
@@ -120,7 +120,7 @@ int G6DOFRotationalLimitMotorSW::testLimitValue(real_t test_value) {
 
 real_t G6DOFRotationalLimitMotorSW::solveAngularLimits(
 		real_t timeStep, Vector3 &axis, real_t jacDiagABInv,
-		BodySW *body0, BodySW *body1) {
+		BodySW *body0, BodySW *body1, bool dynamic0, bool dynamic1) {
 	if (needApplyTorques() == false) return 0.0f;
 
 	real_t target_velocity = m_targetVelocity;
@@ -174,8 +174,8 @@ real_t G6DOFRotationalLimitMotorSW::solveAngularLimits(
 
 	Vector3 motorImp = clippedMotorImpulse * axis;
 
-	body0->apply_torque_impulse(motorImp);
-	if (body1) body1->apply_torque_impulse(-motorImp);
+	if (dynamic0) body0->apply_torque_impulse(motorImp);
+	if (body1 && dynamic1) body1->apply_torque_impulse(-motorImp);
 
 	return clippedMotorImpulse;
 }
@@ -190,7 +190,8 @@ real_t G6DOFTranslationalLimitMotorSW::solveLinearAxis(
 		BodySW *body2, const Vector3 &pointInB,
 		int limit_index,
 		const Vector3 &axis_normal_on_a,
-		const Vector3 &anchorPos) {
+		const Vector3 &anchorPos,
+		bool dynamic1, bool dynamic2) {
 
 	///find relative velocity
 	//    Vector3 rel_pos1 = pointInA - body1->get_transform().origin;
@@ -240,8 +241,10 @@ real_t G6DOFTranslationalLimitMotorSW::solveLinearAxis(
 	normalImpulse = m_accumulatedImpulse[limit_index] - oldNormalImpulse;
 
 	Vector3 impulse_vector = axis_normal_on_a * normalImpulse;
-	body1->apply_impulse(rel_pos1, impulse_vector);
-	body2->apply_impulse(rel_pos2, -impulse_vector);
+	if (dynamic1)
+		body1->apply_impulse(rel_pos1, impulse_vector);
+	if (dynamic2)
+		body2->apply_impulse(rel_pos2, -impulse_vector);
 	return normalImpulse;
 }
 
@@ -338,6 +341,8 @@ bool Generic6DOFJointSW::testAngularLimitMotor(int axis_index) {
 
 bool Generic6DOFJointSW::setup(float p_step) {
 
+	_update_dynamic();
+
 	// Clear accumulated impulses for the next simulation step
 	m_linearLimits.m_accumulatedImpulse = Vector3(real_t(0.), real_t(0.), real_t(0.));
 	int i;
@@ -413,7 +418,8 @@ void Generic6DOFJointSW::solve(real_t timeStep) {
 					jacDiagABInv,
 					A, pointInA,
 					B, pointInB,
-					i, linear_axis, m_AnchorPos);
+					i, linear_axis, m_AnchorPos,
+					dynamic_A, dynamic_B);
 		}
 	}
 
@@ -428,7 +434,7 @@ void Generic6DOFJointSW::solve(real_t timeStep) {
 
 			angularJacDiagABInv = real_t(1.) / m_jacAng[i].getDiagonal();
 
-			m_angularLimits[i].solveAngularLimits(m_timeStep, angular_axis, angularJacDiagABInv, A, B);
+			m_angularLimits[i].solveAngularLimits(m_timeStep, angular_axis, angularJacDiagABInv, A, B, dynamic_A, dynamic_B);
 		}
 	}
 }
@@ -134,8 +134,8 @@ public:
 	*/
 	int testLimitValue(real_t test_value);
 
-	//! apply the correction impulses for two bodies
-	real_t solveAngularLimits(real_t timeStep, Vector3 &axis, real_t jacDiagABInv, BodySW *body0, BodySW *body1);
+	//! apply the correction impulses for two bodies, only the dynamic ones are written
+	real_t solveAngularLimits(real_t timeStep, Vector3 &axis, real_t jacDiagABInv, BodySW *body0, BodySW *body1, bool dynamic0, bool dynamic1);
 };
 
 class G6DOFTranslationalLimitMotorSW {
@@ -193,7 +193,8 @@ public:
 			BodySW *body2, const Vector3 &pointInB,
 			int limit_index,
 			const Vector3 &axis_normal_on_a,
-			const Vector3 &anchorPos);
+			const Vector3 &anchorPos,
+			bool dynamic1, bool dynamic2);
 };
 
 class Generic6DOFJointSW : public JointSW {
@@ -159,6 +159,8 @@ HingeJointSW::HingeJointSW(BodySW *rbA, BodySW *rbB, const Vector3 &pivotInA, co
 
 bool HingeJointSW::setup(float p_step) {
 
+	_update_dynamic();
+
 	m_appliedImpulse = real_t(0.);
 
 	if (!m_angularOnly) {
@@ -287,8 +289,10 @@ void HingeJointSW::solve(float p_step) {
 			real_t impulse = depth * tau / p_step * jacDiagABInv - rel_vel * jacDiagABInv;
 			m_appliedImpulse += impulse;
 			Vector3 impulse_vector = normal * impulse;
-			A->apply_impulse(pivotAInW - A->get_transform().origin, impulse_vector);
-			B->apply_impulse(pivotBInW - B->get_transform().origin, -impulse_vector);
+			if (dynamic_A)
+				A->apply_impulse(pivotAInW - A->get_transform().origin, impulse_vector);
+			if (dynamic_B)
+				B->apply_impulse(pivotBInW - B->get_transform().origin, -impulse_vector);
 		}
 	}
 
@@ -330,8 +334,10 @@ void HingeJointSW::solve(float p_step) {
 				angularError *= (real_t(1.) / denom2) * relaxation;
 			}
 
-			A->apply_torque_impulse(-velrelOrthog + angularError);
-			B->apply_torque_impulse(velrelOrthog - angularError);
+			if (dynamic_A)
+				A->apply_torque_impulse(-velrelOrthog + angularError);
+			if (dynamic_B)
+				B->apply_torque_impulse(velrelOrthog - angularError);
 
 			// solve limit
 			if (m_solveLimit) {
@@ -345,8 +351,10 @@ void HingeJointSW::solve(float p_step) {
 				impulseMag = m_accLimitImpulse - temp;
 
 				Vector3 impulse = axisA * impulseMag * m_limitSign;
-				A->apply_torque_impulse(impulse);
-				B->apply_torque_impulse(-impulse);
+				if (dynamic_A)
+					A->apply_torque_impulse(impulse);
+				if (dynamic_B)
+					B->apply_torque_impulse(-impulse);
 			}
 		}
 
@@ -367,8 +375,10 @@ void HingeJointSW::solve(float p_step) {
 			clippedMotorImpulse = clippedMotorImpulse < -m_maxMotorImpulse ? -m_maxMotorImpulse : clippedMotorImpulse;
 			Vector3 motorImp = clippedMotorImpulse * axisA;
 
-			A->apply_torque_impulse(motorImp + angularLimit);
-			B->apply_torque_impulse(-motorImp - angularLimit);
+			if (dynamic_A)
+				A->apply_torque_impulse(motorImp + angularLimit);
+			if (dynamic_B)
+				B->apply_torque_impulse(-motorImp - angularLimit);
 		}
 	}
 }
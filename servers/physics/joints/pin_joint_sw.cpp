@@ -51,6 +51,8 @@ subject to the following restrictions:
 
 bool PinJointSW::setup(float p_step) {
 
+	_update_dynamic();
+
 	m_appliedImpulse = real_t(0.);
 
 	Vector3 normal(0, 0, 0);
@@ -119,8 +121,10 @@ void PinJointSW::solve(float p_step) {
 
 		m_appliedImpulse += impulse;
 		Vector3 impulse_vector = normal * impulse;
-		A->apply_impulse(pivotAInW - A->get_transform().origin, impulse_vector);
-		B->apply_impulse(pivotBInW - B->get_transform().origin, -impulse_vector);
+		if (dynamic_A)
+			A->apply_impulse(pivotAInW - A->get_transform().origin, impulse_vector);
+		if (dynamic_B)
+			B->apply_impulse(pivotBInW - B->get_transform().origin, -impulse_vector);
 
 		normal[i] = 0;
 	}
@@ -35,10 +35,24 @@
 
 class JointSW : public ConstraintSW {
 
+protected:
+	// bodies with no inverse mass (static, kinematic) can be in several islands solved
+	// on different threads, impulses would not move them anyway so they are never written
+	bool dynamic_A;
+	bool dynamic_B;
+
+	_FORCE_INLINE_ void _update_dynamic() {
+
+		dynamic_A = get_body_ptr()[0]->get_inv_mass() != 0;
+		dynamic_B = get_body_ptr()[1]->get_inv_mass() != 0;
+	}
+
 public:
 	virtual PhysicsServer::JointType get_type() const = 0;
 	_FORCE_INLINE_ JointSW(BodySW **p_body_ptr = NULL, int p_body_count = 0) :
 			ConstraintSW(p_body_ptr, p_body_count) {
+		dynamic_A = false;
+		dynamic_B = false;
 	}
 };
 
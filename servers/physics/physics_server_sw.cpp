@@ -29,7 +29,9 @@
 /*************************************************************************/
 #include "physics_server_sw.h"
 #include "broad_phase_basic.h"
+#include "broad_phase_bvh.h"
 #include "broad_phase_octree.h"
+#include "globals.h"
 #include "joints/cone_twist_joint_sw.h"
 #include "joints/generic_6dof_joint_sw.h"
 #include "joints/hinge_joint_sw.h"
@@ -1379,6 +1381,20 @@ void PhysicsServerSW::init() {
 	last_step = 0.001;
 	iterations = 8; // 8?
 	stepper = memnew(StepSW);
+
+	// 1 keeps island solving on the physics thread, 0 uses one thread per processor
+	int solver_threads = GLOBAL_DEF("physics/solver_thread_count", 1);
+	Globals::get_singleton()->set_custom_property_info("physics/solver_thread_count", PropertyInfo(Variant::INT, "physics/solver_thread_count", PROPERTY_HINT_RANGE, "0,64,1"));
+	stepper->set_thread_count(solver_threads);
+
+	String broadphase = GLOBAL_DEF("physics/broadphase", "octree");
+	Globals::get_singleton()->set_custom_property_info("physics/broadphase", PropertyInfo(Variant::STRING, "physics/broadphase", PROPERTY_HINT_ENUM, "octree,bvh,basic"));
+	if (broadphase == "bvh") {
+		BroadPhaseSW::create_func = BroadPhaseBVH::_create;
+	} else if (broadphase == "basic") {
+		BroadPhaseSW::create_func = BroadPhaseBasic::_create;
+	}
+
 	direct_state = memnew(PhysicsDirectBodyStateSW);
 };
 
@@ -30,6 +30,7 @@
 #include "step_sw.h"
 #include "joints_sw.h"
 
+#include "frame_allocator.h"
 #include "os/os.h"
 
 void StepSW::_populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **p_constraint_island) {
@@ -106,6 +107,11 @@ void StepSW::_solve_island(ConstraintSW *p_island, int p_iterations, float p_del
 	}
 }
 
+void StepSW::_solve_island_work(uint32_t p_index, SolveData *p_data) {
+
+	_solve_island(p_data->islands[p_index], p_data->iterations, p_data->delta);
+}
+
 void StepSW::_check_suspend(BodySW *p_island, float p_delta) {
 
 	bool can_sleep = true;
@@ -247,7 +253,34 @@ void StepSW::step(SpaceSW *p_space, float p_delta, int p_iterations) {
 
 	/* SOLVE CONSTRAINT ISLANDS */
 
-	{
+	if (work_pool.is_threaded() && island_count > 1) {
+
+		// islands share no dynamic bodies, so they can be solved in any order (and at the same time)
+		// without changing the result. Static and kinematic bodies may be shared between islands and
+		// are read concurrently, so body pairs and joints must never write them (they skip bodies
+		// with no inverse mass, which impulses would not move anyway).
+
+		int solve_count = 0;
+		for (ConstraintSW *ci = constraint_island_list; ci; ci = ci->get_island_list_next()) {
+			solve_count++;
+		}
+
+		FrameAllocator::Scope frame_scope;
+		ConstraintSW **islandw = frame_scope.alloc_array<ConstraintSW *>(solve_count);
+
+		int idx = 0;
+		for (ConstraintSW *ci = constraint_island_list; ci; ci = ci->get_island_list_next()) {
+			islandw[idx++] = ci;
+		}
+
+		SolveData data;
+		data.islands = islandw;
+		data.iterations = p_iterations;
+		data.delta = p_delta;
+
+		work_pool.do_work(solve_count, this, &StepSW::_solve_island_work, &data);
+
+	} else {
 		ConstraintSW *ci = constraint_island_list;
 		while (ci) {
 			//iterating each island separatedly improves cache efficiency
@@ -293,7 +326,23 @@ void StepSW::step(SpaceSW *p_space, float p_delta, int p_iterations) {
 	_step++;
 }
 
+void StepSW::set_thread_count(int p_threads) {
+
+	work_pool.finish();
+	work_pool.init(p_threads);
+}
+
+int StepSW::get_thread_count() const {
+
+	return work_pool.get_thread_count();
+}
+
 StepSW::StepSW() {
 
 	_step = 1;
 }
+
+StepSW::~StepSW() {
+
+	work_pool.finish();
+}
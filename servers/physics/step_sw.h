@@ -30,20 +30,35 @@
 #ifndef STEP_SW_H
 #define STEP_SW_H
 
+#include "os/thread_work_pool.h"
 #include "space_sw.h"
 
 class StepSW {
 
 	uint64_t _step;
 
+	struct SolveData {
+
+		ConstraintSW **islands;
+		int iterations;
+		float delta;
+	};
+
+	ThreadWorkPool work_pool;
+
 	void _populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **p_constraint_island);
 	void _setup_island(ConstraintSW *p_island, float p_delta);
 	void _solve_island(ConstraintSW *p_island, int p_iterations, float p_delta);
+	void _solve_island_work(uint32_t p_index, SolveData *p_data);
 	void _check_suspend(BodySW *p_island, float p_delta);
 
 public:
+	void set_thread_count(int p_threads);
+	int get_thread_count() const;
+
 	void step(SpaceSW *p_space, float p_delta, int p_iterations);
 	StepSW();
+	~StepSW();
 };
 
 #endif // STEP__SW_H
@@ -30,11 +30,16 @@
 #include "area_pair_2d_sw.h"
 #include "collision_solver_2d_sw.h"
 
-bool AreaPair2DSW::setup(float p_step) {
+void AreaPair2DSW::narrowphase(float p_step) {
 
-	bool result =
+	detected =
 			area_shape != -1 && body_shape != -1 &&
 			area->test_collision_mask(body) && CollisionSolver2DSW::solve(body->get_shape(body_shape), body->get_transform() * body->get_shape_transform(body_shape), Vector2(), area->get_shape(area_shape), area->get_transform() * area->get_shape_transform(area_shape), Vector2(), NULL, this);
+}
+
+bool AreaPair2DSW::setup(float p_step) {
+
+	bool result = detected;
 
 	if (result != colliding) {
 
@@ -84,6 +89,7 @@ AreaPair2DSW::AreaPair2DSW(Body2DSW *p_body, int p_body_shape, Area2DSW *p_area,
 	body_shape = p_body_shape;
 	area_shape = p_area_shape;
 	colliding = false;
+	detected = false;
 	body->add_constraint(this, 0);
 	area->add_constraint(this);
 	if (p_body->get_mode() == Physics2DServer::BODY_MODE_KINEMATIC) //need to be active to process pair
@@ -105,11 +111,16 @@ AreaPair2DSW::~AreaPair2DSW() {
 
 //////////////////////////////////
 
-bool Area2Pair2DSW::setup(float p_step) {
+void Area2Pair2DSW::narrowphase(float p_step) {
 
-	bool result =
+	detected =
 			shape_a != -1 && shape_b != -1 &&
 			area_a->test_collision_mask(area_b) && CollisionSolver2DSW::solve(area_a->get_shape(shape_a), area_a->get_transform() * area_a->get_shape_transform(shape_a), Vector2(), area_b->get_shape(shape_b), area_b->get_transform() * area_b->get_shape_transform(shape_b), Vector2(), NULL, this);
+}
+
+bool Area2Pair2DSW::setup(float p_step) {
+
+	bool result = detected;
 
 	if (result != colliding) {
 
@@ -161,6 +172,7 @@ Area2Pair2DSW::Area2Pair2DSW(Area2DSW *p_area_a, int p_shape_a, Area2DSW *p_area
 	shape_a = p_shape_a;
 	shape_b = p_shape_b;
 	colliding = false;
+	detected = false;
 	area_a->add_constraint(this);
 	area_b->add_constraint(this);
 }
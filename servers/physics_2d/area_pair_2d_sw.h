@@ -41,8 +41,10 @@ class AreaPair2DSW : public Constraint2DSW {
 	int body_shape;
 	int area_shape;
 	bool colliding;
+	bool detected;
 
 public:
+	virtual void narrowphase(float p_step);
 	bool setup(float p_step);
 	void solve(float p_step);
 
@@ -59,8 +61,10 @@ class Area2Pair2DSW : public Constraint2DSW {
 	int shape_a;
 	int shape_b;
 	bool colliding;
+	bool detected;
 
 public:
+	virtual void narrowphase(float p_step);
 	bool setup(float p_step);
 	void solve(float p_step);
 
@@ -217,36 +217,35 @@ bool BodyPair2DSW::_test_ccd(float p_step, Body2DSW *p_A, int p_shape_A, const M
 	return true;
 }
 
-bool BodyPair2DSW::setup(float p_step) {
+void BodyPair2DSW::narrowphase(float p_step) {
+
+	ignore = true;
 
 	//one or both shapes have been removed
 	if (shape_A == -1 || shape_B == -1) {
 		collided = false;
-		return false;
+		return;
 	}
 
 	//cannot collide
 	if (!A->test_collision_mask(B) || A->has_exception(B->get_self()) || B->has_exception(A->get_self()) || (A->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC && B->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC && A->get_max_contacts_reported() == 0 && B->get_max_contacts_reported() == 0)) {
 		collided = false;
-		return false;
+		return;
 	}
 
+	ignore = false;
+
 	//use local A coordinates to avoid numerical issues on collision detection
 	offset_B = B->get_transform().get_origin() - A->get_transform().get_origin();
 
 	_validate_contacts();
 
-	Vector2 offset_A = A->get_transform().get_origin();
-	Matrix32 xform_Au = A->get_transform().untranslated();
-	Matrix32 xform_A = xform_Au * A->get_shape_transform(shape_A);
+	Matrix32 xform_A = A->get_transform().untranslated() * A->get_shape_transform(shape_A);
 
 	Matrix32 xform_Bu = B->get_transform();
 	xform_Bu.elements[2] -= A->get_transform().get_origin();
 	Matrix32 xform_B = xform_Bu * B->get_shape_transform(shape_B);
 
-	Shape2DSW *shape_A_ptr = A->get_shape(shape_A);
-	Shape2DSW *shape_B_ptr = B->get_shape(shape_B);
-
 	Vector2 motion_A, motion_B;
 
 	if (A->get_continuous_collision_detection_mode() == Physics2DServer::CCD_MODE_CAST_SHAPE) {
@@ -259,7 +258,28 @@ bool BodyPair2DSW::setup(float p_step) {
 
 	//bool prev_collided=collided;
 
-	collided = CollisionSolver2DSW::solve(shape_A_ptr, xform_A, motion_A, shape_B_ptr, xform_B, motion_B, _add_contact, this, &sep_axis);
+	collided = CollisionSolver2DSW::solve(A->get_shape(shape_A), xform_A, motion_A, B->get_shape(shape_B), xform_B, motion_B, _add_contact, this, &sep_axis);
+}
+
+bool BodyPair2DSW::setup(float p_step) {
+
+	// narrowphase() already ran for this step and found the contacts, this part
+	// reports them and touches the bodies, so it always runs serially.
+
+	if (ignore)
+		return false;
+
+	Vector2 offset_A = A->get_transform().get_origin();
+	Matrix32 xform_Au = A->get_transform().untranslated();
+	Matrix32 xform_A = xform_Au * A->get_shape_transform(shape_A);
+
+	Matrix32 xform_Bu = B->get_transform();
+	xform_Bu.elements[2] -= A->get_transform().get_origin();
+	Matrix32 xform_B = xform_Bu * B->get_shape_transform(shape_B);
+
+	Shape2DSW *shape_A_ptr = A->get_shape(shape_A);
+	Shape2DSW *shape_B_ptr = B->get_shape(shape_B);
+
 	if (!collided) {
 
 		//test ccd (currently just a raycast)
@@ -528,6 +548,7 @@ BodyPair2DSW::BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_sh
 	B->add_constraint(this, 1);
 	contact_count = 0;
 	collided = false;
+	ignore = true;
 	oneway_disabled = false;
 }
 
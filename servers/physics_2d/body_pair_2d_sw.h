@@ -76,6 +76,7 @@ class BodyPair2DSW : public Constraint2DSW {
 	Contact contacts[MAX_CONTACTS];
 	int contact_count;
 	bool collided;
+	bool ignore;
 	bool oneway_disabled;
 	int cc;
 
@@ -85,6 +86,7 @@ class BodyPair2DSW : public Constraint2DSW {
 	_FORCE_INLINE_ void _contact_added_callback(const Vector2 &p_point_A, const Vector2 &p_point_B);
 
 public:
+	virtual void narrowphase(float p_step);
 	bool setup(float p_step);
 	void solve(float p_step);
 
@@ -96,211 +96,318 @@ void BroadPhase2DHashGrid::_check_motion(Element *p_elem) {
 	}
 }
 
-void BroadPhase2DHashGrid::_enter_grid(Element *p_elem, const Rect2 &p_rect, bool p_static) {
+BroadPhase2DHashGrid::GridLevel BroadPhase2DHashGrid::_get_level(const Rect2 &p_rect) const {
 
 	Vector2 sz = (p_rect.size / cell_size * LARGE_ELEMENT_FI); //use magic number to avoid floating point issues
-	if (sz.width * sz.height > large_object_min_surface) {
-		//large object, do not use grid, must check against all elements
-		for (Map<ID, Element>::Element *E = element_map.front(); E; E = E->next()) {
-			if (E->key() == p_elem->self)
-				continue; // do not pair against itself
-			if (E->get().owner == p_elem->owner)
-				continue;
-			if (E->get()._static && p_static)
-				continue;
+	if (sz.width * sz.height <= large_object_min_surface)
+		return LEVEL_SMALL;
 
-			_pair_attempt(p_elem, &E->get());
+	sz = (p_rect.size / large_cell_size * LARGE_ELEMENT_FI);
+	if (sz.width * sz.height <= large_object_min_surface)
+		return LEVEL_LARGE;
+
+	return LEVEL_HUGE;
+}
+
+void BroadPhase2DHashGrid::_get_cells(const Rect2 &p_rect, int p_cell_size, Point2i &r_from, Point2i &r_to) const {
+
+	r_from = (p_rect.pos / p_cell_size).floor();
+	r_to = ((p_rect.pos + p_rect.size) / p_cell_size).floor();
+}
+
+BroadPhase2DHashGrid::PosBin *BroadPhase2DHashGrid::_get_bin(PosBin **p_table, const PosKey &p_key, bool p_create) {
+
+	uint32_t idx = p_key.hash() % hash_table_size;
+	PosBin *pb = p_table[idx];
+
+	while (pb) {
+
+		if (pb->key == p_key) {
+			break;
 		}
 
-		large_elements[p_elem].inc();
-		return;
+		pb = pb->next;
 	}
 
-	Point2i from = (p_rect.pos / cell_size).floor();
-	Point2i to = ((p_rect.pos + p_rect.size) / cell_size).floor();
-
-	for (int i = from.x; i <= to.x; i++) {
+	if (!pb && p_create) {
+		//does not exist, create!
+		pb = memnew(PosBin);
+		pb->key = p_key;
+		pb->next = p_table[idx];
+		p_table[idx] = pb;
+	}
 
-		for (int j = from.y; j <= to.y; j++) {
+	return pb;
+}
 
-			PosKey pk;
-			pk.x = i;
-			pk.y = j;
+void BroadPhase2DHashGrid::_free_bin_if_empty(PosBin **p_table, PosBin *p_bin) {
 
-			uint32_t idx = pk.hash() % hash_table_size;
-			PosBin *pb = hash_table[idx];
+	if (!p_bin->object_set.empty() || !p_bin->static_object_set.empty() || !p_bin->footprint_set.empty())
+		return;
 
-			while (pb) {
+	uint32_t idx = p_bin->key.hash() % hash_table_size;
 
-				if (pb->key == pk) {
-					break;
-				}
+	if (p_table[idx] == p_bin) {
+		p_table[idx] = p_bin->next;
+	} else {
 
-				pb = pb->next;
-			}
+		PosBin *px = p_table[idx];
 
-			bool entered = false;
+		while (px) {
 
-			if (!pb) {
-				//does not exist, create!
-				pb = memnew(PosBin);
-				pb->key = pk;
-				pb->next = hash_table[idx];
-				hash_table[idx] = pb;
+			if (px->next == p_bin) {
+				px->next = p_bin->next;
+				break;
 			}
 
-			if (p_static) {
-				if (pb->static_object_set[p_elem].inc() == 1) {
-					entered = true;
-				}
-			} else {
-				if (pb->object_set[p_elem].inc() == 1) {
+			px = px->next;
+		}
 
-					entered = true;
-				}
-			}
+		ERR_FAIL_COND(!px);
+	}
 
-			if (entered) {
+	memdelete(p_bin);
+}
 
-				for (Map<Element *, RC>::Element *E = pb->object_set.front(); E; E = E->next()) {
+void BroadPhase2DHashGrid::_enter_cell(Element *p_elem, PosBin **p_table, const PosKey &p_key, bool p_static, bool p_footprint) {
 
-					if (E->key()->owner == p_elem->owner)
-						continue;
-					_pair_attempt(p_elem, E->key());
-				}
+	PosBin *pb = _get_bin(p_table, p_key, true);
 
-				if (!p_static) {
+	bool entered = false;
 
-					for (Map<Element *, RC>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
+	if (p_footprint) {
+		if (pb->footprint_set[p_elem].inc() == 1) {
+			entered = true;
+		}
+	} else if (p_static) {
+		if (pb->static_object_set[p_elem].inc() == 1) {
+			entered = true;
+		}
+	} else {
+		if (pb->object_set[p_elem].inc() == 1) {
 
-						if (E->key()->owner == p_elem->owner)
-							continue;
-						_pair_attempt(p_elem, E->key());
-					}
-				}
-			}
+			entered = true;
 		}
 	}
 
-	//pair separatedly with large elements
+	if (!entered)
+		return;
 
-	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
+	for (Map<Element *, RC>::Element *E = pb->object_set.front(); E; E = E->next()) {
 
-		if (E->key() == p_elem)
-			continue; // do not pair against itself
 		if (E->key()->owner == p_elem->owner)
 			continue;
-		if (E->key()->_static && p_static)
-			continue;
+		_pair_attempt(p_elem, E->key());
+	}
 
-		_pair_attempt(E->key(), p_elem);
+	if (!p_static) {
+
+		for (Map<Element *, RC>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
+
+			if (E->key()->owner == p_elem->owner)
+				continue;
+			_pair_attempt(p_elem, E->key());
+		}
+	}
+
+	if (!p_footprint) {
+
+		//smaller elements are only found through their footprint in the large grid
+		for (Map<Element *, RC>::Element *E = pb->footprint_set.front(); E; E = E->next()) {
+
+			if (E->key()->owner == p_elem->owner)
+				continue;
+			if (E->key()->_static && p_static)
+				continue;
+			_pair_attempt(p_elem, E->key());
+		}
 	}
 }
 
-void BroadPhase2DHashGrid::_exit_grid(Element *p_elem, const Rect2 &p_rect, bool p_static) {
+void BroadPhase2DHashGrid::_exit_cell(Element *p_elem, PosBin **p_table, const PosKey &p_key, bool p_static, bool p_footprint) {
 
-	Vector2 sz = (p_rect.size / cell_size * LARGE_ELEMENT_FI);
-	if (sz.width * sz.height > large_object_min_surface) {
+	PosBin *pb = _get_bin(p_table, p_key, false);
 
-		//unpair all elements, instead of checking all, just check what is already paired, so we at least save from checking static vs static
-		Map<Element *, PairData *>::Element *E = p_elem->paired.front();
-		while (E) {
-			Map<Element *, PairData *>::Element *next = E->next();
+	ERR_FAIL_COND(!pb); //should exist!!
+
+	bool exited = false;
+
+	if (p_footprint) {
+		if (pb->footprint_set[p_elem].dec() == 0) {
+
+			pb->footprint_set.erase(p_elem);
+			exited = true;
+		}
+	} else if (p_static) {
+		if (pb->static_object_set[p_elem].dec() == 0) {
+
+			pb->static_object_set.erase(p_elem);
+			exited = true;
+		}
+	} else {
+		if (pb->object_set[p_elem].dec() == 0) {
+
+			pb->object_set.erase(p_elem);
+			exited = true;
+		}
+	}
+
+	if (exited) {
+
+		for (Map<Element *, RC>::Element *E = pb->object_set.front(); E; E = E->next()) {
+
+			if (E->key()->owner == p_elem->owner)
+				continue;
 			_unpair_attempt(p_elem, E->key());
-			E = next;
 		}
 
-		if (large_elements[p_elem].dec() == 0) {
-			large_elements.erase(p_elem);
+		if (!p_static) {
+
+			for (Map<Element *, RC>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
+
+				if (E->key()->owner == p_elem->owner)
+					continue;
+				_unpair_attempt(p_elem, E->key());
+			}
+		}
+
+		if (!p_footprint) {
+
+			for (Map<Element *, RC>::Element *E = pb->footprint_set.front(); E; E = E->next()) {
+
+				if (E->key()->owner == p_elem->owner)
+					continue;
+				if (E->key()->_static && p_static)
+					continue;
+				_unpair_attempt(p_elem, E->key());
+			}
 		}
-		return;
 	}
 
-	Point2i from = (p_rect.pos / cell_size).floor();
-	Point2i to = ((p_rect.pos + p_rect.size) / cell_size).floor();
+	_free_bin_if_empty(p_table, pb);
+}
 
-	for (int i = from.x; i <= to.x; i++) {
+void BroadPhase2DHashGrid::_enter_cells(Element *p_elem, PosBin **p_table, const Point2i &p_from, const Point2i &p_to, const Point2i &p_skip_from, const Point2i &p_skip_to, bool p_static, bool p_footprint) {
 
-		for (int j = from.y; j <= to.y; j++) {
+	for (int i = p_from.x; i <= p_to.x; i++) {
+
+		for (int j = p_from.y; j <= p_to.y; j++) {
+
+			if (i >= p_skip_from.x && i <= p_skip_to.x && j >= p_skip_from.y && j <= p_skip_to.y)
+				continue; //already inside
 
 			PosKey pk;
 			pk.x = i;
 			pk.y = j;
 
-			uint32_t idx = pk.hash() % hash_table_size;
-			PosBin *pb = hash_table[idx];
+			_enter_cell(p_elem, p_table, pk, p_static, p_footprint);
+		}
+	}
+}
 
-			while (pb) {
+void BroadPhase2DHashGrid::_exit_cells(Element *p_elem, PosBin **p_table, const Point2i &p_from, const Point2i &p_to, const Point2i &p_skip_from, const Point2i &p_skip_to, bool p_static, bool p_footprint) {
 
-				if (pb->key == pk) {
-					break;
-				}
+	for (int i = p_from.x; i <= p_to.x; i++) {
 
-				pb = pb->next;
-			}
+		for (int j = p_from.y; j <= p_to.y; j++) {
+
+			if (i >= p_skip_from.x && i <= p_skip_to.x && j >= p_skip_from.y && j <= p_skip_to.y)
+				continue; //still inside
+
+			PosKey pk;
+			pk.x = i;
+			pk.y = j;
 
-			ERR_CONTINUE(!pb); //should exist!!
+			_exit_cell(p_elem, p_table, pk, p_static, p_footprint);
+		}
+	}
+}
 
-			bool exited = false;
+void BroadPhase2DHashGrid::_enter_grid(Element *p_elem, const Rect2 &p_rect, bool p_static) {
 
-			if (p_static) {
-				if (pb->static_object_set[p_elem].dec() == 0) {
+	GridLevel level = _get_level(p_rect);
 
-					pb->static_object_set.erase(p_elem);
-					exited = true;
-				}
-			} else {
-				if (pb->object_set[p_elem].dec() == 0) {
+	if (level == LEVEL_HUGE) {
+		//huge object, do not use grid, must check against all elements
+		for (Map<ID, Element>::Element *E = element_map.front(); E; E = E->next()) {
+			if (E->key() == p_elem->self)
+				continue; // do not pair against itself
+			if (E->get().owner == p_elem->owner)
+				continue;
+			if (E->get()._static && p_static)
+				continue;
 
-					pb->object_set.erase(p_elem);
-					exited = true;
-				}
-			}
+			_pair_attempt(p_elem, &E->get());
+		}
 
-			if (exited) {
+		large_elements[p_elem].inc();
+		return;
+	}
 
-				for (Map<Element *, RC>::Element *E = pb->object_set.front(); E; E = E->next()) {
+	Point2i from, to;
+	Point2i no_skip(1, 1), no_skip_to(0, 0);
 
-					if (E->key()->owner == p_elem->owner)
-						continue;
-					_unpair_attempt(p_elem, E->key());
-				}
+	if (level == LEVEL_SMALL) {
 
-				if (!p_static) {
+		_get_cells(p_rect, cell_size, from, to);
+		_enter_cells(p_elem, hash_table, from, to, no_skip, no_skip_to, p_static, false);
+		//leave a footprint in the large grid, so large elements can find this one
+		_get_cells(p_rect, large_cell_size, from, to);
+		_enter_cells(p_elem, large_hash_table, from, to, no_skip, no_skip_to, p_static, true);
+	} else {
 
-					for (Map<Element *, RC>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
+		_get_cells(p_rect, large_cell_size, from, to);
+		_enter_cells(p_elem, large_hash_table, from, to, no_skip, no_skip_to, p_static, false);
+	}
 
-						if (E->key()->owner == p_elem->owner)
-							continue;
-						_unpair_attempt(p_elem, E->key());
-					}
-				}
-			}
+	//pair separatedly with huge elements
 
-			if (pb->object_set.empty() && pb->static_object_set.empty()) {
+	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
 
-				if (hash_table[idx] == pb) {
-					hash_table[idx] = pb->next;
-				} else {
+		if (E->key() == p_elem)
+			continue; // do not pair against itself
+		if (E->key()->owner == p_elem->owner)
+			continue;
+		if (E->key()->_static && p_static)
+			continue;
 
-					PosBin *px = hash_table[idx];
+		_pair_attempt(E->key(), p_elem);
+	}
+}
 
-					while (px) {
+void BroadPhase2DHashGrid::_exit_grid(Element *p_elem, const Rect2 &p_rect, bool p_static) {
 
-						if (px->next == pb) {
-							px->next = pb->next;
-							break;
-						}
+	GridLevel level = _get_level(p_rect);
 
-						px = px->next;
-					}
+	if (level == LEVEL_HUGE) {
 
-					ERR_CONTINUE(!px);
-				}
+		//unpair all elements, instead of checking all, just check what is already paired, so we at least save from checking static vs static
+		Map<Element *, PairData *>::Element *E = p_elem->paired.front();
+		while (E) {
+			Map<Element *, PairData *>::Element *next = E->next();
+			_unpair_attempt(p_elem, E->key());
+			E = next;
+		}
 
-				memdelete(pb);
-			}
+		if (large_elements[p_elem].dec() == 0) {
+			large_elements.erase(p_elem);
 		}
+		return;
+	}
+
+	Point2i from, to;
+	Point2i no_skip(1, 1), no_skip_to(0, 0);
+
+	if (level == LEVEL_SMALL) {
+
+		_get_cells(p_rect, cell_size, from, to);
+		_exit_cells(p_elem, hash_table, from, to, no_skip, no_skip_to, p_static, false);
+		_get_cells(p_rect, large_cell_size, from, to);
+		_exit_cells(p_elem, large_hash_table, from, to, no_skip, no_skip_to, p_static, true);
+	} else {
+
+		_get_cells(p_rect, large_cell_size, from, to);
+		_exit_cells(p_elem, large_hash_table, from, to, no_skip, no_skip_to, p_static, false);
 	}
 
 	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
@@ -311,11 +418,46 @@ void BroadPhase2DHashGrid::_exit_grid(Element *p_elem, const Rect2 &p_rect, bool
 		if (E->key()->_static && p_static)
 			continue;
 
-		//unpair from large elements
+		//unpair from huge elements
 		_unpair_attempt(p_elem, E->key());
 	}
 }
 
+void BroadPhase2DHashGrid::_move_grid(Element *p_elem, const Rect2 &p_from, const Rect2 &p_to) {
+
+	//same level on both rects, so only the cells that were entered or left need to be touched.
+	//pairing with huge elements does not change either.
+	//cells are entered before leaving the old ones, so pairs that remain never drop to zero.
+
+	bool small = _get_level(p_to) == LEVEL_SMALL;
+	PosBin **table = small ? hash_table : large_hash_table;
+	int size = small ? cell_size : large_cell_size;
+
+	Point2i old_from, old_to, new_from, new_to;
+	_get_cells(p_from, size, old_from, old_to);
+	_get_cells(p_to, size, new_from, new_to);
+	bool cells_changed = old_from != new_from || old_to != new_to;
+
+	Point2i old_fp_from, old_fp_to, new_fp_from, new_fp_to;
+	bool footprint_changed = false;
+
+	if (small) {
+		_get_cells(p_from, large_cell_size, old_fp_from, old_fp_to);
+		_get_cells(p_to, large_cell_size, new_fp_from, new_fp_to);
+		footprint_changed = old_fp_from != new_fp_from || old_fp_to != new_fp_to;
+	}
+
+	if (cells_changed)
+		_enter_cells(p_elem, table, new_from, new_to, old_from, old_to, p_elem->_static, false);
+	if (footprint_changed)
+		_enter_cells(p_elem, large_hash_table, new_fp_from, new_fp_to, old_fp_from, old_fp_to, p_elem->_static, true);
+
+	if (cells_changed)
+		_exit_cells(p_elem, table, old_from, old_to, new_from, new_to, p_elem->_static, false);
+	if (footprint_changed)
+		_exit_cells(p_elem, large_hash_table, old_fp_from, old_fp_to, new_fp_from, new_fp_to, p_elem->_static, true);
+}
+
 BroadPhase2DHashGrid::ID BroadPhase2DHashGrid::create(CollisionObject2DSW *p_object, int p_subindex) {
 
 	current++;
@@ -341,21 +483,25 @@ void BroadPhase2DHashGrid::move(ID p_id, const Rect2 &p_aabb) {
 	if (p_aabb == e.aabb)
 		return;
 
-	if (p_aabb != Rect2()) {
+	if (p_aabb != Rect2() && e.aabb != Rect2() && _get_level(p_aabb) != LEVEL_HUGE && _get_level(p_aabb) == _get_level(e.aabb)) {
 
-		_enter_grid(&e, p_aabb, e._static);
-	}
+		_move_grid(&e, e.aabb, p_aabb);
+	} else {
 
-	if (e.aabb != Rect2()) {
+		if (p_aabb != Rect2()) {
 
-		_exit_grid(&e, e.aabb, e._static);
+			_enter_grid(&e, p_aabb, e._static);
+		}
+
+		if (e.aabb != Rect2()) {
+
+			_exit_grid(&e, e.aabb, e._static);
+		}
 	}
 
 	e.aabb = p_aabb;
 
 	_check_motion(&e);
-
-	e.aabb = p_aabb;
 }
 void BroadPhase2DHashGrid::set_static(ID p_id, bool p_static) {
 
@@ -410,23 +556,13 @@ int BroadPhase2DHashGrid::get_subindex(ID p_id) const {
 }
 
 template <bool use_aabb, bool use_segment>
-void BroadPhase2DHashGrid::_cull(const Point2i p_cell, const Rect2 &p_aabb, const Point2 &p_from, const Point2 &p_to, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices, int &index) {
+void BroadPhase2DHashGrid::_cull(PosBin **p_table, const Point2i p_cell, const Rect2 &p_aabb, const Point2 &p_from, const Point2 &p_to, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices, int &index) {
 
 	PosKey pk;
 	pk.x = p_cell.x;
 	pk.y = p_cell.y;
 
-	uint32_t idx = pk.hash() % hash_table_size;
-	PosBin *pb = hash_table[idx];
-
-	while (pb) {
-
-		if (pb->key == pk) {
-			break;
-		}
-
-		pb = pb->next;
-	}
+	PosBin *pb = _get_bin(p_table, pk, false);
 
 	if (!pb)
 		return;
@@ -472,13 +608,9 @@ void BroadPhase2DHashGrid::_cull(const Point2i p_cell, const Rect2 &p_aabb, cons
 	}
 }
 
-int BroadPhase2DHashGrid::cull_segment(const Vector2 &p_from, const Vector2 &p_to, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices) {
-
-	pass++;
+void BroadPhase2DHashGrid::_cull_segment_cells(PosBin **p_table, int p_cell_size, const Vector2 &p_from, const Vector2 &p_to, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices, int &index) {
 
 	Vector2 dir = (p_to - p_from);
-	if (dir == Vector2())
-		return 0;
 	//avoid divisions by zero
 	dir.normalize();
 	if (dir.x == 0.0)
@@ -487,28 +619,27 @@ int BroadPhase2DHashGrid::cull_segment(const Vector2 &p_from, const Vector2 &p_t
 		dir.y = 0.000001;
 	Vector2 delta = dir.abs();
 
-	delta.x = cell_size / delta.x;
-	delta.y = cell_size / delta.y;
+	delta.x = p_cell_size / delta.x;
+	delta.y = p_cell_size / delta.y;
 
-	Point2i pos = (p_from / cell_size).floor();
-	Point2i end = (p_to / cell_size).floor();
+	Point2i pos = (p_from / p_cell_size).floor();
+	Point2i end = (p_to / p_cell_size).floor();
 
 	Point2i step = Vector2(SGN(dir.x), SGN(dir.y));
 
 	Vector2 max;
 
 	if (dir.x < 0)
-		max.x = (Math::floor(pos.x) * cell_size - p_from.x) / dir.x;
+		max.x = (Math::floor(pos.x) * p_cell_size - p_from.x) / dir.x;
 	else
-		max.x = (Math::floor(pos.x + 1) * cell_size - p_from.x) / dir.x;
+		max.x = (Math::floor(pos.x + 1) * p_cell_size - p_from.x) / dir.x;
 
 	if (dir.y < 0)
-		max.y = (Math::floor(pos.y) * cell_size - p_from.y) / dir.y;
+		max.y = (Math::floor(pos.y) * p_cell_size - p_from.y) / dir.y;
 	else
-		max.y = (Math::floor(pos.y + 1) * cell_size - p_from.y) / dir.y;
+		max.y = (Math::floor(pos.y + 1) * p_cell_size - p_from.y) / dir.y;
 
-	int cullcount = 0;
-	_cull<false, true>(pos, Rect2(), p_from, p_to, p_results, p_max_results, p_result_indices, cullcount);
+	_cull<false, true>(p_table, pos, Rect2(), p_from, p_to, p_results, p_max_results, p_result_indices, index);
 
 	bool reached_x = false;
 	bool reached_y = false;
@@ -541,11 +672,23 @@ int BroadPhase2DHashGrid::cull_segment(const Vector2 &p_from, const Vector2 &p_t
 			reached_y = true;
 		}
 
-		_cull<false, true>(pos, Rect2(), p_from, p_to, p_results, p_max_results, p_result_indices, cullcount);
+		_cull<false, true>(p_table, pos, Rect2(), p_from, p_to, p_results, p_max_results, p_result_indices, index);
 
 		if (reached_x && reached_y)
 			break;
 	}
+}
+
+int BroadPhase2DHashGrid::cull_segment(const Vector2 &p_from, const Vector2 &p_to, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices) {
+
+	pass++;
+
+	if (p_to == p_from)
+		return 0;
+
+	int cullcount = 0;
+	_cull_segment_cells(hash_table, cell_size, p_from, p_to, p_results, p_max_results, p_result_indices, cullcount);
+	_cull_segment_cells(large_hash_table, large_cell_size, p_from, p_to, p_results, p_max_results, p_result_indices, cullcount);
 
 	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
 
@@ -574,15 +717,26 @@ int BroadPhase2DHashGrid::cull_aabb(const Rect2 &p_aabb, CollisionObject2DSW **p
 
 	pass++;
 
-	Point2i from = (p_aabb.pos / cell_size).floor();
-	Point2i to = ((p_aabb.pos + p_aabb.size) / cell_size).floor();
+	Point2i from, to;
 	int cullcount = 0;
 
+	_get_cells(p_aabb, cell_size, from, to);
+
 	for (int i = from.x; i <= to.x; i++) {
 
 		for (int j = from.y; j <= to.y; j++) {
 
-			_cull<true, false>(Point2i(i, j), p_aabb, Point2(), Point2(), p_results, p_max_results, p_result_indices, cullcount);
+			_cull<true, false>(hash_table, Point2i(i, j), p_aabb, Point2(), Point2(), p_results, p_max_results, p_result_indices, cullcount);
+		}
+	}
+
+	_get_cells(p_aabb, large_cell_size, from, to);
+
+	for (int i = from.x; i <= to.x; i++) {
+
+		for (int j = from.y; j <= to.y; j++) {
+
+			_cull<true, false>(large_hash_table, Point2i(i, j), p_aabb, Point2(), Point2(), p_results, p_max_results, p_result_indices, cullcount);
 		}
 	}
 
@@ -632,12 +786,16 @@ BroadPhase2DHashGrid::BroadPhase2DHashGrid() {
 	hash_table_size = GLOBAL_DEF("physics_2d/bp_hash_table_size", 4096);
 	hash_table_size = Math::larger_prime(hash_table_size);
 	hash_table = memnew_arr(PosBin *, hash_table_size);
+	large_hash_table = memnew_arr(PosBin *, hash_table_size);
 
 	cell_size = GLOBAL_DEF("physics_2d/cell_size", 128);
 	large_object_min_surface = GLOBAL_DEF("physics_2d/large_object_surface_treshold_in_cells", 512);
+	large_cell_size = cell_size * LARGE_CELL_SCALE;
 
-	for (int i = 0; i < hash_table_size; i++)
+	for (uint32_t i = 0; i < hash_table_size; i++) {
 		hash_table[i] = NULL;
+		large_hash_table[i] = NULL;
+	}
 	pass = 1;
 
 	current = 0;
@@ -645,15 +803,21 @@ BroadPhase2DHashGrid::BroadPhase2DHashGrid() {
 
 BroadPhase2DHashGrid::~BroadPhase2DHashGrid() {
 
-	for (int i = 0; i < hash_table_size; i++) {
+	for (uint32_t i = 0; i < hash_table_size; i++) {
 		while (hash_table[i]) {
 			PosBin *pb = hash_table[i];
 			hash_table[i] = pb->next;
 			memdelete(pb);
 		}
+		while (large_hash_table[i]) {
+			PosBin *pb = large_hash_table[i];
+			large_hash_table[i] = pb->next;
+			memdelete(pb);
+		}
 	}
 
 	memdelete_arr(hash_table);
+	memdelete_arr(large_hash_table);
 }
 
 /* 3D version of voxel traversal:
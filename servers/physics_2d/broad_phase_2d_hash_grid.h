@@ -33,6 +33,14 @@
 #include "broad_phase_2d_sw.h"
 #include "map.h"
 
+/**
+ * Two level hash grid. Most elements go to the regular grid, elements that
+ * would cover too many of its cells go to a coarser grid, and only those too
+ * big even for that one are paired against everything. Small elements leave a
+ * footprint in the coarse grid so the large elements overlapping them can be
+ * found. Moving an element only touches the cells it entered or left.
+ */
+
 class BroadPhase2DHashGrid : public BroadPhase2DSW {
 
 	struct PairData {
@@ -111,7 +119,18 @@ class BroadPhase2DHashGrid : public BroadPhase2DSW {
 
 	Map<PairKey, PairData> pair_map;
 
+	enum {
+		LARGE_CELL_SCALE = 8
+	};
+
+	enum GridLevel {
+		LEVEL_SMALL,
+		LEVEL_LARGE,
+		LEVEL_HUGE
+	};
+
 	int cell_size;
+	int large_cell_size;
 	int large_object_min_surface;
 
 	PairCallback pair_callback;
@@ -119,11 +138,6 @@ class BroadPhase2DHashGrid : public BroadPhase2DSW {
 	UnpairCallback unpair_callback;
 	void *unpair_userdata;
 
-	void _enter_grid(Element *p_elem, const Rect2 &p_rect, bool p_static);
-	void _exit_grid(Element *p_elem, const Rect2 &p_rect, bool p_static);
-	template <bool use_aabb, bool use_segment>
-	_FORCE_INLINE_ void _cull(const Point2i p_cell, const Rect2 &p_aabb, const Point2 &p_from, const Point2 &p_to, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices, int &index);
-
 	struct PosKey {
 
 		union {
@@ -156,11 +170,31 @@ class BroadPhase2DHashGrid : public BroadPhase2DSW {
 		PosKey key;
 		Map<Element *, RC> object_set;
 		Map<Element *, RC> static_object_set;
+		Map<Element *, RC> footprint_set; // smaller elements, only used in the large grid
 		PosBin *next;
 	};
 
 	uint32_t hash_table_size;
 	PosBin **hash_table;
+	PosBin **large_hash_table;
+
+	GridLevel _get_level(const Rect2 &p_rect) const;
+	_FORCE_INLINE_ void _get_cells(const Rect2 &p_rect, int p_cell_size, Point2i &r_from, Point2i &r_to) const;
+	PosBin *_get_bin(PosBin **p_table, const PosKey &p_key, bool p_create);
+	void _free_bin_if_empty(PosBin **p_table, PosBin *p_bin);
+
+	void _enter_cell(Element *p_elem, PosBin **p_table, const PosKey &p_key, bool p_static, bool p_footprint);
+	void _exit_cell(Element *p_elem, PosBin **p_table, const PosKey &p_key, bool p_static, bool p_footprint);
+	void _enter_cells(Element *p_elem, PosBin **p_table, const Point2i &p_from, const Point2i &p_to, const Point2i &p_skip_from, const Point2i &p_skip_to, bool p_static, bool p_footprint);
+	void _exit_cells(Element *p_elem, PosBin **p_table, const Point2i &p_from, const Point2i &p_to, const Point2i &p_skip_from, const Point2i &p_skip_to, bool p_static, bool p_footprint);
+
+	void _enter_grid(Element *p_elem, const Rect2 &p_rect, bool p_static);
+	void _exit_grid(Element *p_elem, const Rect2 &p_rect, bool p_static);
+	void _move_grid(Element *p_elem, const Rect2 &p_from, const Rect2 &p_to);
+
+	template <bool use_aabb, bool use_segment>
+	_FORCE_INLINE_ void _cull(PosBin **p_table, const Point2i p_cell, const Rect2 &p_aabb, const Point2 &p_from, const Point2 &p_to, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices, int &index);
+	void _cull_segment_cells(PosBin **p_table, int p_cell_size, const Vector2 &p_from, const Vector2 &p_to, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices, int &index);
 
 	void _pair_attempt(Element *p_elem, Element *p_with);
 	void _unpair_attempt(Element *p_elem, Element *p_with);
@@ -65,6 +65,8 @@ public:
 	_FORCE_INLINE_ Body2DSW **get_body_ptr() const { return _body_ptr; }
 	_FORCE_INLINE_ int get_body_count() const { return _body_count; }
 
+	// collision detection part of the setup, it may run on any thread so it must only write to the constraint itself
+	virtual void narrowphase(float p_step) {}
 	virtual bool setup(float p_step) = 0;
 	virtual void solve(float p_step) = 0;
 
@@ -1176,6 +1176,12 @@ void Physics2DServerSW::init() {
 	last_step = 0.001;
 	iterations = 8; // 8?
 	stepper = memnew(Step2DSW);
+
+	// 1 keeps collision detection on the physics thread, 0 uses one thread per processor
+	int narrowphase_threads = GLOBAL_DEF("physics_2d/narrowphase_thread_count", 1);
+	Globals::get_singleton()->set_custom_property_info("physics_2d/narrowphase_thread_count", PropertyInfo(Variant::INT, "physics_2d/narrowphase_thread_count", PROPERTY_HINT_RANGE, "0,64,1"));
+	stepper->set_thread_count(narrowphase_threads);
+
 	direct_state = memnew(Physics2DDirectBodyStateSW);
 };
 
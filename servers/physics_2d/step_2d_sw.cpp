@@ -28,6 +28,7 @@
 /* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
 /*************************************************************************/
 #include "step_2d_sw.h"
+#include "frame_allocator.h"
 #include "os/os.h"
 
 void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island) {
@@ -56,6 +57,50 @@ void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constrain
 	}
 }
 
+void Step2DSW::_narrowphase_work(uint32_t p_index, NarrowphaseData *p_data) {
+
+	p_data->constraints[p_index]->narrowphase(p_data->delta);
+}
+
+void Step2DSW::_narrowphase(Constraint2DSW *p_constraint_island_list, float p_delta) {
+
+	if (!work_pool.is_threaded()) {
+
+		for (Constraint2DSW *island = p_constraint_island_list; island; island = island->get_island_list_next()) {
+			for (Constraint2DSW *ci = island; ci; ci = ci->get_island_next()) {
+				ci->narrowphase(p_delta);
+			}
+		}
+		return;
+	}
+
+	// flatten the islands, in the same order they are set up later
+
+	int count = 0;
+	for (Constraint2DSW *island = p_constraint_island_list; island; island = island->get_island_list_next()) {
+		for (Constraint2DSW *ci = island; ci; ci = ci->get_island_next()) {
+			count++;
+		}
+	}
+
+	FrameAllocator::Scope frame_scope;
+	Constraint2DSW **constraintw = frame_scope.alloc_array<Constraint2DSW *>(count);
+
+	int idx = 0;
+	for (Constraint2DSW *island = p_constraint_island_list; island; island = island->get_island_list_next()) {
+		for (Constraint2DSW *ci = island; ci; ci = ci->get_island_next()) {
+			constraintw[idx++] = ci;
+		}
+	}
+
+	// each constraint only writes to itself here, so the outcome does not depend on which thread ran it
+	NarrowphaseData data;
+	data.constraints = constraintw;
+	data.delta = p_delta;
+
+	work_pool.do_work(count, this, &Step2DSW::_narrowphase_work, &data);
+}
+
 bool Step2DSW::_setup_island(Constraint2DSW *p_island, float p_delta) {
 
 	Constraint2DSW *ci = p_island;
@@ -218,6 +263,8 @@ void Step2DSW::step(Space2DSW *p_space, float p_delta, int p_iterations) {
 
 	/* SETUP CONSTRAINT ISLANDS */
 
+	_narrowphase(constraint_island_list, p_delta);
+
 	{
 		Constraint2DSW *ci = constraint_island_list;
 		Constraint2DSW *prev_ci = NULL;
@@ -311,7 +358,23 @@ void Step2DSW::step(Space2DSW *p_space, float p_delta, int p_iterations) {
 	_step++;
 }
 
+void Step2DSW::set_thread_count(int p_threads) {
+
+	work_pool.finish();
+	work_pool.init(p_threads);
+}
+
+int Step2DSW::get_thread_count() const {
+
+	return work_pool.get_thread_count();
+}
+
 Step2DSW::Step2DSW() {
 
 	_step = 1;
 }
+
+Step2DSW::~Step2DSW() {
+
+	work_pool.finish();
+}
@@ -30,20 +30,35 @@
 #ifndef STEP_2D_SW_H
 #define STEP_2D_SW_H
 
+#include "os/thread_work_pool.h"
 #include "space_2d_sw.h"
 
 class Step2DSW {
 
 	uint64_t _step;
 
+	struct NarrowphaseData {
+
+		Constraint2DSW **constraints;
+		float delta;
+	};
+
+	ThreadWorkPool work_pool;
+
 	void _populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island);
+	void _narrowphase(Constraint2DSW *p_constraint_island_list, float p_delta);
+	void _narrowphase_work(uint32_t p_index, NarrowphaseData *p_data);
 	bool _setup_island(Constraint2DSW *p_island, float p_delta);
 	void _solve_island(Constraint2DSW *p_island, int p_iterations, float p_delta);
 	void _check_suspend(Body2DSW *p_island, float p_delta);
 
 public:
+	void set_thread_count(int p_threads);
+	int get_thread_count() const;
+
 	void step(Space2DSW *p_space, float p_delta, int p_iterations);
 	Step2DSW();
+	~Step2DSW();
 };
 
 #endif // STEP_2D_SW_H
@@ -0,0 +1,235 @@
+/*************************************************************************/
+/*  rasterizer_canvas_batch.cpp                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "rasterizer_canvas_batch.h"
+
+void RasterizerCanvasBatch::get_textured_quad_uvs(const Rect2 &p_src_region, const Size2 &p_tex_size, bool p_h_flip, bool p_v_flip, bool p_transpose, Vector2 *r_uvs) {
+
+	r_uvs[0] = Vector2(p_src_region.pos.x / p_tex_size.width,
+			p_src_region.pos.y / p_tex_size.height);
+
+	r_uvs[1] = Vector2((p_src_region.pos.x + p_src_region.size.width) / p_tex_size.width,
+			p_src_region.pos.y / p_tex_size.height);
+
+	r_uvs[2] = Vector2((p_src_region.pos.x + p_src_region.size.width) / p_tex_size.width,
+			(p_src_region.pos.y + p_src_region.size.height) / p_tex_size.height);
+
+	r_uvs[3] = Vector2(p_src_region.pos.x / p_tex_size.width,
+			(p_src_region.pos.y + p_src_region.size.height) / p_tex_size.height);
+
+	if (p_transpose) {
+		SWAP(r_uvs[1], r_uvs[3]);
+	}
+	if (p_h_flip) {
+		SWAP(r_uvs[0], r_uvs[1]);
+		SWAP(r_uvs[2], r_uvs[3]);
+	}
+	if (p_v_flip) {
+		SWAP(r_uvs[1], r_uvs[2]);
+		SWAP(r_uvs[0], r_uvs[3]);
+	}
+}
+
+int RasterizerCanvasBatch::get_style_box_quads(const Rect2 &p_rect, const Rect2 &p_region, const float *p_margin, bool p_draw_center, Rect2 *r_rects, Rect2 *r_sources) {
+
+	/* CORNERS */
+
+	// top left
+	r_rects[0] = Rect2(p_rect.pos, Size2(p_margin[MARGIN_LEFT], p_margin[MARGIN_TOP]));
+	r_sources[0] = Rect2(p_region.pos, Size2(p_margin[MARGIN_LEFT], p_margin[MARGIN_TOP]));
+
+	// top right
+	r_rects[1] = Rect2(Point2(p_rect.pos.x + p_rect.size.width - p_margin[MARGIN_RIGHT], p_rect.pos.y), Size2(p_margin[MARGIN_RIGHT], p_margin[MARGIN_TOP]));
+	r_sources[1] = Rect2(Point2(p_region.pos.x + p_region.size.width - p_margin[MARGIN_RIGHT], p_region.pos.y), Size2(p_margin[MARGIN_RIGHT], p_margin[MARGIN_TOP]));
+
+	// bottom left
+	r_rects[2] = Rect2(Point2(p_rect.pos.x, p_rect.pos.y + p_rect.size.height - p_margin[MARGIN_BOTTOM]), Size2(p_margin[MARGIN_LEFT], p_margin[MARGIN_BOTTOM]));
+	r_sources[2] = Rect2(Point2(p_region.pos.x, p_region.pos.y + p_region.size.height - p_margin[MARGIN_BOTTOM]), Size2(p_margin[MARGIN_LEFT], p_margin[MARGIN_BOTTOM]));
+
+	// bottom right
+	r_rects[3] = Rect2(Point2(p_rect.pos.x + p_rect.size.width - p_margin[MARGIN_RIGHT], p_rect.pos.y + p_rect.size.height - p_margin[MARGIN_BOTTOM]), Size2(p_margin[MARGIN_RIGHT], p_margin[MARGIN_BOTTOM]));
+	r_sources[3] = Rect2(Point2(p_region.pos.x + p_region.size.width - p_margin[MARGIN_RIGHT], p_region.pos.y + p_region.size.height - p_margin[MARGIN_BOTTOM]), Size2(p_margin[MARGIN_RIGHT], p_margin[MARGIN_BOTTOM]));
+
+	Rect2 rect_center(p_rect.pos + Point2(p_margin[MARGIN_LEFT], p_margin[MARGIN_TOP]), Size2(p_rect.size.width - p_margin[MARGIN_LEFT] - p_margin[MARGIN_RIGHT], p_rect.size.height - p_margin[MARGIN_TOP] - p_margin[MARGIN_BOTTOM]));
+
+	Rect2 src_center(Point2(p_region.pos.x + p_margin[MARGIN_LEFT], p_region.pos.y + p_margin[MARGIN_TOP]), Size2(p_region.size.width - p_margin[MARGIN_LEFT] - p_margin[MARGIN_RIGHT], p_region.size.height - p_margin[MARGIN_TOP] - p_margin[MARGIN_BOTTOM]));
+
+	// top
+	r_rects[4] = Rect2(Point2(rect_center.pos.x, p_rect.pos.y), Size2(rect_center.size.width, p_margin[MARGIN_TOP]));
+	r_sources[4] = Rect2(Point2(src_center.pos.x, p_region.pos.y), Size2(src_center.size.width, p_margin[MARGIN_TOP]));
+
+	// bottom
+	r_rects[5] = Rect2(Point2(rect_center.pos.x, rect_center.pos.y + rect_center.size.height), Size2(rect_center.size.width, p_margin[MARGIN_BOTTOM]));
+	r_sources[5] = Rect2(Point2(src_center.pos.x, src_center.pos.y + src_center.size.height), Size2(src_center.size.width, p_margin[MARGIN_BOTTOM]));
+
+	// left
+	r_rects[6] = Rect2(Point2(p_rect.pos.x, rect_center.pos.y), Size2(p_margin[MARGIN_LEFT], rect_center.size.height));
+	r_sources[6] = Rect2(Point2(p_region.pos.x, p_region.pos.y + p_margin[MARGIN_TOP]), Size2(p_margin[MARGIN_LEFT], src_center.size.height));
+
+	// right
+	r_rects[7] = Rect2(Point2(rect_center.pos.x + rect_center.size.width, rect_center.pos.y), Size2(p_margin[MARGIN_RIGHT], rect_center.size.height));
+	r_sources[7] = Rect2(Point2(src_center.pos.x + src_center.size.width, p_region.pos.y + p_margin[MARGIN_TOP]), Size2(p_margin[MARGIN_RIGHT], src_center.size.height));
+
+	if (!p_draw_center)
+		return 8;
+
+	r_rects[8] = rect_center;
+	r_sources[8] = src_center;
+
+	return 9;
+}
+
+void RasterizerCanvasBatch::set_transform(const Matrix32 &p_xform) {
+
+	xform = p_xform;
+	use_xform = true;
+}
+
+void RasterizerCanvasBatch::clear_transform() {
+
+	xform = Matrix32();
+	use_xform = false;
+}
+
+void RasterizerCanvasBatch::_add_quad(const Rect2 &p_rect, const Vector2 *p_uvs, const Color &p_color) {
+
+	Vector2 coords[4] = {
+		Vector2(p_rect.pos.x, p_rect.pos.y),
+		Vector2(p_rect.pos.x + p_rect.size.width, p_rect.pos.y),
+		Vector2(p_rect.pos.x + p_rect.size.width, p_rect.pos.y + p_rect.size.height),
+		Vector2(p_rect.pos.x, p_rect.pos.y + p_rect.size.height)
+	};
+
+	Vertex *v = &vertices[vertex_count];
+	for (int i = 0; i < 4; i++) {
+
+		v[i].vertex = use_xform ? xform.xform(coords[i]) : coords[i];
+		v[i].uv = p_uvs ? p_uvs[i] : Vector2();
+		v[i].color = p_color;
+	}
+
+	// same triangles as the fan the unbatched quads are drawn with
+	uint16_t *idx = &indices[index_count];
+	idx[0] = vertex_count;
+	idx[1] = vertex_count + 1;
+	idx[2] = vertex_count + 2;
+	idx[3] = vertex_count;
+	idx[4] = vertex_count + 2;
+	idx[5] = vertex_count + 3;
+
+	vertex_count += 4;
+	index_count += 6;
+}
+
+void RasterizerCanvasBatch::add_rect(const RID &p_texture, const Size2 &p_tex_size, const Rect2 &p_rect, int p_flags, const Rect2 &p_source, const Color &p_color) {
+
+	ERR_FAIL_COND(!can_add(p_texture, QUAD_VERTICES, QUAD_INDICES));
+	texture = p_texture;
+
+	if (!p_texture.is_valid()) {
+
+		_add_quad(p_rect, NULL, p_color);
+		return;
+	}
+
+	Rect2 region = (p_flags & Rasterizer::CANVAS_RECT_REGION) ? p_source : Rect2(Point2(), p_tex_size);
+
+	Vector2 uvs[4];
+	get_textured_quad_uvs(region, p_tex_size, p_flags & Rasterizer::CANVAS_RECT_FLIP_H, p_flags & Rasterizer::CANVAS_RECT_FLIP_V, p_flags & Rasterizer::CANVAS_RECT_TRANSPOSE, uvs);
+	_add_quad(p_rect, uvs, p_color);
+}
+
+void RasterizerCanvasBatch::add_style_box(const RID &p_texture, const Size2 &p_tex_size, const Rect2 &p_rect, const Rect2 &p_source, const float *p_margin, bool p_draw_center, const Color &p_color) {
+
+	ERR_FAIL_COND(!can_add(p_texture, STYLE_BOX_VERTICES, STYLE_BOX_INDICES));
+	texture = p_texture;
+
+	Rect2 region = p_source;
+	if (region.size.width <= 0)
+		region.size.width = p_tex_size.width;
+	if (region.size.height <= 0)
+		region.size.height = p_tex_size.height;
+
+	Rect2 rects[9];
+	Rect2 sources[9];
+	int count = get_style_box_quads(p_rect, region, p_margin, p_draw_center, rects, sources);
+
+	for (int i = 0; i < count; i++) {
+
+		Vector2 uvs[4];
+		get_textured_quad_uvs(sources[i], p_tex_size, false, false, false, uvs);
+		_add_quad(rects[i], uvs, p_color);
+	}
+}
+
+void RasterizerCanvasBatch::add_polygon(const RID &p_texture, int p_count, const int *p_indices, const Vector2 *p_points, const Vector2 *p_uvs, const Color *p_colors, const Color &p_color) {
+
+	// vertices are unrolled, the indices of a polygon don't tell how many points it has
+	ERR_FAIL_COND(!can_add(p_texture, p_count, p_count));
+	texture = p_texture;
+
+	bool do_uvs = p_texture.is_valid() && p_uvs;
+
+	Vertex *v = &vertices[vertex_count];
+	uint16_t *idx = &indices[index_count];
+
+	for (int i = 0; i < p_count; i++) {
+
+		int src = p_indices ? p_indices[i] : i;
+		v[i].vertex = use_xform ? xform.xform(p_points[src]) : p_points[src];
+		v[i].uv = do_uvs ? p_uvs[src] : Vector2();
+		v[i].color = p_colors ? p_colors[src] : p_color;
+		idx[i] = vertex_count + i;
+	}
+
+	vertex_count += p_count;
+	index_count += p_count;
+}
+
+void RasterizerCanvasBatch::clear() {
+
+	vertex_count = 0;
+	index_count = 0;
+	texture = RID();
+}
+
+RasterizerCanvasBatch::RasterizerCanvasBatch() {
+
+	vertices = memnew_arr(Vertex, MAX_VERTICES);
+	indices = memnew_arr(uint16_t, MAX_INDICES);
+	vertex_count = 0;
+	index_count = 0;
+	use_xform = false;
+}
+
+RasterizerCanvasBatch::~RasterizerCanvasBatch() {
+
+	memdelete_arr(vertices);
+	memdelete_arr(indices);
+}
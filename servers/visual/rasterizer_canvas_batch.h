@@ -0,0 +1,107 @@
+/*************************************************************************/
+/*  rasterizer_canvas_batch.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2019 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2019 Godot Engine contributors (cf. AUTHORS.md)    */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef RASTERIZER_CANVAS_BATCH_H
+#define RASTERIZER_CANVAS_BATCH_H
+
+#include "servers/visual/rasterizer.h"
+
+/**
+ * Collects canvas rects, style boxes and polygons that share a texture into
+ * one indexed triangle list, so a rasterizer can draw them with a single call.
+ * Drawing and the GL state the batch is drawn with are up to the rasterizer:
+ * before adding, it must check can_add() and draw and clear() the batch if
+ * the primitive doesn't go in it. With a transform set, vertices are stored
+ * transformed, which lets a batch span canvas items with different transforms.
+ */
+
+class RasterizerCanvasBatch {
+public:
+	enum {
+		MAX_VERTICES = 4096,
+		MAX_INDICES = MAX_VERTICES * 3,
+		QUAD_VERTICES = 4,
+		QUAD_INDICES = 6,
+		STYLE_BOX_VERTICES = QUAD_VERTICES * 9,
+		STYLE_BOX_INDICES = QUAD_INDICES * 9
+	};
+
+	struct Vertex {
+
+		Vector2 vertex;
+		Vector2 uv;
+		Color color;
+	};
+
+private:
+	Vertex *vertices;
+	uint16_t *indices;
+	int vertex_count;
+	int index_count;
+	RID texture;
+
+	Matrix32 xform;
+	bool use_xform;
+
+	void _add_quad(const Rect2 &p_rect, const Vector2 *p_uvs, const Color &p_color);
+
+public:
+	static void get_textured_quad_uvs(const Rect2 &p_src_region, const Size2 &p_tex_size, bool p_h_flip, bool p_v_flip, bool p_transpose, Vector2 *r_uvs);
+	static int get_style_box_quads(const Rect2 &p_rect, const Rect2 &p_region, const float *p_margin, bool p_draw_center, Rect2 *r_rects, Rect2 *r_sources);
+
+	static _FORCE_INLINE_ bool fits(int p_vertices, int p_indices) { return p_vertices <= MAX_VERTICES && p_indices <= MAX_INDICES; }
+	_FORCE_INLINE_ bool can_add(const RID &p_texture, int p_vertices, int p_indices) const {
+
+		return index_count == 0 || (p_texture == texture && vertex_count + p_vertices <= MAX_VERTICES && index_count + p_indices <= MAX_INDICES);
+	}
+
+	void set_transform(const Matrix32 &p_xform);
+	void clear_transform();
+	_FORCE_INLINE_ bool has_transform() const { return use_xform; }
+
+	// p_tex_size is ignored for an invalid p_texture, which draws an untextured rect
+	void add_rect(const RID &p_texture, const Size2 &p_tex_size, const Rect2 &p_rect, int p_flags, const Rect2 &p_source, const Color &p_color);
+	void add_style_box(const RID &p_texture, const Size2 &p_tex_size, const Rect2 &p_rect, const Rect2 &p_source, const float *p_margin, bool p_draw_center, const Color &p_color);
+	// p_count indices (or vertices if p_indices is NULL) are unrolled, p_colors is per vertex or NULL to use p_color for all
+	void add_polygon(const RID &p_texture, int p_count, const int *p_indices, const Vector2 *p_points, const Vector2 *p_uvs, const Color *p_colors, const Color &p_color);
+
+	_FORCE_INLINE_ bool is_empty() const { return index_count == 0; }
+	_FORCE_INLINE_ const Vertex *get_vertices() const { return vertices; }
+	_FORCE_INLINE_ const uint16_t *get_indices() const { return indices; }
+	_FORCE_INLINE_ int get_vertex_count() const { return vertex_count; }
+	_FORCE_INLINE_ int get_index_count() const { return index_count; }
+	_FORCE_INLINE_ const RID &get_texture() const { return texture; }
+
+	void clear();
+
+	RasterizerCanvasBatch();
+	~RasterizerCanvasBatch();
+};
+
+#endif // RASTERIZER_CANVAS_BATCH_H
@@ -2308,18 +2308,40 @@ void VisualServerRaster::instance_set_surface_material(RID p_instance, int p_sur
 	instance->data.materials[p_surface] = p_material;
 }
 
+void VisualServerRaster::_instance_set_transform(Instance *p_instance, const Transform &p_transform) {
+
+	if (p_transform == p_instance->data.transform) // must improve somehow
+		return;
+
+	p_instance->data.transform = p_transform;
+	if (p_instance->base_type == INSTANCE_LIGHT)
+		p_instance->data.transform.orthonormalize();
+	_instance_queue_update(p_instance);
+}
+
 void VisualServerRaster::instance_set_transform(RID p_instance, const Transform &p_transform) {
 	VS_CHANGED;
 	Instance *instance = instance_owner.get(p_instance);
 	ERR_FAIL_COND(!instance);
 
-	if (p_transform == instance->data.transform) // must improve somehow
-		return;
+	_instance_set_transform(instance, p_transform);
+}
 
-	instance->data.transform = p_transform;
-	if (instance->base_type == INSTANCE_LIGHT)
-		instance->data.transform.orthonormalize();
-	_instance_queue_update(instance);
+void VisualServerRaster::instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform> &p_transforms) {
+	VS_CHANGED;
+	ERR_FAIL_COND(p_instances.size() != p_transforms.size());
+
+	int count = p_instances.size();
+	const RID *instances = p_instances.ptr();
+	const Transform *transforms = p_transforms.ptr();
+
+	for (int i = 0; i < count; i++) {
+
+		Instance *instance = instance_owner.get(instances[i]);
+		ERR_CONTINUE(!instance);
+
+		_instance_set_transform(instance, transforms[i]);
+	}
 }
 
 Transform VisualServerRaster::instance_get_transform(RID p_instance) const {
@@ -4689,7 +4711,7 @@ void VisualServerRaster::_light_instance_update_pssm_shadow(Instance *p_light, S
 		light_frustum_planes[4] = Plane(z_vec, z_max + 1e6);
 		light_frustum_planes[5] = Plane(-z_vec, -z_min); // z_min is ok, since casters further than far-light plane are not needed
 
-		int caster_cull_count = p_scenario->octree.cull_convex(light_frustum_planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, INSTANCE_GEOMETRY_MASK);
+		int caster_cull_count = _cull_convex(p_scenario, light_frustum_planes, instance_shadow_cull_result, INSTANCE_GEOMETRY_MASK);
 
 		// a pre pass will need to be needed to determine the actual z-near to be used
 		for (int j = 0; j < caster_cull_count; j++) {
@@ -4780,19 +4802,19 @@ void VisualServerRaster::_light_instance_update_lispsm_shadow(Instance *p_light,
 	float near_dist = 1;
 
 	Vector<Plane> light_frustum_planes = _camera_generate_orthogonal_planes(p_light, p_camera, p_cull_range.min, p_cull_range.max);
-	int caster_count = p_scenario->octree.cull_convex(light_frustum_planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, INSTANCE_GEOMETRY_MASK);
+	int caster_count = _cull_convex(p_scenario, light_frustum_planes, instance_shadow_cull_result, INSTANCE_GEOMETRY_MASK);
 
 	// this could be faster by just getting supports from the AABBs..
 	// but, safer to do as the original implementation explains for now..
 
-	Vector<Vector3> caster_pointcloud;
-	caster_pointcloud.resize(caster_count * 8);
+	FrameAllocator::Scope frame_scope(&frame_allocator);
+	Vector3 *caster_pointcloud = frame_scope.alloc_array<Vector3>(caster_count * 8);
 	int caster_pointcloud_size = 0;
 
 	{
 
 		//fill pointcloud
-		Vector3 *caster_pointcloud_ptr = &caster_pointcloud[0];
+		Vector3 *caster_pointcloud_ptr = caster_pointcloud;
 
 		for (int i = 0; i < caster_count; i++) {
 
@@ -4838,7 +4860,7 @@ void VisualServerRaster::_light_instance_update_lispsm_shadow(Instance *p_light,
 		AABB light_space_pointcloud_aabb;
 		AABB light_space_camera_aabb;
 		//xform pointcloud
-		const Vector3 *caster_pointcloud_ptr = &caster_pointcloud[0];
+		const Vector3 *caster_pointcloud_ptr = caster_pointcloud;
 
 		for (int i = 0; i < caster_pointcloud_size; i++) {
 
@@ -4899,7 +4921,7 @@ void VisualServerRaster::_light_instance_update_lispsm_shadow(Instance *p_light,
 		AABB proj_space_pointcloud_aabb;
 		AABB proj_space_camera_aabb;
 		//xform pointcloud
-		Vector3 *caster_pointcloud_ptr = &caster_pointcloud[0];
+		Vector3 *caster_pointcloud_ptr = caster_pointcloud;
 		for (int i = 0; i < caster_pointcloud_size; i++) {
 
 			Vector3 p = projection.xform(caster_pointcloud_ptr[i]);
@@ -5018,7 +5040,7 @@ void VisualServerRaster::_light_instance_update_lispsm_shadow(Instance *p_light,
 
 	/* STEP 3: CULL CASTERS */
 
-	int caster_count = p_scenario->octree.cull_convex(light_cull_planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, INSTANCE_GEOMETRY_MASK);
+	int caster_count = _cull_convex(p_scenario, light_cull_planes, instance_shadow_cull_result, INSTANCE_GEOMETRY_MASK);
 
 	/* STEP 4: ADJUST FAR Z PLANE */
 
@@ -5122,24 +5144,13 @@ void VisualServerRaster::_light_instance_update_lispsm_shadow(Instance *p_light,
 
 #endif
 
-void VisualServerRaster::_light_instance_update_shadow(Instance *p_light, Scenario *p_scenario, Camera *p_camera, const CullRange &p_cull_range) {
-
-	if (!rasterizer->shadow_allocate_near(p_light->light_info->instance))
-		return; // shadow could not be updated
+int VisualServerRaster::_light_instance_get_shadow_planes(Instance *p_light, Rasterizer::ShadowType p_shadow_type, Vector<Plane> *r_planes) {
 
-	/* VisualServerRaster supports for many shadow techniques, using the one the rasterizer requests */
-
-	Rasterizer::ShadowType shadow_type = rasterizer->light_instance_get_shadow_type(p_light->light_info->instance);
-
-	switch (shadow_type) {
+	switch (p_shadow_type) {
 
 		case Rasterizer::SHADOW_SIMPLE: {
 			/* SPOT SHADOW */
 
-			rasterizer->begin_shadow_map(p_light->light_info->instance, 0);
-
-			//using this one ensures that raster deferred will have it
-
 			float far = rasterizer->light_get_var(p_light->base_rid, VS::LIGHT_PARAM_RADIUS);
 
 			float angle = rasterizer->light_get_var(p_light->base_rid, VS::LIGHT_PARAM_SPOT_ANGLE);
@@ -5147,60 +5158,88 @@ void VisualServerRaster::_light_instance_update_shadow(Instance *p_light, Scenar
 			CameraMatrix cm;
 			cm.set_perspective(angle * 2.0, 1.0, 0.001, far);
 
-			Vector<Plane> planes = cm.get_projection_planes(p_light->data.transform);
-			int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, INSTANCE_GEOMETRY_MASK);
+			r_planes[0] = cm.get_projection_planes(p_light->data.transform);
+			return 1;
+
+		} break;
+		case Rasterizer::SHADOW_DUAL_PARABOLOID: {
+
+			/* OMNI SHADOW */
 
-			for (int i = 0; i < cull_count; i++) {
+			int passes = rasterizer->light_instance_get_shadow_passes(p_light->light_info->instance);
 
-				Instance *instance = instance_shadow_cull_result[i];
-				if (!instance->visible || instance->data.cast_shadows == VS::SHADOW_CASTING_SETTING_OFF)
-					continue;
-				_instance_draw(instance);
+			if (passes != 2)
+				return 0; // one go is not supported
+
+			float radius = rasterizer->light_get_var(p_light->base_rid, VS::LIGHT_PARAM_RADIUS);
+
+			for (int i = 0; i < 2; i++) {
+
+				float z = i == 0 ? -1 : 1;
+				Vector<Plane> &planes = r_planes[i];
+				planes.resize(5);
+				planes[0] = p_light->data.transform.xform(Plane(Vector3(0, 0, z), radius));
+				planes[1] = p_light->data.transform.xform(Plane(Vector3(1, 0, z).normalized(), radius));
+				planes[2] = p_light->data.transform.xform(Plane(Vector3(-1, 0, z).normalized(), radius));
+				planes[3] = p_light->data.transform.xform(Plane(Vector3(0, 1, z).normalized(), radius));
+				planes[4] = p_light->data.transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
 			}
 
-			rasterizer->end_shadow_map();
+			return 2;
 
 		} break;
-		case Rasterizer::SHADOW_DUAL_PARABOLOID: {
+		default: {}
+	}
 
-			/* OMNI SHADOW */
+	return 0;
+}
 
-			int passes = rasterizer->light_instance_get_shadow_passes(p_light->light_info->instance);
+void VisualServerRaster::_light_instance_update_shadow(Instance *p_light, Scenario *p_scenario, Camera *p_camera, const CullRange &p_cull_range, const ShadowCasterCull *p_caster_cull) {
 
-			if (passes == 2) {
+	if (!rasterizer->shadow_allocate_near(p_light->light_info->instance))
+		return; // shadow could not be updated
 
-				for (int i = 0; i < 2; i++) {
+	/* VisualServerRaster supports for many shadow techniques, using the one the rasterizer requests */
 
-					rasterizer->begin_shadow_map(p_light->light_info->instance, i);
+	Rasterizer::ShadowType shadow_type = rasterizer->light_instance_get_shadow_type(p_light->light_info->instance);
 
-					//using this one ensures that raster deferred will have it
+	switch (shadow_type) {
 
-					float radius = rasterizer->light_get_var(p_light->base_rid, VS::LIGHT_PARAM_RADIUS);
+		case Rasterizer::SHADOW_SIMPLE:
+		case Rasterizer::SHADOW_DUAL_PARABOLOID: {
 
-					float z = i == 0 ? -1 : 1;
-					Vector<Plane> planes;
-					planes.resize(5);
-					planes[0] = p_light->data.transform.xform(Plane(Vector3(0, 0, z), radius));
-					planes[1] = p_light->data.transform.xform(Plane(Vector3(1, 0, z).normalized(), radius));
-					planes[2] = p_light->data.transform.xform(Plane(Vector3(-1, 0, z).normalized(), radius));
-					planes[3] = p_light->data.transform.xform(Plane(Vector3(0, 1, z).normalized(), radius));
-					planes[4] = p_light->data.transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
+			//casters may have been culled in advance, in parallel with other lights
 
-					int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, INSTANCE_GEOMETRY_MASK);
+			Vector<Plane> planes[2];
+			int passes = p_caster_cull ? p_caster_cull->passes : _light_instance_get_shadow_planes(p_light, shadow_type, planes);
 
-					for (int j = 0; j < cull_count; j++) {
+			for (int i = 0; i < passes; i++) {
 
-						Instance *instance = instance_shadow_cull_result[j];
-						if (!instance->visible || instance->data.cast_shadows == VS::SHADOW_CASTING_SETTING_OFF)
-							continue;
+				rasterizer->begin_shadow_map(p_light->light_info->instance, i);
 
-						_instance_draw(instance);
-					}
+				//using this one ensures that raster deferred will have it
+
+				Instance *const *casters;
+				int cull_count;
+
+				if (p_caster_cull) {
+					casters = p_caster_cull->casters[i].ptr();
+					cull_count = p_caster_cull->caster_count[i];
+				} else {
+					cull_count = _cull_convex(p_scenario, planes[i], instance_shadow_cull_result, INSTANCE_GEOMETRY_MASK);
+					casters = instance_shadow_cull_result.ptr();
+				}
+
+				for (int j = 0; j < cull_count; j++) {
+
+					Instance *instance = casters[j];
+					if (!instance->visible || instance->data.cast_shadows == VS::SHADOW_CASTING_SETTING_OFF)
+						continue;
 
-					rasterizer->end_shadow_map();
+					_instance_draw(instance);
 				}
-			} else if (passes == 1) {
-				//one go
+
+				rasterizer->end_shadow_map();
 			}
 
 		} break;
@@ -5908,6 +5947,125 @@ void VisualServerRaster::_render_no_camera(Viewport *p_viewport, Camera *p_camer
 	rasterizer->end_scene();
 }
 
+int VisualServerRaster::_cull_convex(Scenario *p_scenario, const Vector<Plane> &p_planes, Vector<Instance *> &r_result, uint32_t p_mask) {
+
+	// the octree stops once the result is full, so grow it and cull again until everything fits
+	while (true) {
+
+		int count = p_scenario->octree.cull_convex(p_planes, r_result.ptr(), r_result.size(), p_mask);
+		if (count < r_result.size())
+			return count;
+
+		r_result.resize(MAX(r_result.size() * 2, 1024));
+	}
+}
+
+void VisualServerRaster::_instance_cull_chunk(uint32_t p_chunk, InstanceCullData *p_data) {
+
+	const CullRange &cull_range = p_data->cull_range;
+	CullRange &chunk_range = p_data->chunk_ranges[p_chunk];
+	chunk_range.min = cull_range.min;
+	chunk_range.max = cull_range.max;
+
+	int from = p_chunk * INSTANCE_CULL_CHUNK_SIZE;
+	int to = MIN(from + INSTANCE_CULL_CHUNK_SIZE, p_data->instance_count);
+
+	for (int i = from; i < to; i++) {
+
+		Instance *ins = p_data->instances[i];
+
+		uint8_t visibility = INSTANCE_CULL_DISCARD;
+
+		if ((p_data->camera_layer_mask & ins->layer_mask) == 0) {
+
+			//failure
+		} else if (ins->base_type == INSTANCE_LIGHT) {
+
+			visibility = INSTANCE_CULL_LIGHT;
+			//				rasterizer->light_instance_set_active_hint(ins->light_info->instance);
+			{
+				//compute distance to camera using aabb support
+				Vector3 n = ins->data.transform.basis.xform_inv(cull_range.nearp.normal).normalized();
+				Vector3 s = ins->data.transform.xform(ins->aabb.get_support(n));
+				ins->light_info->dtc = cull_range.nearp.distance_to(s);
+			}
+
+		} else if ((1 << ins->base_type) & INSTANCE_GEOMETRY_MASK && ins->visible && ins->data.cast_shadows != VS::SHADOW_CASTING_SETTING_SHADOWS_ONLY) {
+
+			bool discarded = false;
+			bool keep = false;
+
+			if (ins->draw_range_end > 0) {
+
+				float d = cull_range.nearp.distance_to(ins->data.transform.origin);
+				if (d < 0)
+					d = 0;
+				discarded = (d < ins->draw_range_begin || d >= ins->draw_range_end);
+			}
+
+			if (!discarded) {
+
+				// test if this geometry should be visible
+
+				if (room_cull_enabled) {
+
+					if (ins->visible_in_all_rooms) {
+						keep = true;
+					} else if (ins->room) {
+
+						if (ins->room->room_info->last_visited_pass == render_pass)
+							keep = true;
+					} else if (ins->auto_rooms.size()) {
+
+						for (Set<Instance *>::Element *E = ins->auto_rooms.front(); E; E = E->next()) {
+
+							if (E->get()->room_info->last_visited_pass == render_pass) {
+								keep = true;
+								break;
+							}
+						}
+					} else if (exterior_visited)
+						keep = true;
+				} else {
+
+					keep = true;
+				}
+			}
+
+			if (keep) {
+				// update cull range
+				float min, max;
+				ins->transformed_aabb.project_range_in_plane(cull_range.nearp, min, max);
+
+				if (min < chunk_range.min)
+					chunk_range.min = min;
+				if (max > chunk_range.max)
+					chunk_range.max = max;
+
+				visibility = INSTANCE_CULL_GEOMETRY;
+			}
+		}
+
+		p_data->visibility[i] = visibility;
+	}
+}
+
+void VisualServerRaster::_shadow_caster_cull(uint32_t p_index, ShadowCasterCullData *p_data) {
+
+	ShadowCasterCull &cc = p_data->culls[p_index / 2];
+	int pass = p_index % 2;
+
+	if (pass >= cc.passes)
+		return;
+
+	cc.caster_count[pass] = p_data->scenario->octree.cull_convex_threadsafe(cc.planes[pass], cc.casters[pass], cc.cull_buffers[pass], INSTANCE_GEOMETRY_MASK);
+}
+
+void VisualServerRaster::_camera_cull_part(uint32_t p_part, CameraCullData *p_data) {
+
+	camera_cull_counts[p_part] = p_data->scenario->octree.cull_convex_threadsafe_part(p_part, *p_data->planes, camera_cull_buffers[p_part]);
+}
+
 void VisualServerRaster::_render_camera(Viewport *p_viewport, Camera *p_camera, Scenario *p_scenario) {
 
 	render_pass++;
@@ -5957,7 +6115,22 @@ void VisualServerRaster::_render_camera(Viewport *p_viewport, Camera *p_camera,
 	cull_range.max = cull_range.z_near;
 
 	/* STEP 2 - CULL */
-	int cull_count = p_scenario->octree.cull_convex(planes, instance_cull_result, MAX_INSTANCE_CULL);
+	int cull_count;
+
+	if (cull_work_pool.is_threaded()) {
+
+		// each part of the octree is culled on its own thread, the result is sorted by octree id instead of traversal order
+		CameraCullData data;
+		data.scenario = p_scenario;
+		data.planes = &planes;
+
+		cull_work_pool.do_work(Scenario::Octree::CULL_PARTS, this, &VisualServerRaster::_camera_cull_part, &data);
+		cull_count = p_scenario->octree.cull_convex_threadsafe_merge(camera_cull_buffers, camera_cull_counts, instance_cull_result);
+	} else {
+
+		cull_count = _cull_convex(p_scenario, planes, instance_cull_result);
+	}
+	Instance **cull_result = instance_cull_result.ptr();
 	light_cull_count = 0;
 	light_samplers_culled = 0;
 
@@ -5977,7 +6150,7 @@ void VisualServerRaster::_render_camera(Viewport *p_viewport, Camera *p_camera,
 	if (room_cull_enabled) {
 		for (int i = 0; i < cull_count; i++) {
 
-			Instance *ins = instance_cull_result[i];
+			Instance *ins = cull_result[i];
 			ins->last_render_pass = render_pass;
 
 			if (ins->base_type != INSTANCE_PORTAL)
@@ -6048,98 +6221,67 @@ void VisualServerRaster::_render_camera(Viewport *p_viewport, Camera *p_camera,
 
 	/* STEP 4 - REMOVE FURTHER CULLED OBJECTS, ADD LIGHTS */
 
-	for (int i = 0; i < cull_count; i++) {
-
-		Instance *ins = instance_cull_result[i];
-
-		bool keep = false;
-
-		if ((camera_layer_mask & ins->layer_mask) == 0) {
-
-			//failure
-		} else if (ins->base_type == INSTANCE_LIGHT) {
+	{
+		// visibility and draw range checks only touch each instance, so they are split in chunks between
+		// the cull threads. Keeping the result, lights and baked light samplers is done afterwards, in order.
 
-			if (light_cull_count < MAX_LIGHTS_CULLED) {
-				light_cull_result[light_cull_count++] = ins;
-				//				rasterizer->light_instance_set_active_hint(ins->light_info->instance);
-				{
-					//compute distance to camera using aabb support
-					Vector3 n = ins->data.transform.basis.xform_inv(cull_range.nearp.normal).normalized();
-					Vector3 s = ins->data.transform.xform(ins->aabb.get_support(n));
-					ins->light_info->dtc = cull_range.nearp.distance_to(s);
-				}
-			}
+		int chunk_count = (cull_count + INSTANCE_CULL_CHUNK_SIZE - 1) / INSTANCE_CULL_CHUNK_SIZE;
 
-		} else if ((1 << ins->base_type) & INSTANCE_GEOMETRY_MASK && ins->visible && ins->data.cast_shadows != VS::SHADOW_CASTING_SETTING_SHADOWS_ONLY) {
+		if (instance_cull_visibility.size() < cull_count)
+			instance_cull_visibility.resize(cull_count);
+		if (instance_cull_chunk_ranges.size() < chunk_count)
+			instance_cull_chunk_ranges.resize(chunk_count);
 
-			bool discarded = false;
+		InstanceCullData data;
+		data.instances = cull_result;
+		data.visibility = instance_cull_visibility.ptr();
+		data.chunk_ranges = instance_cull_chunk_ranges.ptr();
+		data.instance_count = cull_count;
+		data.camera_layer_mask = camera_layer_mask;
+		data.cull_range = cull_range;
 
-			if (ins->draw_range_end > 0) {
+		cull_work_pool.do_work(chunk_count, this, &VisualServerRaster::_instance_cull_chunk, &data);
 
-				float d = cull_range.nearp.distance_to(ins->data.transform.origin);
-				if (d < 0)
-					d = 0;
-				discarded = (d < ins->draw_range_begin || d >= ins->draw_range_end);
-			}
+		for (int i = 0; i < chunk_count; i++) {
 
-			if (!discarded) {
+			if (data.chunk_ranges[i].min < cull_range.min)
+				cull_range.min = data.chunk_ranges[i].min;
+			if (data.chunk_ranges[i].max > cull_range.max)
+				cull_range.max = data.chunk_ranges[i].max;
+		}
 
-				// test if this geometry should be visible
+		int keep_count = 0;
 
-				if (room_cull_enabled) {
+		for (int i = 0; i < cull_count; i++) {
 
-					if (ins->visible_in_all_rooms) {
-						keep = true;
-					} else if (ins->room) {
+			Instance *ins = cull_result[i];
 
-						if (ins->room->room_info->last_visited_pass == render_pass)
-							keep = true;
-					} else if (ins->auto_rooms.size()) {
+			if (data.visibility[i] != INSTANCE_CULL_GEOMETRY) {
 
-						for (Set<Instance *>::Element *E = ins->auto_rooms.front(); E; E = E->next()) {
+				if (data.visibility[i] == INSTANCE_CULL_LIGHT) {
 
-							if (E->get()->room_info->last_visited_pass == render_pass) {
-								keep = true;
-								break;
-							}
-						}
-					} else if (exterior_visited)
-						keep = true;
-				} else {
-
-					keep = true;
+					if (light_cull_count == light_cull_result.size())
+						light_cull_result.resize(MAX(light_cull_count * 2, 64));
+					light_cull_result[light_cull_count++] = ins;
 				}
-			}
-
-			if (keep) {
-				// update cull range
-				float min, max;
-				ins->transformed_aabb.project_range_in_plane(cull_range.nearp, min, max);
 
-				if (min < cull_range.min)
-					cull_range.min = min;
-				if (max > cull_range.max)
-					cull_range.max = max;
+				// remove, no reason to keep
+				ins->last_render_pass = 0; // make invalid
+				continue;
+			}
 
-				if (ins->sampled_light && ins->sampled_light->baked_light_sampler_info->last_pass != render_pass) {
-					if (light_samplers_culled < MAX_LIGHT_SAMPLERS) {
-						light_sampler_cull_result[light_samplers_culled++] = ins->sampled_light;
-						ins->sampled_light->baked_light_sampler_info->last_pass = render_pass;
-					}
+			if (ins->sampled_light && ins->sampled_light->baked_light_sampler_info->last_pass != render_pass) {
+				if (light_samplers_culled < MAX_LIGHT_SAMPLERS) {
+					light_sampler_cull_result[light_samplers_culled++] = ins->sampled_light;
+					ins->sampled_light->baked_light_sampler_info->last_pass = render_pass;
 				}
 			}
-		}
-
-		if (!keep) {
-			// remove, no reason to keep
-			cull_count--;
-			SWAP(instance_cull_result[i], instance_cull_result[cull_count]);
-			i--;
-			ins->last_render_pass = 0; // make invalid
-		} else {
 
 			ins->last_render_pass = render_pass;
+			cull_result[keep_count++] = ins;
 		}
+
+		cull_count = keep_count;
 	}
 
 	if (cull_range.max > cull_range.z_far)
@@ -6204,7 +6346,41 @@ void VisualServerRaster::_render_camera(Viewport *p_viewport, Camera *p_camera,
 	{ //this should eventually change to
 		//assign shadows by distance to camera
 		SortArray<Instance *, _InstanceLightsort> sorter;
-		sorter.sort(light_cull_result, light_cull_count);
+		sorter.sort(light_cull_result.ptr(), light_cull_count);
+
+		// spot and omni casters don't depend on each other, cull them for all lights at once
+		int caster_cull_count = 0;
+
+		if (cull_work_pool.is_threaded() && shadows_enabled) {
+
+			for (int i = 0; i < light_cull_count; i++) {
+
+				Instance *ins = light_cull_result[i];
+
+				if (!rasterizer->light_has_shadow(ins->base_rid))
+					continue;
+
+				if (caster_cull_count == shadow_caster_culls.size())
+					shadow_caster_culls.resize(MAX(caster_cull_count * 2, 16));
+
+				ShadowCasterCull &cc = shadow_caster_culls[caster_cull_count];
+				cc.light = ins;
+				cc.passes = _light_instance_get_shadow_planes(ins, rasterizer->light_instance_get_shadow_type(ins->light_info->instance), cc.planes);
+
+				if (cc.passes)
+					caster_cull_count++;
+			}
+
+			// the workers index the raw array, Vector::operator[] may copy on write
+			ShadowCasterCullData data;
+			data.scenario = p_scenario;
+			data.culls = shadow_caster_culls.ptr();
+
+			cull_work_pool.do_work(caster_cull_count * 2, this, &VisualServerRaster::_shadow_caster_cull, &data);
+		}
+
+		int caster_cull_idx = 0;
+
 		for (int i = 0; i < light_cull_count; i++) {
 
 			Instance *ins = light_cull_result[i];
@@ -6217,7 +6393,12 @@ void VisualServerRaster::_render_camera(Viewport *p_viewport, Camera *p_camera,
 				continue; // didn't change
 			*/
 
-			_light_instance_update_shadow(ins, p_scenario, p_camera, cull_range);
+			const ShadowCasterCull *caster_cull = NULL;
+			if (caster_cull_idx < caster_cull_count && shadow_caster_culls[caster_cull_idx].light == ins) {
+				caster_cull = &shadow_caster_culls[caster_cull_idx++];
+			}
+
+			_light_instance_update_shadow(ins, p_scenario, p_camera, cull_range, caster_cull);
 			ins->light_info->last_version = ins->version;
 		}
 	}
@@ -6276,7 +6457,7 @@ void VisualServerRaster::_render_camera(Viewport *p_viewport, Camera *p_camera,
 
 	for (int i = 0; i < cull_count; i++) {
 
-		Instance *ins = instance_cull_result[i];
+		Instance *ins = cull_result[i];
 
 		ERR_CONTINUE(!((1 << ins->base_type) & INSTANCE_GEOMETRY_MASK));
 
@@ -6931,6 +7112,9 @@ void VisualServerRaster::draw() {
 	//if (changes)
 	//	print_line("changes: "+itos(changes));
 	changes = 0;
+	//draw() may run in the server thread, which then owns the frame memory
+	frame_allocator.set_owner_thread(Thread::get_caller_ID());
+	frame_allocator.reset();
 	shadows_enabled = GLOBAL_DEF("render/shadows_enabled", true);
 	room_cull_enabled = GLOBAL_DEF("render/room_cull_enabled", true);
 	light_discard_enabled = GLOBAL_DEF("render/light_discard_enabled", true);
@@ -7029,6 +7213,12 @@ void VisualServerRaster::init() {
 	rasterizer->init();
 
 	shadows_enabled = GLOBAL_DEF("render/shadows_enabled", true);
+
+	// 1 keeps culling on the render thread, 0 uses one thread per processor
+	int cull_threads = GLOBAL_DEF("render/cull_thread_count", 1);
+	Globals::get_singleton()->set_custom_property_info("render/cull_thread_count", PropertyInfo(Variant::INT, "render/cull_thread_count", PROPERTY_HINT_RANGE, "0,64,1"));
+	cull_work_pool.init(cull_threads);
+
 	//default_scenario = scenario_create();
 	//default_viewport = viewport_create();
 	for (int i = 0; i < 4; i++)
@@ -7078,6 +7268,7 @@ void VisualServerRaster::finish() {
 	_clean_up_owner(&canvas_item_owner, "CanvasItem");
 
 	rasterizer->finish();
+	cull_work_pool.finish();
 	octree_allocator.clear();
 
 	if (instance_dependency_map.size()) {
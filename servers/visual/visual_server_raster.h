@@ -31,7 +31,9 @@
 #define VISUAL_SERVER_RASTER_H
 
 #include "allocators.h"
+#include "frame_allocator.h"
 #include "octree.h"
+#include "os/thread_work_pool.h"
 #include "servers/visual/rasterizer.h"
 #include "servers/visual_server.h"
 
@@ -43,10 +45,9 @@ class VisualServerRaster : public VisualServer {
 
 	enum {
 
-		MAX_INSTANCE_CULL = 8192,
+		INSTANCE_CULL_CHUNK_SIZE = 256,
 		MAX_INSTANCE_LIGHTS = 4,
 		LIGHT_CACHE_DIRTY = -1,
-		MAX_LIGHTS_CULLED = 256,
 		MAX_ROOM_CULL = 32,
 		MAX_EXTERIOR_PORTALS = 128,
 		MAX_LIGHT_SAMPLERS = 256,
@@ -62,6 +63,7 @@ class VisualServerRaster : public VisualServer {
 	};
 
 	BalloonAllocator<> octree_allocator;
+	FrameAllocator frame_allocator;
 
 	struct OctreeAllocator {
 
@@ -560,11 +562,57 @@ class VisualServerRaster : public VisualServer {
 	static void *instance_pair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int);
 	static void instance_unpair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int, void *);
 
-	Instance *instance_cull_result[MAX_INSTANCE_CULL];
-	Instance *instance_shadow_cull_result[MAX_INSTANCE_CULL]; //used for generating shadowmaps
-	Instance *light_cull_result[MAX_LIGHTS_CULLED];
+	Vector<Instance *> instance_cull_result;
+	Vector<Instance *> instance_shadow_cull_result; //used for generating shadowmaps
+	Vector<Instance *> light_cull_result;
 	int light_cull_count;
 
+	enum InstanceCullVisibility {
+
+		INSTANCE_CULL_DISCARD,
+		INSTANCE_CULL_LIGHT,
+		INSTANCE_CULL_GEOMETRY
+	};
+
+	struct InstanceCullData {
+
+		Instance **instances;
+		uint8_t *visibility;
+		CullRange *chunk_ranges;
+		int instance_count;
+		uint32_t camera_layer_mask;
+		CullRange cull_range;
+	};
+
+	struct ShadowCasterCull {
+
+		Instance *light;
+		int passes;
+		Vector<Plane> planes[2];
+		Vector<Instance *> casters[2];
+		int caster_count[2];
+		Scenario::Octree::CullBuffer cull_buffers[2];
+	};
+
+	struct ShadowCasterCullData {
+
+		Scenario *scenario;
+		ShadowCasterCull *culls;
+	};
+
+	struct CameraCullData {
+
+		Scenario *scenario;
+		const Vector<Plane> *planes;
+	};
+
+	ThreadWorkPool cull_work_pool;
+	Vector<uint8_t> instance_cull_visibility;
+	Vector<CullRange> instance_cull_chunk_ranges;
+	Vector<ShadowCasterCull> shadow_caster_culls;
+	Scenario::Octree::CullBuffer camera_cull_buffers[Scenario::Octree::CULL_PARTS];
+	int camera_cull_counts[Scenario::Octree::CULL_PARTS];
+
 	Instance *exterior_portal_cull_result[MAX_EXTERIOR_PORTALS];
 	int exterior_portal_cull_count;
 	bool exterior_visited;
@@ -589,6 +637,7 @@ class VisualServerRaster : public VisualServer {
 	void _portal_attempt_connect(Instance *p_portal);
 	void _dependency_queue_update(RID p_rid, bool p_update_aabb = false, bool p_update_materials = false);
 	_FORCE_INLINE_ void _instance_queue_update(Instance *p_instance, bool p_update_aabb = false, bool p_update_materials = false);
+	_FORCE_INLINE_ void _instance_set_transform(Instance *p_instance, const Transform &p_transform);
 	void _update_instances();
 	void _update_instance_aabb(Instance *p_instance);
 	void _update_instance(Instance *p_instance);
@@ -642,7 +691,13 @@ class VisualServerRaster : public VisualServer {
 	void _light_instance_update_lispsm_shadow(Instance *p_light, Scenario *p_scenario, Camera *p_camera, const CullRange &p_cull_range);
 	void _light_instance_update_pssm_shadow(Instance *p_light, Scenario *p_scenario, Camera *p_camera, const CullRange &p_cull_range);
 
-	void _light_instance_update_shadow(Instance *p_light, Scenario *p_scenario, Camera *p_camera, const CullRange &p_cull_range);
+	void _light_instance_update_shadow(Instance *p_light, Scenario *p_scenario, Camera *p_camera, const CullRange &p_cull_range, const ShadowCasterCull *p_caster_cull = NULL);
+	int _light_instance_get_shadow_planes(Instance *p_light, Rasterizer::ShadowType p_shadow_type, Vector<Plane> *r_planes);
+
+	int _cull_convex(Scenario *p_scenario, const Vector<Plane> &p_planes, Vector<Instance *> &r_result, uint32_t p_mask = 0xFFFFFFFF);
+	void _instance_cull_chunk(uint32_t p_chunk, InstanceCullData *p_data);
+	void _shadow_caster_cull(uint32_t p_index, ShadowCasterCullData *p_data);
+	void _camera_cull_part(uint32_t p_part, CameraCullData *p_data);
 
 	uint64_t render_pass;
 	int changes;
@@ -1074,6 +1129,7 @@ public:
 
 	virtual void instance_set_transform(RID p_instance, const Transform &p_transform);
 	virtual Transform instance_get_transform(RID p_instance) const;
+	virtual void instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform> &p_transforms);
 
 	virtual void instance_set_exterior(RID p_instance, bool p_enabled);
 	virtual bool instance_is_exterior(RID p_instance) const;
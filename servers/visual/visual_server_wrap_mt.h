@@ -505,6 +505,7 @@ public:
 
 	FUNC2(instance_set_transform, RID, const Transform &);
 	FUNC1RC(Transform, instance_get_transform, RID);
+	FUNC2(instances_set_transforms, const Vector<RID> &, const Vector<Transform> &);
 
 	FUNC2(instance_set_exterior, RID, bool);
 	FUNC1RC(bool, instance_is_exterior, RID);
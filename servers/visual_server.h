@@ -878,6 +878,7 @@ public:
 
 	virtual void instance_set_transform(RID p_instance, const Transform &p_transform) = 0;
 	virtual Transform instance_get_transform(RID p_instance) const = 0;
+	virtual void instances_set_transforms(const Vector<RID> &p_instances, const Vector<Transform> &p_transforms) = 0; // same as calling instance_set_transform() for each one
 
 	virtual void instance_attach_object_instance_ID(RID p_instance, uint32_t p_ID) = 0;
 	virtual uint32_t instance_get_object_instance_ID(RID p_instance) const = 0;